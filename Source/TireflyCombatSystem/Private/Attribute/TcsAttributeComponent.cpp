@@ -3,8 +3,12 @@
 
 #include "Attribute/TcsAttributeComponent.h"
 
+#include "TcsDefinitionId.h"
 #include "TcsEntityInterface.h"
 #include "TcsLogChannels.h"
+#include "TcsStats.h"
+#include "TcsDefinitionProfiler.h"
+#include "TcsMemoryReport.h"
 #include "Attribute/TcsAttributeManagerSubsystem.h"
 #include "Attribute/TcsAttributeDefinition.h"
 #include "Attribute/TcsAttributeModifierDefinition.h"
@@ -14,18 +18,33 @@
 #include "Attribute/AttrClampStrategy/TcsAttributeClampContext.h"
 #include "Engine/GameInstance.h"
 #include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
 
 
 
 UTcsAttributeComponent::UTcsAttributeComponent()
 {
-	PrimaryComponentTick.bCanEverTick = false;
+	// 只用于延迟提交修改器，平时不 Tick；Tick 函数只在启用延迟提交时注册（见 RegisterComponentTickFunctions）
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	SetIsReplicatedByDefault(true);
+}
+
+void UTcsAttributeComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// 复制数组的回调需要回到组件，组件构造完成后再绑定（避免从原型拷贝到错误的 Owner）
+	ReplicatedAttributes.OwnerComponent = this;
+	ReplicatedModifiers.OwnerComponent = this;
 }
 
 void UTcsAttributeComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
+	SetTickGroup(DeferredCommitTickGroup);
+
 	if (UWorld* World = GetWorld())
 	{
 		if (UGameInstance* GI = World->GetGameInstance())
@@ -39,6 +58,69 @@ void UTcsAttributeComponent::BeginPlay()
 	// 若此处仍为空表明 Subsystem 生命周期被破坏，立即暴露。
 	checkf(AttrMgr, TEXT("AttrMgr resolve failed in BeginPlay for %s; GameInstanceSubsystem lifecycle broken."), *GetPathName());
 #endif
+
+	if (bPublishAttributeSnapshot && AttrMgr)
+	{
+		// 首份快照在本帧所有 Actor Tick 结束后由属性管理器发布
+		AttrMgr->RegisterAttributeSnapshotPublisher(this);
+		bAttributeSnapshotDirty = true;
+	}
+
+	// 连接握手：由客户端自己控制的实体上报定义列表哈希，服务端回复后两端各自决定能否使用 NetIndex
+	if (GetOwnerRole() == ROLE_AutonomousProxy)
+	{
+		ServerReportNetworkDefinitionListHashes(FTcsDefinitionIdTable::GetNetworkDefinitionListHashes());
+	}
+}
+
+void UTcsAttributeComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// 归还组件为挂有修改器的来源持有的引用
+	if (AttrMgr)
+	{
+		for (const TPair<FTcsSourceHandle, TArray<int32>>& Pair : SourceHandleIdToModifierInstIds)
+		{
+			AttrMgr->ReleaseSourceHandle(Pair.Key);
+		}
+	}
+	SourceHandleIdToModifierInstIds.Empty();
+
+	// 归还暂存修改器持有的来源引用
+	for (const FPendingDeferredModifier& Pending : PendingDeferredModifiers)
+	{
+		ReleaseDeferredModifierSource(Pending.Modifier);
+	}
+	PendingDeferredModifiers.Empty();
+	NumDeferredApplyCalls = 0;
+
+	if (bPublishAttributeSnapshot && AttrMgr)
+	{
+		AttrMgr->UnregisterAttributeSnapshotPublisher(this);
+	}
+	AttributeSnapshots.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UTcsAttributeComponent::RegisterComponentTickFunctions(bool bRegister)
+{
+	// 未启用延迟提交时组件永远不需要 Tick，不进入 World 的 Tick 列表
+	if (bRegister && !bDeferModifierCommit)
+	{
+		return;
+	}
+
+	Super::RegisterComponentTickFunctions(bRegister);
+}
+
+void UTcsAttributeComponent::TickComponent(
+	float DeltaTime,
+	ELevelTick TickType,
+	FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	CommitDeferredModifiers();
 }
 
 UTcsAttributeManagerSubsystem* UTcsAttributeComponent::ResolveAttributeManager()
@@ -105,17 +187,92 @@ TMap<FName, float> UTcsAttributeComponent::GetAttributeBaseValues() const
 void UTcsAttributeComponent::BroadcastAttributeValueChangeEvent(
 	const TArray<FTcsAttributeChangeEventPayload>& Payloads) const
 {
-	if (!Payloads.IsEmpty() && OnAttributeValueChanged.IsBound())
+	if (Payloads.IsEmpty())
+	{
+		return;
+	}
+
+	if (IsBatchingNotifications())
+	{
+		QueueAttributeChangePayloads(Payloads, PendingValueChangePayloads, PendingValueChangeIndices);
+		return;
+	}
+
+	// 原生订阅只派发给变化属性的监听者
+	if (!AttributeChangedSubscriptions.IsEmpty())
+	{
+		for (const FTcsAttributeChangeEventPayload& Payload : Payloads)
+		{
+			if (const TSharedRef<FTcsOnAttributeChangedNative>* Subscription = AttributeChangedSubscriptions.Find(Payload.AttributeName))
+			{
+				const TSharedRef<FTcsOnAttributeChangedNative> Event = *Subscription;
+				TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
+				Event->Broadcast(Payload);
+			}
+		}
+	}
+
+	if (OnAttributeValueChanged.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnAttributeValueChanged.Broadcast(Payloads);
 	}
 }
 
+FDelegateHandle UTcsAttributeComponent::SubscribeAttributeChanged(
+	FName AttributeName,
+	FTcsOnAttributeChangedNative::FDelegate&& Delegate)
+{
+	if (AttributeName.IsNone() || !Delegate.IsBound())
+	{
+		return FDelegateHandle();
+	}
+
+	TSharedRef<FTcsOnAttributeChangedNative>* Subscription = AttributeChangedSubscriptions.Find(AttributeName);
+	if (!Subscription)
+	{
+		Subscription = &AttributeChangedSubscriptions.Add(AttributeName, MakeShared<FTcsOnAttributeChangedNative>());
+	}
+
+	return (*Subscription)->Add(MoveTemp(Delegate));
+}
+
+void UTcsAttributeComponent::UnsubscribeAttributeChanged(FName AttributeName, FDelegateHandle Handle)
+{
+	if (const TSharedRef<FTcsOnAttributeChangedNative>* Subscription = AttributeChangedSubscriptions.Find(AttributeName))
+	{
+		(*Subscription)->Remove(Handle);
+		if (!(*Subscription)->IsBound())
+		{
+			AttributeChangedSubscriptions.Remove(AttributeName);
+		}
+	}
+}
+
+void UTcsAttributeComponent::UnsubscribeAllAttributeChanged(const void* UserObject)
+{
+	for (auto It = AttributeChangedSubscriptions.CreateIterator(); It; ++It)
+	{
+		It->Value->RemoveAll(UserObject);
+		if (!It->Value->IsBound())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
 void UTcsAttributeComponent::BroadcastAttributeBaseValueChangeEvent(
 	const TArray<FTcsAttributeChangeEventPayload>& Payloads) const
 {
+	if (!Payloads.IsEmpty() && IsBatchingNotifications())
+	{
+		QueueAttributeChangePayloads(Payloads, PendingBaseValueChangePayloads, PendingBaseValueChangeIndices);
+		return;
+	}
+
 	if (!Payloads.IsEmpty() && OnAttributeBaseValueChanged.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnAttributeBaseValueChanged.Broadcast(Payloads);
 	}
 }
@@ -123,8 +280,15 @@ void UTcsAttributeComponent::BroadcastAttributeBaseValueChangeEvent(
 void UTcsAttributeComponent::BroadcastAttributeModifierAddedEvent(
 	const FTcsAttributeModifierInstance& ModifierInstance) const
 {
+	if (IsBatchingNotifications())
+	{
+		QueueModifierNotification(EPendingModifierNotify::Added, ModifierInstance);
+		return;
+	}
+
 	if (OnAttributeModifierAdded.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnAttributeModifierAdded.Broadcast(ModifierInstance);
 	}
 }
@@ -132,8 +296,15 @@ void UTcsAttributeComponent::BroadcastAttributeModifierAddedEvent(
 void UTcsAttributeComponent::BroadcastAttributeModifierRemovedEvent(
 	const FTcsAttributeModifierInstance& ModifierInstance) const
 {
+	if (IsBatchingNotifications())
+	{
+		QueueModifierNotification(EPendingModifierNotify::Removed, ModifierInstance);
+		return;
+	}
+
 	if (OnAttributeModifierRemoved.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnAttributeModifierRemoved.Broadcast(ModifierInstance);
 	}
 }
@@ -141,8 +312,15 @@ void UTcsAttributeComponent::BroadcastAttributeModifierRemovedEvent(
 void UTcsAttributeComponent::BroadcastAttributeModifierUpdatedEvent(
 	const FTcsAttributeModifierInstance& ModifierInstance) const
 {
+	if (IsBatchingNotifications())
+	{
+		QueueModifierNotification(EPendingModifierNotify::Updated, ModifierInstance);
+		return;
+	}
+
 	if (OnAttributeModifierUpdated.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnAttributeModifierUpdated.Broadcast(ModifierInstance);
 	}
 }
@@ -154,8 +332,26 @@ void UTcsAttributeComponent::BroadcastAttributeReachedBoundaryEvent(
 	float NewValue,
 	float BoundaryValue) const
 {
+	if (IsBatchingNotifications())
+	{
+		// 同一属性同一边界只保留一次，旧值取最早、新值取最新
+		for (FPendingBoundaryNotification& Pending : PendingBoundaryNotifications)
+		{
+			if (Pending.AttributeName == AttributeName && Pending.bIsMaxBoundary == bIsMaxBoundary)
+			{
+				Pending.NewValue = NewValue;
+				Pending.BoundaryValue = BoundaryValue;
+				return;
+			}
+		}
+
+		PendingBoundaryNotifications.Add({ AttributeName, bIsMaxBoundary, OldValue, NewValue, BoundaryValue });
+		return;
+	}
+
 	if (OnAttributeReachedBoundary.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnAttributeReachedBoundary.Broadcast(AttributeName, bIsMaxBoundary, OldValue, NewValue, BoundaryValue);
 	}
 }
@@ -404,6 +600,8 @@ bool UTcsAttributeComponent::ResetAttribute(FName AttributeName)
 		return false;
 	}
 
+	FTcsAttributeNotificationBatchScope NotificationBatch(this);
+
 	FTcsAttributeInstance* Attribute = Attributes.Find(AttributeName);
 	if (!Attribute)
 	{
@@ -438,6 +636,7 @@ bool UTcsAttributeComponent::ResetAttribute(FName AttributeName)
 	}
 
 	// 重置 Base 和 Current 值
+	MarkAttributesReplicationDirty();
 	float OldBase = Attribute->BaseValue;
 	float OldCurrent = Attribute->CurrentValue;
 	Attribute->BaseValue = InitValue;
@@ -490,6 +689,8 @@ bool UTcsAttributeComponent::RemoveAttribute(FName AttributeName)
 		return false;
 	}
 
+	FTcsAttributeNotificationBatchScope NotificationBatch(this);
+
 	if (!Attributes.Contains(AttributeName))
 	{
 		UE_LOG(LogTcsAttribute, Warning,
@@ -554,6 +755,7 @@ bool UTcsAttributeComponent::RemoveAttribute(FName AttributeName)
 
 	// 从组件中移除属性
 	Attributes.Remove(AttributeName);
+	MarkAttributesReplicationDirty();
 
 	UE_LOG(LogTcsAttribute, Log,
 		TEXT("[%s] Removed attribute '%s' from '%s'"),
@@ -608,6 +810,7 @@ bool UTcsAttributeComponent::CreateAttributeModifier(
 	// 设置 DataAsset 引用和 ModifierId
 	OutModifierInst.ModifierDef = ModifierDef;
 	OutModifierInst.ModifierId = ModifierId;
+	OutModifierInst.ModifierDefIndex = ModifierDef->GetAttributeModifierDefIndex();
 
 	// 验证优先级
 	if (ModifierDef->Priority < 0)
@@ -684,6 +887,7 @@ bool UTcsAttributeComponent::CreateAttributeModifierWithOperands(
 	// 设置 DataAsset 引用和 ModifierId
 	OutModifierInst.ModifierDef = ModifierDef;
 	OutModifierInst.ModifierId = ModifierId;
+	OutModifierInst.ModifierDefIndex = ModifierDef->GetAttributeModifierDefIndex();
 
 	// 验证优先级
 	if (ModifierDef->Priority < 0)
@@ -709,6 +913,14 @@ void UTcsAttributeComponent::ApplyModifier(TArray<FTcsAttributeModifierInstance>
 		return;
 	}
 
+	if (bDeferModifierCommit && !bIsCommittingDeferredModifiers)
+	{
+		QueueDeferredModifiers(Modifiers);
+		return;
+	}
+
+	FTcsAttributeNotificationBatchScope NotificationBatch(this);
+
 	UTcsAttributeManagerSubsystem* Mgr = ResolveAttributeManager();
 	if (!Mgr)
 	{
@@ -779,10 +991,8 @@ void UTcsAttributeComponent::ApplyModifier(TArray<FTcsAttributeModifierInstance>
 
 				if (Incoming.SourceHandle.IsValid())
 				{
-					const int32 SourceId = Incoming.SourceHandle.Id;
-
 					// 使用稳定 ID 缓存查找现有修改器
-					if (const TArray<int32>* InstIdsPtr = SourceHandleIdToModifierInstIds.Find(SourceId))
+					if (const TArray<int32>* InstIdsPtr = SourceHandleIdToModifierInstIds.Find(Incoming.SourceHandle))
 					{
 						for (int32 ModifierInstId : *InstIdsPtr)
 						{
@@ -815,6 +1025,15 @@ void UTcsAttributeComponent::ApplyModifier(TArray<FTcsAttributeModifierInstance>
 
 							UpdatedExistingModifiers.Add(Stored);
 							bUpdated = true;
+
+							// 刷新保留原实例 Id：回写到调用者的数组，保证调用者随后的 RemoveModifier 命中
+							for (FTcsAttributeModifierInstance& CallerModifier : Modifiers)
+							{
+								if (CallerModifier.ModifierInstId == Incoming.ModifierInstId)
+								{
+									CallerModifier.ModifierInstId = Stored.ModifierInstId;
+								}
+							}
 							break;
 						}
 					}
@@ -831,6 +1050,7 @@ void UTcsAttributeComponent::ApplyModifier(TArray<FTcsAttributeModifierInstance>
 
 		// 剩余的 ModifiersToApply 即为新增的修改器
 		NewlyAddedModifiers = ModifiersToApply;
+		MarkModifiersReplicationDirty();
 
 		// 添加新修改器并更新索引
 		for (const FTcsAttributeModifierInstance& Modifier : ModifiersToApply)
@@ -842,11 +1062,7 @@ void UTcsAttributeComponent::ApplyModifier(TArray<FTcsAttributeModifierInstance>
 			// 更新两个缓存: ModifierInstId -> Index 和 SourceId -> ModifierInstIds
 			ModifierInstIdToIndex.Add(ModifierToStore.ModifierInstId, NewIndex);
 
-			if (ModifierToStore.SourceHandle.IsValid())
-			{
-				TArray<int32>& InstIds = SourceHandleIdToModifierInstIds.FindOrAdd(ModifierToStore.SourceHandle.Id);
-				InstIds.AddUnique(ModifierToStore.ModifierInstId);
-			}
+			TrackModifierSource(ModifierToStore.SourceHandle, ModifierToStore.ModifierInstId);
 		}
 
 		// 广播新增事件
@@ -878,11 +1094,14 @@ bool UTcsAttributeComponent::ApplyModifierWithSourceHandle(
 
 	OutModifiers.Empty();
 
+	UTcsAttributeManagerSubsystem* Mgr = ResolveAttributeManager();
+	AActor* Instigator = Mgr ? Mgr->GetSourceInstigator(SourceHandle) : nullptr;
+
 	// 为每个 ModifierId 创建修改器实例
 	for (const FName& ModifierId : ModifierIds)
 	{
 		FTcsAttributeModifierInstance ModifierInst;
-		if (CreateAttributeModifier(ModifierId, SourceHandle.Instigator.Get(), ModifierInst))
+		if (CreateAttributeModifier(ModifierId, Instigator, ModifierInst))
 		{
 			// 设置 SourceHandle
 			ModifierInst.SourceHandle = SourceHandle;
@@ -901,6 +1120,20 @@ bool UTcsAttributeComponent::ApplyModifierWithSourceHandle(
 
 void UTcsAttributeComponent::RemoveModifier(TArray<FTcsAttributeModifierInstance>& Modifiers)
 {
+	FTcsAttributeNotificationBatchScope NotificationBatch(this);
+
+	// 尚未提交的修改器直接丢弃
+	if (!PendingDeferredModifiers.IsEmpty())
+	{
+		DiscardDeferredModifiers([&Modifiers](const FTcsAttributeModifierInstance& Pending)
+		{
+			return Modifiers.ContainsByPredicate([&Pending](const FTcsAttributeModifierInstance& Modifier)
+			{
+				return Modifier.ModifierInstId == Pending.ModifierInstId;
+			});
+		});
+	}
+
 	UTcsAttributeManagerSubsystem* Mgr = ResolveAttributeManager();
 	if (!Mgr)
 	{
@@ -939,19 +1172,7 @@ void UTcsAttributeComponent::RemoveModifier(TArray<FTcsAttributeModifierInstance
 		// 从两个缓存中移除
 		ModifierInstIdToIndex.Remove(RemovedModifier.ModifierInstId);
 
-		if (RemovedModifier.SourceHandle.IsValid())
-		{
-			TArray<int32>* InstIdsPtr = SourceHandleIdToModifierInstIds.Find(RemovedModifier.SourceHandle.Id);
-			if (InstIdsPtr)
-			{
-				// TODO(Perf): 逐个 Remove 导致 O(K^2) 批量退化；见 SourceHandleIdToModifierInstIds 注释。
-				InstIdsPtr->Remove(RemovedModifier.ModifierInstId);
-				if (InstIdsPtr->Num() == 0)
-				{
-					SourceHandleIdToModifierInstIds.Remove(RemovedModifier.SourceHandle.Id);
-				}
-			}
-		}
+		UntrackModifierSource(RemovedModifier.SourceHandle, RemovedModifier.ModifierInstId);
 
 		// 使用 RemoveAtSwap 删除元素（O(1) 操作）
 		const int32 LastIndex = AttributeModifiers.Num() - 1;
@@ -971,6 +1192,7 @@ void UTcsAttributeComponent::RemoveModifier(TArray<FTcsAttributeModifierInstance
 	// 如果确实有属性修改器被移除，则更新属性的当前值
 	if (bModified)
 	{
+		MarkModifiersReplicationDirty();
 		RecalculateAttributeCurrentValues(BatchId);
 	}
 }
@@ -983,11 +1205,24 @@ bool UTcsAttributeComponent::RemoveModifiersBySourceHandle(const FTcsSourceHandl
 		return false;
 	}
 
+	FTcsAttributeNotificationBatchScope NotificationBatch(this);
+
+	// 尚未提交的同来源修改器直接丢弃
+	const int32 NumDeferredBefore = PendingDeferredModifiers.Num();
+	if (NumDeferredBefore > 0)
+	{
+		DiscardDeferredModifiers([&SourceHandle](const FTcsAttributeModifierInstance& Pending)
+		{
+			return Pending.SourceHandle == SourceHandle;
+		});
+	}
+	const bool bDiscardedDeferred = PendingDeferredModifiers.Num() != NumDeferredBefore;
+
 	// 使用稳定 ID 缓存查找匹配的修改器
-	const TArray<int32>* InstIdsPtr = SourceHandleIdToModifierInstIds.Find(SourceHandle.Id);
+	const TArray<int32>* InstIdsPtr = SourceHandleIdToModifierInstIds.Find(SourceHandle);
 	if (!InstIdsPtr || InstIdsPtr->Num() == 0)
 	{
-		return false;
+		return bDiscardedDeferred;
 	}
 
 	// 先拷贝 ID 列表（避免在迭代中修改）
@@ -1021,7 +1256,7 @@ bool UTcsAttributeComponent::RemoveModifiersBySourceHandle(const FTcsSourceHandl
 		return true;
 	}
 
-	return false;
+	return bDiscardedDeferred;
 }
 
 bool UTcsAttributeComponent::GetModifiersBySourceHandle(
@@ -1034,7 +1269,7 @@ bool UTcsAttributeComponent::GetModifiersBySourceHandle(
 		return false;
 	}
 
-	const TArray<int32>* InstIdsPtr = SourceHandleIdToModifierInstIds.Find(SourceHandle.Id);
+	const TArray<int32>* InstIdsPtr = SourceHandleIdToModifierInstIds.Find(SourceHandle);
 	if (!InstIdsPtr || InstIdsPtr->Num() == 0)
 	{
 		return false;
@@ -1063,6 +1298,8 @@ bool UTcsAttributeComponent::GetModifiersBySourceHandle(
 
 void UTcsAttributeComponent::HandleModifierUpdated(TArray<FTcsAttributeModifierInstance>& Modifiers)
 {
+	FTcsAttributeNotificationBatchScope NotificationBatch(this);
+
 	UTcsAttributeManagerSubsystem* Mgr = ResolveAttributeManager();
 	if (!Mgr)
 	{
@@ -1101,42 +1338,235 @@ void UTcsAttributeComponent::HandleModifierUpdated(TArray<FTcsAttributeModifierI
 		AttributeModifiers[ModifierIndex] = Modifier;
 
 		// 更新 SourceHandle 缓存（如果 SourceHandle 发生变化）
-		const int32 OldSourceId = OldStored.SourceHandle.IsValid() ? OldStored.SourceHandle.Id : -1;
-		const int32 NewSourceId = Modifier.SourceHandle.IsValid() ? Modifier.SourceHandle.Id : -1;
-		if (OldSourceId != NewSourceId)
+		if (OldStored.SourceHandle != Modifier.SourceHandle)
+		{
+			UntrackModifierSource(OldStored.SourceHandle, Modifier.ModifierInstId);
+		}
+		TrackModifierSource(Modifier.SourceHandle, Modifier.ModifierInstId);
+
+		BroadcastAttributeModifierUpdatedEvent(Modifier);
+
+		bModified = true;
+	}
+
+	if (bModified)
+	{
+		MarkModifiersReplicationDirty();
+		RecalculateAttributeCurrentValues(BatchId);
+	}
+}
+
+void UTcsAttributeComponent::TrackModifierSource(const FTcsSourceHandle& SourceHandle, int32 ModifierInstId)
+{
+	if (!SourceHandle.IsValid())
+	{
+		return;
+	}
+
+	TArray<int32>* InstIdsPtr = SourceHandleIdToModifierInstIds.Find(SourceHandle);
+	if (!InstIdsPtr)
+	{
+		// 每个本地来源桶持有一个来源引用，保证修改器存续期间来源元数据可解析（远端来源只是镜像，不计数）
+		UTcsAttributeManagerSubsystem* Mgr = SourceHandle.IsLocal() ? ResolveAttributeManager() : nullptr;
+		if (Mgr)
+		{
+			Mgr->RetainSourceHandle(SourceHandle);
+		}
+		InstIdsPtr = &SourceHandleIdToModifierInstIds.Add(SourceHandle);
+	}
+	InstIdsPtr->AddUnique(ModifierInstId);
+}
+
+void UTcsAttributeComponent::UntrackModifierSource(const FTcsSourceHandle& SourceHandle, int32 ModifierInstId)
+{
+	if (!SourceHandle.IsValid())
+	{
+		return;
+	}
+
+	TArray<int32>* InstIdsPtr = SourceHandleIdToModifierInstIds.Find(SourceHandle);
+	if (!InstIdsPtr)
+	{
+		return;
+	}
+
+	// TODO(Perf): 逐个 Remove 导致 O(K^2) 批量退化；见 SourceHandleIdToModifierInstIds 注释。
+	InstIdsPtr->Remove(ModifierInstId);
+	if (InstIdsPtr->Num() == 0)
+	{
+		SourceHandleIdToModifierInstIds.Remove(SourceHandle);
+		if (UTcsAttributeManagerSubsystem* Mgr = ResolveAttributeManager())
+		{
+			Mgr->ReleaseSourceHandle(SourceHandle);
+		}
+	}
+}
+
+
+// ============================================================
+// #pragma region DeferredModifierCommit
+// ============================================================
+
+void UTcsAttributeComponent::CommitDeferredModifiers()
+{
+	SetComponentTickEnabled(false);
+
+	if (PendingDeferredModifiers.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<FPendingDeferredModifier> Pendings = MoveTemp(PendingDeferredModifiers);
+	PendingDeferredModifiers.Reset();
+	NumDeferredApplyCalls = 0;
+
+	TGuardValue<bool> CommitGuard(bIsCommittingDeferredModifiers, true);
+
+	{
+		// 逐批提交的 BaseValue 修改器与最终的 CurrentValue 批次只触发一次当前值重算（事件广播时来源仍被暂存引用持有）
+		FTcsAttributeRecalculationScope RecalculationScope(ResolveAttributeManager());
+
+		// BaseValue 修改器不跨调用合并：按原 ApplyModifier 调用逐批提交，合并策略（UseNewest/UseMax 等）只作用于同一次调用内
+		// CurrentValue 修改器持续存在，跨调用合并为一个批次与逐次应用的结果一致
+		TArray<FTcsAttributeModifierInstance> BaseValueBatch;
+		TArray<FTcsAttributeModifierInstance> CurrentValueBatch;
+		CurrentValueBatch.Reserve(Pendings.Num());
+
+		int32 BaseValueBatchCallIndex = INDEX_NONE;
+		for (FPendingDeferredModifier& Pending : Pendings)
 		{
-			if (OldSourceId >= 0)
+			const bool bIsBaseValue = Pending.Modifier.ModifierDef
+				&& Pending.Modifier.ModifierDef->ModifierMode == ETcsAttributeModifierMode::AMM_BaseValue;
+			if (!bIsBaseValue)
 			{
-				if (TArray<int32>* InstIdsPtr = SourceHandleIdToModifierInstIds.Find(OldSourceId))
+				CurrentValueBatch.Add(Pending.Modifier);
+				continue;
+			}
+
+			if (Pending.ApplyCallIndex != BaseValueBatchCallIndex && !BaseValueBatch.IsEmpty())
+			{
+				ApplyModifier(BaseValueBatch);
+				BaseValueBatch.Reset();
+			}
+			BaseValueBatchCallIndex = Pending.ApplyCallIndex;
+			BaseValueBatch.Add(Pending.Modifier);
+		}
+
+		if (!BaseValueBatch.IsEmpty())
+		{
+			ApplyModifier(BaseValueBatch);
+		}
+
+		if (!CurrentValueBatch.IsEmpty())
+		{
+			ApplyModifier(CurrentValueBatch);
+		}
+	}
+
+	// 已挂上的修改器由来源桶持有引用，重算与事件广播结束后归还暂存期间的引用
+	for (const FPendingDeferredModifier& Pending : Pendings)
+	{
+		ReleaseDeferredModifierSource(Pending.Modifier);
+	}
+}
+
+void UTcsAttributeComponent::QueueDeferredModifiers(TArray<FTcsAttributeModifierInstance>& Modifiers)
+{
+	const int32 ApplyCallIndex = NumDeferredApplyCalls++;
+	UTcsAttributeManagerSubsystem* Mgr = ResolveAttributeManager();
+
+	for (FTcsAttributeModifierInstance& Incoming : Modifiers)
+	{
+		const bool bIsRefreshable = Incoming.SourceHandle.IsValid()
+			&& Incoming.ModifierDef
+			&& Incoming.ModifierDef->ModifierMode == ETcsAttributeModifierMode::AMM_CurrentValue;
+
+		// 同来源同 Id 的 CurrentValue 修改器：保留首个实例 Id，刷新为最新数据，并把保留的 Id 回写给调用者
+		FTcsAttributeModifierInstance* Existing = nullptr;
+		if (bIsRefreshable)
+		{
+			FPendingDeferredModifier* ExistingPending = PendingDeferredModifiers.FindByPredicate([&Incoming](const FPendingDeferredModifier& Pending)
+			{
+				return Pending.Modifier.SourceHandle == Incoming.SourceHandle && Pending.Modifier.ModifierId == Incoming.ModifierId;
+			});
+			Existing = ExistingPending ? &ExistingPending->Modifier : nullptr;
+		}
+
+		if (Existing)
+		{
+			Existing->Operands = Incoming.Operands;
+			Existing->Instigator = Incoming.Instigator;
+			Existing->Target = Incoming.Target;
+			Incoming.ModifierInstId = Existing->ModifierInstId;
+			continue;
+		}
+
+		// 将刷新已生效的修改器：提交时会保留已生效实例的 Id，暂存时即采用该 Id
+		if (bIsRefreshable)
+		{
+			if (const TArray<int32>* InstIdsPtr = SourceHandleIdToModifierInstIds.Find(Incoming.SourceHandle))
+			{
+				for (int32 ModifierInstId : *InstIdsPtr)
 				{
-					InstIdsPtr->Remove(Modifier.ModifierInstId);
-					if (InstIdsPtr->IsEmpty())
+					const int32* IndexPtr = ModifierInstIdToIndex.Find(ModifierInstId);
+					if (IndexPtr
+						&& AttributeModifiers.IsValidIndex(*IndexPtr)
+						&& AttributeModifiers[*IndexPtr].ModifierInstId == ModifierInstId
+						&& AttributeModifiers[*IndexPtr].ModifierId == Incoming.ModifierId)
 					{
-						SourceHandleIdToModifierInstIds.Remove(OldSourceId);
+						Incoming.ModifierInstId = ModifierInstId;
+						break;
 					}
 				}
 			}
+		}
 
-			if (NewSourceId >= 0)
-			{
-				TArray<int32>& InstIds = SourceHandleIdToModifierInstIds.FindOrAdd(NewSourceId);
-				InstIds.AddUnique(Modifier.ModifierInstId);
-			}
+		// 暂存期间来源可能被创建者释放，持有一个引用保证提交时仍可解析
+		if (Mgr && Incoming.SourceHandle.IsLocal())
+		{
+			Mgr->RetainSourceHandle(Incoming.SourceHandle);
 		}
-		else if (NewSourceId >= 0)
+
+		FPendingDeferredModifier& Pending = PendingDeferredModifiers.AddDefaulted_GetRef();
+		Pending.Modifier = Incoming;
+		Pending.ApplyCallIndex = ApplyCallIndex;
+	}
+
+	if (!PendingDeferredModifiers.IsEmpty() && !IsComponentTickEnabled())
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UTcsAttributeComponent::DiscardDeferredModifiers(TFunctionRef<bool(const FTcsAttributeModifierInstance&)> Predicate)
+{
+	PendingDeferredModifiers.RemoveAll([this, &Predicate](const FPendingDeferredModifier& Pending)
+	{
+		if (!Predicate(Pending.Modifier))
 		{
-			TArray<int32>& InstIds = SourceHandleIdToModifierInstIds.FindOrAdd(NewSourceId);
-			InstIds.AddUnique(Modifier.ModifierInstId);
+			return false;
 		}
 
-		BroadcastAttributeModifierUpdatedEvent(Modifier);
+		ReleaseDeferredModifierSource(Pending.Modifier);
+		return true;
+	});
 
-		bModified = true;
+	if (PendingDeferredModifiers.IsEmpty())
+	{
+		SetComponentTickEnabled(false);
 	}
+}
 
-	if (bModified)
+void UTcsAttributeComponent::ReleaseDeferredModifierSource(const FTcsAttributeModifierInstance& Modifier)
+{
+	if (!Modifier.SourceHandle.IsLocal())
 	{
-		RecalculateAttributeCurrentValues(BatchId);
+		return;
+	}
+
+	if (UTcsAttributeManagerSubsystem* Mgr = ResolveAttributeManager())
+	{
+		Mgr->ReleaseSourceHandle(Modifier.SourceHandle);
 	}
 }
 
@@ -1147,6 +1577,10 @@ void UTcsAttributeComponent::HandleModifierUpdated(TArray<FTcsAttributeModifierI
 
 void UTcsAttributeComponent::RecalculateAttributeBaseValues(const TArray<FTcsAttributeModifierInstance>& Modifiers)
 {
+	TCS_SCOPE_CYCLE_COUNTER(STAT_TcsAttributeRecalculateBase);
+
+	MarkAttributesReplicationDirty();
+
 	// 按类型整理所有属性修改器，方便后续执行修改器合并
 	TArray<FTcsAttributeModifierInstance> MergedModifiers;
 	MergeAttributeModifiers(Modifiers, MergedModifiers);
@@ -1183,7 +1617,12 @@ void UTcsAttributeComponent::RecalculateAttributeBaseValues(const TArray<FTcsAtt
 
 		// 执行修改器
 		auto Execution = ModDef->ModifierType->GetDefaultObject<UTcsAttributeModifierExecution>();
-		Execution->Execute(Modifier, BaseValues, BaseValues);
+		{
+			TCS_SCOPE_CYCLE_COUNTER(STAT_TcsAttributeModifierExecute);
+			TCS_INC_DWORD_STAT(STAT_TcsModifiersExecuted);
+			TCS_DEFINITION_COST_SCOPE(ModifierExecution, Modifier.ModifierId);
+			Execution->Execute(Modifier, BaseValues, BaseValues);
+		}
 
 		// 记录属性修改过程
 		for (const TPair<FName, float>& LastPair : LastModifiedResults)
@@ -1250,22 +1689,36 @@ void UTcsAttributeComponent::RecalculateAttributeBaseValues(const TArray<FTcsAtt
 
 void UTcsAttributeComponent::RecalculateAttributeCurrentValues(int64 ChangeBatchId)
 {
-	// 按类型整理所有属性修改器，方便后续执行修改器合并
+	// 管理器正在收集重算请求时只登记，作用域结束时由管理器统一（并行）重算
+	if (AttrMgr && AttrMgr->IsBatchingAttributeRecalculation())
+	{
+		AttrMgr->RequestAttributeRecalculation(this, ChangeBatchId);
+		return;
+	}
+
+	TCS_SCOPE_CYCLE_COUNTER(STAT_TcsAttributeRecalculateCurrent);
+
+	FCurrentValueRecalculationJob Job;
+	Job.ChangeBatchIds.Add(ChangeBatchId);
+	PrepareCurrentValueRecalculation(Job);
+	ExecuteCurrentValueRecalculation(Job);
+	CommitCurrentValueRecalculation(Job);
+}
+
+void UTcsAttributeComponent::PrepareCurrentValueRecalculation(FCurrentValueRecalculationJob& Job)
+{
+	MarkAttributesReplicationDirty();
+
+	// 按类型整理所有属性修改器，方便后续执行修改器合并
 	TArray<FTcsAttributeModifierInstance> MergedModifiers;
 	MergeAttributeModifiers(AttributeModifiers, MergedModifiers);
 	// 按照优先级对属性修改器进行排序
 	MergedModifiers.Sort();
 
-	// 属性修改事件记录
-	TMap<FName, FTcsAttributeChangeEventPayload> ChangeEventPayloads;
-
-	// 获取属性基础值，用于计算
-	TMap<FName, float> BaseValues = GetAttributeBaseValues();
-	// 用于更新计算的临时属性值容器，基于属性的基础值
-	TMap<FName, float> CurrentValuesToCalc = BaseValues;
-
-	// 执行属性修改器的修改计算
-	for (const FTcsAttributeModifierInstance& Modifier : MergedModifiers)
+	// 解析执行器，无效的修改器在此剔除
+	Job.Modifiers.Reset(MergedModifiers.Num());
+	Job.Executions.Reset(MergedModifiers.Num());
+	for (FTcsAttributeModifierInstance& Modifier : MergedModifiers)
 	{
 		if (!Modifier.ModifierDef)
 		{
@@ -1285,29 +1738,82 @@ void UTcsAttributeComponent::RecalculateAttributeCurrentValues(int64 ChangeBatch
 			continue;
 		}
 
+		UTcsAttributeModifierExecution* Execution = ModDef->ModifierType->GetDefaultObject<UTcsAttributeModifierExecution>();
+		// 只有显式声明线程安全的原生执行器才离开游戏线程；蓝图子类需要经过蓝图虚拟机
+		if (!Execution->IsThreadSafe() || !Execution->GetClass()->HasAnyClassFlags(CLASS_Native))
+		{
+			Job.bRequiresGameThread = true;
+		}
+
+		Job.Modifiers.Add(MoveTemp(Modifier));
+		Job.Executions.Add(Execution);
+	}
+
+	// 获取属性基础值，用于计算
+	Job.BaseValues = GetAttributeBaseValues();
+	// 用于更新计算的临时属性值容器，基于属性的基础值
+	Job.CurrentValues = Job.BaseValues;
+}
+
+void UTcsAttributeComponent::ExecuteCurrentValueRecalculation(FCurrentValueRecalculationJob& Job)
+{
+	TCS_SCOPE_CYCLE_COUNTER(STAT_TcsAttributeModifierExecute);
+	TCS_INC_DWORD_STAT_BY(STAT_TcsModifiersExecuted, Job.Modifiers.Num());
+
+	const bool bRecordAllBatches = Job.ChangeBatchIds.ContainsByPredicate([](int64 BatchId) { return BatchId < 0; });
+
+	// 执行属性修改器的修改计算
+	for (int32 Index = 0; Index < Job.Modifiers.Num(); ++Index)
+	{
+		const FTcsAttributeModifierInstance& Modifier = Job.Modifiers[Index];
+		UTcsAttributeModifierExecution* Execution = Job.Executions[Index];
+
+		// 只记录本次修改批次触及的修改器，需要属性修改器的更新时间为最新
+		const bool bRecordModifier = bRecordAllBatches || Job.ChangeBatchIds.Contains(Modifier.LastTouchedBatchId);
+
 		// 缓存属性当前值的上一次修改最终值
-		TMap<FName, float> LastModifiedResults = CurrentValuesToCalc;
+		TMap<FName, float> LastModifiedResults;
+		if (bRecordModifier)
+		{
+			LastModifiedResults = Job.CurrentValues;
+		}
 
-		// 执行修改器
-		auto Execution = ModDef->ModifierType->GetDefaultObject<UTcsAttributeModifierExecution>();
-		Execution->Execute(Modifier, BaseValues, CurrentValuesToCalc);
+		// 执行修改器（原生执行器直接调用实现，避免经过 UFunction 派发）
+		{
+			TCS_DEFINITION_COST_SCOPE(ModifierExecution, Modifier.ModifierId);
+			if (Job.bRequiresGameThread)
+			{
+				Execution->Execute(Modifier, Job.BaseValues, Job.CurrentValues);
+			}
+			else
+			{
+				Execution->Execute_Implementation(Modifier, Job.BaseValues, Job.CurrentValues);
+			}
+		}
 
-		// 记录属性修改过程，需要属性修改器的更新时间为最新
+		// 记录属性修改过程
 		for (const TPair<FName, float>& LastPair : LastModifiedResults)
 		{
-			const float& NewValue = CurrentValuesToCalc.FindRef(LastPair.Key);
-			if (!FMath::IsNearlyEqual(NewValue, LastPair.Value) && (ChangeBatchId < 0 || Modifier.LastTouchedBatchId == ChangeBatchId))
+			const float& NewValue = Job.CurrentValues.FindRef(LastPair.Key);
+			if (!FMath::IsNearlyEqual(NewValue, LastPair.Value))
 			{
-				FTcsAttributeChangeEventPayload& Payload = ChangeEventPayloads.FindOrAdd(LastPair.Key);
+				FTcsAttributeChangeEventPayload& Payload = Job.ChangeEventPayloads.FindOrAdd(LastPair.Key);
 				Payload.AttributeName = LastPair.Key;
 				float& PayloadValue = Payload.ChangeSourceRecord.FindOrAdd(Modifier.SourceHandle);
 				PayloadValue += NewValue - LastPair.Value;
 			}
 		}
 	}
+}
+
+void UTcsAttributeComponent::CommitCurrentValueRecalculation(FCurrentValueRecalculationJob& Job)
+{
+	TCS_SCOPE_CYCLE_COUNTER(STAT_TcsAttributeRecalculateCommit);
+
+	TMap<FName, FTcsAttributeChangeEventPayload>& ChangeEventPayloads = Job.ChangeEventPayloads;
 
 	// 对修改后的属性当前值进行范围修正，然后更新属性当前值
-	for (TPair<FName, float>& Pair : CurrentValuesToCalc)
+	for (TPair<FName, float>& Pair : Job.CurrentValues)
 	{
 		if (FTcsAttributeInstance* Attribute = Attributes.Find(Pair.Key))
 		{
@@ -1358,15 +1864,20 @@ void UTcsAttributeComponent::MergeAttributeModifiers(
 	const TArray<FTcsAttributeModifierInstance>& Modifiers,
 	TArray<FTcsAttributeModifierInstance>& MergedModifiers)
 {
-	// 按 ModifierId 整理所有属性修改器，方便后续执行修改器合并
-	TMap<FName, TArray<FTcsAttributeModifierInstance>> ModifiersToMerge;
+	TCS_SCOPE_CYCLE_COUNTER(STAT_TcsAttributeModifierMerge);
+
+	// 按修改器定义稠密 ID 整理所有属性修改器，方便后续执行修改器合并
+	TMap<int32, TArray<FTcsAttributeModifierInstance>> ModifiersToMerge;
 	for (const FTcsAttributeModifierInstance& Modifier : Modifiers)
 	{
-		ModifiersToMerge.FindOrAdd(Modifier.ModifierId).Add(Modifier);
+		const int32 ModifierDefIndex = Modifier.ModifierDefIndex != INDEX_NONE
+			? Modifier.ModifierDefIndex
+			: FTcsDefinitionIdTable::FindOrAdd(ETcsDefinitionKind::AttributeModifier, Modifier.ModifierId);
+		ModifiersToMerge.FindOrAdd(ModifierDefIndex).Add(Modifier);
 	}
 
 	// 执行修改器合并
-	for (TPair<FName, TArray<FTcsAttributeModifierInstance>>& Pair : ModifiersToMerge)
+	for (TPair<int32, TArray<FTcsAttributeModifierInstance>>& Pair : ModifiersToMerge)
 	{
 		if (Pair.Value.IsEmpty())
 		{
@@ -1401,6 +1912,8 @@ void UTcsAttributeComponent::ClampAttributeValueInRange(
 	float* OutMaxValue,
 	const TMap<FName, float>* WorkingValues)
 {
+	TCS_SCOPE_CYCLE_COUNTER(STAT_TcsAttributeClamp);
+
 	const FTcsAttributeInstance* Attribute = Attributes.Find(AttributeName);
 	if (!Attribute)
 	{
@@ -1520,6 +2033,8 @@ void UTcsAttributeComponent::ClampAttributeValueInRange(
 
 void UTcsAttributeComponent::EnforceAttributeRangeConstraints()
 {
+	MarkAttributesReplicationDirty();
+
 	const int32 MaxIterations = 8; // 防止无限循环
 	int32 Iteration = 0;
 	bool bAnyChanged = true;
@@ -1650,3 +2165,509 @@ void UTcsAttributeComponent::EnforceAttributeRangeConstraints()
 		BroadcastAttributeValueChangeEvent(CurrentChangePayloads);
 	}
 }
+
+
+// ============================================================
+// #pragma region Replication
+// ============================================================
+
+void UTcsAttributeComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UTcsAttributeComponent, ReplicatedAttributes);
+	DOREPLIFETIME(UTcsAttributeComponent, ReplicatedModifiers);
+}
+
+void UTcsAttributeComponent::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	// 只有自上次复制以来发生过变更时才比对，静止实体没有额外开销
+	if (bAttributesReplicationDirty)
+	{
+		SyncReplicatedAttributes();
+	}
+
+	if (bModifiersReplicationDirty)
+	{
+		SyncReplicatedModifiers();
+	}
+}
+
+void UTcsAttributeComponent::SendFullCausalityChainRequest()
+{
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		ClientRequestFullCausalityChains();
+	}
+	else
+	{
+		ServerRequestFullCausalityChains();
+	}
+}
+
+void UTcsAttributeComponent::ServerReportNetworkDefinitionListHashes_Implementation(const TArray<uint32>& ListHashes)
+{
+	HandlePeerNetworkDefinitionListHashes(ListHashes);
+	ClientReportNetworkDefinitionListHashes(FTcsDefinitionIdTable::GetNetworkDefinitionListHashes());
+}
+
+void UTcsAttributeComponent::ClientReportNetworkDefinitionListHashes_Implementation(const TArray<uint32>& ListHashes)
+{
+	HandlePeerNetworkDefinitionListHashes(ListHashes);
+}
+
+void UTcsAttributeComponent::ServerRequestFullCausalityChains_Implementation()
+{
+	HandleFullCausalityChainRequest();
+}
+
+void UTcsAttributeComponent::ClientRequestFullCausalityChains_Implementation()
+{
+	HandleFullCausalityChainRequest();
+}
+
+void UTcsAttributeComponent::HandlePeerNetworkDefinitionListHashes(const TArray<uint32>& ListHashes)
+{
+	UTcsAttributeManagerSubsystem* Mgr = ResolveAttributeManager();
+	AActor* Owner = GetOwner();
+	if (Mgr && Owner)
+	{
+		Mgr->SetPeerNetworkDefinitionListHashes(Owner->GetNetConnection(), ListHashes);
+	}
+}
+
+void UTcsAttributeComponent::HandleFullCausalityChainRequest()
+{
+	UTcsAttributeManagerSubsystem* Mgr = ResolveAttributeManager();
+	AActor* Owner = GetOwner();
+	if (Mgr && Owner)
+	{
+		Mgr->RequestFullCausalityChains(Owner->GetNetConnection());
+	}
+}
+
+void UTcsAttributeComponent::SyncReplicatedAttributes()
+{
+	bAttributesReplicationDirty = false;
+
+	TArray<FTcsReplicatedAttribute>& Items = ReplicatedAttributes.Items;
+	TSet<FName> SyncedAttributeNames;
+	SyncedAttributeNames.Reserve(Items.Num());
+
+	bool bAnyRemoved = false;
+	for (int32 Index = Items.Num() - 1; Index >= 0; --Index)
+	{
+		FTcsReplicatedAttribute& Item = Items[Index];
+		const FTcsAttributeInstance* Attribute = Attributes.Find(Item.AttributeName);
+		if (!Attribute)
+		{
+			Items.RemoveAtSwap(Index);
+			bAnyRemoved = true;
+			continue;
+		}
+
+		SyncedAttributeNames.Add(Item.AttributeName);
+		if (Item.SyncFrom(*Attribute))
+		{
+			ReplicatedAttributes.MarkItemDirty(Item);
+		}
+	}
+
+	for (const TPair<FName, FTcsAttributeInstance>& Pair : Attributes)
+	{
+		if (SyncedAttributeNames.Contains(Pair.Key))
+		{
+			continue;
+		}
+
+		FTcsReplicatedAttribute& NewItem = Items.AddDefaulted_GetRef();
+		NewItem.AttributeName = Pair.Key;
+		NewItem.SyncFrom(Pair.Value);
+		ReplicatedAttributes.MarkItemDirty(NewItem);
+	}
+
+	if (bAnyRemoved)
+	{
+		ReplicatedAttributes.MarkArrayDirty();
+	}
+}
+
+void UTcsAttributeComponent::SyncReplicatedModifiers()
+{
+	bModifiersReplicationDirty = false;
+
+	TArray<FTcsReplicatedAttributeModifier>& Items = ReplicatedModifiers.Items;
+	TSet<int32> SyncedModifierInstIds;
+	SyncedModifierInstIds.Reserve(Items.Num());
+
+	bool bAnyRemoved = false;
+	for (int32 Index = Items.Num() - 1; Index >= 0; --Index)
+	{
+		FTcsReplicatedAttributeModifier& Item = Items[Index];
+		const int32* ModifierIndexPtr = ModifierInstIdToIndex.Find(Item.Modifier.ModifierInstId);
+		if (!ModifierIndexPtr
+			|| !AttributeModifiers.IsValidIndex(*ModifierIndexPtr)
+			|| AttributeModifiers[*ModifierIndexPtr].ModifierInstId != Item.Modifier.ModifierInstId)
+		{
+			Items.RemoveAtSwap(Index);
+			bAnyRemoved = true;
+			continue;
+		}
+
+		SyncedModifierInstIds.Add(Item.Modifier.ModifierInstId);
+		if (Item.SyncFrom(AttributeModifiers[*ModifierIndexPtr]))
+		{
+			ReplicatedModifiers.MarkItemDirty(Item);
+		}
+	}
+
+	for (const FTcsAttributeModifierInstance& Modifier : AttributeModifiers)
+	{
+		if (SyncedModifierInstIds.Contains(Modifier.ModifierInstId))
+		{
+			continue;
+		}
+
+		FTcsReplicatedAttributeModifier& NewItem = Items.AddDefaulted_GetRef();
+		NewItem.SyncFrom(Modifier);
+		ReplicatedModifiers.MarkItemDirty(NewItem);
+	}
+
+	if (bAnyRemoved)
+	{
+		ReplicatedModifiers.MarkArrayDirty();
+	}
+}
+
+void UTcsAttributeComponent::HandleReplicatedAttributeUpdated(const FTcsReplicatedAttribute& Item)
+{
+	FTcsAttributeInstance* Attribute = Attributes.Find(Item.AttributeName);
+	if (!Attribute)
+	{
+		UTcsAttributeManagerSubsystem* Mgr = ResolveAttributeManager();
+		const UTcsAttributeDefinition* AttrDef = Mgr ? Mgr->GetAttributeDefinition(Item.AttributeName) : nullptr;
+		const int32 AttrInstId = Mgr ? Mgr->AllocateAttributeInstanceId() : -1;
+
+		FTcsAttributeInstance AttrInst = FTcsAttributeInstance(AttrDef, Item.AttributeName, AttrInstId, GetOwner(), Item.BaseValue);
+		AttrInst.CurrentValue = Item.CurrentValue;
+		Attributes.Add(Item.AttributeName, AttrInst);
+		bAttributeSnapshotDirty = true;
+		return;
+	}
+
+	bAttributeSnapshotDirty = true;
+
+	const float OldBase = Attribute->BaseValue;
+	const float OldCurrent = Attribute->CurrentValue;
+	Attribute->BaseValue = Item.BaseValue;
+	Attribute->CurrentValue = Item.CurrentValue;
+
+	if (!FMath::IsNearlyEqual(OldBase, Item.BaseValue))
+	{
+		TArray<FTcsAttributeChangeEventPayload> Payloads;
+		Payloads.Add(FTcsAttributeChangeEventPayload(Item.AttributeName, Item.BaseValue, OldBase, TMap<FTcsSourceHandle, float>()));
+		BroadcastAttributeBaseValueChangeEvent(Payloads);
+	}
+
+	if (!FMath::IsNearlyEqual(OldCurrent, Item.CurrentValue))
+	{
+		TArray<FTcsAttributeChangeEventPayload> Payloads;
+		Payloads.Add(FTcsAttributeChangeEventPayload(Item.AttributeName, Item.CurrentValue, OldCurrent, TMap<FTcsSourceHandle, float>()));
+		BroadcastAttributeValueChangeEvent(Payloads);
+	}
+}
+
+void UTcsAttributeComponent::HandleReplicatedAttributeRemoved(const FTcsReplicatedAttribute& Item)
+{
+	Attributes.Remove(Item.AttributeName);
+	bAttributeSnapshotDirty = true;
+}
+
+void UTcsAttributeComponent::HandleReplicatedModifierUpdated(const FTcsReplicatedAttributeModifier& Item)
+{
+	FTcsAttributeModifierInstance Modifier = Item.Modifier;
+
+	// 定义引用与目标不参与序列化，在本地重新解析
+	UTcsAttributeManagerSubsystem* Mgr = ResolveAttributeManager();
+	Modifier.ModifierDef = Mgr ? Mgr->GetModifierDefinition(Modifier.ModifierId) : nullptr;
+	Modifier.ModifierDefIndex = Modifier.ModifierDef ? Modifier.ModifierDef->GetAttributeModifierDefIndex() : INDEX_NONE;
+	Modifier.Target = GetOwner();
+
+	const int32* IndexPtr = ModifierInstIdToIndex.Find(Modifier.ModifierInstId);
+	if (IndexPtr && AttributeModifiers.IsValidIndex(*IndexPtr))
+	{
+		FTcsAttributeModifierInstance& Stored = AttributeModifiers[*IndexPtr];
+		if (Stored.SourceHandle != Modifier.SourceHandle)
+		{
+			UntrackModifierSource(Stored.SourceHandle, Modifier.ModifierInstId);
+			TrackModifierSource(Modifier.SourceHandle, Modifier.ModifierInstId);
+		}
+
+		Stored = Modifier;
+		BroadcastAttributeModifierUpdatedEvent(Stored);
+		return;
+	}
+
+	const int32 NewIndex = AttributeModifiers.Add(Modifier);
+	ModifierInstIdToIndex.Add(Modifier.ModifierInstId, NewIndex);
+	TrackModifierSource(Modifier.SourceHandle, Modifier.ModifierInstId);
+
+	BroadcastAttributeModifierAddedEvent(Modifier);
+}
+
+void UTcsAttributeComponent::HandleReplicatedModifierRemoved(const FTcsReplicatedAttributeModifier& Item)
+{
+	const int32* IndexPtr = ModifierInstIdToIndex.Find(Item.Modifier.ModifierInstId);
+	if (!IndexPtr || !AttributeModifiers.IsValidIndex(*IndexPtr))
+	{
+		return;
+	}
+
+	const int32 RemovedIndex = *IndexPtr;
+	const FTcsAttributeModifierInstance RemovedModifier = AttributeModifiers[RemovedIndex];
+
+	ModifierInstIdToIndex.Remove(RemovedModifier.ModifierInstId);
+	UntrackModifierSource(RemovedModifier.SourceHandle, RemovedModifier.ModifierInstId);
+
+	const int32 LastIndex = AttributeModifiers.Num() - 1;
+	if (RemovedIndex != LastIndex)
+	{
+		ModifierInstIdToIndex[AttributeModifiers[LastIndex].ModifierInstId] = RemovedIndex;
+	}
+	AttributeModifiers.RemoveAtSwap(RemovedIndex);
+
+	BroadcastAttributeModifierRemovedEvent(RemovedModifier);
+}
+
+
+// ============================================================
+// #pragma region NotificationBatch
+// ============================================================
+
+void UTcsAttributeComponent::BeginNotificationBatch()
+{
+	++NotificationBatchDepth;
+}
+
+void UTcsAttributeComponent::EndNotificationBatch()
+{
+	if (!ensureMsgf(NotificationBatchDepth > 0, TEXT("[%s] Unbalanced notification batch"), *FString(__FUNCTION__)))
+	{
+		return;
+	}
+
+	if (--NotificationBatchDepth == 0)
+	{
+		FlushPendingNotifications();
+	}
+}
+
+void UTcsAttributeComponent::QueueAttributeChangePayloads(
+	const TArray<FTcsAttributeChangeEventPayload>& Payloads,
+	TArray<FTcsAttributeChangeEventPayload>& PendingPayloads,
+	TMap<FName, int32>& PendingIndices)
+{
+	for (const FTcsAttributeChangeEventPayload& Payload : Payloads)
+	{
+		if (const int32* PendingIndex = PendingIndices.Find(Payload.AttributeName))
+		{
+			FTcsAttributeChangeEventPayload& Pending = PendingPayloads[*PendingIndex];
+			Pending.NewValue = Payload.NewValue;
+			for (const TPair<FTcsSourceHandle, float>& Record : Payload.ChangeSourceRecord)
+			{
+				Pending.ChangeSourceRecord.FindOrAdd(Record.Key) += Record.Value;
+			}
+			continue;
+		}
+
+		PendingIndices.Add(Payload.AttributeName, PendingPayloads.Add(Payload));
+	}
+}
+
+void UTcsAttributeComponent::QueueModifierNotification(
+	EPendingModifierNotify Type,
+	const FTcsAttributeModifierInstance& ModifierInstance) const
+{
+	const int32* PendingIndex = PendingModifierIndices.Find(ModifierInstance.ModifierInstId);
+	if (!PendingIndex)
+	{
+		FPendingModifierNotification& Pending = PendingModifierNotifications.AddDefaulted_GetRef();
+		Pending.Type = Type;
+		Pending.Modifier = ModifierInstance;
+		PendingModifierIndices.Add(ModifierInstance.ModifierInstId, PendingModifierNotifications.Num() - 1);
+		return;
+	}
+
+	FPendingModifierNotification& Pending = PendingModifierNotifications[*PendingIndex];
+	Pending.Modifier = ModifierInstance;
+
+	if (Pending.Type == EPendingModifierNotify::Added)
+	{
+		// 批处理内新增的修改器：更新仍报告为新增，移除则整体抵消
+		if (Type == EPendingModifierNotify::Removed)
+		{
+			Pending.bDiscarded = true;
+			PendingModifierIndices.Remove(ModifierInstance.ModifierInstId);
+		}
+		return;
+	}
+
+	Pending.Type = Type;
+}
+
+void UTcsAttributeComponent::FlushPendingNotifications()
+{
+	// 先取走暂存数据，广播回调中产生的新事件直接派发
+	TArray<FPendingModifierNotification> ModifierNotifications = MoveTemp(PendingModifierNotifications);
+	TArray<FPendingBoundaryNotification> BoundaryNotifications = MoveTemp(PendingBoundaryNotifications);
+	TArray<FTcsAttributeChangeEventPayload> BaseValuePayloads = MoveTemp(PendingBaseValueChangePayloads);
+	TArray<FTcsAttributeChangeEventPayload> ValuePayloads = MoveTemp(PendingValueChangePayloads);
+	PendingModifierNotifications.Reset();
+	PendingBoundaryNotifications.Reset();
+	PendingBaseValueChangePayloads.Reset();
+	PendingValueChangePayloads.Reset();
+	PendingModifierIndices.Reset();
+	PendingBaseValueChangeIndices.Reset();
+	PendingValueChangeIndices.Reset();
+
+	for (const FPendingModifierNotification& Pending : ModifierNotifications)
+	{
+		if (Pending.bDiscarded)
+		{
+			continue;
+		}
+
+		switch (Pending.Type)
+		{
+		case EPendingModifierNotify::Added:
+			BroadcastAttributeModifierAddedEvent(Pending.Modifier);
+			break;
+		case EPendingModifierNotify::Removed:
+			BroadcastAttributeModifierRemovedEvent(Pending.Modifier);
+			break;
+		case EPendingModifierNotify::Updated:
+			BroadcastAttributeModifierUpdatedEvent(Pending.Modifier);
+			break;
+		}
+	}
+
+	for (const FPendingBoundaryNotification& Pending : BoundaryNotifications)
+	{
+		BroadcastAttributeReachedBoundaryEvent(
+			Pending.AttributeName,
+			Pending.bIsMaxBoundary,
+			Pending.OldValue,
+			Pending.NewValue,
+			Pending.BoundaryValue);
+	}
+
+	// 合并后净值未变化的属性不再广播
+	auto RemoveUnchanged = [](TArray<FTcsAttributeChangeEventPayload>& Payloads)
+	{
+		Payloads.RemoveAll([](const FTcsAttributeChangeEventPayload& Payload)
+		{
+			return Payload.OldValue == Payload.NewValue;
+		});
+	};
+	RemoveUnchanged(BaseValuePayloads);
+	RemoveUnchanged(ValuePayloads);
+
+	BroadcastAttributeBaseValueChangeEvent(BaseValuePayloads);
+	BroadcastAttributeValueChangeEvent(ValuePayloads);
+}
+
+
+// ============================================================
+// #pragma region AttributeSnapshot
+// ============================================================
+
+void UTcsAttributeComponent::PublishAttributeSnapshot()
+{
+	// 同帧已发布时保持脏标记，下一帧再发布
+	if (AttributeSnapshots.Publish(Attributes, GFrameCounter))
+	{
+		bAttributeSnapshotDirty = false;
+	}
+}
+
+
+// ============================================================
+// #pragma region MemoryReport
+// ============================================================
+
+void UTcsAttributeComponent::CollectMemoryUsage(FTcsMemoryUsage& Usage) const
+{
+	auto GetPayloadsAllocatedSize = [](const TArray<FTcsAttributeChangeEventPayload>& Payloads)
+	{
+		SIZE_T Size = Payloads.GetAllocatedSize();
+		for (const FTcsAttributeChangeEventPayload& Payload : Payloads)
+		{
+			Size += Payload.ChangeSourceRecord.GetAllocatedSize();
+		}
+		return Size;
+	};
+
+	Usage.AddContainer(TEXT("AttributeComponent.Object"), GetClass()->GetStructureSize());
+
+	Usage.AddContainer(TEXT("AttributeComponent.Attributes"), Attributes.GetAllocatedSize(), Attributes.Num());
+
+	// 修改器数组与各修改器的操作数表分开统计；单个修改器的开销同时按定义归集
+	SIZE_T OperandsBytes = 0;
+	for (const FTcsAttributeModifierInstance& Modifier : AttributeModifiers)
+	{
+		const SIZE_T ModifierOperandsBytes = Modifier.Operands.GetAllocatedSize();
+		OperandsBytes += ModifierOperandsBytes;
+		Usage.AddModifierDefinition(Modifier.ModifierId, sizeof(FTcsAttributeModifierInstance) + ModifierOperandsBytes);
+	}
+	Usage.AddContainer(TEXT("AttributeComponent.AttributeModifiers"), AttributeModifiers.GetAllocatedSize(), AttributeModifiers.Num());
+	Usage.AddContainer(TEXT("AttributeComponent.AttributeModifiers.Operands"), OperandsBytes, AttributeModifiers.Num());
+
+	SIZE_T DeferredModifiersBytes = PendingDeferredModifiers.GetAllocatedSize();
+	for (const FPendingDeferredModifier& Pending : PendingDeferredModifiers)
+	{
+		DeferredModifiersBytes += Pending.Modifier.Operands.GetAllocatedSize();
+	}
+	Usage.AddContainer(TEXT("AttributeComponent.PendingDeferredModifiers"), DeferredModifiersBytes, PendingDeferredModifiers.Num());
+
+	SIZE_T SourceHandleIndexBytes = SourceHandleIdToModifierInstIds.GetAllocatedSize();
+	for (const TPair<FTcsSourceHandle, TArray<int32>>& Pair : SourceHandleIdToModifierInstIds)
+	{
+		SourceHandleIndexBytes += Pair.Value.GetAllocatedSize();
+	}
+	Usage.AddContainer(TEXT("AttributeComponent.SourceHandleIndex"), SourceHandleIndexBytes, SourceHandleIdToModifierInstIds.Num());
+
+	Usage.AddContainer(TEXT("AttributeComponent.ModifierIndex"), ModifierInstIdToIndex.GetAllocatedSize(), ModifierInstIdToIndex.Num());
+
+	SIZE_T SubscriptionsBytes = AttributeChangedSubscriptions.GetAllocatedSize();
+	for (const TPair<FName, TSharedRef<FTcsOnAttributeChangedNative>>& Pair : AttributeChangedSubscriptions)
+	{
+		SubscriptionsBytes += sizeof(FTcsOnAttributeChangedNative) + Pair.Value->GetAllocatedSize();
+	}
+	Usage.AddContainer(TEXT("AttributeComponent.AttributeChangedSubscriptions"), SubscriptionsBytes, AttributeChangedSubscriptions.Num());
+
+	SIZE_T ReplicationBytes = ReplicatedAttributes.Items.GetAllocatedSize() + ReplicatedModifiers.Items.GetAllocatedSize();
+	for (const FTcsReplicatedAttributeModifier& Item : ReplicatedModifiers.Items)
+	{
+		ReplicationBytes += Item.Modifier.Operands.GetAllocatedSize();
+	}
+	Usage.AddContainer(TEXT("AttributeComponent.Replication"),
+		ReplicationBytes,
+		ReplicatedAttributes.Items.Num() + ReplicatedModifiers.Items.Num());
+
+	Usage.AddContainer(TEXT("AttributeComponent.Snapshot"), AttributeSnapshots.GetAllocatedSize());
+
+	SIZE_T PendingNotificationsBytes = GetPayloadsAllocatedSize(PendingValueChangePayloads)
+		+ GetPayloadsAllocatedSize(PendingBaseValueChangePayloads)
+		+ PendingValueChangeIndices.GetAllocatedSize()
+		+ PendingBaseValueChangeIndices.GetAllocatedSize()
+		+ PendingModifierNotifications.GetAllocatedSize()
+		+ PendingModifierIndices.GetAllocatedSize()
+		+ PendingBoundaryNotifications.GetAllocatedSize();
+	for (const FPendingModifierNotification& Pending : PendingModifierNotifications)
+	{
+		PendingNotificationsBytes += Pending.Modifier.Operands.GetAllocatedSize();
+	}
+	Usage.AddContainer(TEXT("AttributeComponent.PendingNotifications"), PendingNotificationsBytes);
+}
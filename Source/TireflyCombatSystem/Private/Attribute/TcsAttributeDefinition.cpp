@@ -29,6 +29,12 @@ void UTcsAttributeDefinition::PostEditChangeProperty(FPropertyChangedEvent& Prop
 
 	const FName PropertyName = PropertyChangedEvent.GetPropertyName();
 
+	// 定义 ID 变更后稠密 ID 需重新分配
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UTcsAttributeDefinition, AttributeDefId))
+	{
+		CachedDefIndex = INDEX_NONE;
+	}
+
 	// 验证 AttributeRange（静态类型时，确保 MinValue <= MaxValue）
 	if (PropertyName == GET_MEMBER_NAME_CHECKED(UTcsAttributeDefinition, AttributeRange))
 	{
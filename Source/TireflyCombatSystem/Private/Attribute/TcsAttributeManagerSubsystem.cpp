@@ -3,11 +3,22 @@
 
 #include "Attribute/TcsAttributeManagerSubsystem.h"
 
+#include "TcsDefinitionId.h"
 #include "TcsDefinitionRegistrySubsystem.h"
 #include "TcsDeveloperSettings.h"
 #include "TcsLogChannels.h"
+#include "TcsGenericLibrary.h"
+#include "TcsStats.h"
+#include "Attribute/TcsAttributeComponent.h"
 #include "Attribute/TcsAttributeDefinition.h"
 #include "Attribute/TcsAttributeModifierDefinition.h"
+#include "State/TcsStateComponent.h"
+#include "Async/ParallelFor.h"
+#include "Engine/GameInstance.h"
+#include "Engine/NetConnection.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
 
 #if WITH_EDITOR
 #include "Engine/Engine.h"
@@ -18,6 +29,44 @@
 #endif
 
 
+#if WITH_EDITOR
+namespace TcsAttributeManagerPrivate
+{
+	template <typename AssetType>
+	void ApplyDefinitionDelta(
+		TMap<FName, const AssetType*>& Definitions,
+		const TMap<FName, TSoftObjectPtr<AssetType>>& RegistryDefinitions,
+		const TSet<FName>& ChangedIds,
+		const TSet<FName>& RemovedIds,
+		const TCHAR* DefinitionLabel)
+	{
+		for (const FName& DefinitionId : RemovedIds)
+		{
+			Definitions.Remove(DefinitionId);
+		}
+
+		for (const FName& DefinitionId : ChangedIds)
+		{
+			const TSoftObjectPtr<AssetType>* AssetPtr = RegistryDefinitions.Find(DefinitionId);
+			const AssetType* Asset = AssetPtr ? AssetPtr->LoadSynchronous() : nullptr;
+			if (Asset)
+			{
+				Definitions.Add(DefinitionId, Asset);
+			}
+			else
+			{
+				Definitions.Remove(DefinitionId);
+				UE_LOG(LogTcsAttribute, Warning, TEXT("[%s] Failed to load %s: %s"),
+					*FString(__FUNCTION__),
+					DefinitionLabel,
+					*DefinitionId.ToString());
+			}
+		}
+	}
+}
+#endif
+
+
 void UTcsAttributeManagerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
@@ -34,10 +83,32 @@ void UTcsAttributeManagerSubsystem::Initialize(FSubsystemCollectionBase& Collect
 #else
 	LoadFromAssetManager();
 #endif
+
+	PublishNetworkDefinitionIds();
+
+	WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(
+		this,
+		&UTcsAttributeManagerSubsystem::HandleWorldTickStart);
+	WorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(
+		this,
+		&UTcsAttributeManagerSubsystem::HandleWorldPostActorTick);
 }
 
 void UTcsAttributeManagerSubsystem::Deinitialize()
 {
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+	WorldTickStartHandle.Reset();
+	CombatCommandQueue.Reset();
+	PendingUnownedSourceHandles.Empty();
+	FWorldDelegates::OnWorldPostActorTick.Remove(WorldPostActorTickHandle);
+	WorldPostActorTickHandle.Reset();
+	AttributeSnapshotPublishers.Empty();
+	PendingRecalculationComponents.Empty();
+	AttributeRecalculationBatchDepth = 0;
+
+	SourceHandleRegistry.Reset();
+	NetConnectionStates.Empty();
+
 #if WITH_EDITOR
 	if (DefinitionRegistryRefreshedHandle.IsValid())
 	{
@@ -188,6 +259,17 @@ void UTcsAttributeManagerSubsystem::LoadFromDefinitionRegistry()
 		AttributeTagToName.Num());
 }
 
+void UTcsAttributeManagerSubsystem::PublishNetworkDefinitionIds() const
+{
+	TArray<FName> AttributeIds;
+	AttributeDefinitions.GetKeys(AttributeIds);
+	FTcsDefinitionIdTable::SetNetworkDefinitionIds(ETcsDefinitionKind::Attribute, MoveTemp(AttributeIds));
+
+	TArray<FName> ModifierIds;
+	AttributeModifierDefinitions.GetKeys(ModifierIds);
+	FTcsDefinitionIdTable::SetNetworkDefinitionIds(ETcsDefinitionKind::AttributeModifier, MoveTemp(ModifierIds));
+}
+
 void UTcsAttributeManagerSubsystem::RebuildAttributeTagMappings()
 {
 
@@ -283,8 +365,253 @@ FTcsSourceHandle UTcsAttributeManagerSubsystem::CreateSourceHandle(
 	AActor* Instigator,
 	const FGameplayTagContainer& SourceTags)
 {
-	++GlobalSourceHandleIdMgr;
-	return FTcsSourceHandle(GlobalSourceHandleIdMgr, CausalityChain, Instigator, SourceTags);
+	FTcsSourceHandleData Data;
+	Data.SourceTags = SourceTags;
+	Data.Instigator = Instigator;
+	Data.CausalityTail = SourceHandleRegistry.InternCausalityChain(CausalityChain);
+	return SourceHandleRegistry.Allocate(MoveTemp(Data));
+}
+
+FTcsSourceHandle UTcsAttributeManagerSubsystem::CreateDerivedSourceHandle(
+	const FTcsSourceHandle& ParentSourceHandle,
+	const FPrimaryAssetId& DerivedAssetId,
+	AActor* Instigator,
+	const FGameplayTagContainer& SourceTags)
+{
+	FTcsSourceHandleData Data;
+	Data.SourceTags = SourceTags;
+	Data.Instigator = Instigator;
+	if (ParentSourceHandle.IsValid())
+	{
+		const FTcsSourceHandleData* ParentData = SourceHandleRegistry.Resolve(ParentSourceHandle);
+		Data.CausalityTail = SourceHandleRegistry.ExtendCausalityChain(
+			ParentData ? ParentData->CausalityTail : TSharedPtr<const FTcsCausalityNode>(),
+			DerivedAssetId);
+	}
+	return SourceHandleRegistry.Allocate(MoveTemp(Data));
+}
+
+FTcsSourceHandle UTcsAttributeManagerSubsystem::CreateUnownedSourceHandle(
+	const TArray<FPrimaryAssetId>& CausalityChain,
+	AActor* Instigator,
+	const FGameplayTagContainer& SourceTags)
+{
+	const FTcsSourceHandle SourceHandle = CreateSourceHandle(CausalityChain, Instigator, SourceTags);
+	PendingUnownedSourceHandles.Add(SourceHandle);
+	return SourceHandle;
+}
+
+void UTcsAttributeManagerSubsystem::ReleasePendingUnownedSourceHandles()
+{
+	if (PendingUnownedSourceHandles.IsEmpty())
+	{
+		return;
+	}
+
+	const TArray<FTcsSourceHandle> SourceHandles = MoveTemp(PendingUnownedSourceHandles);
+	PendingUnownedSourceHandles.Reset();
+	for (const FTcsSourceHandle& SourceHandle : SourceHandles)
+	{
+		SourceHandleRegistry.Release(SourceHandle);
+	}
+}
+
+bool UTcsAttributeManagerSubsystem::RetainSourceHandle(const FTcsSourceHandle& SourceHandle)
+{
+	return SourceHandleRegistry.AddRef(SourceHandle);
+}
+
+void UTcsAttributeManagerSubsystem::ReleaseSourceHandle(const FTcsSourceHandle& SourceHandle)
+{
+	SourceHandleRegistry.Release(SourceHandle);
+}
+
+const FTcsSourceHandleData* UTcsAttributeManagerSubsystem::ResolveSourceHandle(const FTcsSourceHandle& SourceHandle) const
+{
+	return SourceHandleRegistry.Resolve(SourceHandle);
+}
+
+AActor* UTcsAttributeManagerSubsystem::GetSourceInstigator(const FTcsSourceHandle& SourceHandle) const
+{
+	const FTcsSourceHandleData* Data = SourceHandleRegistry.Resolve(SourceHandle);
+	return Data ? Data->Instigator.Get() : nullptr;
+}
+
+FGameplayTagContainer UTcsAttributeManagerSubsystem::GetSourceTags(const FTcsSourceHandle& SourceHandle) const
+{
+	const FTcsSourceHandleData* Data = SourceHandleRegistry.Resolve(SourceHandle);
+	return Data ? Data->SourceTags : FGameplayTagContainer();
+}
+
+TArray<FPrimaryAssetId> UTcsAttributeManagerSubsystem::GetSourceCausalityChain(const FTcsSourceHandle& SourceHandle) const
+{
+	TArray<FPrimaryAssetId> CausalityChain;
+	if (const FTcsSourceHandleData* Data = SourceHandleRegistry.Resolve(SourceHandle))
+	{
+		Data->GetCausalityChain(CausalityChain);
+	}
+	return CausalityChain;
+}
+
+FString UTcsAttributeManagerSubsystem::GetSourceHandleDebugString(const FTcsSourceHandle& SourceHandle) const
+{
+	return SourceHandleRegistry.ToDebugString(SourceHandle);
+}
+
+FTcsSourceHandleRegistry* UTcsAttributeManagerSubsystem::FindSourceHandleRegistry(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	UTcsAttributeManagerSubsystem* AttrMgr = GameInstance ? GameInstance->GetSubsystem<UTcsAttributeManagerSubsystem>() : nullptr;
+	return AttrMgr ? &AttrMgr->SourceHandleRegistry : nullptr;
+}
+
+bool UTcsAttributeManagerSubsystem::FindSourceHandleNetContext(UPackageMap* Map, FTcsSourceHandleNetContext& OutContext)
+{
+	UNetConnection* Connection = Map ? Cast<UNetConnection>(Map->GetOuter()) : nullptr;
+	const UWorld* World = Connection ? Connection->GetWorld() : (Map ? Map->GetWorld() : nullptr);
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	UTcsAttributeManagerSubsystem* AttrMgr = GameInstance ? GameInstance->GetSubsystem<UTcsAttributeManagerSubsystem>() : nullptr;
+	if (!AttrMgr)
+	{
+		return false;
+	}
+
+	OutContext.Registry = &AttrMgr->SourceHandleRegistry;
+
+	if (!Connection)
+	{
+		return true;
+	}
+
+	FNetConnectionState& ConnectionState = AttrMgr->FindOrAddNetConnectionState(Connection);
+	OutContext.ConnectionId = ConnectionState.ConnectionId;
+
+	// 回放连接可能从任意位置开始播放，不能依赖之前发送过的链，也可能在定义列表不同的版本中播放
+	if (Connection->IsReplay())
+	{
+		return true;
+	}
+
+	OutContext.NetIndexKinds = ConnectionState.GetNetIndexKinds();
+
+	// 写出的 Bunch 可能排队或拆分到之后的包中发出，序列化时无法得知真实包序号：
+	// 发送包序号留空，由缓存在下一帧以连接的 OutPacketId 补记上界，补记并被对端确认后才切换为只写链引用号
+	FTcsSourceHandleNetCache& Cache = ConnectionState.Cache;
+	Cache.UpdateAckState(Connection->OutAckPacketId, Connection->OutTotalPacketsLost, Connection->OutPacketId, GFrameCounter);
+	OutContext.Cache = &Cache;
+	OutContext.SendPacketId = INDEX_NONE;
+	return true;
+}
+
+bool UTcsAttributeManagerSubsystem::CanUseDefinitionNetIndex(UPackageMap* Map, ETcsDefinitionKind Kind)
+{
+	UNetConnection* Connection = Map ? Cast<UNetConnection>(Map->GetOuter()) : nullptr;
+	if (!Connection || Connection->IsReplay())
+	{
+		return false;
+	}
+
+	const UWorld* World = Connection->GetWorld();
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	const UTcsAttributeManagerSubsystem* AttrMgr = GameInstance ? GameInstance->GetSubsystem<UTcsAttributeManagerSubsystem>() : nullptr;
+	const FNetConnectionState* ConnectionState = AttrMgr ? AttrMgr->NetConnectionStates.Find(Connection) : nullptr;
+	return ConnectionState && (ConnectionState->GetNetIndexKinds() & (1 << static_cast<uint8>(Kind))) != 0;
+}
+
+void UTcsAttributeManagerSubsystem::SetPeerNetworkDefinitionListHashes(UNetConnection* Connection, const TArray<uint32>& ListHashes)
+{
+	if (!Connection)
+	{
+		return;
+	}
+
+	FNetConnectionState& ConnectionState = FindOrAddNetConnectionState(Connection);
+	ConnectionState.PeerDefinitionListHashes = ListHashes;
+
+	const uint8 NetIndexKinds = ConnectionState.GetNetIndexKinds();
+	for (int32 KindIndex = 0; KindIndex < static_cast<int32>(ETcsDefinitionKind::Num); ++KindIndex)
+	{
+		if ((NetIndexKinds & (1 << KindIndex)) == 0)
+		{
+			UE_LOG(LogTcs, Warning, TEXT("[%s] Definition list %d differs from peer %s, definition ids are sent by name"),
+				*FString(__FUNCTION__), KindIndex, *Connection->GetName());
+		}
+	}
+}
+
+void UTcsAttributeManagerSubsystem::RequestFullCausalityChains(UNetConnection* Connection)
+{
+	if (FNetConnectionState* ConnectionState = Connection ? NetConnectionStates.Find(Connection) : nullptr)
+	{
+		ConnectionState->Cache.ResetAcks();
+	}
+}
+
+uint8 UTcsAttributeManagerSubsystem::FNetConnectionState::GetNetIndexKinds() const
+{
+	// 与当前发布的列表比较：本端列表刷新后（编辑器中修改定义）自动回退到 FName
+	uint8 NetIndexKinds = 0;
+	for (int32 KindIndex = 0; KindIndex < PeerDefinitionListHashes.Num() && KindIndex < static_cast<int32>(ETcsDefinitionKind::Num); ++KindIndex)
+	{
+		if (PeerDefinitionListHashes[KindIndex] == FTcsDefinitionIdTable::GetNetworkDefinitionListHash(static_cast<ETcsDefinitionKind>(KindIndex)))
+		{
+			NetIndexKinds |= 1 << KindIndex;
+		}
+	}
+	return NetIndexKinds;
+}
+
+UTcsAttributeManagerSubsystem::FNetConnectionState& UTcsAttributeManagerSubsystem::FindOrAddNetConnectionState(UNetConnection* Connection)
+{
+	FNetConnectionState* ConnectionState = NetConnectionStates.Find(Connection);
+	if (!ConnectionState)
+	{
+		// 新连接出现时顺带清理已失效连接的状态
+		RemoveClosedNetConnectionStates();
+		ConnectionState = &NetConnectionStates.Add(Connection);
+		ConnectionState->ConnectionId = NextNetConnectionId++;
+	}
+	return *ConnectionState;
+}
+
+void UTcsAttributeManagerSubsystem::RemoveClosedNetConnectionStates()
+{
+	for (auto It = NetConnectionStates.CreateIterator(); It; ++It)
+	{
+		const UNetConnection* Connection = It->Key.ResolveObjectPtr();
+		if (!Connection || Connection->GetConnectionState() == USOCK_Closed)
+		{
+			SourceHandleRegistry.RemoveConnection(It->Value.ConnectionId);
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UTcsAttributeManagerSubsystem::SendFullCausalityChainRequests()
+{
+	for (TPair<TObjectKey<UNetConnection>, FNetConnectionState>& Pair : NetConnectionStates)
+	{
+		FTcsSourceHandleNetCache& Cache = Pair.Value.Cache;
+		if (!Cache.ConsumeUnknownChainRef())
+		{
+			continue;
+		}
+
+		// 请求经由连接玩家的属性组件发出；暂时没有可用的组件时保留记录，下一帧再试
+		UNetConnection* Connection = Pair.Key.ResolveObjectPtr();
+		APlayerController* PlayerController = Connection ? Connection->PlayerController.Get() : nullptr;
+		UTcsAttributeComponent* AttrComp = PlayerController
+			? UTcsGenericLibrary::GetAttributeComponent(PlayerController->GetPawn())
+			: nullptr;
+		if (!AttrComp)
+		{
+			Cache.RecordUnknownChainRef();
+			continue;
+		}
+
+		AttrComp->SendFullCausalityChainRequest();
+	}
 }
 
 const UTcsAttributeDefinition* UTcsAttributeManagerSubsystem::GetAttributeDefinition(FName AttributeName) const
@@ -305,6 +632,29 @@ const UTcsAttributeModifierDefinition* UTcsAttributeManagerSubsystem::GetModifie
 	return nullptr;
 }
 
+void UTcsAttributeManagerSubsystem::RegisterTransientAttributeDefinition(const UTcsAttributeDefinition* Definition)
+{
+	if (!Definition || Definition->AttributeDefId.IsNone())
+	{
+		UE_LOG(LogTcsAttribute, Warning, TEXT("[%s] Invalid transient AttributeDefinition"), *FString(__FUNCTION__));
+		return;
+	}
+
+	AttributeDefinitions.Add(Definition->AttributeDefId, Definition);
+	RebuildAttributeTagMappings();
+}
+
+void UTcsAttributeManagerSubsystem::RegisterTransientModifierDefinition(const UTcsAttributeModifierDefinition* Definition)
+{
+	if (!Definition || Definition->AttributeModifierDefId.IsNone())
+	{
+		UE_LOG(LogTcsAttribute, Warning, TEXT("[%s] Invalid transient AttributeModifierDefinition"), *FString(__FUNCTION__));
+		return;
+	}
+
+	AttributeModifierDefinitions.Add(Definition->AttributeModifierDefId, Definition);
+}
+
 void UTcsAttributeManagerSubsystem::LoadFromAssetManager()
 {
 #if !WITH_EDITOR
@@ -374,8 +724,340 @@ UTcsDefinitionRegistrySubsystem* UTcsAttributeManagerSubsystem::GetDefinitionReg
 	return GEngine ? GEngine->GetEngineSubsystem<UTcsDefinitionRegistrySubsystem>() : nullptr;
 }
 
-void UTcsAttributeManagerSubsystem::HandleDefinitionRegistryRefreshed(const UTcsDefinitionRegistrySubsystem* Registry)
+void UTcsAttributeManagerSubsystem::HandleDefinitionRegistryRefreshed(
+	const UTcsDefinitionRegistrySubsystem* Registry,
+	const FTcsDefinitionChangeSet& ChangeSet)
 {
-	LoadFromDefinitionRegistry();
+	if (!Registry || ChangeSet.bIsFullRefresh)
+	{
+		LoadFromDefinitionRegistry();
+		PublishNetworkDefinitionIds();
+		return;
+	}
+
+	const bool bAttributesChanged = ChangeSet.HasChanges(ETcsDefinitionKind::Attribute);
+	const bool bModifiersChanged = ChangeSet.HasChanges(ETcsDefinitionKind::AttributeModifier);
+	if (!bAttributesChanged && !bModifiersChanged)
+	{
+		return;
+	}
+
+	// 只移除/重新加载变更集中列出的定义
+	TcsAttributeManagerPrivate::ApplyDefinitionDelta(
+		AttributeDefinitions,
+		Registry->GetAttributeDefinitions(),
+		ChangeSet.GetChanged(ETcsDefinitionKind::Attribute),
+		ChangeSet.GetRemoved(ETcsDefinitionKind::Attribute),
+		TEXT("AttributeDefinition"));
+	TcsAttributeManagerPrivate::ApplyDefinitionDelta(
+		AttributeModifierDefinitions,
+		Registry->GetAttributeModifierDefinitions(),
+		ChangeSet.GetChanged(ETcsDefinitionKind::AttributeModifier),
+		ChangeSet.GetRemoved(ETcsDefinitionKind::AttributeModifier),
+		TEXT("AttributeModifierDefinition"));
+
+	if (bAttributesChanged)
+	{
+		RebuildAttributeTagMappings();
+	}
+	PublishNetworkDefinitionIds();
+
+	UE_LOG(LogTcsAttribute, Verbose, TEXT("[%s] Applied definition delta: %d Attributes, %d AttributeModifiers"),
+		*FString(__FUNCTION__),
+		AttributeDefinitions.Num(),
+		AttributeModifierDefinitions.Num());
+}
+#endif
+
+void UTcsAttributeManagerSubsystem::EnqueueApplyModifiers(
+	AActor* Target,
+	TArray<FName> ModifierIds,
+	const FTcsSourceHandle& SourceHandle,
+	AActor* Instigator,
+	TMap<FName, float> Operands)
+{
+	FTcsCombatCommand Command;
+	Command.Type = ETcsCombatCommandType::ApplyModifiers;
+	Command.Target = Target;
+	Command.Instigator = Instigator;
+	Command.SourceHandle = SourceHandle;
+	Command.ModifierIds = MoveTemp(ModifierIds);
+	Command.Operands = MoveTemp(Operands);
+	CombatCommandQueue.Enqueue(MoveTemp(Command));
+}
+
+void UTcsAttributeManagerSubsystem::EnqueueRemoveModifiersBySource(AActor* Target, const FTcsSourceHandle& SourceHandle)
+{
+	FTcsCombatCommand Command;
+	Command.Type = ETcsCombatCommandType::RemoveModifiersBySource;
+	Command.Target = Target;
+	Command.SourceHandle = SourceHandle;
+	CombatCommandQueue.Enqueue(MoveTemp(Command));
+}
+
+void UTcsAttributeManagerSubsystem::EnqueueApplyState(
+	AActor* Target,
+	FName StateDefId,
+	AActor* Instigator,
+	int32 StateLevel,
+	const FTcsSourceHandle& ParentSourceHandle)
+{
+	FTcsCombatCommand Command;
+	Command.Type = ETcsCombatCommandType::ApplyState;
+	Command.Target = Target;
+	Command.Instigator = Instigator;
+	Command.StateDefId = StateDefId;
+	Command.StateLevel = StateLevel;
+	Command.SourceHandle = ParentSourceHandle;
+	CombatCommandQueue.Enqueue(MoveTemp(Command));
+}
+
+void UTcsAttributeManagerSubsystem::EnqueueRemoveStatesByDefId(AActor* Target, FName StateDefId)
+{
+	FTcsCombatCommand Command;
+	Command.Type = ETcsCombatCommandType::RemoveStatesByDefId;
+	Command.Target = Target;
+	Command.StateDefId = StateDefId;
+	CombatCommandQueue.Enqueue(MoveTemp(Command));
+}
+
+int32 UTcsAttributeManagerSubsystem::DrainCombatCommands()
+{
+	if (CombatCommandQueue.NumPending() == 0)
+	{
+		return 0;
+	}
+
+	return CombatCommandQueue.Drain([this](FTcsCombatCommand& Command)
+	{
+		ExecuteCombatCommand(Command);
+	});
+}
+
+void UTcsAttributeManagerSubsystem::HandleWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World && World->GetGameInstance() == GetGameInstance())
+	{
+		// 本帧排队的战斗指令引起的属性重算合并为一次批处理（各组件的修改器计算并行执行）
+		{
+			FTcsAttributeRecalculationScope RecalculationScope(this);
+			DrainCombatCommands();
+		}
+
+		// 排队指令已为挂上的修改器持有来源引用，此后再归还蓝图创建的来源
+		ReleasePendingUnownedSourceHandles();
+
+		// 连接关闭后经由其收到的远端来源不再有效
+		RemoveClosedNetConnectionStates();
+
+		// 上一帧读取到未知因果链引用的连接，请求对端重新完整发送
+		SendFullCausalityChainRequests();
+	}
+}
+
+void UTcsAttributeManagerSubsystem::ExecuteCombatCommand(FTcsCombatCommand& Command)
+{
+	AActor* Target = Command.Target.Get();
+	if (!IsValid(Target))
+	{
+		return;
+	}
+
+	switch (Command.Type)
+	{
+	case ETcsCombatCommandType::ApplyModifiers:
+		{
+			UTcsAttributeComponent* AttrComp = UTcsGenericLibrary::GetAttributeComponent(Target);
+			if (!AttrComp)
+			{
+				return;
+			}
+
+			AActor* Instigator = Command.Instigator.Get();
+			if (!Instigator && Command.SourceHandle.IsValid())
+			{
+				Instigator = GetSourceInstigator(Command.SourceHandle);
+			}
+
+			TArray<FTcsAttributeModifierInstance> Modifiers;
+			Modifiers.Reserve(Command.ModifierIds.Num());
+			for (const FName& ModifierId : Command.ModifierIds)
+			{
+				FTcsAttributeModifierInstance ModifierInst;
+				const bool bCreated = Command.Operands.IsEmpty()
+					? AttrComp->CreateAttributeModifier(ModifierId, Instigator, ModifierInst)
+					: AttrComp->CreateAttributeModifierWithOperands(ModifierId, Instigator, Command.Operands, ModifierInst);
+				if (bCreated)
+				{
+					ModifierInst.SourceHandle = Command.SourceHandle;
+					Modifiers.Add(MoveTemp(ModifierInst));
+				}
+			}
+
+			AttrComp->ApplyModifier(Modifiers);
+			break;
+		}
+	case ETcsCombatCommandType::RemoveModifiersBySource:
+		{
+			if (UTcsAttributeComponent* AttrComp = UTcsGenericLibrary::GetAttributeComponent(Target))
+			{
+				AttrComp->RemoveModifiersBySourceHandle(Command.SourceHandle);
+			}
+			break;
+		}
+	case ETcsCombatCommandType::ApplyState:
+		{
+			if (UTcsStateComponent* StateComp = UTcsGenericLibrary::GetStateComponent(Target))
+			{
+				StateComp->TryApplyState(Command.StateDefId, Command.Instigator.Get(), Command.StateLevel, Command.SourceHandle);
+			}
+			break;
+		}
+	case ETcsCombatCommandType::RemoveStatesByDefId:
+		{
+			if (UTcsStateComponent* StateComp = UTcsGenericLibrary::GetStateComponent(Target))
+			{
+				StateComp->RemoveStatesByDefId(Command.StateDefId);
+			}
+			break;
+		}
+	}
+}
+
+void UTcsAttributeManagerSubsystem::RegisterAttributeSnapshotPublisher(UTcsAttributeComponent* AttributeComponent)
+{
+	if (IsValid(AttributeComponent))
+	{
+		AttributeSnapshotPublishers.AddUnique(AttributeComponent);
+	}
+}
+
+void UTcsAttributeManagerSubsystem::UnregisterAttributeSnapshotPublisher(UTcsAttributeComponent* AttributeComponent)
+{
+	AttributeSnapshotPublishers.RemoveSingleSwap(AttributeComponent);
+}
+
+void UTcsAttributeManagerSubsystem::HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (!World || World->GetGameInstance() != GetGameInstance())
+	{
+		return;
+	}
+
+	for (int32 Index = AttributeSnapshotPublishers.Num() - 1; Index >= 0; --Index)
+	{
+		UTcsAttributeComponent* AttributeComponent = AttributeSnapshotPublishers[Index].Get();
+		if (!AttributeComponent)
+		{
+			AttributeSnapshotPublishers.RemoveAtSwap(Index);
+			continue;
+		}
+
+		if (AttributeComponent->bAttributeSnapshotDirty)
+		{
+			AttributeComponent->PublishAttributeSnapshot();
+		}
+	}
+}
+
+void UTcsAttributeManagerSubsystem::BeginAttributeRecalculationBatch()
+{
+	check(IsInGameThread());
+	++AttributeRecalculationBatchDepth;
+}
+
+void UTcsAttributeManagerSubsystem::EndAttributeRecalculationBatch()
+{
+	check(IsInGameThread());
+	if (!ensureMsgf(AttributeRecalculationBatchDepth > 0, TEXT("[%s] Unbalanced attribute recalculation batch."), *FString(__FUNCTION__)))
+	{
+		return;
+	}
+
+	if (--AttributeRecalculationBatchDepth == 0)
+	{
+		FlushAttributeRecalculations();
+	}
+}
+
+void UTcsAttributeManagerSubsystem::RequestAttributeRecalculation(UTcsAttributeComponent* AttributeComponent, int64 ChangeBatchId)
+{
+	if (!IsValid(AttributeComponent))
+	{
+		return;
+	}
+
+	AttributeComponent->PendingRecalculationBatchIds.AddUnique(ChangeBatchId);
+	if (!AttributeComponent->bCurrentValueRecalculationPending)
+	{
+		AttributeComponent->bCurrentValueRecalculationPending = true;
+		PendingRecalculationComponents.Add(AttributeComponent);
+	}
+}
+
+int32 UTcsAttributeManagerSubsystem::FlushAttributeRecalculations()
+{
+	check(IsInGameThread());
+	TCS_SCOPE_CYCLE_COUNTER(STAT_TcsAttributeRecalculateBatch);
+
+	int32 NumRecalculated = 0;
+	while (!PendingRecalculationComponents.IsEmpty())
+	{
+		TArray<TWeakObjectPtr<UTcsAttributeComponent>> ComponentsToRecalculate = MoveTemp(PendingRecalculationComponents);
+		PendingRecalculationComponents.Reset();
+
+		// 准备阶段（游戏线程）：合并修改器、解析执行器
+		TArray<UTcsAttributeComponent*> Components;
+		TArray<UTcsAttributeComponent::FCurrentValueRecalculationJob> Jobs;
+		Components.Reserve(ComponentsToRecalculate.Num());
+		Jobs.Reserve(ComponentsToRecalculate.Num());
+		for (const TWeakObjectPtr<UTcsAttributeComponent>& WeakComponent : ComponentsToRecalculate)
+		{
+			UTcsAttributeComponent* AttributeComponent = WeakComponent.Get();
+			if (!IsValid(AttributeComponent))
+			{
+				continue;
+			}
+
+			AttributeComponent->bCurrentValueRecalculationPending = false;
+
+			UTcsAttributeComponent::FCurrentValueRecalculationJob& Job = Jobs.AddDefaulted_GetRef();
+			Job.ChangeBatchIds = MoveTemp(AttributeComponent->PendingRecalculationBatchIds);
+			AttributeComponent->PendingRecalculationBatchIds.Reset();
+			AttributeComponent->PrepareCurrentValueRecalculation(Job);
+			Components.Add(AttributeComponent);
+		}
+
+		// 计算阶段：纯数值计算并行执行；任务过少时并行调度的开销高于收益
+		constexpr int32 MinParallelRecalculationJobs = 4;
+		ParallelFor(Jobs.Num(), [&Jobs](int32 Index)
+		{
+			if (!Jobs[Index].bRequiresGameThread)
+			{
+				UTcsAttributeComponent::ExecuteCurrentValueRecalculation(Jobs[Index]);
+			}
+		}, Jobs.Num() < MinParallelRecalculationJobs);
+
+		// 含蓝图执行器的任务留在游戏线程计算
+		for (UTcsAttributeComponent::FCurrentValueRecalculationJob& Job : Jobs)
+		{
+			if (Job.bRequiresGameThread)
+			{
+				UTcsAttributeComponent::ExecuteCurrentValueRecalculation(Job);
+			}
+		}
+
+		// 提交阶段（游戏线程）：按登记顺序串行修正范围、写回并广播
+		// 事件回调中触发的重算登记到下一轮，避免被本轮尚未提交的任务覆盖
+		++AttributeRecalculationBatchDepth;
+		for (int32 Index = 0; Index < Components.Num(); ++Index)
+		{
+			Components[Index]->CommitCurrentValueRecalculation(Jobs[Index]);
+		}
+		--AttributeRecalculationBatchDepth;
+
+		NumRecalculated += Components.Num();
+	}
+
+	return NumRecalculated;
 }
-#endif
\ No newline at end of file
@@ -30,6 +30,12 @@ void UTcsAttributeModifierDefinition::PostEditChangeProperty(FPropertyChangedEve
 
 	const FName PropertyName = PropertyChangedEvent.GetPropertyName();
 
+	// 定义 ID 变更后稠密 ID 需重新分配
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UTcsAttributeModifierDefinition, AttributeModifierDefId))
+	{
+		CachedDefIndex = INDEX_NONE;
+	}
+
 	// 验证 Operands（确保至少有 Magnitude）
 	if (PropertyName == GET_MEMBER_NAME_CHECKED(UTcsAttributeModifierDefinition, Operands))
 	{
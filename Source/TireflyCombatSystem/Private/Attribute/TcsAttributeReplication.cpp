@@ -0,0 +1,281 @@
+// Copyright Tirefly. All Rights Reserved.
+
+
+#include "Attribute/TcsAttributeReplication.h"
+
+#include "TcsDefinitionId.h"
+#include "Attribute/TcsAttributeComponent.h"
+#include "Attribute/TcsAttributeManagerSubsystem.h"
+#include "Attribute/TcsAttributeDefinition.h"
+#include "GameFramework/Actor.h"
+
+
+
+namespace TcsAttributeReplicationPrivate
+{
+	// 接收端允许的最大操作数数量（防止异常数据导致超大分配）
+	constexpr uint32 MaxNetOperands = 64;
+
+	// 量化步长的倒数（完整精度返回 0）
+	double GetQuantizationScale(ETcsAttributeNetQuantization Quantization)
+	{
+		switch (Quantization)
+		{
+		case ETcsAttributeNetQuantization::ANQ_Integer:
+			return 1.0;
+		case ETcsAttributeNetQuantization::ANQ_OneDecimal:
+			return 10.0;
+		case ETcsAttributeNetQuantization::ANQ_TwoDecimals:
+			return 100.0;
+		default:
+			return 0.0;
+		}
+	}
+
+	// 量化后的整数是否可按 int32 写出（超出范围时回退为完整精度）
+	bool TryQuantize(float Value, double Scale, int32& OutQuantized)
+	{
+		const double Quantized = FMath::RoundToDouble(static_cast<double>(Value) * Scale);
+		if (Scale <= 0.0 || !FMath::IsFinite(Quantized) || FMath::Abs(Quantized) > static_cast<double>(MAX_int32))
+		{
+			return false;
+		}
+
+		OutQuantized = static_cast<int32>(Quantized);
+		return true;
+	}
+
+	float QuantizeValue(float Value, ETcsAttributeNetQuantization Quantization)
+	{
+		const double Scale = GetQuantizationScale(Quantization);
+		int32 Quantized = 0;
+		return TryQuantize(Value, Scale, Quantized) ? static_cast<float>(Quantized / Scale) : Value;
+	}
+
+	// 量化值写为 ZigZag 变长整数，无法量化时写完整浮点
+	void SerializeQuantizedValue(FArchive& Ar, ETcsAttributeNetQuantization Quantization, float& Value)
+	{
+		const double Scale = GetQuantizationScale(Quantization);
+		if (Scale <= 0.0)
+		{
+			Ar << Value;
+			return;
+		}
+
+		int32 Quantized = 0;
+		uint8 bFullPrecision = 0;
+		if (Ar.IsSaving())
+		{
+			bFullPrecision = TryQuantize(Value, Scale, Quantized) ? 0 : 1;
+		}
+		Ar.SerializeBits(&bFullPrecision, 1);
+
+		if (bFullPrecision)
+		{
+			Ar << Value;
+			return;
+		}
+
+		uint32 ZigZag = (static_cast<uint32>(Quantized) << 1) ^ static_cast<uint32>(Quantized >> 31);
+		Ar.SerializeIntPacked(ZigZag);
+
+		if (Ar.IsLoading())
+		{
+			Quantized = static_cast<int32>(ZigZag >> 1) ^ -static_cast<int32>(ZigZag & 1);
+			Value = static_cast<float>(Quantized / Scale);
+		}
+	}
+}
+
+
+
+// ============================================================
+// #pragma region ReplicatedAttribute
+// ============================================================
+
+bool FTcsReplicatedAttribute::SyncFrom(const FTcsAttributeInstance& Attribute)
+{
+	const ETcsAttributeNetQuantization NewQuantization = Attribute.AttributeDef
+		? Attribute.AttributeDef->NetQuantization
+		: ETcsAttributeNetQuantization::ANQ_None;
+	const float NewBaseValue = TcsAttributeReplicationPrivate::QuantizeValue(Attribute.BaseValue, NewQuantization);
+	const float NewCurrentValue = TcsAttributeReplicationPrivate::QuantizeValue(Attribute.CurrentValue, NewQuantization);
+
+	if (Quantization == NewQuantization && BaseValue == NewBaseValue && CurrentValue == NewCurrentValue)
+	{
+		return false;
+	}
+
+	Quantization = NewQuantization;
+	BaseValue = NewBaseValue;
+	CurrentValue = NewCurrentValue;
+	return true;
+}
+
+bool FTcsReplicatedAttribute::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = FTcsDefinitionIdTable::NetSerializeDefinitionId(
+		Ar,
+		ETcsDefinitionKind::Attribute,
+		AttributeName,
+		Ar.IsSaving() && UTcsAttributeManagerSubsystem::CanUseDefinitionNetIndex(Map, ETcsDefinitionKind::Attribute));
+
+	uint8 QuantizationBits = static_cast<uint8>(Quantization);
+	Ar.SerializeBits(&QuantizationBits, 2);
+	if (Ar.IsLoading())
+	{
+		Quantization = static_cast<ETcsAttributeNetQuantization>(QuantizationBits);
+	}
+
+	TcsAttributeReplicationPrivate::SerializeQuantizedValue(Ar, Quantization, BaseValue);
+	TcsAttributeReplicationPrivate::SerializeQuantizedValue(Ar, Quantization, CurrentValue);
+
+	bOutSuccess &= !Ar.IsError();
+	return bOutSuccess;
+}
+
+void FTcsReplicatedAttribute::PreReplicatedRemove(const FTcsReplicatedAttributeArray& InArraySerializer)
+{
+	if (InArraySerializer.OwnerComponent)
+	{
+		InArraySerializer.OwnerComponent->HandleReplicatedAttributeRemoved(*this);
+	}
+}
+
+void FTcsReplicatedAttribute::PostReplicatedAdd(const FTcsReplicatedAttributeArray& InArraySerializer)
+{
+	if (InArraySerializer.OwnerComponent)
+	{
+		InArraySerializer.OwnerComponent->HandleReplicatedAttributeUpdated(*this);
+	}
+}
+
+void FTcsReplicatedAttribute::PostReplicatedChange(const FTcsReplicatedAttributeArray& InArraySerializer)
+{
+	if (InArraySerializer.OwnerComponent)
+	{
+		InArraySerializer.OwnerComponent->HandleReplicatedAttributeUpdated(*this);
+	}
+}
+
+
+// ============================================================
+// #pragma region ReplicatedAttributeModifier
+// ============================================================
+
+bool FTcsReplicatedAttributeModifier::SyncFrom(const FTcsAttributeModifierInstance& Source)
+{
+	if (Modifier.ModifierInstId == Source.ModifierInstId
+		&& Modifier.UpdateTimestamp == Source.UpdateTimestamp
+		&& Modifier.LastTouchedBatchId == Source.LastTouchedBatchId)
+	{
+		return false;
+	}
+
+	Modifier = Source;
+	return true;
+}
+
+bool FTcsReplicatedAttributeModifier::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	uint32 ModifierInstIdPlusOne = static_cast<uint32>(Modifier.ModifierInstId + 1);
+	Ar.SerializeIntPacked(ModifierInstIdPlusOne);
+	if (Ar.IsLoading())
+	{
+		Modifier.ModifierInstId = static_cast<int32>(ModifierInstIdPlusOne) - 1;
+	}
+
+	const bool bUseModifierNetIndex = Ar.IsSaving()
+		&& UTcsAttributeManagerSubsystem::CanUseDefinitionNetIndex(Map, ETcsDefinitionKind::AttributeModifier);
+	if (!FTcsDefinitionIdTable::NetSerializeDefinitionId(Ar, ETcsDefinitionKind::AttributeModifier, Modifier.ModifierId, bUseModifierNetIndex))
+	{
+		bOutSuccess = false;
+		return false;
+	}
+
+	bool bHandleSuccess = true;
+	Modifier.SourceHandle.NetSerialize(Ar, Map, bHandleSuccess);
+	bOutSuccess &= bHandleSuccess;
+
+	// 条件序列化 Instigator
+	uint8 bHasInstigator = 0;
+	if (Ar.IsSaving())
+	{
+		bHasInstigator = Modifier.Instigator.IsValid() && Map ? 1 : 0;
+	}
+	Ar.SerializeBits(&bHasInstigator, 1);
+
+	if (bHasInstigator && Map)
+	{
+		UObject* InstigatorObject = Modifier.Instigator.Get();
+		Map->SerializeObject(Ar, AActor::StaticClass(), InstigatorObject);
+		if (Ar.IsLoading())
+		{
+			Modifier.Instigator = Cast<AActor>(InstigatorObject);
+		}
+	}
+	else if (Ar.IsLoading())
+	{
+		Modifier.Instigator.Reset();
+	}
+
+	// 序列化操作数
+	uint32 NumOperands = static_cast<uint32>(Modifier.Operands.Num());
+	Ar.SerializeIntPacked(NumOperands);
+
+	if (Ar.IsSaving())
+	{
+		for (TPair<FName, float>& Operand : Modifier.Operands)
+		{
+			Ar << Operand.Key;
+			Ar << Operand.Value;
+		}
+	}
+	else
+	{
+		if (NumOperands > TcsAttributeReplicationPrivate::MaxNetOperands)
+		{
+			bOutSuccess = false;
+			return false;
+		}
+
+		Modifier.Operands.Reset();
+		for (uint32 i = 0; i < NumOperands; ++i)
+		{
+			FName OperandName;
+			float OperandValue = 0.f;
+			Ar << OperandName;
+			Ar << OperandValue;
+			Modifier.Operands.Add(OperandName, OperandValue);
+		}
+	}
+
+	bOutSuccess &= !Ar.IsError();
+	return bOutSuccess;
+}
+
+void FTcsReplicatedAttributeModifier::PreReplicatedRemove(const FTcsReplicatedAttributeModifierArray& InArraySerializer)
+{
+	if (InArraySerializer.OwnerComponent)
+	{
+		InArraySerializer.OwnerComponent->HandleReplicatedModifierRemoved(*this);
+	}
+}
+
+void FTcsReplicatedAttributeModifier::PostReplicatedAdd(const FTcsReplicatedAttributeModifierArray& InArraySerializer)
+{
+	if (InArraySerializer.OwnerComponent)
+	{
+		InArraySerializer.OwnerComponent->HandleReplicatedModifierUpdated(*this);
+	}
+}
+
+void FTcsReplicatedAttributeModifier::PostReplicatedChange(const FTcsReplicatedAttributeModifierArray& InArraySerializer)
+{
+	if (InArraySerializer.OwnerComponent)
+	{
+		InArraySerializer.OwnerComponent->HandleReplicatedModifierUpdated(*this);
+	}
+}
@@ -0,0 +1,119 @@
+// Copyright Tirefly. All Rights Reserved.
+
+
+#include "Attribute/TcsAttributeSnapshot.h"
+
+#include "Algo/BinarySearch.h"
+#include "Attribute/TcsAttributeInstance.h"
+
+
+
+int32 FTcsAttributeSnapshot::FindIndex(FName AttributeName) const
+{
+	return Algo::BinarySearch(AttributeNames, AttributeName, FNameFastLess());
+}
+
+bool FTcsAttributeSnapshot::FindCurrentValue(FName AttributeName, float& OutValue) const
+{
+	const int32 Index = FindIndex(AttributeName);
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutValue = CurrentValues[Index];
+	return true;
+}
+
+bool FTcsAttributeSnapshot::FindBaseValue(FName AttributeName, float& OutValue) const
+{
+	const int32 Index = FindIndex(AttributeName);
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutValue = BaseValues[Index];
+	return true;
+}
+
+bool FTcsAttributeSnapshotBuffer::Publish(const TMap<FName, FTcsAttributeInstance>& Attributes, uint64 FrameNumber)
+{
+	check(IsInGameThread());
+
+	if (bHasPublished && LastPublishedFrame == FrameNumber)
+	{
+		return false;
+	}
+
+	// 只有游戏线程会替换 Published，此处读取无需加锁
+	const FTcsAttributeSnapshot* Previous = Published.Get();
+	TSharedRef<FTcsAttributeSnapshot, ESPMode::ThreadSafe> Snapshot = MakeShared<FTcsAttributeSnapshot, ESPMode::ThreadSafe>();
+
+	// 属性集合变化时才重建排序后的属性名列表
+	bool bLayoutValid = Previous && Previous->AttributeNames.Num() == Attributes.Num();
+	if (bLayoutValid)
+	{
+		for (const FName& AttributeName : Previous->AttributeNames)
+		{
+			if (!Attributes.Contains(AttributeName))
+			{
+				bLayoutValid = false;
+				break;
+			}
+		}
+	}
+
+	if (bLayoutValid)
+	{
+		Snapshot->AttributeNames = Previous->AttributeNames;
+	}
+	else
+	{
+		Attributes.GenerateKeyArray(Snapshot->AttributeNames);
+		Snapshot->AttributeNames.Sort(FNameFastLess());
+	}
+
+	const int32 NumAttributes = Snapshot->AttributeNames.Num();
+	Snapshot->CurrentValues.SetNumUninitialized(NumAttributes);
+	Snapshot->BaseValues.SetNumUninitialized(NumAttributes);
+	for (int32 Index = 0; Index < NumAttributes; ++Index)
+	{
+		const FTcsAttributeInstance& Attribute = Attributes.FindChecked(Snapshot->AttributeNames[Index]);
+		Snapshot->CurrentValues[Index] = Attribute.CurrentValue;
+		Snapshot->BaseValues[Index] = Attribute.BaseValue;
+	}
+	Snapshot->FrameNumber = FrameNumber;
+	Snapshot->Generation = ++LastGeneration;
+
+	LastPublishedFrame = FrameNumber;
+	bHasPublished = true;
+
+	// 旧快照由共享指针在最后一个读取方释放后销毁
+	FTcsAttributeSnapshotPtr Retired;
+	{
+		FWriteScopeLock WriteLock(PublishedLock);
+		Retired = MoveTemp(Published);
+		Published = Snapshot;
+	}
+	return true;
+}
+
+void FTcsAttributeSnapshotBuffer::Reset()
+{
+	check(IsInGameThread());
+
+	FTcsAttributeSnapshotPtr Retired;
+	{
+		FWriteScopeLock WriteLock(PublishedLock);
+		Retired = MoveTemp(Published);
+	}
+	bHasPublished = false;
+}
+
+SIZE_T FTcsAttributeSnapshotBuffer::GetAllocatedSize() const
+{
+	check(IsInGameThread());
+
+	return Published.IsValid() ? sizeof(FTcsAttributeSnapshot) + Published->GetAllocatedSize() : 0;
+}
@@ -5,12 +5,16 @@
 
 #include "Attribute/TcsAttributeComponent.h"
 #include "TcsLogChannels.h"
+#include "TcsStats.h"
+#include "TcsDefinitionProfiler.h"
+#include "TcsMemoryReport.h"
 #include "TcsEntityInterface.h"
 #include "State/TcsStateInstance.h"
 #include "State/TcsStateManagerSubsystem.h"
 #include "State/TcsStateSlotDefinition.h"
 #include "Attribute/TcsAttributeManagerSubsystem.h"
 #include "Engine/World.h"
+#include "GameFramework/Pawn.h"
 #include "Engine/DataTable.h"
 #include "StateTree.h"
 #include "StateTreeExecutionTypes.h"
@@ -54,6 +58,12 @@ void UTcsStateComponent::BeginPlay()
 	// 初始化 StateSlot 和 StateTreeState 的映射
 	InitStateSlotMappings();
 
+	// 状态实例缓存了拥有者的控制器，拥有者被重新控制时需要刷新
+	if (APawn* OwnerPawn = Cast<APawn>(GetOwner()))
+	{
+		OwnerPawn->ReceiveControllerChangedDelegate.AddUniqueDynamic(this, &UTcsStateComponent::HandleOwnerControllerChanged);
+	}
+
 	// 各项初始化之后，再执行状态管理StateTree
 	Super::BeginPlay();
 
@@ -65,6 +75,22 @@ void UTcsStateComponent::BeginPlay()
 #endif
 }
 
+void UTcsStateComponent::RefreshStateObjectReferences()
+{
+	for (UTcsStateInstance* StateInstance : StateInstanceIndex.Instances)
+	{
+		if (IsValid(StateInstance))
+		{
+			StateInstance->RefreshObjectReferences();
+		}
+	}
+}
+
+void UTcsStateComponent::HandleOwnerControllerChanged(APawn* Pawn, AController* OldController, AController* NewController)
+{
+	RefreshStateObjectReferences();
+}
+
 UTcsStateManagerSubsystem* UTcsStateComponent::ResolveStateManager()
 {
 	if (!StateMgr)
@@ -101,6 +127,8 @@ UTcsAttributeManagerSubsystem* UTcsStateComponent::ResolveAttributeManager()
 
 void UTcsStateComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+	FTcsStateNotificationBatchScope NotificationBatch(this);
+
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
 	UpdateActiveStateDurations(DeltaTime);
@@ -329,6 +357,10 @@ bool UTcsStateComponent::TryApplyState(
 	int32 StateLevel,
 	const FTcsSourceHandle& ParentSourceHandle)
 {
+	FTcsStateNotificationBatchScope NotificationBatch(this);
+	// 施加期间（含合并、抢占、派生状态）的属性重算合并到最外层作用域结束时执行
+	FTcsAttributeRecalculationScope RecalculationScope(ResolveAttributeManager());
+
 	AActor* OwnerActor = GetOwner();
 	if (!IsValid(OwnerActor) || !IsValid(Instigator) || StateDefId.IsNone())
 	{
@@ -484,15 +516,12 @@ UTcsStateInstance* UTcsStateComponent::CreateStateInstance(
 	UTcsStateInstance* StateInstance = TempStateInstance;
 	StateInstance->SetApplyTimestamp(FDateTime::UtcNow().GetTicks());
 
-	TArray<FPrimaryAssetId> NewCausalityChain = ParentSourceHandle.CausalityChain;
-	if (ParentSourceHandle.IsValid())
-	{
-		NewCausalityChain.Add(StateDef->GetPrimaryAssetId());
-	}
-
 	if (UTcsAttributeManagerSubsystem* LocalAttrMgr = ResolveAttributeManager())
 	{
-		StateInstance->SetSourceHandle(LocalAttrMgr->CreateSourceHandle(NewCausalityChain, Instigator));
+		// 在父来源的因果链节点上追加本定义（O(1)），状态实例持有来源句柄的创建引用，在移除或销毁时释放
+		StateInstance->SetSourceHandle(
+			LocalAttrMgr->CreateDerivedSourceHandle(ParentSourceHandle, StateDef->GetPrimaryAssetId(), Instigator),
+			LocalAttrMgr);
 	}
 	else
 	{
@@ -523,13 +552,20 @@ bool UTcsStateComponent::EvaluateAndApplyStateParameters(
 		return true;
 	}
 
+	TCS_DEFINITION_COST_SCOPE(ParameterEvaluation, StateInstance->GetStateDefId());
+
 	AActor* OwnerActor = GetOwner();
 	bool bAllSuccess = true;
 
+	// 实例的 Schema 来自同一定义时按 Schema 索引直接写入值块（索引顺序与 Parameters → TagParameters 遍历顺序一致）
+	const bool bUseSchemaIndex = StateInstance->GetParamSchema() == &StateDef->GetParameterSchema().Get();
+	int32 NextParamIndex = 0;
+
 	for (const TPair<FName, FTcsStateParameter>& ParamPair : StateDef->Parameters)
 	{
 		const FName& ParamName = ParamPair.Key;
 		const FTcsStateParameter& Param = ParamPair.Value;
+		const int32 ParamIndex = NextParamIndex++;
 
 		switch (Param.ParameterType)
 		{
@@ -558,7 +594,14 @@ bool UTcsStateComponent::EvaluateAndApplyStateParameters(
 					bAllSuccess = false;
 					break;
 				}
-				StateInstance->SetNumericParam(ParamName, ParamValue);
+				if (bUseSchemaIndex)
+				{
+					StateInstance->SetNumericParamByIndex(ParamIndex, ParamValue);
+				}
+				else
+				{
+					StateInstance->SetNumericParam(ParamName, ParamValue);
+				}
 				break;
 			}
 		case ETcsStateParameterType::SPT_Bool:
@@ -586,7 +629,14 @@ bool UTcsStateComponent::EvaluateAndApplyStateParameters(
 					bAllSuccess = false;
 					break;
 				}
-				StateInstance->SetBoolParam(ParamName, ParamValue);
+				if (bUseSchemaIndex)
+				{
+					StateInstance->SetBoolParamByIndex(ParamIndex, ParamValue);
+				}
+				else
+				{
+					StateInstance->SetBoolParam(ParamName, ParamValue);
+				}
 				break;
 			}
 		case ETcsStateParameterType::SPT_Vector:
@@ -614,7 +664,14 @@ bool UTcsStateComponent::EvaluateAndApplyStateParameters(
 					bAllSuccess = false;
 					break;
 				}
-				StateInstance->SetVectorParam(ParamName, ParamValue);
+				if (bUseSchemaIndex)
+				{
+					StateInstance->SetVectorParamByIndex(ParamIndex, ParamValue);
+				}
+				else
+				{
+					StateInstance->SetVectorParam(ParamName, ParamValue);
+				}
 				break;
 			}
 		default:
@@ -631,6 +688,7 @@ bool UTcsStateComponent::EvaluateAndApplyStateParameters(
 		const FGameplayTag& ParamTag = ParamPair.Key;
 		const FTcsStateParameter& Param = ParamPair.Value;
 		const FName ParamName = ParamTag.GetTagName();
+		const int32 ParamIndex = NextParamIndex++;
 
 		switch (Param.ParameterType)
 		{
@@ -659,7 +717,14 @@ bool UTcsStateComponent::EvaluateAndApplyStateParameters(
 					bAllSuccess = false;
 					break;
 				}
-				StateInstance->SetNumericParamByTag(ParamTag, ParamValue);
+				if (bUseSchemaIndex)
+				{
+					StateInstance->SetNumericParamByIndex(ParamIndex, ParamValue);
+				}
+				else
+				{
+					StateInstance->SetNumericParamByTag(ParamTag, ParamValue);
+				}
 				break;
 			}
 		case ETcsStateParameterType::SPT_Bool:
@@ -687,7 +752,14 @@ bool UTcsStateComponent::EvaluateAndApplyStateParameters(
 					bAllSuccess = false;
 					break;
 				}
-				StateInstance->SetBoolParamByTag(ParamTag, ParamValue);
+				if (bUseSchemaIndex)
+				{
+					StateInstance->SetBoolParamByIndex(ParamIndex, ParamValue);
+				}
+				else
+				{
+					StateInstance->SetBoolParamByTag(ParamTag, ParamValue);
+				}
 				break;
 			}
 		case ETcsStateParameterType::SPT_Vector:
@@ -715,7 +787,14 @@ bool UTcsStateComponent::EvaluateAndApplyStateParameters(
 					bAllSuccess = false;
 					break;
 				}
-				StateInstance->SetVectorParamByTag(ParamTag, ParamValue);
+				if (bUseSchemaIndex)
+				{
+					StateInstance->SetVectorParamByIndex(ParamIndex, ParamValue);
+				}
+				else
+				{
+					StateInstance->SetVectorParamByTag(ParamTag, ParamValue);
+				}
 				break;
 			}
 		default:
@@ -732,6 +811,10 @@ bool UTcsStateComponent::EvaluateAndApplyStateParameters(
 
 bool UTcsStateComponent::TryApplyStateInstance(UTcsStateInstance* StateInstance)
 {
+	TCS_SCOPE_CYCLE_COUNTER(STAT_TcsStateApply);
+	FTcsStateNotificationBatchScope NotificationBatch(this);
+	FTcsAttributeRecalculationScope RecalculationScope(ResolveAttributeManager());
+
 	if (!IsValid(StateInstance))
 	{
 		UE_LOG(LogTcsState, Error, TEXT("[%s] StateInstance is invalid."), *FString(__FUNCTION__));
@@ -810,7 +893,12 @@ bool UTcsStateComponent::CheckStateApplyConditions(UTcsStateInstance* StateInsta
 		}
 
 		UTcsStateCondition* Condition = StateDef->ActiveConditions[Index].ConditionClass.GetDefaultObject();
-		if (!Condition->CheckCondition(StateInstance, StateDef->ActiveConditions[Index].Payload))
+		bool bConditionPassed = false;
+		{
+			TCS_DEFINITION_COST_SCOPE(ConditionCheck, StateInstance->GetStateDefId());
+			bConditionPassed = Condition->CheckCondition(StateInstance, StateDef->ActiveConditions[Index].Payload);
+		}
+		if (!bConditionPassed)
 		{
 			return false;
 		}
@@ -834,8 +922,7 @@ void UTcsStateComponent::InitStateSlotMappings()
 		return;
 	}
 
-	Mapping_StateSlotToStateHandle.Empty();
-	Mapping_StateHandleToStateSlot.Empty();
+	StateSlotMapping.Reset();
 
 	const TArray<FName> SlotDefIds = LocalStateMgr->GetAllStateSlotDefNames();
 	for (const FName& SlotDefId : SlotDefIds)
@@ -856,42 +943,11 @@ void UTcsStateComponent::InitStateSlotMappings()
 		return;
 	}
 
-	for (const FName& SlotDefId : SlotDefIds)
+	// 映射按 StateTree 资产构建一次，同一资产的组件共享
+	StateSlotMapping = LocalStateMgr->GetStateTreeSlotMapping(*StateTree);
+	for (const auto& Pair : StateSlotMapping->SlotToStateHandle)
 	{
-		const UTcsStateSlotDefinition* StateSlotDef = LocalStateMgr->GetStateSlotDefinition(SlotDefId);
-		if (!StateSlotDef)
-		{
-			continue;
-		}
-
-		const FGameplayTag StateSlotTag = StateSlotDef->SlotTag;
-		if (StateSlotDef->StateTreeStateName.IsNone())
-		{
-			continue;
-		}
-
-		bool bMapped = false;
-		const TArrayView<const FCompactStateTreeState> States = StateTree->GetStates();
-		for (int32 Index = 0; Index < States.Num(); ++Index)
-		{
-			const FCompactStateTreeState& State = States[Index];
-			if (State.Name == StateSlotDef->StateTreeStateName)
-			{
-				FStateTreeStateHandle Handle(Index);
-				Mapping_StateSlotToStateHandle.Add(StateSlotTag, Handle);
-				Mapping_StateHandleToStateSlot.Add(Handle, StateSlotTag);
-				StateSlotsX.FindOrAdd(StateSlotTag);
-				bMapped = true;
-				break;
-			}
-		}
-
-		UE_LOG(LogTcsState, Log, TEXT("[%s] State Slot [%s] -> StateTree State [%s] %s of %s"),
-			*FString(__FUNCTION__),
-			*StateSlotTag.ToString(),
-			*StateSlotDef->StateTreeStateName.ToString(),
-			bMapped ? TEXT("mapped") : TEXT("not found"),
-			*OwnerActor->GetName());
+		StateSlotsX.FindOrAdd(Pair.Key);
 	}
 }
 
@@ -1081,57 +1137,57 @@ bool UTcsStateComponent::TryAssignStateToStateSlot(UTcsStateInstance* StateInsta
 
 void UTcsStateComponent::RefreshSlotsForStateChange(const TArray<FName>& NewStates, const TArray<FName>& OldStates)
 {
-	UTcsStateManagerSubsystem* LocalStateMgr = ResolveStateManager();
-	if (!LocalStateMgr)
+	if (!StateSlotMapping.IsValid() || StateSlotMapping->StateNameToSlots.IsEmpty())
 	{
 		return;
 	}
 
-	TSet<FName> AddedStates(NewStates);
-	for (const FName& OldState : OldStates)
+	auto RefreshSlotGates = [this](const FName& StateName, bool bShouldOpen)
 	{
-		AddedStates.Remove(OldState);
-	}
-
-	TSet<FName> RemovedStates(OldStates);
-	for (const FName& NewState : NewStates)
-	{
-		RemovedStates.Remove(NewState);
-	}
-
-	for (const auto& Pair : Mapping_StateSlotToStateHandle)
-	{
-		const FGameplayTag SlotTag = Pair.Key;
-		const UTcsStateSlotDefinition* SlotDef = LocalStateMgr->GetStateSlotDefinitionByTag(SlotTag);
-		if (!SlotDef)
+		const auto* SlotTags = StateSlotMapping->StateNameToSlots.Find(StateName);
+		if (!SlotTags)
 		{
-			continue;
+			return;
 		}
 
-		const FName& MappedStateName = SlotDef->StateTreeStateName;
-		bool bShouldOpen = false;
-		if (AddedStates.Contains(MappedStateName))
+		for (const FGameplayTag& SlotTag : *SlotTags)
 		{
-			bShouldOpen = true;
+			if (bShouldOpen != IsSlotGateOpen(SlotTag))
+			{
+				SetSlotGateOpen(SlotTag, bShouldOpen);
+				UE_LOG(LogTcsState, Log,
+					TEXT("[StateTree Event] Slot [%s] gate %s due to StateTree state '%s'"),
+					*SlotTag.ToString(),
+					bShouldOpen ? TEXT("opened") : TEXT("closed"),
+					*StateName.ToString());
+			}
 		}
-		else if (RemovedStates.Contains(MappedStateName))
+	};
+
+	// 此前没有激活状态（首次同步）：按当前激活状态校正全部映射槽的 Gate
+	if (OldStates.IsEmpty())
+	{
+		for (const auto& Pair : StateSlotMapping->StateNameToSlots)
 		{
-			bShouldOpen = false;
+			RefreshSlotGates(Pair.Key, NewStates.Contains(Pair.Key));
 		}
-		else
+		return;
+	}
+
+	// 激活状态列表只包含当前路径上的少量状态，直接线性比较；只刷新退出/进入状态对应的槽
+	for (const FName& OldState : OldStates)
+	{
+		if (!NewStates.Contains(OldState))
 		{
-			bShouldOpen = NewStates.Contains(MappedStateName);
+			RefreshSlotGates(OldState, false);
 		}
+	}
 
-		const bool bWasOpen = IsSlotGateOpen(SlotTag);
-		if (bShouldOpen != bWasOpen)
+	for (const FName& NewState : NewStates)
+	{
+		if (!OldStates.Contains(NewState))
 		{
-			SetSlotGateOpen(SlotTag, bShouldOpen);
-			UE_LOG(LogTcsState, Log,
-				TEXT("[StateTree Event] Slot [%s] gate %s due to StateTree state '%s'"),
-				*SlotTag.ToString(),
-				bShouldOpen ? TEXT("opened") : TEXT("closed"),
-				*MappedStateName.ToString());
+			RefreshSlotGates(NewState, true);
 		}
 	}
 }
@@ -1198,6 +1254,7 @@ void UTcsStateComponent::UpdateStateSlotActivation(FGameplayTag StateSlotTag)
 	}
 
 	{
+		TCS_SCOPE_CYCLE_COUNTER(STAT_TcsStateSlotActivation);
 		TGuardValue<bool> Guard(bIsUpdatingSlotActivation, true);
 
 		if (!StateSlotTag.IsValid())
@@ -1375,29 +1432,30 @@ void UTcsStateComponent::ProcessStateSlotMerging(FTcsStateSlot* StateSlot)
 		return;
 	}
 
-	TMap<FName, TArray<UTcsStateInstance*>> StatesByDefId;
+	// 按状态定义稠密 ID 分组，避免逐个哈希 StateDefId
+	TMap<int32, TArray<UTcsStateInstance*>> StatesByDefIndex;
 	for (UTcsStateInstance* State : StateSlot->States)
 	{
 		if (IsValid(State))
 		{
-			StatesByDefId.FindOrAdd(State->GetStateDefId()).Add(State);
+			StatesByDefIndex.FindOrAdd(State->GetStateDefIndex()).Add(State);
 		}
 	}
 
 	TArray<UTcsStateInstance*> AllMergedStates;
-	TMap<FName, UTcsStateInstance*> MergePrimaryByDefId;
-	for (auto& Pair : StatesByDefId)
+	TMap<int32, UTcsStateInstance*> MergePrimaryByDefIndex;
+	for (auto& Pair : StatesByDefIndex)
 	{
 		TArray<UTcsStateInstance*> MergedGroup;
 		MergeStateGroup(Pair.Value, MergedGroup);
 		AllMergedStates.Append(MergedGroup);
 		if (MergedGroup.Num() > 0 && IsValid(MergedGroup[0]))
 		{
-			MergePrimaryByDefId.Add(Pair.Key, MergedGroup[0]);
+			MergePrimaryByDefIndex.Add(Pair.Key, MergedGroup[0]);
 		}
 	}
 
-	RemoveUnmergedStates(StateSlot, AllMergedStates, MergePrimaryByDefId);
+	RemoveUnmergedStates(StateSlot, AllMergedStates, MergePrimaryByDefIndex);
 }
 
 void UTcsStateComponent::MergeStateGroup(
@@ -1416,7 +1474,7 @@ void UTcsStateComponent::MergeStateGroup(
 		return;
 	}
 
-	const UTcsStateDefinition* StateDef = LocalStateMgr->GetStateDefinition(StatesToMerge[0]->GetStateDefId());
+	const UTcsStateDefinition* StateDef = LocalStateMgr->GetStateDefinitionByIndex(StatesToMerge[0]->GetStateDefIndex());
 	if (!StateDef)
 	{
 		UE_LOG(LogTcsState, Warning, TEXT("[%s] Failed to get state definition for %s"),
@@ -1443,13 +1501,14 @@ void UTcsStateComponent::MergeStateGroup(
 		return;
 	}
 
+	TCS_SCOPE_CYCLE_COUNTER(STAT_TcsStateMergerExecute);
 	Merger->Merge(StatesToMerge, OutMergedStates);
 }
 
 void UTcsStateComponent::RemoveUnmergedStates(
 	FTcsStateSlot* StateSlot,
 	const TArray<UTcsStateInstance*>& MergedStates,
-	const TMap<FName, UTcsStateInstance*>& MergePrimaryByDefId)
+	const TMap<int32, UTcsStateInstance*>& MergePrimaryByDefIndex)
 {
 	if (!StateSlot)
 	{
@@ -1475,7 +1534,7 @@ void UTcsStateComponent::RemoveUnmergedStates(
 		UTcsStateInstance* MergeTarget = nullptr;
 		for (UTcsStateInstance* Candidate : MergedStates)
 		{
-			if (!IsValid(Candidate) || Candidate->GetStateDefId() != State->GetStateDefId())
+			if (!IsValid(Candidate) || Candidate->GetStateDefIndex() != State->GetStateDefIndex())
 			{
 				continue;
 			}
@@ -1494,7 +1553,7 @@ void UTcsStateComponent::RemoveUnmergedStates(
 
 		if (!IsValid(MergeTarget))
 		{
-			if (UTcsStateInstance* const* Primary = MergePrimaryByDefId.Find(State->GetStateDefId()))
+			if (UTcsStateInstance* const* Primary = MergePrimaryByDefIndex.Find(State->GetStateDefIndex()))
 			{
 				MergeTarget = IsValid(*Primary) ? *Primary : nullptr;
 			}
@@ -1767,6 +1826,9 @@ bool UTcsStateComponent::HasActiveStateInSlot(FGameplayTag SlotTag) const
 
 bool UTcsStateComponent::RequestStateRemoval(UTcsStateInstance* StateInstance, FName RemovalReason)
 {
+	FTcsStateNotificationBatchScope NotificationBatch(this);
+	FTcsAttributeRecalculationScope RecalculationScope(ResolveAttributeManager());
+
 	if (!IsValid(StateInstance))
 	{
 		return false;
@@ -1783,6 +1845,8 @@ bool UTcsStateComponent::RequestStateRemoval(UTcsStateInstance* StateInstance, F
 
 bool UTcsStateComponent::RemoveState(UTcsStateInstance* StateInstance)
 {
+	FTcsStateNotificationBatchScope NotificationBatch(this);
+
 	if (!IsValid(StateInstance))
 	{
 		UE_LOG(LogTcsState, Warning, TEXT("[%s] StateInstance is invalid"), *FString(__FUNCTION__));
@@ -1821,6 +1885,10 @@ bool UTcsStateComponent::RemoveState(UTcsStateInstance* StateInstance)
 
 int32 UTcsStateComponent::RemoveStatesByDefId(FName StateDefId, bool bRemoveAll)
 {
+	FTcsStateNotificationBatchScope NotificationBatch(this);
+	// 多个状态移除引起的属性重算只执行一次
+	FTcsAttributeRecalculationScope RecalculationScope(ResolveAttributeManager());
+
 	if (StateDefId.IsNone())
 	{
 		return 0;
@@ -1862,6 +1930,9 @@ int32 UTcsStateComponent::RemoveStatesByDefId(FName StateDefId, bool bRemoveAll)
 
 int32 UTcsStateComponent::RemoveAllStatesInSlot(FGameplayTag SlotTag)
 {
+	FTcsStateNotificationBatchScope NotificationBatch(this);
+	FTcsAttributeRecalculationScope RecalculationScope(ResolveAttributeManager());
+
 	if (!SlotTag.IsValid())
 	{
 		return 0;
@@ -1890,6 +1961,9 @@ int32 UTcsStateComponent::RemoveAllStatesInSlot(FGameplayTag SlotTag)
 
 int32 UTcsStateComponent::RemoveAllStates()
 {
+	FTcsStateNotificationBatchScope NotificationBatch(this);
+	FTcsAttributeRecalculationScope RecalculationScope(ResolveAttributeManager());
+
 	ensureMsgf(!IsInStateTreeUpdateContext(), TEXT("[%s] RemoveAllStates called during StateTree update on %s. Prefer frame-boundary reclaim to avoid overlapping callback teardown."),
 		*FString(__FUNCTION__),
 		*GetPathName());
@@ -2253,6 +2327,7 @@ void UTcsStateComponent::FinalizeStateRemoval(UTcsStateInstance* StateInstance,
 		}
 	}
 
+	StateInstance->ReleaseSourceHandle();
 	StateInstance->MarkPendingGC();
 }
 
@@ -2263,8 +2338,23 @@ void UTcsStateComponent::NotifyStateStageChanged(UTcsStateInstance* StateInstanc
 		return;
 	}
 
+	if (IsBatchingNotifications())
+	{
+		// 同一实例多次阶段变化合并为一次：保留最早的旧阶段与最新的新阶段
+		bool bIsNew = false;
+		FPendingStateNotification& Pending = FindOrAddPendingNotification(
+			EPendingStateNotify::StageChanged, StateInstance, NAME_None, FGameplayTag(), bIsNew);
+		if (bIsNew)
+		{
+			Pending.PreviousStage = PreviousStage;
+		}
+		Pending.NewStage = NewStage;
+		return;
+	}
+
 	if (OnStateStageChanged.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnStateStageChanged.Broadcast(this, StateInstance, PreviousStage, NewStage);
 	}
 }
@@ -2279,8 +2369,19 @@ void UTcsStateComponent::NotifyStateDeactivated(
 		return;
 	}
 
+	if (IsBatchingNotifications())
+	{
+		bool bIsNew = false;
+		FPendingStateNotification& Pending = FindOrAddPendingNotification(
+			EPendingStateNotify::Deactivated, StateInstance, NAME_None, FGameplayTag(), bIsNew);
+		Pending.NewStage = NewStage;
+		Pending.Name = DeactivateReason;
+		return;
+	}
+
 	if (OnStateDeactivated.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnStateDeactivated.Broadcast(this, StateInstance, NewStage, DeactivateReason);
 	}
 }
@@ -2292,8 +2393,22 @@ void UTcsStateComponent::NotifyStateRemoved(UTcsStateInstance* StateInstance, FN
 		return;
 	}
 
+	if (IsBatchingNotifications())
+	{
+		// 同一实例只报告首次移除
+		bool bIsNew = false;
+		FPendingStateNotification& Pending = FindOrAddPendingNotification(
+			EPendingStateNotify::Removed, StateInstance, NAME_None, FGameplayTag(), bIsNew);
+		if (bIsNew)
+		{
+			Pending.Name = RemovalReason;
+		}
+		return;
+	}
+
 	if (OnStateRemoved.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnStateRemoved.Broadcast(this, StateInstance, RemovalReason);
 	}
 }
@@ -2305,8 +2420,22 @@ void UTcsStateComponent::NotifyStateStackChanged(UTcsStateInstance* StateInstanc
 		return;
 	}
 
+	if (IsBatchingNotifications())
+	{
+		bool bIsNew = false;
+		FPendingStateNotification& Pending = FindOrAddPendingNotification(
+			EPendingStateNotify::StackChanged, StateInstance, NAME_None, FGameplayTag(), bIsNew);
+		if (bIsNew)
+		{
+			Pending.OldValue = OldStackCount;
+		}
+		Pending.NewValue = NewStackCount;
+		return;
+	}
+
 	if (OnStateStackChanged.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnStateStackChanged.Broadcast(this, StateInstance, OldStackCount, NewStackCount);
 	}
 }
@@ -2318,8 +2447,22 @@ void UTcsStateComponent::NotifyStateLevelChanged(UTcsStateInstance* StateInstanc
 		return;
 	}
 
+	if (IsBatchingNotifications())
+	{
+		bool bIsNew = false;
+		FPendingStateNotification& Pending = FindOrAddPendingNotification(
+			EPendingStateNotify::LevelChanged, StateInstance, NAME_None, FGameplayTag(), bIsNew);
+		if (bIsNew)
+		{
+			Pending.OldValue = OldLevel;
+		}
+		Pending.NewValue = NewLevel;
+		return;
+	}
+
 	if (OnStateLevelChanged.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnStateLevelChanged.Broadcast(this, StateInstance, OldLevel, NewLevel);
 	}
 }
@@ -2331,8 +2474,18 @@ void UTcsStateComponent::NotifyStateDurationRefreshed(UTcsStateInstance* StateIn
 		return;
 	}
 
+	if (IsBatchingNotifications())
+	{
+		bool bIsNew = false;
+		FPendingStateNotification& Pending = FindOrAddPendingNotification(
+			EPendingStateNotify::DurationRefreshed, StateInstance, NAME_None, FGameplayTag(), bIsNew);
+		Pending.Duration = NewDuration;
+		return;
+	}
+
 	if (OnStateDurationRefreshed.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnStateDurationRefreshed.Broadcast(this, StateInstance, NewDuration);
 	}
 }
@@ -2344,8 +2497,23 @@ void UTcsStateComponent::NotifySlotGateStateChanged(FGameplayTag SlotTag, bool b
 		return;
 	}
 
+	if (IsBatchingNotifications())
+	{
+		// Gate 只在开关真正变化时通知，首次通知前的状态即为其反值；最终回到初始状态时不再广播
+		bool bIsNew = false;
+		FPendingStateNotification& Pending = FindOrAddPendingNotification(
+			EPendingStateNotify::SlotGateStateChanged, nullptr, NAME_None, SlotTag, bIsNew);
+		if (bIsNew)
+		{
+			Pending.bInitialFlag = !bIsOpen;
+		}
+		Pending.bFlag = bIsOpen;
+		return;
+	}
+
 	if (OnSlotGateStateChanged.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnSlotGateStateChanged.Broadcast(this, SlotTag, bIsOpen);
 	}
 }
@@ -2362,8 +2530,19 @@ void UTcsStateComponent::NotifyStateParameterChanged(
 		return;
 	}
 
+	if (IsBatchingNotifications())
+	{
+		bool bIsNew = false;
+		FPendingStateNotification& Pending = FindOrAddPendingNotification(
+			EPendingStateNotify::ParameterChanged, StateInstance, ParameterName, ParameterTag, bIsNew);
+		Pending.KeyType = KeyType;
+		Pending.ParameterType = ParameterType;
+		return;
+	}
+
 	if (OnStateParameterChanged.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnStateParameterChanged.Broadcast(StateInstance, KeyType, ParameterName, ParameterTag, ParameterType);
 	}
 }
@@ -2375,8 +2554,18 @@ void UTcsStateComponent::NotifyStateMerged(UTcsStateInstance* TargetStateInstanc
 		return;
 	}
 
+	if (IsBatchingNotifications())
+	{
+		FPendingStateNotification& Pending = AddPendingNotification(EPendingStateNotify::Merged);
+		Pending.StateInstance = TargetStateInstance;
+		Pending.OtherStateInstance = SourceStateInstance;
+		Pending.NewValue = ResultStackCount;
+		return;
+	}
+
 	if (OnStateMerged.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnStateMerged.Broadcast(this, TargetStateInstance, SourceStateInstance, ResultStackCount);
 	}
 }
@@ -2393,6 +2582,19 @@ void UTcsStateComponent::NotifyStateApplySuccess(
 		return;
 	}
 
+	if (IsBatchingNotifications())
+	{
+		FPendingStateNotification& Pending = AddPendingNotification(EPendingStateNotify::ApplySuccess);
+		Pending.TargetActor = TargetActor;
+		Pending.Name = StateDefId;
+		Pending.StateInstance = CreatedStateInstance;
+		Pending.Tag = TargetSlot;
+		Pending.NewStage = AppliedStage;
+		return;
+	}
+
+	TCS_INC_DWORD_STAT(STAT_TcsStatesApplied);
+
 	const UTcsStateDefinition* StateDef = CreatedStateInstance->GetStateDef();
 	const int32 Priority = StateDef ? StateDef->Priority : 0;
 	const ETcsStateTreeTickPolicy TickPolicy = StateDef ? StateDef->TickPolicy : ETcsStateTreeTickPolicy::ManualOnly;
@@ -2409,6 +2611,7 @@ void UTcsStateComponent::NotifyStateApplySuccess(
 
 	if (OnStateApplySuccess.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnStateApplySuccess.Broadcast(TargetActor, StateDefId, CreatedStateInstance, TargetSlot, AppliedStage);
 	}
 }
@@ -2424,6 +2627,18 @@ void UTcsStateComponent::NotifyStateApplyFailed(
 		return;
 	}
 
+	if (IsBatchingNotifications())
+	{
+		FPendingStateNotification& Pending = AddPendingNotification(EPendingStateNotify::ApplyFailed);
+		Pending.TargetActor = TargetActor;
+		Pending.Name = StateDefId;
+		Pending.FailureReason = FailureReason;
+		Pending.Message = FailureMessage;
+		return;
+	}
+
+	TCS_INC_DWORD_STAT(STAT_TcsStatesRejected);
+
 	UE_LOG(LogTcsState, Verbose, TEXT("[%s] ApplyFailed: Target=%s State=%s Reason=%s Message=%s"),
 		*FString(__FUNCTION__),
 		*TargetActor->GetName(),
@@ -2433,10 +2648,133 @@ void UTcsStateComponent::NotifyStateApplyFailed(
 
 	if (OnStateApplyFailed.IsBound())
 	{
+		TCS_INC_DWORD_STAT(STAT_TcsEventsBroadcast);
 		OnStateApplyFailed.Broadcast(TargetActor, StateDefId, FailureReason, FailureMessage);
 	}
 }
 
+void UTcsStateComponent::BeginNotificationBatch()
+{
+	if (NotificationBatchDepth++ > 0)
+	{
+		return;
+	}
+
+	// 状态变化引起的修改器移除与属性重算事件在同一批次内合并
+	if (AActor* OwnerActor = GetOwner())
+	{
+		if (UTcsAttributeComponent* AttrComp = OwnerActor->FindComponentByClass<UTcsAttributeComponent>())
+		{
+			AttrComp->BeginNotificationBatch();
+			BatchedAttributeComponent = AttrComp;
+		}
+	}
+}
+
+void UTcsStateComponent::EndNotificationBatch()
+{
+	if (!ensureMsgf(NotificationBatchDepth > 0, TEXT("[%s] Unbalanced notification batch"), *FString(__FUNCTION__)))
+	{
+		return;
+	}
+
+	if (--NotificationBatchDepth > 0)
+	{
+		return;
+	}
+
+	// 先广播属性事件，使状态事件的监听者读取到的属性已是最终值
+	if (UTcsAttributeComponent* AttrComp = BatchedAttributeComponent.Get())
+	{
+		BatchedAttributeComponent.Reset();
+		AttrComp->EndNotificationBatch();
+	}
+
+	FlushPendingNotifications();
+}
+
+UTcsStateComponent::FPendingStateNotification& UTcsStateComponent::FindOrAddPendingNotification(
+	EPendingStateNotify Type,
+	UTcsStateInstance* StateInstance,
+	FName Name,
+	FGameplayTag Tag,
+	bool& bOutIsNew)
+{
+	const FPendingStateNotifyKey Key(Type, StateInstance, Name, Tag);
+	if (const int32* PendingIndex = PendingNotificationIndices.Find(Key))
+	{
+		bOutIsNew = false;
+		return PendingNotifications[*PendingIndex];
+	}
+
+	bOutIsNew = true;
+	FPendingStateNotification& Pending = AddPendingNotification(Type);
+	Pending.StateInstance = StateInstance;
+	Pending.Name = Name;
+	Pending.Tag = Tag;
+	PendingNotificationIndices.Add(Key, PendingNotifications.Num() - 1);
+	return Pending;
+}
+
+UTcsStateComponent::FPendingStateNotification& UTcsStateComponent::AddPendingNotification(EPendingStateNotify Type)
+{
+	FPendingStateNotification& Pending = PendingNotifications.AddDefaulted_GetRef();
+	Pending.Type = Type;
+	return Pending;
+}
+
+void UTcsStateComponent::FlushPendingNotifications()
+{
+	// 先取走暂存数据，广播回调中产生的新事件直接派发
+	TArray<FPendingStateNotification> Notifications = MoveTemp(PendingNotifications);
+	PendingNotifications.Reset();
+	PendingNotificationIndices.Reset();
+
+	for (const FPendingStateNotification& Pending : Notifications)
+	{
+		UTcsStateInstance* StateInstance = Pending.StateInstance.Get();
+		switch (Pending.Type)
+		{
+		case EPendingStateNotify::StageChanged:
+			NotifyStateStageChanged(StateInstance, Pending.PreviousStage, Pending.NewStage);
+			break;
+		case EPendingStateNotify::Deactivated:
+			NotifyStateDeactivated(StateInstance, Pending.NewStage, Pending.Name);
+			break;
+		case EPendingStateNotify::Removed:
+			NotifyStateRemoved(StateInstance, Pending.Name);
+			break;
+		case EPendingStateNotify::StackChanged:
+			NotifyStateStackChanged(StateInstance, Pending.OldValue, Pending.NewValue);
+			break;
+		case EPendingStateNotify::LevelChanged:
+			NotifyStateLevelChanged(StateInstance, Pending.OldValue, Pending.NewValue);
+			break;
+		case EPendingStateNotify::DurationRefreshed:
+			NotifyStateDurationRefreshed(StateInstance, Pending.Duration);
+			break;
+		case EPendingStateNotify::SlotGateStateChanged:
+			if (Pending.bFlag != Pending.bInitialFlag)
+			{
+				NotifySlotGateStateChanged(Pending.Tag, Pending.bFlag);
+			}
+			break;
+		case EPendingStateNotify::ParameterChanged:
+			NotifyStateParameterChanged(StateInstance, Pending.KeyType, Pending.Name, Pending.Tag, Pending.ParameterType);
+			break;
+		case EPendingStateNotify::Merged:
+			NotifyStateMerged(StateInstance, Pending.OtherStateInstance.Get(), Pending.NewValue);
+			break;
+		case EPendingStateNotify::ApplySuccess:
+			NotifyStateApplySuccess(Pending.TargetActor.Get(), Pending.Name, StateInstance, Pending.Tag, Pending.NewStage);
+			break;
+		case EPendingStateNotify::ApplyFailed:
+			NotifyStateApplyFailed(Pending.TargetActor.Get(), Pending.Name, Pending.FailureReason, Pending.Message);
+			break;
+		}
+	}
+}
+
 FStateTreeReference UTcsStateComponent::GetStateTreeReference() const
 {
 	return StateTreeRef;
@@ -2762,6 +3100,8 @@ FString UTcsStateComponent::GetStateDebugSnapshot(FName StateDefIdFilter) const
 
 void UTcsStateComponent::SetSlotGateOpen(FGameplayTag SlotTag, bool bOpen)
 {
+	FTcsStateNotificationBatchScope NotificationBatch(this);
+
     FTcsStateSlot* Slot = StateSlotsX.Find(SlotTag);
     if (!Slot)
     {
@@ -2825,6 +3165,8 @@ TArray<FName> UTcsStateComponent::GetCurrentActiveStateTreeStates() const
 
 void UTcsStateComponent::OnStateTreeStateChanged(const FStateTreeExecutionContext& Context)
 {
+	FTcsStateNotificationBatchScope NotificationBatch(this);
+
 	TGuardValue<bool> StateTreeCallbackGuard(bIsInStateTreeCallback, true);
 
 	// 【关键API】从ExecutionContext获取当前激活状态
@@ -2865,3 +3207,199 @@ bool UTcsStateComponent::AreStateNamesEqual(const TArray<FName>& A, const TArray
 
 	return true;
 }
+
+int32 UTcsStateComponent::SendStateTreeEventToStates(FGameplayTag EventTag, const FInstancedStruct& EventPayload)
+{
+	if (!EventTag.IsValid())
+	{
+		UE_LOG(LogTcsState, Warning, TEXT("[%s] Invalid EventTag"), *FString(__FUNCTION__));
+		return 0;
+	}
+
+	// 先收集接收者再投递：事件可能触发状态启停，从而修改监听索引
+	TArray<UTcsStateInstance*, TInlineAllocator<16>> Receivers;
+	auto GatherReceivers = [&Receivers](TArray<TWeakObjectPtr<UTcsStateInstance>>& Listeners)
+	{
+		for (int32 Index = Listeners.Num() - 1; Index >= 0; --Index)
+		{
+			UTcsStateInstance* StateInstance = Listeners[Index].Get();
+			if (!IsValid(StateInstance) || !StateInstance->IsStateTreeRunning())
+			{
+				Listeners.RemoveAtSwap(Index);
+				continue;
+			}
+			Receivers.AddUnique(StateInstance);
+		}
+	};
+
+	GatherReceivers(StateTreeAllEventListeners);
+
+	// 与 StateTree 的事件匹配规则一致：监听父标签的实例也接收子标签事件
+	const FGameplayTagContainer EventTagAndParents = EventTag.GetGameplayTagParents();
+	for (const FGameplayTag& ListenTag : EventTagAndParents)
+	{
+		if (TArray<TWeakObjectPtr<UTcsStateInstance>>* Listeners = StateTreeEventListeners.Find(ListenTag))
+		{
+			GatherReceivers(*Listeners);
+		}
+	}
+
+	if (Receivers.IsEmpty())
+	{
+		return 0;
+	}
+
+	FTcsStateNotificationBatchScope NotificationBatch(this);
+
+	int32 NumReceived = 0;
+	for (UTcsStateInstance* StateInstance : Receivers)
+	{
+		if (IsValid(StateInstance) && StateInstance->IsStateTreeRunning())
+		{
+			StateInstance->SendStateTreeEvent(EventTag, EventPayload);
+			++NumReceived;
+		}
+	}
+
+	return NumReceived;
+}
+
+void UTcsStateComponent::RegisterStateTreeEventListener(UTcsStateInstance* StateInstance)
+{
+	FGameplayTagContainer EventTags;
+	bool bListensToAllEvents = false;
+	if (!GetStateTreeEventListenTags(StateInstance, EventTags, bListensToAllEvents))
+	{
+		return;
+	}
+
+	if (bListensToAllEvents)
+	{
+		StateTreeAllEventListeners.AddUnique(StateInstance);
+		return;
+	}
+
+	for (const FGameplayTag& EventTag : EventTags)
+	{
+		StateTreeEventListeners.FindOrAdd(EventTag).AddUnique(StateInstance);
+	}
+}
+
+void UTcsStateComponent::UnregisterStateTreeEventListener(UTcsStateInstance* StateInstance)
+{
+	FGameplayTagContainer EventTags;
+	bool bListensToAllEvents = false;
+	if (!GetStateTreeEventListenTags(StateInstance, EventTags, bListensToAllEvents))
+	{
+		return;
+	}
+
+	if (bListensToAllEvents)
+	{
+		StateTreeAllEventListeners.RemoveSingleSwap(StateInstance);
+		return;
+	}
+
+	for (const FGameplayTag& EventTag : EventTags)
+	{
+		if (TArray<TWeakObjectPtr<UTcsStateInstance>>* Listeners = StateTreeEventListeners.Find(EventTag))
+		{
+			Listeners->RemoveSingleSwap(StateInstance);
+			if (Listeners->IsEmpty())
+			{
+				StateTreeEventListeners.Remove(EventTag);
+			}
+		}
+	}
+}
+
+bool UTcsStateComponent::GetStateTreeEventListenTags(
+	const UTcsStateInstance* StateInstance,
+	FGameplayTagContainer& OutEventTags,
+	bool& bOutListensToAllEvents)
+{
+	const UTcsStateDefinition* StateDef = IsValid(StateInstance) ? StateInstance->GetStateDef() : nullptr;
+	const UStateTree* StateTree = StateDef ? StateDef->StateTreeRef.GetStateTree() : nullptr;
+	UTcsStateManagerSubsystem* LocalStateMgr = ResolveStateManager();
+	if (!IsValid(StateTree) || !LocalStateMgr)
+	{
+		return false;
+	}
+
+	const TSharedRef<const FTcsStateTreeEventListenInfo> ListenInfo = LocalStateMgr->GetStateTreeEventListenInfo(*StateTree);
+	OutEventTags = ListenInfo->EventTags;
+	OutEventTags.AppendTags(StateDef->StateTreeEventTags);
+	bOutListensToAllEvents = ListenInfo->bListensToAllEvents;
+	return true;
+}
+
+void UTcsStateComponent::CollectMemoryUsage(FTcsMemoryUsage& Usage) const
+{
+	Usage.AddContainer(TEXT("StateComponent.Object"), GetClass()->GetStructureSize());
+
+	// 状态实例索引的四个容器（按槽位/定义分组的容器包含各组内的实例数组）
+	Usage.AddContainer(TEXT("StateComponent.InstanceIndex.Instances"),
+		StateInstanceIndex.Instances.GetAllocatedSize(),
+		StateInstanceIndex.Instances.Num());
+	Usage.AddContainer(TEXT("StateComponent.InstanceIndex.InstancesById"),
+		StateInstanceIndex.InstancesById.GetAllocatedSize(),
+		StateInstanceIndex.InstancesById.Num());
+
+	SIZE_T InstancesByDefIndexBytes = StateInstanceIndex.InstancesByDefIndex.GetAllocatedSize();
+	for (const FTcsStateInstanceArray& InstanceArray : StateInstanceIndex.InstancesByDefIndex)
+	{
+		InstancesByDefIndexBytes += InstanceArray.StateInstances.GetAllocatedSize();
+	}
+	Usage.AddContainer(TEXT("StateComponent.InstanceIndex.InstancesByDefIndex"),
+		InstancesByDefIndexBytes,
+		StateInstanceIndex.InstancesByDefIndex.Num());
+
+	SIZE_T InstancesBySlotBytes = StateInstanceIndex.InstancesBySlot.GetAllocatedSize();
+	for (const TPair<FGameplayTag, FTcsStateInstanceArray>& Pair : StateInstanceIndex.InstancesBySlot)
+	{
+		InstancesBySlotBytes += Pair.Value.StateInstances.GetAllocatedSize();
+	}
+	Usage.AddContainer(TEXT("StateComponent.InstanceIndex.InstancesBySlot"),
+		InstancesBySlotBytes,
+		StateInstanceIndex.InstancesBySlot.Num());
+
+	SIZE_T StateSlotsBytes = StateSlotsX.GetAllocatedSize();
+	for (const TPair<FGameplayTag, FTcsStateSlot>& Pair : StateSlotsX)
+	{
+		StateSlotsBytes += Pair.Value.States.GetAllocatedSize();
+	}
+	Usage.AddContainer(TEXT("StateComponent.StateSlots"), StateSlotsBytes, StateSlotsX.Num());
+
+	Usage.AddContainer(TEXT("StateComponent.SlotActivation"),
+		CachedActiveStateNames.GetAllocatedSize() + PendingSlotActivationUpdates.GetAllocatedSize());
+
+	Usage.AddContainer(TEXT("StateComponent.StateTreeTickScheduler"),
+		StateTreeTickScheduler.RunningInstances.GetAllocatedSize(),
+		StateTreeTickScheduler.RunningInstances.Num());
+
+	Usage.AddContainer(TEXT("StateComponent.DurationTracker"),
+		DurationTracker.RemainingByInstance.GetAllocatedSize(),
+		DurationTracker.RemainingByInstance.Num());
+
+	SIZE_T EventListenersBytes = StateTreeEventListeners.GetAllocatedSize() + StateTreeAllEventListeners.GetAllocatedSize();
+	for (const TPair<FGameplayTag, TArray<TWeakObjectPtr<UTcsStateInstance>>>& Pair : StateTreeEventListeners)
+	{
+		EventListenersBytes += Pair.Value.GetAllocatedSize();
+	}
+	Usage.AddContainer(TEXT("StateComponent.StateTreeEventListeners"), EventListenersBytes);
+
+	SIZE_T PendingNotificationsBytes = PendingNotifications.GetAllocatedSize() + PendingNotificationIndices.GetAllocatedSize();
+	for (const FPendingStateNotification& Pending : PendingNotifications)
+	{
+		PendingNotificationsBytes += Pending.Message.GetAllocatedSize();
+	}
+	Usage.AddContainer(TEXT("StateComponent.PendingNotifications"), PendingNotificationsBytes, PendingNotifications.Num());
+
+	for (const UTcsStateInstance* StateInstance : StateInstanceIndex.Instances)
+	{
+		if (IsValid(StateInstance))
+		{
+			StateInstance->CollectMemoryUsage(Usage);
+		}
+	}
+}
@@ -3,6 +3,7 @@
 
 #include "State/TcsStateContainer.h"
 
+#include "TcsDefinitionId.h"
 #include "TcsLogChannels.h"
 #include "State/TcsStateInstance.h"
 
@@ -37,8 +38,12 @@ void FTcsStateInstanceIndex::AddInstance(UTcsStateInstance* StateInstance)
 	Instances.Add(StateInstance);
 	InstancesById.FindOrAdd(StateInstance->GetInstanceId()) = StateInstance;
 
-	FTcsStateInstanceArray& ByName = InstancesByName.FindOrAdd(StateInstance->GetStateDefId());
-	ByName.StateInstances.Add(StateInstance);
+	const int32 StateDefIndex = StateInstance->GetStateDefIndex();
+	if (StateDefIndex >= InstancesByDefIndex.Num())
+	{
+		InstancesByDefIndex.SetNum(StateDefIndex + 1);
+	}
+	InstancesByDefIndex[StateDefIndex].StateInstances.Add(StateInstance);
 
 	const UTcsStateDefinition* StateDef = StateInstance->GetStateDef();
 	if (StateDef)
@@ -62,13 +67,10 @@ void FTcsStateInstanceIndex::RemoveInstance(UTcsStateInstance* StateInstance)
 	Instances.Remove(StateInstance);
 	InstancesById.Remove(StateInstance->GetInstanceId());
 
-	if (FTcsStateInstanceArray* InstanceArray = InstancesByName.Find(StateInstance->GetStateDefId()))
+	const int32 StateDefIndex = StateInstance->GetStateDefIndex();
+	if (InstancesByDefIndex.IsValidIndex(StateDefIndex))
 	{
-		InstanceArray->StateInstances.Remove(StateInstance);
-		if (InstanceArray->StateInstances.IsEmpty())
-		{
-			InstancesByName.Remove(StateInstance->GetStateDefId());
-		}
+		InstancesByDefIndex[StateDefIndex].StateInstances.Remove(StateInstance);
 	}
 
 	const UTcsStateDefinition* StateDef = StateInstance->GetStateDef();
@@ -106,19 +108,9 @@ void FTcsStateInstanceIndex::RefreshInstances()
 		InstancesById.Remove(Id);
 	}
 
-	TArray<FName> InvalidNames;
-	for (const TPair<FName, FTcsStateInstanceArray>& Pair : InstancesByName)
+	for (FTcsStateInstanceArray& InstanceArray : InstancesByDefIndex)
 	{
-		FTcsStateInstanceArray& InstanceArray = InstancesByName[Pair.Key];
 		RemoveInvalidAndExpired(InstanceArray.StateInstances);
-		if (InstanceArray.StateInstances.IsEmpty())
-		{
-			InvalidNames.Add(Pair.Key);
-		}
-	}
-	for (const FName& Name : InvalidNames)
-	{
-		InstancesByName.Remove(Name);
 	}
 
 	TArray<FGameplayTag> InvalidSlots;
@@ -144,10 +136,16 @@ UTcsStateInstance* FTcsStateInstanceIndex::GetInstanceById(int32 InstanceId) con
 
 bool FTcsStateInstanceIndex::GetInstancesByName(FName StateDefId, TArray<UTcsStateInstance*>& OutInstances) const
 {
-	if (const FTcsStateInstanceArray* Found = InstancesByName.Find(StateDefId))
+	return GetInstancesByDefIndex(FTcsDefinitionIdTable::Find(ETcsDefinitionKind::State, StateDefId), OutInstances);
+}
+
+bool FTcsStateInstanceIndex::GetInstancesByDefIndex(int32 StateDefIndex, TArray<UTcsStateInstance*>& OutInstances) const
+{
+	if (InstancesByDefIndex.IsValidIndex(StateDefIndex))
 	{
-		OutInstances.Empty(Found->StateInstances.Num());
-		for (UTcsStateInstance* State : Found->StateInstances)
+		const FTcsStateInstanceArray& InstanceArray = InstancesByDefIndex[StateDefIndex];
+		OutInstances.Empty(InstanceArray.StateInstances.Num());
+		for (UTcsStateInstance* State : InstanceArray.StateInstances)
 		{
 			if (IsValid(State) && State->GetCurrentStage() != ETcsStateStage::SS_Expired)
 			{
@@ -2,6 +2,9 @@
 
 #include "State/TcsStateDefinition.h"
 
+#include "TcsGenericMacro.h"
+#include "StateTree.h"
+
 #if WITH_EDITOR
 #include "Misc/DataValidation.h"
 #endif
@@ -16,6 +19,167 @@ FPrimaryAssetId UTcsStateDefinition::GetPrimaryAssetId() const
 	return FPrimaryAssetId(PrimaryAssetType, StateDefId);
 }
 
+void UTcsStateDefinition::PostLoad()
+{
+	Super::PostLoad();
+
+	// 只依赖资产自身的数据，可在异步加载线程上执行
+	CompileParameterSchema();
+}
+
+TSharedRef<const FTcsStateParameterSchema> UTcsStateDefinition::GetParameterSchema() const
+{
+	if (ParameterSchema.IsValid())
+	{
+		return ParameterSchema.ToSharedRef();
+	}
+
+	ensureMsgf(false, TEXT("StateDefinition %s has no compiled parameter schema, call CompileParameterSchema after configuring it"),
+		*StateDefId.ToString());
+	return BuildParameterSchema();
+}
+
+bool UTcsStateDefinition::RequiresStateTree() const
+{
+	if (bSkipStateTree)
+	{
+		return false;
+	}
+
+#if WITH_EDITOR
+	return ComputeRequiresStateTree();
+#else
+	if (CachedRequiresStateTree < 0)
+	{
+		CachedRequiresStateTree = ComputeRequiresStateTree() ? 1 : 0;
+	}
+	return CachedRequiresStateTree != 0;
+#endif
+}
+
+bool UTcsStateDefinition::ComputeRequiresStateTree() const
+{
+	const UStateTree* StateTree = StateTreeRef.GetStateTree();
+	if (!IsValid(StateTree))
+	{
+		return false;
+	}
+
+	// 不含任何任务、条件、评估器的 StateTree 运行后没有可观察的效果
+	if (StateTree->GetNodes().Num() > 0)
+	{
+		return true;
+	}
+
+	// 链接状态在运行时进入其他子树或子树资产，链接目标的节点不计入本资产的节点列表
+	for (const FCompactStateTreeState& State : StateTree->GetStates())
+	{
+		if (State.LinkedAsset
+			|| State.Type == EStateTreeStateType::Linked
+			|| State.Type == EStateTreeStateType::LinkedAsset)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void UTcsStateDefinition::CompileParameterSchema()
+{
+	ParameterSchema = BuildParameterSchema();
+}
+
+TSharedRef<const FTcsStateParameterSchema> UTcsStateDefinition::BuildParameterSchema() const
+{
+	TSharedRef<FTcsStateParameterSchema> Schema = MakeShared<FTcsStateParameterSchema>();
+	Schema->Entries.Reserve(Parameters.Num() + TagParameters.Num() + 2);
+
+	// 1. 分配参数索引：Parameters → TagParameters，各自按键名排序
+	//    不依赖 TMap 的遍历顺序，保证同一份配置在编辑、Cook 与加载后编译出相同的索引
+	TArray<FName> ParameterNames;
+	Parameters.GenerateKeyArray(ParameterNames);
+	ParameterNames.Sort(FNameLexicalLess());
+	for (const FName& ParameterName : ParameterNames)
+	{
+		FTcsStateParameterSchema::FEntry& Entry = Schema->Entries.AddDefaulted_GetRef();
+		Entry.ParameterType = Parameters[ParameterName].ParameterType;
+		Entry.KeyType = ETcsStateParameterKeyType::Name;
+		Entry.ParameterName = ParameterName;
+		Schema->NameToIndex[static_cast<int32>(Entry.ParameterType)].Add(ParameterName, Schema->Entries.Num() - 1);
+	}
+
+	TArray<FGameplayTag> ParameterTags;
+	TagParameters.GenerateKeyArray(ParameterTags);
+	ParameterTags.Sort([](const FGameplayTag& A, const FGameplayTag& B)
+	{
+		return A.GetTagName().LexicalLess(B.GetTagName());
+	});
+	for (const FGameplayTag& ParameterTag : ParameterTags)
+	{
+		FTcsStateParameterSchema::FEntry& Entry = Schema->Entries.AddDefaulted_GetRef();
+		Entry.ParameterType = TagParameters[ParameterTag].ParameterType;
+		Entry.KeyType = ETcsStateParameterKeyType::Tag;
+		Entry.ParameterTag = ParameterTag;
+		Schema->TagToIndex[static_cast<int32>(Entry.ParameterType)].Add(ParameterTag, Schema->Entries.Num() - 1);
+	}
+
+	// 2. 内置数值参数：若已在 Parameters 中声明为数值参数则复用，否则追加
+	auto FindOrAddBuiltinNumeric = [&Schema](FName ParameterName)
+	{
+		int32 ParamIndex = Schema->FindIndexByName(ParameterName, ETcsStateParameterType::SPT_Numeric);
+		if (ParamIndex == INDEX_NONE)
+		{
+			FTcsStateParameterSchema::FEntry& Entry = Schema->Entries.AddDefaulted_GetRef();
+			Entry.ParameterType = ETcsStateParameterType::SPT_Numeric;
+			Entry.KeyType = ETcsStateParameterKeyType::Name;
+			Entry.ParameterName = ParameterName;
+			ParamIndex = Schema->Entries.Num() - 1;
+			Schema->NameToIndex[static_cast<int32>(ETcsStateParameterType::SPT_Numeric)].Add(ParameterName, ParamIndex);
+		}
+		return ParamIndex;
+	};
+	Schema->TotalDurationIndex = FindOrAddBuiltinNumeric(Tcs_Generic_Name_TotalDuration);
+	Schema->StackCountIndex = FindOrAddBuiltinNumeric(Tcs_Generic_Name_StackCount);
+
+	// 3. 分配偏移：按对齐要求从大到小排布（Vector → Numeric → Bool），值块内无额外填充
+	int32 BlockSize = 0;
+	auto AssignOffsets = [&Schema, &BlockSize](ETcsStateParameterType ParameterType, int32 ValueSize, int32 ValueAlignment)
+	{
+		BlockSize = Align(BlockSize, ValueAlignment);
+		for (FTcsStateParameterSchema::FEntry& Entry : Schema->Entries)
+		{
+			if (Entry.ParameterType == ParameterType)
+			{
+				Entry.Offset = BlockSize;
+				BlockSize += ValueSize;
+			}
+		}
+	};
+	AssignOffsets(ETcsStateParameterType::SPT_Vector, sizeof(FVector), alignof(FVector));
+	AssignOffsets(ETcsStateParameterType::SPT_Numeric, sizeof(float), alignof(float));
+	AssignOffsets(ETcsStateParameterType::SPT_Bool, sizeof(bool), alignof(bool));
+
+	// 4. 构建默认值块：普通参数零初始化且未赋值，内置参数按定义配置预置
+	Schema->DefaultValueBlock.SetNumZeroed(BlockSize);
+	Schema->DefaultAssignedFlags.Init(false, Schema->Entries.Num());
+
+	if (DurationType == ETcsStateDurationType::SDT_Duration)
+	{
+		const FTcsStateParameterSchema::FEntry& Entry = Schema->Entries[Schema->TotalDurationIndex];
+		*reinterpret_cast<float*>(Schema->DefaultValueBlock.GetData() + Entry.Offset) = Duration;
+		Schema->DefaultAssignedFlags[Schema->TotalDurationIndex] = true;
+	}
+
+	if (MaxStackCount > 0)
+	{
+		const FTcsStateParameterSchema::FEntry& Entry = Schema->Entries[Schema->StackCountIndex];
+		*reinterpret_cast<float*>(Schema->DefaultValueBlock.GetData() + Entry.Offset) = 1.f;
+		Schema->DefaultAssignedFlags[Schema->StackCountIndex] = true;
+	}
+
+	return Schema;
+}
+
 #if WITH_EDITOR
 void UTcsStateDefinition::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
@@ -23,6 +187,12 @@ void UTcsStateDefinition::PostEditChangeProperty(FPropertyChangedEvent& Property
 
 	const FName PropertyName = PropertyChangedEvent.GetPropertyName();
 
+	// 定义 ID 变更后稠密 ID 需重新分配
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UTcsStateDefinition, StateDefId))
+	{
+		CachedDefIndex = INDEX_NONE;
+	}
+
 	// 验证 Duration
 	if (PropertyName == GET_MEMBER_NAME_CHECKED(UTcsStateDefinition, Duration))
 	{
@@ -42,6 +212,9 @@ void UTcsStateDefinition::PostEditChangeProperty(FPropertyChangedEvent& Property
 			MaxStackCount = 1;
 		}
 	}
+
+	// 参数集、持续时间或叠层配置变化都会影响 Schema 布局与默认值块，统一重新编译
+	CompileParameterSchema();
 }
 
 EDataValidationResult UTcsStateDefinition::IsDataValid(FDataValidationContext& Context) const
@@ -93,6 +266,16 @@ EDataValidationResult UTcsStateDefinition::IsDataValid(FDataValidationContext& C
 		Result = EDataValidationResult::Invalid;
 	}
 
+	// 验证 bSkipStateTree
+	if (bSkipStateTree && StateTreeRef.IsValid())
+	{
+		Context.AddWarning(FText::FromString(TEXT("bSkipStateTree is enabled, the assigned StateTree will never run")));
+		if (Result == EDataValidationResult::Valid)
+		{
+			Result = EDataValidationResult::NotValidated;
+		}
+	}
+
 	// 验证 MergerType（如果 MaxStackCount > 1）
 	if (MaxStackCount > 1 && !MergerType)
 	{
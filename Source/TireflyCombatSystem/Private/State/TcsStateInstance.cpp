@@ -3,6 +3,7 @@
 
 #include "State/TcsStateInstance.h"
 
+#include "Attribute/TcsAttributeManagerSubsystem.h"
 #include "State/TcsStateComponent.h"
 #include "State/TcsStateDefinition.h"
 #include "State/TcsStateManagerSubsystem.h"
@@ -15,10 +16,77 @@
 #include "TcsEntityInterface.h"
 #include "TcsGenericMacro.h"
 #include "TcsLogChannels.h"
+#include "TcsStats.h"
+#include "TcsDefinitionProfiler.h"
+#include "TcsMemoryReport.h"
 #include "GameFramework/Actor.h"
 #include "Engine/World.h"
 
 
+namespace TcsStateInstancePrivate
+{
+	// 收集 Schema 中已赋值的参数键 + 动态参数键
+	template <typename KeyType, typename ValueType>
+	TArray<KeyType> CollectParamKeys(
+		const TBitArray<>& AssignedFlags,
+		const TMap<KeyType, int32>* SchemaIndexMap,
+		const TMap<KeyType, ValueType>* DynamicMap)
+	{
+		TArray<KeyType> Keys;
+		if (SchemaIndexMap)
+		{
+			Keys.Reserve(SchemaIndexMap->Num());
+			for (const TPair<KeyType, int32>& Pair : *SchemaIndexMap)
+			{
+				if (AssignedFlags.IsValidIndex(Pair.Value) && AssignedFlags[Pair.Value])
+				{
+					Keys.Add(Pair.Key);
+				}
+			}
+		}
+
+		if (DynamicMap)
+		{
+			for (const TPair<KeyType, ValueType>& Pair : *DynamicMap)
+			{
+				Keys.Add(Pair.Key);
+			}
+		}
+
+		return Keys;
+	}
+
+	// 收集 Schema 中已赋值的参数值 + 动态参数值
+	template <typename KeyType, typename ValueType, typename ReadValueFunc>
+	TMap<KeyType, ValueType> CollectParamValues(
+		const TBitArray<>& AssignedFlags,
+		const TMap<KeyType, int32>* SchemaIndexMap,
+		const TMap<KeyType, ValueType>* DynamicMap,
+		ReadValueFunc&& ReadValue)
+	{
+		TMap<KeyType, ValueType> Values;
+		if (SchemaIndexMap)
+		{
+			Values.Reserve(SchemaIndexMap->Num());
+			for (const TPair<KeyType, int32>& Pair : *SchemaIndexMap)
+			{
+				if (AssignedFlags.IsValidIndex(Pair.Value) && AssignedFlags[Pair.Value])
+				{
+					Values.Add(Pair.Key, ReadValue(Pair.Value));
+				}
+			}
+		}
+
+		if (DynamicMap)
+		{
+			Values.Append(*DynamicMap);
+		}
+
+		return Values;
+	}
+}
+
+
 UTcsStateInstance::UTcsStateInstance()
 {
 }
@@ -40,6 +108,14 @@ UWorld* UTcsStateInstance::GetWorld() const
 	return nullptr;
 }
 
+void UTcsStateInstance::BeginDestroy()
+{
+	// 未经 FinalizeStateRemoval 的实例（例如应用失败被丢弃）在此归还来源引用
+	ReleaseSourceHandle();
+
+	Super::BeginDestroy();
+}
+
 void UTcsStateInstance::Initialize(
 	const UTcsStateDefinition* InStateDef,
 	FName InStateDefId,
@@ -51,19 +127,14 @@ void UTcsStateInstance::Initialize(
 	bInitialized = false;
 
 	Owner = nullptr;
-	OwnerController = nullptr;
-	OwnerStateCmp.Reset();
-	OwnerAttributeCmp.Reset();
-	OwnerSkillCmp.Reset();
-
 	Instigator = nullptr;
-	InstigatorController = nullptr;
-	InstigatorStateCmp.Reset();
-	InstigatorAttributeCmp.Reset();
-	InstigatorSkillCmp.Reset();
+	ResolveObjectReferences();
 
 	StateDef = InStateDef;
 	StateDefId = InStateDefId;
+	StateDefIndex = (InStateDef && InStateDef->StateDefId == InStateDefId)
+		? InStateDef->GetStateDefIndex()
+		: FTcsDefinitionIdTable::FindOrAdd(ETcsDefinitionKind::State, InStateDefId);
 	StateInstanceId = InInstanceId;
 	Level = InLevel;
 
@@ -76,63 +147,83 @@ void UTcsStateInstance::Initialize(
 		return;
 	}
 
-	// 初始化状态Owner和其状态组件、属性组件、技能组件
-	Owner = InOwner;
+	// 初始化状态Owner、Instigator和它们的控制器、状态组件、属性组件、技能组件
 	if (!IsValid(InOwner) || !InOwner->Implements<UTcsEntityInterface>())
 	{
 		UE_LOG(LogTcsState, Error, TEXT("[%s] Owner is invalid"), *FString(__FUNCTION__));
 		return;
 	}
-	OwnerController = Owner->GetInstigatorController();
-	OwnerStateCmp = ITcsEntityInterface::Execute_GetStateComponent(InOwner);
-	OwnerAttributeCmp = ITcsEntityInterface::Execute_GetAttributeComponent(InOwner);
-	OwnerSkillCmp = ITcsEntityInterface::Execute_GetSkillComponent(InOwner);
-
-	if (!OwnerStateCmp.IsValid())
-	{
-		UE_LOG(LogTcsState, Error, TEXT("[%s] Owner %s has no valid StateComponent via TcsEntityInterface"),
-			*FString(__FUNCTION__),
-			*InOwner->GetName());
-		return;
-	}
-
-	// 初始化状态Instigator和其状态组件、属性组件、技能组件
-	Instigator = InInstigator;
 	if (!IsValid(InInstigator) || !InInstigator->Implements<UTcsEntityInterface>())
 	{
 		UE_LOG(LogTcsState, Error, TEXT("[%s] Instigator is invalid"), *FString(__FUNCTION__));
 		return;
 	}
-	InstigatorController = Instigator->GetInstigatorController();
-	InstigatorStateCmp = ITcsEntityInterface::Execute_GetStateComponent(InInstigator);
-	InstigatorAttributeCmp = ITcsEntityInterface::Execute_GetAttributeComponent(InInstigator);
-	InstigatorSkillCmp = ITcsEntityInterface::Execute_GetSkillComponent(InInstigator);
 
-	// 清理参数缓存
-	NumericParameters.Reset();
-	NumericParametersTag.Reset();
-	BoolParameters.Reset();
-	BoolParametersTag.Reset();
-	VectorParameters.Reset();
-	VectorParametersTag.Reset();
+	Owner = InOwner;
+	Instigator = InInstigator;
+	ResolveObjectReferences();
 
-	// 初始化基础数值参数：持续时间
-	if (InStateDef->DurationType == ETcsStateDurationType::SDT_Duration)
-	{
-		NumericParameters.Add(Tcs_Generic_Name_TotalDuration, InStateDef->Duration);
-	}
-	// 初始化基础数值参数：堆叠层数
-	if (InStateDef->MaxStackCount > 0)
+	if (!OwnerStateCmp.IsValid())
 	{
-		NumericParameters.Add(Tcs_Generic_Name_StackCount, 1);
+		UE_LOG(LogTcsState, Error, TEXT("[%s] Owner %s has no valid StateComponent via TcsEntityInterface"),
+			*FString(__FUNCTION__),
+			*InOwner->GetName());
+		return;
 	}
 
+	// 从定义的参数 Schema 整体拷贝默认值块（内置参数 TotalDuration / StackCount 已在 Schema 编译时预置）
+	ParamSchema = InStateDef->GetParameterSchema();
+	ParamValueBlock = ParamSchema->DefaultValueBlock;
+	ParamAssignedFlags = ParamSchema->DefaultAssignedFlags;
+	DynamicParameters.Reset();
+
 	// 参数由 UTcsStateManagerSubsystem::EvaluateAndApplyStateParameters 在创建实例时统一评估并写入，
 	// 此处不再重复调用 InitParameterValues / InitParameterTagValues。
 
 	bInitialized = true;
 }
 
+void UTcsStateInstance::RefreshObjectReferences()
+{
+	ResolveObjectReferences();
+}
+
+void UTcsStateInstance::ResolveObjectReferences()
+{
+	AActor* OwnerActor = Owner.Get();
+	const bool bOwnerIsEntity = OwnerActor && OwnerActor->Implements<UTcsEntityInterface>();
+	OwnerController = OwnerActor ? OwnerActor->GetInstigatorController() : nullptr;
+	OwnerStateCmp = bOwnerIsEntity ? ITcsEntityInterface::Execute_GetStateComponent(OwnerActor) : nullptr;
+	OwnerAttributeCmp = bOwnerIsEntity ? ITcsEntityInterface::Execute_GetAttributeComponent(OwnerActor) : nullptr;
+	OwnerSkillCmp = bOwnerIsEntity ? ITcsEntityInterface::Execute_GetSkillComponent(OwnerActor) : nullptr;
+
+	AActor* InstigatorActor = Instigator.Get();
+	const bool bInstigatorIsEntity = InstigatorActor && InstigatorActor->Implements<UTcsEntityInterface>();
+	InstigatorController = InstigatorActor ? InstigatorActor->GetInstigatorController() : nullptr;
+	InstigatorStateCmp = bInstigatorIsEntity ? ITcsEntityInterface::Execute_GetStateComponent(InstigatorActor) : nullptr;
+	InstigatorAttributeCmp = bInstigatorIsEntity ? ITcsEntityInterface::Execute_GetAttributeComponent(InstigatorActor) : nullptr;
+	InstigatorSkillCmp = bInstigatorIsEntity ? ITcsEntityInterface::Execute_GetSkillComponent(InstigatorActor) : nullptr;
+
+	StateTreeContextCache.Reset();
+}
+
+void UTcsStateInstance::SetSourceHandle(const FTcsSourceHandle& InSourceHandle, UTcsAttributeManagerSubsystem* InSourceHandleOwner)
+{
+	ReleaseSourceHandle();
+
+	SourceHandle = InSourceHandle;
+	SourceHandleOwner = InSourceHandleOwner;
+}
+
+void UTcsStateInstance::ReleaseSourceHandle()
+{
+	if (UTcsAttributeManagerSubsystem* OwnerMgr = SourceHandleOwner.Get())
+	{
+		OwnerMgr->ReleaseSourceHandle(SourceHandle);
+	}
+	SourceHandleOwner.Reset();
+}
+
 bool UTcsStateInstance::SetCurrentStage(ETcsStateStage InStage)
 {
 	// 相同阶段无需处理
@@ -231,7 +322,8 @@ float UTcsStateInstance::GetTotalDuration() const
 	}
 
 	float TotalDuration = StateDef->Duration;
-	if (const float* DurationParam = NumericParameters.Find(Tcs_Generic_Name_TotalDuration))
+	const int32 DurationIndex = ParamSchema.IsValid() ? ParamSchema->TotalDurationIndex : INDEX_NONE;
+	if (const float* DurationParam = FindNumericParamValue(DurationIndex, Tcs_Generic_Name_TotalDuration))
 	{
 		TotalDuration = *DurationParam;
 	}
@@ -252,7 +344,8 @@ bool UTcsStateInstance::CanStack() const
 
 int32 UTcsStateInstance::GetStackCount() const
 {
-	if (const float* StackCount = NumericParameters.Find(Tcs_Generic_Name_StackCount))
+	const int32 StackCountIndex = ParamSchema.IsValid() ? ParamSchema->StackCountIndex : INDEX_NONE;
+	if (const float* StackCount = FindNumericParamValue(StackCountIndex, Tcs_Generic_Name_StackCount))
 	{
 		return *StackCount;
 	}
@@ -295,7 +388,17 @@ void UTcsStateInstance::SetStackCount(int32 InStackCount)
 	    return;
 	}
 
-	*NumericParameters.Find(Tcs_Generic_Name_StackCount) = NewStackCount;
+	// 叠层变化走专用通知，不触发参数变更通知
+	const int32 StackCountIndex = ParamSchema.IsValid() ? ParamSchema->StackCountIndex : INDEX_NONE;
+	if (StackCountIndex != INDEX_NONE)
+	{
+		AccessParamValue<float>(StackCountIndex) = NewStackCount;
+		ParamAssignedFlags[StackCountIndex] = true;
+	}
+	else
+	{
+		GetOrCreateDynamicParameters().NumericParameters.FindOrAdd(Tcs_Generic_Name_StackCount) = NewStackCount;
+	}
 
 	// 通知状态组件叠层变化
 	if (OwnerStateCmp.IsValid())
@@ -535,9 +638,115 @@ void UTcsStateInstance::InitParameterTagValues()
 	}
 }
 
+FTcsStateDynamicParameters& UTcsStateInstance::GetOrCreateDynamicParameters()
+{
+	if (!DynamicParameters.IsValid())
+	{
+		DynamicParameters = MakeUnique<FTcsStateDynamicParameters>();
+	}
+	return *DynamicParameters;
+}
+
+const float* UTcsStateInstance::FindNumericParamValue(int32 ParamIndex, FName ParameterName) const
+{
+	if (ParamIndex != INDEX_NONE)
+	{
+		return IsParamAssigned(ParamIndex) ? &AccessParamValue<float>(ParamIndex) : nullptr;
+	}
+
+	return DynamicParameters.IsValid() ? DynamicParameters->NumericParameters.Find(ParameterName) : nullptr;
+}
+
+void UTcsStateInstance::NotifyParamChangedByIndex(int32 ParamIndex)
+{
+	if (!OwnerStateCmp.IsValid() || Stage == ETcsStateStage::SS_Inactive)
+	{
+		return;
+	}
+
+	const FTcsStateParameterSchema::FEntry& Entry = ParamSchema->Entries[ParamIndex];
+	OwnerStateCmp->NotifyStateParameterChanged(
+		this,
+		Entry.KeyType,
+		Entry.KeyType == ETcsStateParameterKeyType::Name ? Entry.ParameterName : NAME_None,
+		Entry.KeyType == ETcsStateParameterKeyType::Tag ? Entry.ParameterTag : FGameplayTag(),
+		Entry.ParameterType);
+}
+
+void UTcsStateInstance::SetNumericParamByIndex(int32 ParamIndex, float Value)
+{
+	if (!ParamSchema.IsValid() || !ParamSchema->IsValidIndex(ParamIndex, ETcsStateParameterType::SPT_Numeric))
+	{
+		UE_LOG(LogTcsState, Warning, TEXT("[%s] Invalid numeric parameter index %d of state %s"),
+			*FString(__FUNCTION__),
+			ParamIndex,
+			*StateDefId.ToString());
+		return;
+	}
+
+	float& ExistingValue = AccessParamValue<float>(ParamIndex);
+	const bool bValueChanged = !ParamAssignedFlags[ParamIndex] || (ExistingValue != Value);
+
+	ExistingValue = Value;
+	ParamAssignedFlags[ParamIndex] = true;
+
+	// 仅在值发生变化时通知（排除初始化阶段的大量调用）
+	if (bValueChanged)
+	{
+		NotifyParamChangedByIndex(ParamIndex);
+	}
+}
+
+void UTcsStateInstance::SetBoolParamByIndex(int32 ParamIndex, bool Value)
+{
+	if (!ParamSchema.IsValid() || !ParamSchema->IsValidIndex(ParamIndex, ETcsStateParameterType::SPT_Bool))
+	{
+		UE_LOG(LogTcsState, Warning, TEXT("[%s] Invalid bool parameter index %d of state %s"),
+			*FString(__FUNCTION__),
+			ParamIndex,
+			*StateDefId.ToString());
+		return;
+	}
+
+	bool& ExistingValue = AccessParamValue<bool>(ParamIndex);
+	const bool bValueChanged = !ParamAssignedFlags[ParamIndex] || (ExistingValue != Value);
+
+	ExistingValue = Value;
+	ParamAssignedFlags[ParamIndex] = true;
+
+	if (bValueChanged)
+	{
+		NotifyParamChangedByIndex(ParamIndex);
+	}
+}
+
+void UTcsStateInstance::SetVectorParamByIndex(int32 ParamIndex, const FVector& Value)
+{
+	if (!ParamSchema.IsValid() || !ParamSchema->IsValidIndex(ParamIndex, ETcsStateParameterType::SPT_Vector))
+	{
+		UE_LOG(LogTcsState, Warning, TEXT("[%s] Invalid vector parameter index %d of state %s"),
+			*FString(__FUNCTION__),
+			ParamIndex,
+			*StateDefId.ToString());
+		return;
+	}
+
+	FVector& ExistingValue = AccessParamValue<FVector>(ParamIndex);
+	const bool bValueChanged = !ParamAssignedFlags[ParamIndex] || (ExistingValue != Value);
+
+	ExistingValue = Value;
+	ParamAssignedFlags[ParamIndex] = true;
+
+	if (bValueChanged)
+	{
+		NotifyParamChangedByIndex(ParamIndex);
+	}
+}
+
 bool UTcsStateInstance::GetNumericParam(FName ParameterName, float& OutValue) const
 {
-	if (const float* Value = NumericParameters.Find(ParameterName))
+	const int32 ParamIndex = FindParamIndex(ParameterName, ETcsStateParameterType::SPT_Numeric);
+	if (const float* Value = FindNumericParamValue(ParamIndex, ParameterName))
 	{
 		OutValue = *Value;
 		return true;
@@ -547,6 +756,14 @@ bool UTcsStateInstance::GetNumericParam(FName ParameterName, float& OutValue) co
 
 void UTcsStateInstance::SetNumericParam(FName ParameterName, float Value)
 {
+	const int32 ParamIndex = FindParamIndex(ParameterName, ETcsStateParameterType::SPT_Numeric);
+	if (ParamIndex != INDEX_NONE)
+	{
+		SetNumericParamByIndex(ParamIndex, Value);
+		return;
+	}
+
+	TMap<FName, float>& NumericParameters = GetOrCreateDynamicParameters().NumericParameters;
 	float* ExistingValue = NumericParameters.Find(ParameterName);
 	bool bIsNewValue = (ExistingValue == nullptr);
 	bool bValueChanged = bIsNewValue || (*ExistingValue != Value);
@@ -572,7 +789,19 @@ bool UTcsStateInstance::GetNumericParamByTag(FGameplayTag ParameterTag, float& O
 		return false;
 	}
 
-	if (const float* Value = NumericParametersTag.Find(ParameterTag))
+	const int32 ParamIndex = FindParamIndexByTag(ParameterTag, ETcsStateParameterType::SPT_Numeric);
+	if (ParamIndex != INDEX_NONE)
+	{
+		if (!IsParamAssigned(ParamIndex))
+		{
+			return false;
+		}
+
+		OutValue = AccessParamValue<float>(ParamIndex);
+		return true;
+	}
+
+	if (const float* Value = DynamicParameters.IsValid() ? DynamicParameters->NumericParametersTag.Find(ParameterTag) : nullptr)
 	{
 		OutValue = *Value;
 		return true;
@@ -588,6 +817,14 @@ void UTcsStateInstance::SetNumericParamByTag(FGameplayTag ParameterTag, float Va
 		return;
 	}
 
+	const int32 ParamIndex = FindParamIndexByTag(ParameterTag, ETcsStateParameterType::SPT_Numeric);
+	if (ParamIndex != INDEX_NONE)
+	{
+		SetNumericParamByIndex(ParamIndex, Value);
+		return;
+	}
+
+	TMap<FGameplayTag, float>& NumericParametersTag = GetOrCreateDynamicParameters().NumericParametersTag;
 	float* ExistingValue = NumericParametersTag.Find(ParameterTag);
 	bool bIsNewValue = (ExistingValue == nullptr);
 	bool bValueChanged = bIsNewValue || (*ExistingValue != Value);
@@ -607,7 +844,19 @@ void UTcsStateInstance::SetNumericParamByTag(FGameplayTag ParameterTag, float Va
 
 bool UTcsStateInstance::GetBoolParam(FName ParameterName, bool& OutValue) const
 {
-	if (const bool* Value = BoolParameters.Find(ParameterName))
+	const int32 ParamIndex = FindParamIndex(ParameterName, ETcsStateParameterType::SPT_Bool);
+	if (ParamIndex != INDEX_NONE)
+	{
+		if (!IsParamAssigned(ParamIndex))
+		{
+			return false;
+		}
+
+		OutValue = AccessParamValue<bool>(ParamIndex);
+		return true;
+	}
+
+	if (const bool* Value = DynamicParameters.IsValid() ? DynamicParameters->BoolParameters.Find(ParameterName) : nullptr)
 	{
 		OutValue = *Value;
 		return true;
@@ -617,6 +866,14 @@ bool UTcsStateInstance::GetBoolParam(FName ParameterName, bool& OutValue) const
 
 void UTcsStateInstance::SetBoolParam(FName ParameterName, bool Value)
 {
+	const int32 ParamIndex = FindParamIndex(ParameterName, ETcsStateParameterType::SPT_Bool);
+	if (ParamIndex != INDEX_NONE)
+	{
+		SetBoolParamByIndex(ParamIndex, Value);
+		return;
+	}
+
+	TMap<FName, bool>& BoolParameters = GetOrCreateDynamicParameters().BoolParameters;
 	bool* ExistingValue = BoolParameters.Find(ParameterName);
 	bool bIsNewValue = (ExistingValue == nullptr);
 	bool bValueChanged = bIsNewValue || (*ExistingValue != Value);
@@ -642,7 +899,19 @@ bool UTcsStateInstance::GetBoolParamByTag(FGameplayTag ParameterTag, bool& OutVa
 		return false;
 	}
 
-	if (const bool* Value = BoolParametersTag.Find(ParameterTag))
+	const int32 ParamIndex = FindParamIndexByTag(ParameterTag, ETcsStateParameterType::SPT_Bool);
+	if (ParamIndex != INDEX_NONE)
+	{
+		if (!IsParamAssigned(ParamIndex))
+		{
+			return false;
+		}
+
+		OutValue = AccessParamValue<bool>(ParamIndex);
+		return true;
+	}
+
+	if (const bool* Value = DynamicParameters.IsValid() ? DynamicParameters->BoolParametersTag.Find(ParameterTag) : nullptr)
 	{
 		OutValue = *Value;
 		return true;
@@ -658,6 +927,14 @@ void UTcsStateInstance::SetBoolParamByTag(FGameplayTag ParameterTag, bool Value)
 		return;
 	}
 
+	const int32 ParamIndex = FindParamIndexByTag(ParameterTag, ETcsStateParameterType::SPT_Bool);
+	if (ParamIndex != INDEX_NONE)
+	{
+		SetBoolParamByIndex(ParamIndex, Value);
+		return;
+	}
+
+	TMap<FGameplayTag, bool>& BoolParametersTag = GetOrCreateDynamicParameters().BoolParametersTag;
 	bool* ExistingValue = BoolParametersTag.Find(ParameterTag);
 	bool bIsNewValue = (ExistingValue == nullptr);
 	bool bValueChanged = bIsNewValue || (*ExistingValue != Value);
@@ -677,7 +954,19 @@ void UTcsStateInstance::SetBoolParamByTag(FGameplayTag ParameterTag, bool Value)
 
 bool UTcsStateInstance::GetVectorParam(FName ParameterName, FVector& OutValue) const
 {
-	if (const FVector* Value = VectorParameters.Find(ParameterName))
+	const int32 ParamIndex = FindParamIndex(ParameterName, ETcsStateParameterType::SPT_Vector);
+	if (ParamIndex != INDEX_NONE)
+	{
+		if (!IsParamAssigned(ParamIndex))
+		{
+			return false;
+		}
+
+		OutValue = AccessParamValue<FVector>(ParamIndex);
+		return true;
+	}
+
+	if (const FVector* Value = DynamicParameters.IsValid() ? DynamicParameters->VectorParameters.Find(ParameterName) : nullptr)
 	{
 		OutValue = *Value;
 		return true;
@@ -687,6 +976,14 @@ bool UTcsStateInstance::GetVectorParam(FName ParameterName, FVector& OutValue) c
 
 void UTcsStateInstance::SetVectorParam(FName ParameterName, const FVector& Value)
 {
+	const int32 ParamIndex = FindParamIndex(ParameterName, ETcsStateParameterType::SPT_Vector);
+	if (ParamIndex != INDEX_NONE)
+	{
+		SetVectorParamByIndex(ParamIndex, Value);
+		return;
+	}
+
+	TMap<FName, FVector>& VectorParameters = GetOrCreateDynamicParameters().VectorParameters;
 	FVector* ExistingValue = VectorParameters.Find(ParameterName);
 	bool bIsNewValue = (ExistingValue == nullptr);
 	bool bValueChanged = bIsNewValue || (*ExistingValue != Value);
@@ -712,7 +1009,19 @@ bool UTcsStateInstance::GetVectorParamByTag(FGameplayTag ParameterTag, FVector&
 		return false;
 	}
 
-	if (const FVector* Value = VectorParametersTag.Find(ParameterTag))
+	const int32 ParamIndex = FindParamIndexByTag(ParameterTag, ETcsStateParameterType::SPT_Vector);
+	if (ParamIndex != INDEX_NONE)
+	{
+		if (!IsParamAssigned(ParamIndex))
+		{
+			return false;
+		}
+
+		OutValue = AccessParamValue<FVector>(ParamIndex);
+		return true;
+	}
+
+	if (const FVector* Value = DynamicParameters.IsValid() ? DynamicParameters->VectorParametersTag.Find(ParameterTag) : nullptr)
 	{
 		OutValue = *Value;
 		return true;
@@ -728,6 +1037,14 @@ void UTcsStateInstance::SetVectorParamByTag(FGameplayTag ParameterTag, const FVe
 		return;
 	}
 
+	const int32 ParamIndex = FindParamIndexByTag(ParameterTag, ETcsStateParameterType::SPT_Vector);
+	if (ParamIndex != INDEX_NONE)
+	{
+		SetVectorParamByIndex(ParamIndex, Value);
+		return;
+	}
+
+	TMap<FGameplayTag, FVector>& VectorParametersTag = GetOrCreateDynamicParameters().VectorParametersTag;
 	FVector* ExistingValue = VectorParametersTag.Find(ParameterTag);
 	bool bIsNewValue = (ExistingValue == nullptr);
 	bool bValueChanged = bIsNewValue || (*ExistingValue != Value);
@@ -747,44 +1064,116 @@ void UTcsStateInstance::SetVectorParamByTag(FGameplayTag ParameterTag, const FVe
 
 TArray<FName> UTcsStateInstance::GetAllNumericParamNames() const
 {
-	TArray<FName> ParamNames;
-	NumericParameters.GetKeys(ParamNames);
-	return ParamNames;
+	constexpr ETcsStateParameterType Type = ETcsStateParameterType::SPT_Numeric;
+	return TcsStateInstancePrivate::CollectParamKeys(
+		ParamAssignedFlags,
+		ParamSchema.IsValid() ? &ParamSchema->NameToIndex[static_cast<int32>(Type)] : nullptr,
+		DynamicParameters.IsValid() ? &DynamicParameters->NumericParameters : nullptr);
 }
 
 TArray<FGameplayTag> UTcsStateInstance::GetAllNumericParamTags() const
 {
-	TArray<FGameplayTag> ParamTags;
-	NumericParametersTag.GetKeys(ParamTags);
-	return ParamTags;
+	constexpr ETcsStateParameterType Type = ETcsStateParameterType::SPT_Numeric;
+	return TcsStateInstancePrivate::CollectParamKeys(
+		ParamAssignedFlags,
+		ParamSchema.IsValid() ? &ParamSchema->TagToIndex[static_cast<int32>(Type)] : nullptr,
+		DynamicParameters.IsValid() ? &DynamicParameters->NumericParametersTag : nullptr);
 }
 
 TArray<FName> UTcsStateInstance::GetAllBoolParamNames() const
 {
-	TArray<FName> ParamNames;
-	BoolParameters.GetKeys(ParamNames);
-	return ParamNames;
+	constexpr ETcsStateParameterType Type = ETcsStateParameterType::SPT_Bool;
+	return TcsStateInstancePrivate::CollectParamKeys(
+		ParamAssignedFlags,
+		ParamSchema.IsValid() ? &ParamSchema->NameToIndex[static_cast<int32>(Type)] : nullptr,
+		DynamicParameters.IsValid() ? &DynamicParameters->BoolParameters : nullptr);
 }
 
 TArray<FGameplayTag> UTcsStateInstance::GetAllBoolParamTags() const
 {
-	TArray<FGameplayTag> ParamTags;
-	BoolParametersTag.GetKeys(ParamTags);
-	return ParamTags;
+	constexpr ETcsStateParameterType Type = ETcsStateParameterType::SPT_Bool;
+	return TcsStateInstancePrivate::CollectParamKeys(
+		ParamAssignedFlags,
+		ParamSchema.IsValid() ? &ParamSchema->TagToIndex[static_cast<int32>(Type)] : nullptr,
+		DynamicParameters.IsValid() ? &DynamicParameters->BoolParametersTag : nullptr);
 }
 
 TArray<FName> UTcsStateInstance::GetAllVectorParamNames() const
 {
-	TArray<FName> ParamNames;
-	VectorParameters.GetKeys(ParamNames);
-	return ParamNames;
+	constexpr ETcsStateParameterType Type = ETcsStateParameterType::SPT_Vector;
+	return TcsStateInstancePrivate::CollectParamKeys(
+		ParamAssignedFlags,
+		ParamSchema.IsValid() ? &ParamSchema->NameToIndex[static_cast<int32>(Type)] : nullptr,
+		DynamicParameters.IsValid() ? &DynamicParameters->VectorParameters : nullptr);
 }
 
 TArray<FGameplayTag> UTcsStateInstance::GetAllVectorParamTags() const
 {
-	TArray<FGameplayTag> ParamTags;
-	VectorParametersTag.GetKeys(ParamTags);
-	return ParamTags;
+	constexpr ETcsStateParameterType Type = ETcsStateParameterType::SPT_Vector;
+	return TcsStateInstancePrivate::CollectParamKeys(
+		ParamAssignedFlags,
+		ParamSchema.IsValid() ? &ParamSchema->TagToIndex[static_cast<int32>(Type)] : nullptr,
+		DynamicParameters.IsValid() ? &DynamicParameters->VectorParametersTag : nullptr);
+}
+
+TMap<FName, float> UTcsStateInstance::GetNumericParameters() const
+{
+	constexpr ETcsStateParameterType Type = ETcsStateParameterType::SPT_Numeric;
+	return TcsStateInstancePrivate::CollectParamValues(
+		ParamAssignedFlags,
+		ParamSchema.IsValid() ? &ParamSchema->NameToIndex[static_cast<int32>(Type)] : nullptr,
+		DynamicParameters.IsValid() ? &DynamicParameters->NumericParameters : nullptr,
+		[this](int32 ParamIndex) { return AccessParamValue<float>(ParamIndex); });
+}
+
+TMap<FGameplayTag, float> UTcsStateInstance::GetNumericParametersTag() const
+{
+	constexpr ETcsStateParameterType Type = ETcsStateParameterType::SPT_Numeric;
+	return TcsStateInstancePrivate::CollectParamValues(
+		ParamAssignedFlags,
+		ParamSchema.IsValid() ? &ParamSchema->TagToIndex[static_cast<int32>(Type)] : nullptr,
+		DynamicParameters.IsValid() ? &DynamicParameters->NumericParametersTag : nullptr,
+		[this](int32 ParamIndex) { return AccessParamValue<float>(ParamIndex); });
+}
+
+TMap<FName, bool> UTcsStateInstance::GetBoolParameters() const
+{
+	constexpr ETcsStateParameterType Type = ETcsStateParameterType::SPT_Bool;
+	return TcsStateInstancePrivate::CollectParamValues(
+		ParamAssignedFlags,
+		ParamSchema.IsValid() ? &ParamSchema->NameToIndex[static_cast<int32>(Type)] : nullptr,
+		DynamicParameters.IsValid() ? &DynamicParameters->BoolParameters : nullptr,
+		[this](int32 ParamIndex) { return AccessParamValue<bool>(ParamIndex); });
+}
+
+TMap<FGameplayTag, bool> UTcsStateInstance::GetBoolParametersTag() const
+{
+	constexpr ETcsStateParameterType Type = ETcsStateParameterType::SPT_Bool;
+	return TcsStateInstancePrivate::CollectParamValues(
+		ParamAssignedFlags,
+		ParamSchema.IsValid() ? &ParamSchema->TagToIndex[static_cast<int32>(Type)] : nullptr,
+		DynamicParameters.IsValid() ? &DynamicParameters->BoolParametersTag : nullptr,
+		[this](int32 ParamIndex) { return AccessParamValue<bool>(ParamIndex); });
+}
+
+TMap<FName, FVector> UTcsStateInstance::GetVectorParameters() const
+{
+	constexpr ETcsStateParameterType Type = ETcsStateParameterType::SPT_Vector;
+	return TcsStateInstancePrivate::CollectParamValues(
+		ParamAssignedFlags,
+		ParamSchema.IsValid() ? &ParamSchema->NameToIndex[static_cast<int32>(Type)] : nullptr,
+		DynamicParameters.IsValid() ? &DynamicParameters->VectorParameters : nullptr,
+		[this](int32 ParamIndex) { return AccessParamValue<FVector>(ParamIndex); });
+}
+
+TMap<FGameplayTag, FVector> UTcsStateInstance::GetVectorParametersTag() const
+{
+	constexpr ETcsStateParameterType Type = ETcsStateParameterType::SPT_Vector;
+	return TcsStateInstancePrivate::CollectParamValues(
+		ParamAssignedFlags,
+		ParamSchema.IsValid() ? &ParamSchema->TagToIndex[static_cast<int32>(Type)] : nullptr,
+		DynamicParameters.IsValid() ? &DynamicParameters->VectorParametersTag : nullptr,
+		[this](int32 ParamIndex) { return AccessParamValue<FVector>(ParamIndex); });
 }
 
 #if 0 // Removed: InitializeStateTree() was unused; keep code disabled for history.
@@ -830,6 +1219,12 @@ void UTcsStateInstance::StartStateTreeInternal(bool bResetInstanceData)
 		return;
 	}
 
+	// 无逻辑状态不创建 StateTree 实例数据
+	if (!StateDef->RequiresStateTree())
+	{
+		return;
+	}
+
 	const UStateTree* StateTree = StateDef->StateTreeRef.GetStateTree();
 	if (!IsValid(StateTree))
 	{
@@ -846,6 +1241,9 @@ void UTcsStateInstance::StartStateTreeInternal(bool bResetInstanceData)
 		CurrentStateTreeStatus = EStateTreeRunStatus::Unset;
 	}
 
+	// 启动时重新解析上下文数据，之后的 Tick 与事件复用缓存
+	StateTreeContextCache.Reset();
+
 	// 创建执行上下文
 	FStateTreeExecutionContext Context(*this, *StateTree, StateTreeInstanceData);
 
@@ -865,6 +1263,10 @@ void UTcsStateInstance::StartStateTreeInternal(bool bResetInstanceData)
 	if (CurrentStateTreeStatus == EStateTreeRunStatus::Running)
 	{
 		bStateTreeRunning = true;
+		if (OwnerStateCmp.IsValid())
+		{
+			OwnerStateCmp->RegisterStateTreeEventListener(this);
+		}
 		UE_LOG(LogTcsStateTree, Log, TEXT("[%s] StateTree started successfully for StateInstance: %s (Reset: %s)"),
 			*FString(__FUNCTION__),
 			*GetStateDefId().ToString(),
@@ -886,6 +1288,9 @@ void UTcsStateInstance::TickStateTree(float DeltaTime)
 		return;
 	}
 
+	TCS_SCOPE_CYCLE_COUNTER(STAT_TcsStateTreeTick);
+	TCS_DEFINITION_COST_SCOPE(StateTreeTick, StateDefId);
+
 	if (!StateDef)
 	{
 		UE_LOG(LogTcsStateTree, Error, TEXT("[%s] StateDef is invalid for StateInstance: %s"),
@@ -940,6 +1345,12 @@ void UTcsStateInstance::TickStateTree(float DeltaTime)
 			*GetStateDefId().ToString(), (int32)CurrentStateTreeStatus);
 		break;
 	}
+
+	// StateTree 自行结束后不再接收事件
+	if (!bStateTreeRunning && OwnerStateCmp.IsValid())
+	{
+		OwnerStateCmp->UnregisterStateTreeEventListener(this);
+	}
 }
 
 void UTcsStateInstance::StopStateTree()
@@ -979,6 +1390,10 @@ void UTcsStateInstance::StopStateTree()
 	}
 
 	bStateTreeRunning = false;
+	if (OwnerStateCmp.IsValid())
+	{
+		OwnerStateCmp->UnregisterStateTreeEventListener(this);
+	}
 }
 
 void UTcsStateInstance::PauseStateTree()
@@ -1080,8 +1495,34 @@ bool UTcsStateInstance::SetContextRequirements(FStateTreeExecutionContext& Conte
 			&UTcsStateInstance::CollectExternalData
 		)
 	);
-	
-	return UTcsStateTreeSchema_StateInstance::SetContextRequirements(*this, Context);
+
+	// 缓存有效时直接写入已解析的上下文数据
+	const UStateTree* StateTree = Context.GetStateTree();
+	if (StateTreeContextCache.IsValidFor(StateTree, *this))
+	{
+		for (const TPair<FName, FStateTreeDataView>& Pair : StateTreeContextCache.ContextData)
+		{
+			Context.SetContextDataByName(Pair.Key, Pair.Value);
+		}
+		return Context.AreContextDataViewsValid();
+	}
+
+	StateTreeContextCache.Reset();
+	TArray<TPair<FName, FStateTreeDataView>> ContextData;
+	if (!UTcsStateTreeSchema_StateInstance::SetContextRequirements(*this, Context, true, &ContextData))
+	{
+		return false;
+	}
+
+	StateTreeContextCache.StateTree = StateTree;
+	StateTreeContextCache.OwnerController = OwnerController;
+	StateTreeContextCache.InstigatorController = InstigatorController;
+	StateTreeContextCache.ContextData = MoveTemp(ContextData);
+	for (const TPair<FName, FStateTreeDataView>& Pair : StateTreeContextCache.ContextData)
+	{
+		StateTreeContextCache.AddReferencedObject(Pair.Value);
+	}
+	return true;
 }
 
 bool UTcsStateInstance::CollectExternalData(
@@ -1090,12 +1531,122 @@ bool UTcsStateInstance::CollectExternalData(
 	TArrayView<const FStateTreeExternalDataDesc> ExternalDataDescs, 
 	TArrayView<FStateTreeDataView> OutDataViews)
 {
-	return UTcsStateTreeSchema_StateInstance::CollectExternalData(
+	// 缓存有效时复用已解析的外部数据（缓存有效性在 SetContextRequirements 中已校验）
+	if (StateTreeContextCache.StateTree)
+	{
+		for (const TPair<const UStateTree*, TArray<FStateTreeDataView>>& Entry : StateTreeContextCache.ExternalData)
+		{
+			if (Entry.Key == StateTree && Entry.Value.Num() == OutDataViews.Num())
+			{
+				for (int32 Index = 0; Index < OutDataViews.Num(); ++Index)
+				{
+					OutDataViews[Index] = Entry.Value[Index];
+				}
+				return true;
+			}
+		}
+	}
+
+	const bool bCollected = UTcsStateTreeSchema_StateInstance::CollectExternalData(
 		Context,
 		StateTree,
 		this,
 		ExternalDataDescs,
 		OutDataViews);
+
+	if (bCollected && StateTreeContextCache.StateTree)
+	{
+		StateTreeContextCache.ExternalData.Emplace(StateTree, TArray<FStateTreeDataView>(OutDataViews.GetData(), OutDataViews.Num()));
+		for (const FStateTreeDataView& DataView : OutDataViews)
+		{
+			StateTreeContextCache.AddReferencedObject(DataView);
+		}
+	}
+
+	return bCollected;
+}
+
+void UTcsStateInstance::FStateTreeContextCache::Reset()
+{
+	StateTree = nullptr;
+	OwnerController.Reset();
+	InstigatorController.Reset();
+	ContextData.Reset();
+	ExternalData.Reset();
+	ReferencedObjects.Reset();
+}
+
+void UTcsStateInstance::FStateTreeContextCache::AddReferencedObject(const FStateTreeDataView& DataView)
+{
+	// 只有 UObject 数据需要跟踪生命周期；为空的可选视图照常缓存，之后出现的控制器由 IsValidFor 的控制器比较发现
+	if (Cast<UClass>(DataView.GetStruct()) && DataView.GetMemory())
+	{
+		ReferencedObjects.AddUnique(reinterpret_cast<const UObject*>(DataView.GetMemory()));
+	}
+}
+
+bool UTcsStateInstance::FStateTreeContextCache::IsValidFor(const UStateTree* InStateTree, const UTcsStateInstance& StateInstance) const
+{
+	if (!StateTree || StateTree != InStateTree)
+	{
+		return false;
+	}
+
+	// 控制器变化但未收到刷新通知（例如非 Pawn 拥有者、解析时尚未被控制）时，缓存的控制器视图已过期
+	const AActor* OwnerActor = StateInstance.Owner.Get();
+	const AActor* InstigatorActor = StateInstance.Instigator.Get();
+	if (OwnerController.Get() != (OwnerActor ? OwnerActor->GetInstigatorController() : nullptr)
+		|| InstigatorController.Get() != (InstigatorActor ? InstigatorActor->GetInstigatorController() : nullptr))
+	{
+		return false;
+	}
+
+	for (const TWeakObjectPtr<const UObject>& ReferencedObject : ReferencedObjects)
+	{
+		if (!ReferencedObject.IsValid())
+		{
+			return false;
+		}
+	}
+	return true;
 }
 
+void UTcsStateInstance::CollectMemoryUsage(FTcsMemoryUsage& Usage) const
+{
+	const int64 BytesBefore = Usage.TotalBytes;
+
+	Usage.AddContainer(TEXT("StateInstance.Object"), GetClass()->GetStructureSize());
 
+	// 参数 Schema 与状态定义共享，不计入实例
+	Usage.AddContainer(TEXT("StateInstance.ParamValueBlock"),
+		ParamValueBlock.GetAllocatedSize() + ParamAssignedFlags.GetAllocatedSize());
+
+	if (DynamicParameters.IsValid())
+	{
+		const FTcsStateDynamicParameters& Params = *DynamicParameters;
+		Usage.AddContainer(TEXT("StateInstance.DynamicParameters"),
+			sizeof(FTcsStateDynamicParameters)
+				+ Params.NumericParameters.GetAllocatedSize()
+				+ Params.NumericParametersTag.GetAllocatedSize()
+				+ Params.BoolParameters.GetAllocatedSize()
+				+ Params.BoolParametersTag.GetAllocatedSize()
+				+ Params.VectorParameters.GetAllocatedSize()
+				+ Params.VectorParametersTag.GetAllocatedSize(),
+			Params.NumericParameters.Num() + Params.NumericParametersTag.Num()
+				+ Params.BoolParameters.Num() + Params.BoolParametersTag.Num()
+				+ Params.VectorParameters.Num() + Params.VectorParametersTag.Num());
+	}
+
+	Usage.AddContainer(TEXT("StateInstance.StateTreeInstanceData"), StateTreeInstanceData.GetEstimatedMemoryUsage());
+
+	SIZE_T ContextCacheBytes = StateTreeContextCache.ContextData.GetAllocatedSize()
+		+ StateTreeContextCache.ExternalData.GetAllocatedSize()
+		+ StateTreeContextCache.ReferencedObjects.GetAllocatedSize();
+	for (const TPair<const UStateTree*, TArray<FStateTreeDataView>>& Pair : StateTreeContextCache.ExternalData)
+	{
+		ContextCacheBytes += Pair.Value.GetAllocatedSize();
+	}
+	Usage.AddContainer(TEXT("StateInstance.StateTreeContextCache"), ContextCacheBytes);
+
+	Usage.AddStateDefinition(StateDefId, Usage.TotalBytes - BytesBefore);
+}
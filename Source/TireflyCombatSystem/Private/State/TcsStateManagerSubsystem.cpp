@@ -3,20 +3,22 @@
 
 #include "State/TcsStateManagerSubsystem.h"
 
+#include "TcsDefinitionId.h"
 #include "TcsDefinitionRegistrySubsystem.h"
 #include "TcsDeveloperSettings.h"
 #include "TcsGenericLibrary.h"
 #include "TcsLogChannels.h"
+#include "Attribute/TcsAttributeManagerSubsystem.h"
 #include "State/TcsStateComponent.h"
 #include "State/TcsStateDefinition.h"
 #include "State/TcsStateSlotDefinition.h"
+#include "Engine/AssetManager.h"
+#include "Engine/GameInstance.h"
+#include "Engine/StreamableManager.h"
 
 #if WITH_EDITOR
 #include "Engine/Engine.h"
-#endif
-
-#if !WITH_EDITOR
-#include "Engine/AssetManager.h"
+#include "StateTreeDelegates.h"
 #endif
 
 
@@ -33,13 +35,28 @@ void UTcsStateManagerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 			this,
 			&UTcsStateManagerSubsystem::HandleDefinitionRegistryRefreshed);
 	}
+
+	StateTreePostCompileHandle = UE::StateTree::Delegates::OnPostCompile.AddUObject(
+		this,
+		&UTcsStateManagerSubsystem::HandleStateTreePostCompile);
 #else
 	LoadFromAssetManager();
 #endif
+
+	PublishNetworkStateDefinitionIds();
 }
 
 void UTcsStateManagerSubsystem::Deinitialize()
 {
+	for (const TPair<FName, TSharedPtr<FStreamableHandle>>& Pair : StateDefinitionStreamingHandles)
+	{
+		if (Pair.Value.IsValid() && Pair.Value->IsLoadingInProgress())
+		{
+			Pair.Value->CancelHandle();
+		}
+	}
+	StateDefinitionStreamingHandles.Empty();
+
 #if WITH_EDITOR
 	if (DefinitionRegistryRefreshedHandle.IsValid())
 	{
@@ -50,8 +67,14 @@ void UTcsStateManagerSubsystem::Deinitialize()
 
 		DefinitionRegistryRefreshedHandle.Reset();
 	}
+
+	UE::StateTree::Delegates::OnPostCompile.Remove(StateTreePostCompileHandle);
+	StateTreePostCompileHandle.Reset();
 #endif
 
+	StateTreeEventListenInfos.Empty();
+	StateTreeSlotMappings.Empty();
+
 	Super::Deinitialize();
 }
 
@@ -66,6 +89,7 @@ void UTcsStateManagerSubsystem::LoadFromDeveloperSettings()
 	}
 
 	StateSlotDefinitions.Empty();
+	StateTreeSlotMappings.Empty();
 	for (const auto& Pair : Settings->GetCachedStateSlotDefinitions())
 	{
 		const UTcsStateSlotDefinition* Asset = Pair.Value.LoadSynchronous();
@@ -88,8 +112,10 @@ void UTcsStateManagerSubsystem::LoadFromDeveloperSettings()
 	}
 
 	const ETcsStateLoadingStrategy LoadingStrategy = Settings->StateLoadingStrategy;
-	StateDefinitions.Empty();
+	ResetStateDefinitionCache();
 	StateTagToDefId.Empty();
+	UnloadedStateTagIndex.Empty();
+	bUnloadedStateTagIndexBuilt = false;
 
 	switch (LoadingStrategy)
 	{
@@ -151,6 +177,7 @@ void UTcsStateManagerSubsystem::LoadFromDefinitionRegistry()
 	}
 
 	StateSlotDefinitions.Empty();
+	StateTreeSlotMappings.Empty();
 	for (const auto& Pair : *StateSlotSourceCache)
 	{
 		const UTcsStateSlotDefinition* Asset = Pair.Value.LoadSynchronous();
@@ -173,8 +200,10 @@ void UTcsStateManagerSubsystem::LoadFromDefinitionRegistry()
 	}
 
 	const ETcsStateLoadingStrategy LoadingStrategy = Settings->StateLoadingStrategy;
-	StateDefinitions.Empty();
+	ResetStateDefinitionCache();
 	StateTagToDefId.Empty();
+	UnloadedStateTagIndex.Empty();
+	bUnloadedStateTagIndexBuilt = false;
 
 	switch (LoadingStrategy)
 	{
@@ -232,7 +261,7 @@ void UTcsStateManagerSubsystem::PreloadAllStates()
 		const UTcsStateDefinition* Asset = Pair.Value.LoadSynchronous();
 		if (Asset)
 		{
-			StateDefinitions.Add(DefId, Asset);
+			CacheStateDefinition(DefId, Asset);
 
 			if (Asset->StateTag.IsValid())
 			{
@@ -291,7 +320,7 @@ void UTcsStateManagerSubsystem::PreloadCommonStates()
 			continue;
 		}
 
-		StateDefinitions.Add(DefId, Asset);
+		CacheStateDefinition(DefId, Asset);
 		if (Asset->StateTag.IsValid())
 		{
 			if (StateTagToDefId.Contains(Asset->StateTag))
@@ -360,7 +389,7 @@ void UTcsStateManagerSubsystem::PreloadCommonStates()
 			continue;
 		}
 
-		StateDefinitions.Add(DefId, Asset);
+		CacheStateDefinition(DefId, Asset);
 		if (Asset->StateTag.IsValid())
 		{
 			if (StateTagToDefId.Contains(Asset->StateTag))
@@ -392,32 +421,21 @@ const UTcsStateDefinition* UTcsStateManagerSubsystem::LoadStateOnDemand(FName St
 		return *AssetPtr;
 	}
 
-	const UTcsDeveloperSettings* Settings = GetDefault<UTcsDeveloperSettings>();
-	if (!Settings)
+	const FSoftObjectPath AssetPath = ResolveStateDefinitionPath(StateDefId);
+	if (!AssetPath.IsNull())
 	{
-		return nullptr;
-	}
-
-	const TMap<FName, TSoftObjectPtr<UTcsStateDefinition>>* StateSourceCache = nullptr;
-#if WITH_EDITOR
-	StateSourceCache = GetStateDefinitionSourceCache();
-#endif
-
-	if (!StateSourceCache)
-	{
-		StateSourceCache = &Settings->GetCachedStateDefinitions();
-	}
+		// 已在内存中（已被异步预取或被其他系统引用）时无需读盘
+		const UTcsStateDefinition* Asset = Cast<UTcsStateDefinition>(AssetPath.ResolveObject());
+		if (!Asset)
+		{
+			const double LoadStartTime = FPlatformTime::Seconds();
+			Asset = Cast<UTcsStateDefinition>(AssetPath.TryLoad());
+			RecordSyncLoadHitch(StateDefId, FPlatformTime::Seconds() - LoadStartTime);
+		}
 
-	if (const TSoftObjectPtr<UTcsStateDefinition>* AssetPtr = StateSourceCache->Find(StateDefId))
-	{
-		const UTcsStateDefinition* Asset = AssetPtr->LoadSynchronous();
 		if (Asset)
 		{
-			StateDefinitions.Add(StateDefId, Asset);
-			if (Asset->StateTag.IsValid() && !StateTagToDefId.Contains(Asset->StateTag))
-			{
-				StateTagToDefId.Add(Asset->StateTag, StateDefId);
-			}
+			RegisterLoadedStateDefinition(StateDefId, Asset);
 
 			UE_LOG(LogTcsState, Verbose, TEXT("[%s] Loaded State on demand: %s"),
 				*FString(__FUNCTION__),
@@ -432,6 +450,70 @@ const UTcsStateDefinition* UTcsStateManagerSubsystem::LoadStateOnDemand(FName St
 	return nullptr;
 }
 
+void UTcsStateManagerSubsystem::PublishNetworkStateDefinitionIds()
+{
+	TArray<FName> StateDefIds;
+
+#if WITH_EDITOR
+	if (const TMap<FName, TSoftObjectPtr<UTcsStateDefinition>>* SourceCache = GetStateDefinitionSourceCache())
+	{
+		SourceCache->GetKeys(StateDefIds);
+	}
+#else
+	TArray<FPrimaryAssetId> AssetIds;
+	UAssetManager::Get().GetPrimaryAssetIdList(UTcsStateDefinition::PrimaryAssetType, AssetIds);
+	StateDefIds.Reserve(AssetIds.Num());
+	for (const FPrimaryAssetId& AssetId : AssetIds)
+	{
+		StateDefIds.Add(AssetId.PrimaryAssetName);
+	}
+#endif
+
+	FTcsDefinitionIdTable::SetNetworkDefinitionIds(ETcsDefinitionKind::State, MoveTemp(StateDefIds));
+}
+
+void UTcsStateManagerSubsystem::CacheStateDefinition(FName StateDefId, const UTcsStateDefinition* Asset)
+{
+	StateDefinitions.Add(StateDefId, Asset);
+
+	const int32 StateDefIndex = (Asset && Asset->StateDefId == StateDefId)
+		? Asset->GetStateDefIndex()
+		: FTcsDefinitionIdTable::FindOrAdd(ETcsDefinitionKind::State, StateDefId);
+	if (StateDefIndex != INDEX_NONE)
+	{
+		if (StateDefIndex >= StateDefinitionsByIndex.Num())
+		{
+			StateDefinitionsByIndex.SetNumZeroed(StateDefIndex + 1);
+		}
+		StateDefinitionsByIndex[StateDefIndex] = Asset;
+	}
+}
+
+void UTcsStateManagerSubsystem::UncacheStateDefinition(FName StateDefId)
+{
+	StateDefinitions.Remove(StateDefId);
+
+	const int32 StateDefIndex = FTcsDefinitionIdTable::Find(ETcsDefinitionKind::State, StateDefId);
+	if (StateDefinitionsByIndex.IsValidIndex(StateDefIndex))
+	{
+		StateDefinitionsByIndex[StateDefIndex] = nullptr;
+	}
+
+	for (auto It = StateTagToDefId.CreateIterator(); It; ++It)
+	{
+		if (It->Value == StateDefId)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UTcsStateManagerSubsystem::ResetStateDefinitionCache(int32 ExpectedNum)
+{
+	StateDefinitions.Empty(ExpectedNum);
+	StateDefinitionsByIndex.Reset(FTcsDefinitionIdTable::Num(ETcsDefinitionKind::State));
+}
+
 const UTcsStateDefinition* UTcsStateManagerSubsystem::GetStateDefinition(FName DefId)
 {
 	if (const UTcsStateDefinition* const* AssetPtr = StateDefinitions.Find(DefId))
@@ -452,38 +534,28 @@ const UTcsStateDefinition* UTcsStateManagerSubsystem::GetStateDefinition(FName D
 	return nullptr;
 }
 
-const UTcsStateDefinition* UTcsStateManagerSubsystem::GetStateDefinitionByTag(FGameplayTag StateTag)
+const UTcsStateDefinition* UTcsStateManagerSubsystem::GetStateDefinitionByIndex(int32 StateDefIndex)
 {
-	if (const FName* DefId = StateTagToDefId.Find(StateTag))
+	if (StateDefinitionsByIndex.IsValidIndex(StateDefIndex))
 	{
-		return GetStateDefinition(*DefId);
-	}
-
-	const UTcsDeveloperSettings* Settings = GetDefault<UTcsDeveloperSettings>();
-	if (Settings && (Settings->StateLoadingStrategy == ETcsStateLoadingStrategy::OnDemand ||
-		Settings->StateLoadingStrategy == ETcsStateLoadingStrategy::Hybrid))
-	{
-		const TMap<FName, TSoftObjectPtr<UTcsStateDefinition>>* StateSourceCache = nullptr;
-#if WITH_EDITOR
-		StateSourceCache = GetStateDefinitionSourceCache();
-#endif
-
-		if (!StateSourceCache)
+		if (const UTcsStateDefinition* Asset = StateDefinitionsByIndex[StateDefIndex])
 		{
-			StateSourceCache = &Settings->GetCachedStateDefinitions();
+			return Asset;
 		}
+	}
 
-		for (const auto& Pair : *StateSourceCache)
-		{
-			const FName& DefId = Pair.Key;
-			const UTcsStateDefinition* Asset = LoadStateOnDemand(DefId);
-			if (Asset && Asset->StateTag == StateTag)
-			{
-				return Asset;
-			}
-		}
+	return GetStateDefinition(FTcsDefinitionIdTable::GetDefinitionId(ETcsDefinitionKind::State, StateDefIndex));
+}
+
+const UTcsStateDefinition* UTcsStateManagerSubsystem::GetStateDefinitionByTag(FGameplayTag StateTag)
+{
+	FName ResolvedDefId;
+	if (ResolveStateDefIdByTag(StateTag, ResolvedDefId))
+	{
+		return GetStateDefinition(ResolvedDefId);
 	}
 
+	// 标签索引未命中：不逐个加载全部定义去匹配标签（资产需重新保存以写入 AssetRegistry 的 StateTag 标签）
 	UE_LOG(LogTcsState, Warning, TEXT("[%s] StateDefinition not found by tag: %s"),
 		*FString(__FUNCTION__),
 		*StateTag.ToString());
@@ -496,9 +568,92 @@ UTcsDefinitionRegistrySubsystem* UTcsStateManagerSubsystem::GetDefinitionRegistr
 	return GEngine ? GEngine->GetEngineSubsystem<UTcsDefinitionRegistrySubsystem>() : nullptr;
 }
 
-void UTcsStateManagerSubsystem::HandleDefinitionRegistryRefreshed(const UTcsDefinitionRegistrySubsystem* Registry)
+void UTcsStateManagerSubsystem::HandleDefinitionRegistryRefreshed(
+	const UTcsDefinitionRegistrySubsystem* Registry,
+	const FTcsDefinitionChangeSet& ChangeSet)
 {
-	LoadFromDefinitionRegistry();
+	if (!Registry || ChangeSet.bIsFullRefresh)
+	{
+		LoadFromDefinitionRegistry();
+		PublishNetworkStateDefinitionIds();
+		return;
+	}
+
+	// 状态槽定义：只移除/重新加载变更集中列出的条目；槽映射依赖全部槽定义，有变更时整体重建
+	if (ChangeSet.HasChanges(ETcsDefinitionKind::StateSlot))
+	{
+		StateTreeSlotMappings.Empty();
+	}
+
+	for (const FName& SlotDefId : ChangeSet.GetRemoved(ETcsDefinitionKind::StateSlot))
+	{
+		StateSlotDefinitions.Remove(SlotDefId);
+	}
+
+	for (const FName& SlotDefId : ChangeSet.GetChanged(ETcsDefinitionKind::StateSlot))
+	{
+		const TSoftObjectPtr<UTcsStateSlotDefinition>* AssetPtr = Registry->GetStateSlotDefinitions().Find(SlotDefId);
+		const UTcsStateSlotDefinition* Asset = AssetPtr ? AssetPtr->LoadSynchronous() : nullptr;
+		if (Asset)
+		{
+			StateSlotDefinitions.Add(SlotDefId, Asset);
+		}
+		else
+		{
+			StateSlotDefinitions.Remove(SlotDefId);
+			UE_LOG(LogTcsState, Warning, TEXT("[%s] Failed to load StateSlotDefinition: %s"),
+				*FString(__FUNCTION__),
+				*SlotDefId.ToString());
+		}
+	}
+
+	if (!ChangeSet.HasChanges(ETcsDefinitionKind::State))
+	{
+		return;
+	}
+
+	PublishNetworkStateDefinitionIds();
+
+	// 状态定义：已加载的条目就地重新加载；未加载的条目保持按需加载，PreloadAll 策略下新增条目直接加载
+	const UTcsDeveloperSettings* Settings = GetDefault<UTcsDeveloperSettings>();
+	const bool bPreloadAll = Settings && Settings->StateLoadingStrategy == ETcsStateLoadingStrategy::PreloadAll;
+
+	for (const FName& StateDefId : ChangeSet.GetRemoved(ETcsDefinitionKind::State))
+	{
+		UncacheStateDefinition(StateDefId);
+	}
+
+	for (const FName& StateDefId : ChangeSet.GetChanged(ETcsDefinitionKind::State))
+	{
+		const bool bWasLoaded = StateDefinitions.Contains(StateDefId);
+		UncacheStateDefinition(StateDefId);
+		if (!bWasLoaded && !bPreloadAll)
+		{
+			continue;
+		}
+
+		const TSoftObjectPtr<UTcsStateDefinition>* AssetPtr = Registry->GetStateDefinitions().Find(StateDefId);
+		const UTcsStateDefinition* Asset = AssetPtr ? AssetPtr->LoadSynchronous() : nullptr;
+		if (Asset)
+		{
+			RegisterLoadedStateDefinition(StateDefId, Asset);
+		}
+		else
+		{
+			UE_LOG(LogTcsState, Warning, TEXT("[%s] Failed to load StateDefinition: %s"),
+				*FString(__FUNCTION__),
+				*StateDefId.ToString());
+		}
+	}
+
+	// 未加载定义的 Tag 索引可能已过期，下次按 Tag 查询时重建
+	UnloadedStateTagIndex.Empty();
+	bUnloadedStateTagIndexBuilt = false;
+
+	UE_LOG(LogTcsState, Verbose, TEXT("[%s] Applied definition delta: %d StateSlots, %d States loaded"),
+		*FString(__FUNCTION__),
+		StateSlotDefinitions.Num(),
+		StateDefinitions.Num());
 }
 
 const TMap<FName, TSoftObjectPtr<UTcsStateDefinition>>* UTcsStateManagerSubsystem::GetStateDefinitionSourceCache() const
@@ -576,6 +731,367 @@ TArray<FName> UTcsStateManagerSubsystem::GetAllStateSlotDefNames() const
 	return Names;
 }
 
+void UTcsStateManagerSubsystem::RegisterTransientStateDefinition(const UTcsStateDefinition* Definition)
+{
+	if (!Definition || Definition->StateDefId.IsNone())
+	{
+		UE_LOG(LogTcsState, Warning, TEXT("[%s] Invalid transient StateDefinition"), *FString(__FUNCTION__));
+		return;
+	}
+
+	UncacheStateDefinition(Definition->StateDefId);
+	RegisterLoadedStateDefinition(Definition->StateDefId, Definition);
+}
+
+void UTcsStateManagerSubsystem::RegisterTransientStateSlotDefinition(const UTcsStateSlotDefinition* Definition)
+{
+	if (!Definition || Definition->StateSlotDefId.IsNone())
+	{
+		UE_LOG(LogTcsState, Warning, TEXT("[%s] Invalid transient StateSlotDefinition"), *FString(__FUNCTION__));
+		return;
+	}
+
+	StateSlotDefinitions.Add(Definition->StateSlotDefId, Definition);
+	StateTreeSlotMappings.Empty();
+}
+
+bool UTcsStateManagerSubsystem::RequestAsyncLoadStateDefinitions(
+	const TArray<FName>& StateDefIds,
+	FTcsOnStateDefinitionsStreamed OnStreamed)
+{
+	TArray<FName> RequestedDefIds;
+	TArray<FName> PendingDefIds;
+	TArray<FSoftObjectPath> PendingPaths;
+	for (const FName& StateDefId : StateDefIds)
+	{
+		if (StateDefId.IsNone())
+		{
+			continue;
+		}
+
+		if (StateDefinitions.Contains(StateDefId))
+		{
+			RequestedDefIds.AddUnique(StateDefId);
+			continue;
+		}
+
+		const FSoftObjectPath AssetPath = ResolveStateDefinitionPath(StateDefId);
+		if (AssetPath.IsNull())
+		{
+			UE_LOG(LogTcsState, Warning, TEXT("[%s] Unknown StateDefinition, skipping async load: %s"),
+				*FString(__FUNCTION__),
+				*StateDefId.ToString());
+			continue;
+		}
+
+		RequestedDefIds.AddUnique(StateDefId);
+
+		// 已在内存中的定义直接登记，无需发起流式加载
+		if (const UTcsStateDefinition* Asset = Cast<UTcsStateDefinition>(AssetPath.ResolveObject()))
+		{
+			RegisterLoadedStateDefinition(StateDefId, Asset);
+			continue;
+		}
+
+		PendingDefIds.AddUnique(StateDefId);
+		PendingPaths.AddUnique(AssetPath);
+	}
+
+	// 没有任何可加载的定义：请求被拒绝，只通过返回值通知，不调用回调
+	if (RequestedDefIds.IsEmpty())
+	{
+		return false;
+	}
+
+	if (PendingPaths.IsEmpty())
+	{
+		OnStreamed.ExecuteIfBound(RequestedDefIds);
+		return true;
+	}
+
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		PendingPaths,
+		FStreamableDelegate::CreateUObject(
+			this,
+			&UTcsStateManagerSubsystem::HandleStateDefinitionsStreamed,
+			RequestedDefIds,
+			OnStreamed));
+
+	if (!Handle.IsValid())
+	{
+		UE_LOG(LogTcsState, Error, TEXT("[%s] Failed to start async load for %d StateDefinitions"),
+			*FString(__FUNCTION__),
+			PendingPaths.Num());
+		return false;
+	}
+
+	for (const FName& StateDefId : PendingDefIds)
+	{
+		StateDefinitionStreamingHandles.Add(StateDefId, Handle);
+	}
+
+	UE_LOG(LogTcsState, Verbose, TEXT("[%s] Streaming %d StateDefinitions"),
+		*FString(__FUNCTION__),
+		PendingPaths.Num());
+	return true;
+}
+
+void UTcsStateManagerSubsystem::PrefetchStateDefinitions(const TArray<FName>& StateDefIds)
+{
+	RequestAsyncLoadStateDefinitions(StateDefIds);
+}
+
+void UTcsStateManagerSubsystem::PrefetchStateDefinitionsByTag(const FGameplayTagContainer& StateTags)
+{
+	TArray<FName> StateDefIds;
+	for (const FGameplayTag& StateTag : StateTags)
+	{
+		FName StateDefId;
+		if (ResolveStateDefIdByTag(StateTag, StateDefId))
+		{
+			StateDefIds.AddUnique(StateDefId);
+		}
+		else
+		{
+			UE_LOG(LogTcsState, Warning, TEXT("[%s] Cannot resolve StateTag without loading, skipping prefetch: %s"),
+				*FString(__FUNCTION__),
+				*StateTag.ToString());
+		}
+	}
+
+	RequestAsyncLoadStateDefinitions(StateDefIds);
+}
+
+bool UTcsStateManagerSubsystem::RequestApplyStateToTargetAsync(
+	AActor* Target,
+	FName StateDefId,
+	AActor* Instigator,
+	int32 StateLevel,
+	const FTcsSourceHandle& ParentSourceHandle)
+{
+	if (!IsValid(Target) || !IsValid(Instigator) || StateDefId.IsNone())
+	{
+		UE_LOG(LogTcsState, Error, TEXT("[%s] Invalid target, instigator, or StateDefId."),
+			*FString(__FUNCTION__));
+		return false;
+	}
+
+	if (StateDefinitions.Contains(StateDefId))
+	{
+		TryApplyStateToTarget(Target, StateDefId, Instigator, StateLevel, ParentSourceHandle);
+		return true;
+	}
+
+	TWeakObjectPtr<AActor> WeakTarget(Target);
+	TWeakObjectPtr<AActor> WeakInstigator(Instigator);
+	return RequestAsyncLoadStateDefinitions(
+		{ StateDefId },
+		FTcsOnStateDefinitionsStreamed::CreateWeakLambda(this,
+			[this, WeakTarget, WeakInstigator, StateDefId, StateLevel, ParentSourceHandle](const TArray<FName>& LoadedStateDefIds)
+			{
+				AActor* LocalTarget = WeakTarget.Get();
+				AActor* LocalInstigator = WeakInstigator.Get();
+				if (!IsValid(LocalTarget) || !IsValid(LocalInstigator))
+				{
+					UE_LOG(LogTcsState, Verbose, TEXT("[%s] Target or Instigator released before State '%s' finished streaming"),
+						*FString(__FUNCTION__),
+						*StateDefId.ToString());
+					return;
+				}
+
+				if (!StateDefinitions.Contains(StateDefId))
+				{
+					if (UTcsStateComponent* TargetStateCmp = UTcsGenericLibrary::GetStateComponent(LocalTarget))
+					{
+						TargetStateCmp->NotifyStateApplyFailed(
+							LocalTarget,
+							StateDefId,
+							ETcsStateApplyFailReason::InvalidStateDefinition,
+							TEXT("Failed to stream state definition."));
+					}
+					return;
+				}
+
+				TryApplyStateToTarget(LocalTarget, StateDefId, LocalInstigator, StateLevel, ParentSourceHandle);
+			}));
+}
+
+FSoftObjectPath UTcsStateManagerSubsystem::ResolveStateDefinitionPath(FName StateDefId) const
+{
+	const TMap<FName, TSoftObjectPtr<UTcsStateDefinition>>* StateSourceCache = nullptr;
+#if WITH_EDITOR
+	StateSourceCache = GetStateDefinitionSourceCache();
+#endif
+
+	if (!StateSourceCache)
+	{
+		if (const UTcsDeveloperSettings* Settings = GetDefault<UTcsDeveloperSettings>())
+		{
+			StateSourceCache = &Settings->GetCachedStateDefinitions();
+		}
+	}
+
+	if (StateSourceCache)
+	{
+		if (const TSoftObjectPtr<UTcsStateDefinition>* AssetPtr = StateSourceCache->Find(StateDefId))
+		{
+			return AssetPtr->ToSoftObjectPath();
+		}
+	}
+
+	// 运行时 DeveloperSettings 缓存为空，回退到 AssetManager 的 PrimaryAsset 路径
+	if (UAssetManager::IsInitialized())
+	{
+		return UAssetManager::Get().GetPrimaryAssetPath(FPrimaryAssetId(UTcsStateDefinition::PrimaryAssetType, StateDefId));
+	}
+
+	return FSoftObjectPath();
+}
+
+bool UTcsStateManagerSubsystem::ResolveStateDefIdByTag(const FGameplayTag& StateTag, FName& OutStateDefId)
+{
+	if (!StateTag.IsValid())
+	{
+		return false;
+	}
+
+	if (const FName* DefId = StateTagToDefId.Find(StateTag))
+	{
+		OutStateDefId = *DefId;
+		return true;
+	}
+
+	if (!bUnloadedStateTagIndexBuilt && UAssetManager::IsInitialized())
+	{
+		bUnloadedStateTagIndexBuilt = true;
+
+		UAssetManager& AssetManager = UAssetManager::Get();
+		TArray<FAssetData> AssetDataList;
+		AssetManager.GetPrimaryAssetDataList(UTcsStateDefinition::PrimaryAssetType, AssetDataList);
+
+		const FName StateTagPropertyName = GET_MEMBER_NAME_CHECKED(UTcsStateDefinition, StateTag);
+		for (const FAssetData& AssetData : AssetDataList)
+		{
+			FString TagExportString;
+			if (!AssetData.GetTagValue(StateTagPropertyName, TagExportString))
+			{
+				continue;
+			}
+
+			FGameplayTag AssetStateTag;
+			if (!AssetStateTag.FromExportString(TagExportString) || !AssetStateTag.IsValid())
+			{
+				continue;
+			}
+
+			const FPrimaryAssetId AssetId = AssetManager.GetPrimaryAssetIdForData(AssetData);
+			if (AssetId.IsValid() && !UnloadedStateTagIndex.Contains(AssetStateTag))
+			{
+				UnloadedStateTagIndex.Add(AssetStateTag, AssetId.PrimaryAssetName);
+			}
+		}
+	}
+
+	if (const FName* DefId = UnloadedStateTagIndex.Find(StateTag))
+	{
+		OutStateDefId = *DefId;
+		return true;
+	}
+
+	return false;
+}
+
+void UTcsStateManagerSubsystem::RegisterLoadedStateDefinition(FName StateDefId, const UTcsStateDefinition* Asset)
+{
+	CacheStateDefinition(StateDefId, Asset);
+	if (Asset->StateTag.IsValid() && !StateTagToDefId.Contains(Asset->StateTag))
+	{
+		StateTagToDefId.Add(Asset->StateTag, StateDefId);
+	}
+}
+
+void UTcsStateManagerSubsystem::HandleStateDefinitionsStreamed(
+	TArray<FName> RequestedStateDefIds,
+	FTcsOnStateDefinitionsStreamed OnStreamed)
+{
+	TArray<FName> LoadedDefIds;
+	LoadedDefIds.Reserve(RequestedStateDefIds.Num());
+
+	for (const FName& StateDefId : RequestedStateDefIds)
+	{
+		if (StateDefinitions.Contains(StateDefId))
+		{
+			LoadedDefIds.Add(StateDefId);
+			continue;
+		}
+
+		const UTcsStateDefinition* Asset = Cast<UTcsStateDefinition>(ResolveStateDefinitionPath(StateDefId).ResolveObject());
+		if (!Asset)
+		{
+			UE_LOG(LogTcsState, Warning, TEXT("[%s] Failed to stream StateDefinition: %s"),
+				*FString(__FUNCTION__),
+				*StateDefId.ToString());
+			StateDefinitionStreamingHandles.Remove(StateDefId);
+			continue;
+		}
+
+		RegisterLoadedStateDefinition(StateDefId, Asset);
+		LoadedDefIds.Add(StateDefId);
+	}
+
+	OnStreamed.ExecuteIfBound(LoadedDefIds);
+}
+
+void UTcsStateManagerSubsystem::RecordSyncLoadHitch(FName StateDefId, double LoadTimeSeconds)
+{
+	const float LoadTimeMs = static_cast<float>(LoadTimeSeconds * 1000.0);
+
+	UE_LOG(LogTcsState, Warning,
+		TEXT("[%s] Synchronous fallback load of State '%s' took %.2f ms on the game thread. Prefetch it with PrefetchStateDefinitions or RequestApplyStateToTargetAsync."),
+		*FString(__FUNCTION__),
+		*StateDefId.ToString(),
+		LoadTimeMs);
+
+	FTcsStateSyncLoadHitchRecord Record;
+	Record.StateDefId = StateDefId;
+	Record.LoadTimeMs = LoadTimeMs;
+	Record.FrameNumber = static_cast<int64>(GFrameCounter);
+
+	// 写满后覆盖最旧的记录
+	if (SyncLoadHitchRecords.Num() < MaxSyncLoadHitchRecords)
+	{
+		SyncLoadHitchRecords.Add(Record);
+	}
+	else
+	{
+		SyncLoadHitchRecords[NextSyncLoadHitchRecordIndex] = Record;
+	}
+	NextSyncLoadHitchRecordIndex = (NextSyncLoadHitchRecordIndex + 1) % MaxSyncLoadHitchRecords;
+}
+
+TArray<FTcsStateSyncLoadHitchRecord> UTcsStateManagerSubsystem::GetSyncLoadHitchReport() const
+{
+	if (SyncLoadHitchRecords.Num() < MaxSyncLoadHitchRecords)
+	{
+		return SyncLoadHitchRecords;
+	}
+
+	// 缓冲已写满时 NextSyncLoadHitchRecordIndex 指向最旧的记录
+	TArray<FTcsStateSyncLoadHitchRecord> OrderedRecords;
+	OrderedRecords.Reserve(SyncLoadHitchRecords.Num());
+	for (int32 Offset = 0; Offset < SyncLoadHitchRecords.Num(); ++Offset)
+	{
+		OrderedRecords.Add(SyncLoadHitchRecords[(NextSyncLoadHitchRecordIndex + Offset) % SyncLoadHitchRecords.Num()]);
+	}
+	return OrderedRecords;
+}
+
+void UTcsStateManagerSubsystem::ResetSyncLoadHitchReport()
+{
+	SyncLoadHitchRecords.Reset();
+	NextSyncLoadHitchRecordIndex = 0;
+}
+
 bool UTcsStateManagerSubsystem::TryApplyStateToTarget(
 	AActor* Target,
 	FName StateDefId,
@@ -599,6 +1115,9 @@ bool UTcsStateManagerSubsystem::TryApplyStateToTarget(
 		return false;
 	}
 
+	UGameInstance* GameInstance = GetGameInstance();
+	FTcsAttributeRecalculationScope RecalculationScope(
+		GameInstance ? GameInstance->GetSubsystem<UTcsAttributeManagerSubsystem>() : nullptr);
 	return TargetStateCmp->TryApplyState(StateDefId, Instigator, StateLevel, ParentSourceHandle);
 }
 
@@ -608,6 +1127,7 @@ void UTcsStateManagerSubsystem::LoadFromAssetManager()
 	UAssetManager& AssetManager = UAssetManager::Get();
 
 	StateSlotDefinitions.Empty();
+	StateTreeSlotMappings.Empty();
 	{
 		TArray<FPrimaryAssetId> StateSlotDefIds;
 		AssetManager.GetPrimaryAssetIdList(UTcsStateSlotDefinition::PrimaryAssetType, StateSlotDefIds);
@@ -632,8 +1152,10 @@ void UTcsStateManagerSubsystem::LoadFromAssetManager()
 			StateSlotDefinitions.Num());
 	}
 
-	StateDefinitions.Empty();
+	ResetStateDefinitionCache();
 	StateTagToDefId.Empty();
+	UnloadedStateTagIndex.Empty();
+	bUnloadedStateTagIndexBuilt = false;
 
 	const UTcsDeveloperSettings* Settings = GetDefault<UTcsDeveloperSettings>();
 	const ETcsStateLoadingStrategy LoadingStrategy = Settings ? Settings->StateLoadingStrategy : ETcsStateLoadingStrategy::PreloadAll;
@@ -650,7 +1172,7 @@ void UTcsStateManagerSubsystem::LoadFromAssetManager()
 				const UTcsStateDefinition* Asset = Cast<UTcsStateDefinition>(AssetManager.LoadPrimaryAsset(AssetId));
 				if (Asset)
 				{
-					StateDefinitions.Add(Asset->StateDefId, Asset);
+					CacheStateDefinition(Asset->StateDefId, Asset);
 					if (Asset->StateTag.IsValid() && !StateTagToDefId.Contains(Asset->StateTag))
 					{
 						StateTagToDefId.Add(Asset->StateTag, Asset->StateDefId);
@@ -689,7 +1211,7 @@ void UTcsStateManagerSubsystem::LoadFromAssetManager()
 
 				if (!StateDefinitions.Contains(Asset->StateDefId))
 				{
-					StateDefinitions.Add(Asset->StateDefId, Asset);
+					CacheStateDefinition(Asset->StateDefId, Asset);
 					if (Asset->StateTag.IsValid() && !StateTagToDefId.Contains(Asset->StateTag))
 					{
 						StateTagToDefId.Add(Asset->StateTag, Asset->StateDefId);
@@ -741,7 +1263,7 @@ void UTcsStateManagerSubsystem::LoadFromAssetManager()
 
 					if (!StateDefinitions.Contains(Asset->StateDefId))
 					{
-						StateDefinitions.Add(Asset->StateDefId, Asset);
+						CacheStateDefinition(Asset->StateDefId, Asset);
 						if (Asset->StateTag.IsValid() && !StateTagToDefId.Contains(Asset->StateTag))
 						{
 							StateTagToDefId.Add(Asset->StateTag, Asset->StateDefId);
@@ -767,4 +1289,82 @@ void UTcsStateManagerSubsystem::LoadFromAssetManager()
 		StateDefinitions.Num(),
 		StateTagToDefId.Num());
 #endif
-}
\ No newline at end of file
+}
+
+TSharedRef<const FTcsStateTreeEventListenInfo> UTcsStateManagerSubsystem::GetStateTreeEventListenInfo(const UStateTree& StateTree)
+{
+	if (const TSharedRef<const FTcsStateTreeEventListenInfo>* Cached = StateTreeEventListenInfos.Find(&StateTree))
+	{
+		return *Cached;
+	}
+
+	TSharedRef<const FTcsStateTreeEventListenInfo> Info = MakeShared<const FTcsStateTreeEventListenInfo>(
+		FTcsStateTreeEventListenInfo::Build(StateTree));
+	StateTreeEventListenInfos.Add(&StateTree, Info);
+	return Info;
+}
+
+TSharedRef<const FTcsStateTreeSlotMapping> UTcsStateManagerSubsystem::GetStateTreeSlotMapping(const UStateTree& StateTree)
+{
+	if (const TSharedRef<const FTcsStateTreeSlotMapping>* Cached = StateTreeSlotMappings.Find(&StateTree))
+	{
+		return *Cached;
+	}
+
+	TSharedRef<const FTcsStateTreeSlotMapping> Mapping = BuildStateTreeSlotMapping(StateTree);
+	StateTreeSlotMappings.Add(&StateTree, Mapping);
+	return Mapping;
+}
+
+TSharedRef<const FTcsStateTreeSlotMapping> UTcsStateManagerSubsystem::BuildStateTreeSlotMapping(const UStateTree& StateTree) const
+{
+	TSharedRef<FTcsStateTreeSlotMapping> Mapping = MakeShared<FTcsStateTreeSlotMapping>();
+
+	// 状态名 -> 句柄（同名时取第一个）
+	TMap<FName, FStateTreeStateHandle> StateHandlesByName;
+	const TArrayView<const FCompactStateTreeState> States = StateTree.GetStates();
+	StateHandlesByName.Reserve(States.Num());
+	for (int32 Index = 0; Index < States.Num(); ++Index)
+	{
+		if (!StateHandlesByName.Contains(States[Index].Name))
+		{
+			StateHandlesByName.Add(States[Index].Name, FStateTreeStateHandle(Index));
+		}
+	}
+
+	for (const TPair<FName, const UTcsStateSlotDefinition*>& Pair : StateSlotDefinitions)
+	{
+		const UTcsStateSlotDefinition* StateSlotDef = Pair.Value;
+		if (!StateSlotDef || StateSlotDef->StateTreeStateName.IsNone())
+		{
+			continue;
+		}
+
+		const FGameplayTag StateSlotTag = StateSlotDef->SlotTag;
+		const FStateTreeStateHandle* Handle = StateHandlesByName.Find(StateSlotDef->StateTreeStateName);
+		if (Handle)
+		{
+			Mapping->SlotToStateHandle.Add(StateSlotTag, *Handle);
+			Mapping->StateHandleToSlot.Add(*Handle, StateSlotTag);
+			Mapping->StateNameToSlots.FindOrAdd(StateSlotDef->StateTreeStateName).AddUnique(StateSlotTag);
+		}
+
+		UE_LOG(LogTcsState, Log, TEXT("[%s] State Slot [%s] -> StateTree State [%s] %s in %s"),
+			*FString(__FUNCTION__),
+			*StateSlotTag.ToString(),
+			*StateSlotDef->StateTreeStateName.ToString(),
+			Handle ? TEXT("mapped") : TEXT("not found"),
+			*StateTree.GetName());
+	}
+
+	return Mapping;
+}
+
+#if WITH_EDITOR
+void UTcsStateManagerSubsystem::HandleStateTreePostCompile(const UStateTree& StateTree)
+{
+	// 缓存信息包含链接的子树，任一资产重新编译都整体丢弃
+	StateTreeEventListenInfos.Empty();
+	StateTreeSlotMappings.Empty();
+}
+#endif
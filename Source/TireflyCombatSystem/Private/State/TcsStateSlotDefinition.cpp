@@ -29,6 +29,12 @@ void UTcsStateSlotDefinition::PostEditChangeProperty(FPropertyChangedEvent& Prop
 
 	const FName PropertyName = PropertyChangedEvent.GetPropertyName();
 
+	// 定义 ID 变更后稠密 ID 需重新分配
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UTcsStateSlotDefinition, StateSlotDefId))
+	{
+		CachedDefIndex = INDEX_NONE;
+	}
+
 	// 验证 SamePriorityPolicy
 	if (PropertyName == GET_MEMBER_NAME_CHECKED(UTcsStateSlotDefinition, SamePriorityPolicy))
 	{
@@ -0,0 +1,72 @@
+// Copyright Tirefly. All Rights Reserved.
+
+
+#include "StateTree/TcsStateTreeAssetInfo.h"
+
+#include "StateTree.h"
+
+
+
+namespace TcsStateTreeAssetInfoPrivate
+{
+	void CollectEventTags(
+		const UStateTree& StateTree,
+		FTcsStateTreeEventListenInfo& Info,
+		TSet<const UStateTree*>& VisitedStateTrees)
+	{
+		bool bAlreadyVisited = false;
+		VisitedStateTrees.Add(&StateTree, &bAlreadyVisited);
+		if (bAlreadyVisited)
+		{
+			return;
+		}
+
+		auto AddEventTag = [&Info](const FGameplayTag& EventTag)
+		{
+			if (EventTag.IsValid())
+			{
+				Info.EventTags.AddTag(EventTag);
+			}
+			else
+			{
+				Info.bListensToAllEvents = true;
+			}
+		};
+
+		const TArrayView<const FCompactStateTreeState> States = StateTree.GetStates();
+		for (const FCompactStateTreeState& State : States)
+		{
+			// 状态的事件进入条件
+			if (State.bHasRequiredEventToEnter)
+			{
+				AddEventTag(State.RequiredEventToEnter.Tag);
+			}
+
+			// 事件触发的转换
+			const int32 TransitionsEnd = State.TransitionsBegin + State.TransitionsNum;
+			for (int32 TransitionIndex = State.TransitionsBegin; TransitionIndex < TransitionsEnd; ++TransitionIndex)
+			{
+				const FCompactStateTransition* Transition = StateTree.GetTransitionFromIndex(FStateTreeIndex16(TransitionIndex));
+				if (Transition && EnumHasAnyFlags(Transition->Trigger, EStateTreeTransitionTrigger::OnEvent))
+				{
+					AddEventTag(Transition->RequiredEvent.Tag);
+				}
+			}
+
+			// 链接的子树资产
+			if (State.LinkedAsset)
+			{
+				CollectEventTags(*State.LinkedAsset, Info, VisitedStateTrees);
+			}
+		}
+	}
+}
+
+
+FTcsStateTreeEventListenInfo FTcsStateTreeEventListenInfo::Build(const UStateTree& StateTree)
+{
+	FTcsStateTreeEventListenInfo Info;
+	TSet<const UStateTree*> VisitedStateTrees;
+	TcsStateTreeAssetInfoPrivate::CollectEventTags(StateTree, Info, VisitedStateTrees);
+	return Info;
+}
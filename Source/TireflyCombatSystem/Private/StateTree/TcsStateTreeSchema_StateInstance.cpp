@@ -115,14 +115,15 @@ bool UTcsStateTreeSchema_StateInstance::IsExternalItemAllowed(const UStruct& InS
 bool UTcsStateTreeSchema_StateInstance::SetContextRequirements(
 	UTcsStateInstance& StateInstance,
 	FStateTreeExecutionContext& Context,
-	bool bLogErrors)
+	bool bLogErrors,
+	TArray<TPair<FName, FStateTreeDataView>>* OutContextData)
 {
 	if (!Context.IsValid())
 	{
 		return false;
 	}
 
-	FTcsContextDataSetter ContextDataSetter = FTcsContextDataSetter(&StateInstance, Context);
+	FTcsContextDataSetter ContextDataSetter = FTcsContextDataSetter(&StateInstance, Context, OutContextData);
 	ContextDataSetter.GetSchema()->SetContextData(ContextDataSetter, bLogErrors);
 
 	bool bResult = Context.AreContextDataViewsValid();
@@ -328,9 +329,11 @@ bool UTcsStateTreeSchema_StateInstance::CollectExternalData(
 
 UTcsStateTreeSchema_StateInstance::FTcsContextDataSetter::FTcsContextDataSetter(
 	TNotNull<const UTcsStateInstance*> InStateInstance,
-	FStateTreeExecutionContext& Context)
+	FStateTreeExecutionContext& Context,
+	TArray<TPair<FName, FStateTreeDataView>>* InRecordedContextData)
 		: StateInstance(InStateInstance),
-		ExecutionContext(Context)
+		ExecutionContext(Context),
+		RecordedContextData(InRecordedContextData)
 {}
 
 TNotNull<const UStateTree*> UTcsStateTreeSchema_StateInstance::FTcsContextDataSetter::GetStateTree() const
@@ -348,7 +351,16 @@ bool UTcsStateTreeSchema_StateInstance::FTcsContextDataSetter::SetContextDataByN
 	FName Name,
 	FStateTreeDataView DataView)
 {
-	return ExecutionContext.IsValid() ? ExecutionContext.SetContextDataByName(Name, DataView) : false;
+	if (!ExecutionContext.IsValid() || !ExecutionContext.SetContextDataByName(Name, DataView))
+	{
+		return false;
+	}
+
+	if (RecordedContextData)
+	{
+		RecordedContextData->Emplace(Name, DataView);
+	}
+	return true;
 }
 
 void UTcsStateTreeSchema_StateInstance::SetContextData(
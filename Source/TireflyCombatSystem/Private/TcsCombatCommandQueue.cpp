@@ -0,0 +1,43 @@
+// Copyright Tirefly. All Rights Reserved.
+
+
+#include "TcsCombatCommandQueue.h"
+
+
+
+void FTcsCombatCommandQueue::Enqueue(FTcsCombatCommand&& Command)
+{
+	// 先计数再入队，保证计数不小于队列中的实际数量
+	PendingCount.fetch_add(1, std::memory_order_relaxed);
+	Commands.Enqueue(MoveTemp(Command));
+}
+
+int32 FTcsCombatCommandQueue::Drain(TFunctionRef<void(FTcsCombatCommand&)> Executor)
+{
+	check(IsInGameThread());
+
+	// 只执行开始时已入队的指令，避免执行过程中不断入队导致本次无法结束
+	const int32 NumToDrain = PendingCount.load(std::memory_order_relaxed);
+	int32 NumDrained = 0;
+
+	FTcsCombatCommand Command;
+	while (NumDrained < NumToDrain && Commands.Dequeue(Command))
+	{
+		PendingCount.fetch_sub(1, std::memory_order_relaxed);
+		++NumDrained;
+		Executor(Command);
+	}
+
+	return NumDrained;
+}
+
+void FTcsCombatCommandQueue::Reset()
+{
+	check(IsInGameThread());
+
+	FTcsCombatCommand Command;
+	while (Commands.Dequeue(Command))
+	{
+		PendingCount.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,208 @@
+// Copyright Tirefly. All Rights Reserved.
+
+#include "TcsDefinitionId.h"
+
+namespace TcsDefinitionIdPrivate
+{
+	struct FDefinitionIdSpace
+	{
+		// 定义 ID -> DefIndex
+		TMap<FName, int32> IndexById;
+
+		// DefIndex -> 定义 ID
+		TArray<FName> IdByIndex;
+
+		// 定义 ID -> NetIndex
+		TMap<FName, int32> NetIndexById;
+
+		// NetIndex -> 定义 ID（按字符串排序）
+		TArray<FName> IdByNetIndex;
+
+		// IdByNetIndex 的哈希（按小写字符串计算，与进程无关）
+		uint32 NetListHash = 0;
+	};
+
+	// 仅在游戏线程访问，读路径不加锁
+	struct FDefinitionIdStorage
+	{
+		FDefinitionIdSpace Spaces[static_cast<int32>(ETcsDefinitionKind::Num)];
+	};
+
+	FDefinitionIdStorage& GetStorage()
+	{
+		static FDefinitionIdStorage Storage;
+		return Storage;
+	}
+}
+
+int32 FTcsDefinitionIdTable::FindOrAdd(ETcsDefinitionKind Kind, FName DefinitionId)
+{
+	if (DefinitionId.IsNone() || Kind >= ETcsDefinitionKind::Num)
+	{
+		return INDEX_NONE;
+	}
+
+	TcsDefinitionIdPrivate::FDefinitionIdStorage& Storage = TcsDefinitionIdPrivate::GetStorage();
+	TcsDefinitionIdPrivate::FDefinitionIdSpace& Space = Storage.Spaces[static_cast<int32>(Kind)];
+
+	if (const int32* Found = Space.IndexById.Find(DefinitionId))
+	{
+		return *Found;
+	}
+
+	// 分配新 ID 只发生在定义首次注册/加载时
+	check(IsInGameThread());
+	const int32 DefIndex = Space.IdByIndex.Add(DefinitionId);
+	Space.IndexById.Add(DefinitionId, DefIndex);
+	return DefIndex;
+}
+
+int32 FTcsDefinitionIdTable::Find(ETcsDefinitionKind Kind, FName DefinitionId)
+{
+	if (DefinitionId.IsNone() || Kind >= ETcsDefinitionKind::Num)
+	{
+		return INDEX_NONE;
+	}
+
+	TcsDefinitionIdPrivate::FDefinitionIdStorage& Storage = TcsDefinitionIdPrivate::GetStorage();
+	const int32* Found = Storage.Spaces[static_cast<int32>(Kind)].IndexById.Find(DefinitionId);
+	return Found ? *Found : INDEX_NONE;
+}
+
+FName FTcsDefinitionIdTable::GetDefinitionId(ETcsDefinitionKind Kind, int32 DefIndex)
+{
+	if (Kind >= ETcsDefinitionKind::Num)
+	{
+		return NAME_None;
+	}
+
+	TcsDefinitionIdPrivate::FDefinitionIdStorage& Storage = TcsDefinitionIdPrivate::GetStorage();
+	const TArray<FName>& IdByIndex = Storage.Spaces[static_cast<int32>(Kind)].IdByIndex;
+	return IdByIndex.IsValidIndex(DefIndex) ? IdByIndex[DefIndex] : NAME_None;
+}
+
+int32 FTcsDefinitionIdTable::Num(ETcsDefinitionKind Kind)
+{
+	if (Kind >= ETcsDefinitionKind::Num)
+	{
+		return 0;
+	}
+
+	TcsDefinitionIdPrivate::FDefinitionIdStorage& Storage = TcsDefinitionIdPrivate::GetStorage();
+	return Storage.Spaces[static_cast<int32>(Kind)].IdByIndex.Num();
+}
+
+void FTcsDefinitionIdTable::SetNetworkDefinitionIds(ETcsDefinitionKind Kind, TArray<FName> DefinitionIds)
+{
+	if (Kind >= ETcsDefinitionKind::Num)
+	{
+		return;
+	}
+
+	DefinitionIds.RemoveAll([](const FName& DefinitionId) { return DefinitionId.IsNone(); });
+	DefinitionIds.Sort(FNameLexicalLess());
+
+	TcsDefinitionIdPrivate::FDefinitionIdStorage& Storage = TcsDefinitionIdPrivate::GetStorage();
+	check(IsInGameThread());
+	TcsDefinitionIdPrivate::FDefinitionIdSpace& Space = Storage.Spaces[static_cast<int32>(Kind)];
+
+	Space.NetIndexById.Reset();
+	Space.IdByNetIndex.Reset(DefinitionIds.Num());
+	for (const FName& DefinitionId : DefinitionIds)
+	{
+		if (!Space.NetIndexById.Contains(DefinitionId))
+		{
+			Space.NetIndexById.Add(DefinitionId, Space.IdByNetIndex.Add(DefinitionId));
+		}
+	}
+
+	// FName 的哈希与名称表下标相关、不同进程不一致，列表哈希按字符串计算
+	uint32 NetListHash = static_cast<uint32>(Space.IdByNetIndex.Num());
+	for (const FName& DefinitionId : Space.IdByNetIndex)
+	{
+		NetListHash = FCrc::StrCrc32(*DefinitionId.ToString().ToLower(), NetListHash);
+	}
+	Space.NetListHash = NetListHash;
+}
+
+int32 FTcsDefinitionIdTable::FindNetIndex(ETcsDefinitionKind Kind, FName DefinitionId)
+{
+	if (DefinitionId.IsNone() || Kind >= ETcsDefinitionKind::Num)
+	{
+		return INDEX_NONE;
+	}
+
+	TcsDefinitionIdPrivate::FDefinitionIdStorage& Storage = TcsDefinitionIdPrivate::GetStorage();
+	const int32* Found = Storage.Spaces[static_cast<int32>(Kind)].NetIndexById.Find(DefinitionId);
+	return Found ? *Found : INDEX_NONE;
+}
+
+FName FTcsDefinitionIdTable::GetNetDefinitionId(ETcsDefinitionKind Kind, int32 NetIndex)
+{
+	if (Kind >= ETcsDefinitionKind::Num)
+	{
+		return NAME_None;
+	}
+
+	TcsDefinitionIdPrivate::FDefinitionIdStorage& Storage = TcsDefinitionIdPrivate::GetStorage();
+	const TArray<FName>& IdByNetIndex = Storage.Spaces[static_cast<int32>(Kind)].IdByNetIndex;
+	return IdByNetIndex.IsValidIndex(NetIndex) ? IdByNetIndex[NetIndex] : NAME_None;
+}
+
+TArray<FName> FTcsDefinitionIdTable::GetNetworkDefinitionIds(ETcsDefinitionKind Kind)
+{
+	if (Kind >= ETcsDefinitionKind::Num)
+	{
+		return TArray<FName>();
+	}
+
+	TcsDefinitionIdPrivate::FDefinitionIdStorage& Storage = TcsDefinitionIdPrivate::GetStorage();
+	return Storage.Spaces[static_cast<int32>(Kind)].IdByNetIndex;
+}
+
+uint32 FTcsDefinitionIdTable::GetNetworkDefinitionListHash(ETcsDefinitionKind Kind)
+{
+	if (Kind >= ETcsDefinitionKind::Num)
+	{
+		return 0;
+	}
+
+	TcsDefinitionIdPrivate::FDefinitionIdStorage& Storage = TcsDefinitionIdPrivate::GetStorage();
+	return Storage.Spaces[static_cast<int32>(Kind)].NetListHash;
+}
+
+TArray<uint32> FTcsDefinitionIdTable::GetNetworkDefinitionListHashes()
+{
+	TArray<uint32> ListHashes;
+	ListHashes.Reserve(static_cast<int32>(ETcsDefinitionKind::Num));
+	for (int32 KindIndex = 0; KindIndex < static_cast<int32>(ETcsDefinitionKind::Num); ++KindIndex)
+	{
+		ListHashes.Add(GetNetworkDefinitionListHash(static_cast<ETcsDefinitionKind>(KindIndex)));
+	}
+	return ListHashes;
+}
+
+bool FTcsDefinitionIdTable::NetSerializeDefinitionId(FArchive& Ar, ETcsDefinitionKind Kind, FName& DefinitionId, bool bUseNetIndex)
+{
+	uint32 NetIndexPlusOne = 0;
+	if (Ar.IsSaving() && bUseNetIndex)
+	{
+		const int32 NetIndex = FindNetIndex(Kind, DefinitionId);
+		NetIndexPlusOne = NetIndex != INDEX_NONE ? static_cast<uint32>(NetIndex) + 1 : 0;
+	}
+	Ar.SerializeIntPacked(NetIndexPlusOne);
+
+	if (NetIndexPlusOne == 0)
+	{
+		Ar << DefinitionId;
+		return !Ar.IsError();
+	}
+
+	if (Ar.IsLoading())
+	{
+		DefinitionId = GetNetDefinitionId(Kind, static_cast<int32>(NetIndexPlusOne - 1));
+		return !DefinitionId.IsNone();
+	}
+
+	return true;
+}
@@ -0,0 +1,403 @@
+// Copyright Tirefly. All Rights Reserved.
+
+
+#include "TcsDefinitionProfiler.h"
+
+#if TCS_STATS_ENABLED
+
+#include "TcsLogChannels.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+
+
+namespace TcsDefinitionProfilerPrivate
+{
+	constexpr int32 NumCategories = static_cast<int32>(ETcsDefinitionCostCategory::Num);
+
+	constexpr int32 DefaultDumpEntries = 10;
+
+	double CyclesToMs(uint64 Cycles)
+	{
+		return FPlatformTime::ToMilliseconds64(Cycles);
+	}
+
+	double CyclesToUs(uint64 Cycles)
+	{
+		return FPlatformTime::ToMilliseconds64(Cycles) * 1000.0;
+	}
+
+	FAutoConsoleCommand StartCommand(
+		TEXT("tcs.Profiler.Start"),
+		TEXT("Start attributing TCS StateTree tick, parameter evaluation, condition check and modifier execution time to definition ids."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FTcsDefinitionProfiler::Get().SetEnabled(true);
+		}));
+
+	FAutoConsoleCommand StopCommand(
+		TEXT("tcs.Profiler.Stop"),
+		TEXT("Stop the TCS definition cost profiler (captured data is kept)."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FTcsDefinitionProfiler::Get().SetEnabled(false);
+		}));
+
+	FAutoConsoleCommand ResetCommand(
+		TEXT("tcs.Profiler.Reset"),
+		TEXT("Clear the data captured by the TCS definition cost profiler."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FTcsDefinitionProfiler::Get().Reset();
+		}));
+
+	FAutoConsoleCommandWithArgsAndOutputDevice DumpCommand(
+		TEXT("tcs.Profiler.Dump"),
+		TEXT("Dump the most expensive definitions per category. Usage: tcs.Profiler.Dump [N=10] [StateTreeTick|ParameterEvaluation|ConditionCheck|ModifierExecution]"),
+		FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, FOutputDevice& Ar)
+		{
+			int32 NumEntries = DefaultDumpEntries;
+			ETcsDefinitionCostCategory Category = ETcsDefinitionCostCategory::Num;
+			for (const FString& Arg : Args)
+			{
+				if (Arg.IsNumeric())
+				{
+					NumEntries = FMath::Max(1, FCString::Atoi(*Arg));
+				}
+				else
+				{
+					Category = FTcsDefinitionProfiler::ParseCategory(Arg);
+					if (Category == ETcsDefinitionCostCategory::Num)
+					{
+						Ar.Logf(TEXT("Unknown category '%s'."), *Arg);
+						return;
+					}
+				}
+			}
+
+			FTcsDefinitionProfiler::Get().DumpTopN(NumEntries, Category, Ar);
+		}));
+
+	FAutoConsoleCommandWithArgsAndOutputDevice ExportCsvCommand(
+		TEXT("tcs.Profiler.ExportCsv"),
+		TEXT("Export the TCS definition cost profiler data as CSV. Usage: tcs.Profiler.ExportCsv [Path]"),
+		FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, FOutputDevice& Ar)
+		{
+			FString FilePath;
+			if (FTcsDefinitionProfiler::Get().ExportCsv(Args.IsEmpty() ? FString() : Args[0], FilePath))
+			{
+				Ar.Logf(TEXT("TCS definition costs exported to %s"), *FilePath);
+			}
+			else
+			{
+				Ar.Logf(TEXT("Failed to export TCS definition costs to %s"), *FilePath);
+			}
+		}));
+}
+
+
+
+double FTcsDefinitionCostEntry::GetTotalMs() const
+{
+	return TcsDefinitionProfilerPrivate::CyclesToMs(TotalCycles);
+}
+
+double FTcsDefinitionCostEntry::GetAverageUs() const
+{
+	return Calls > 0 ? TcsDefinitionProfilerPrivate::CyclesToUs(TotalCycles) / Calls : 0.0;
+}
+
+double FTcsDefinitionCostEntry::GetMaxUs() const
+{
+	return TcsDefinitionProfilerPrivate::CyclesToUs(MaxCycles);
+}
+
+
+
+std::atomic<bool> FTcsDefinitionProfiler::bEnabled{false};
+
+FTcsDefinitionProfiler& FTcsDefinitionProfiler::Get()
+{
+	static FTcsDefinitionProfiler Instance;
+	return Instance;
+}
+
+void FTcsDefinitionProfiler::SetEnabled(bool bInEnabled)
+{
+	FScopeLock Lock(&CostsLock);
+
+	if (IsEnabled() == bInEnabled)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	if (bInEnabled)
+	{
+		CaptureStartTime = Now;
+	}
+	else
+	{
+		AccumulatedCaptureSeconds += Now - CaptureStartTime;
+	}
+
+	bEnabled.store(bInEnabled, std::memory_order_relaxed);
+
+	UE_LOG(LogTcs, Log, TEXT("[%s] Definition cost profiler %s."),
+		*FString(__FUNCTION__),
+		bInEnabled ? TEXT("started") : TEXT("stopped"));
+}
+
+void FTcsDefinitionProfiler::Reset()
+{
+	FScopeLock Lock(&CostsLock);
+
+	// 各线程的累计表仍被线程局部指针引用，只清空内容
+	for (const TUniquePtr<FThreadCosts>& Thread : ThreadCosts)
+	{
+		FScopeLock ThreadLock(&Thread->Lock);
+		for (TMap<FName, FCost>& CategoryCosts : Thread->Costs)
+		{
+			CategoryCosts.Reset();
+		}
+	}
+	AccumulatedCaptureSeconds = 0.0;
+	CaptureStartTime = FPlatformTime::Seconds();
+}
+
+void FTcsDefinitionProfiler::Record(ETcsDefinitionCostCategory Category, FName DefinitionId, uint64 Cycles)
+{
+	const int32 CategoryIndex = static_cast<int32>(Category);
+	if (!ensure(CategoryIndex >= 0 && CategoryIndex < TcsDefinitionProfilerPrivate::NumCategories))
+	{
+		return;
+	}
+
+	FThreadCosts& Thread = GetThreadCosts();
+	FScopeLock ThreadLock(&Thread.Lock);
+
+	FCost& Cost = Thread.Costs[CategoryIndex].FindOrAdd(DefinitionId);
+	++Cost.Calls;
+	Cost.TotalCycles += Cycles;
+	Cost.MaxCycles = FMath::Max(Cost.MaxCycles, Cycles);
+}
+
+FTcsDefinitionProfiler::FThreadCosts& FTcsDefinitionProfiler::GetThreadCosts()
+{
+	static thread_local FThreadCosts* ThreadLocalCosts = nullptr;
+	if (!ThreadLocalCosts)
+	{
+		FScopeLock Lock(&CostsLock);
+		ThreadLocalCosts = ThreadCosts.Add_GetRef(MakeUnique<FThreadCosts>()).Get();
+	}
+	return *ThreadLocalCosts;
+}
+
+TArray<FTcsDefinitionCostEntry> FTcsDefinitionProfiler::GetEntries(
+	ETcsDefinitionCostCategory Category,
+	int32 MaxEntries) const
+{
+	TArray<FTcsDefinitionCostEntry> Result;
+
+	// 合并各线程的累计表
+	TMap<FName, FCost> Costs[TcsDefinitionProfilerPrivate::NumCategories];
+	{
+		FScopeLock Lock(&CostsLock);
+		for (const TUniquePtr<FThreadCosts>& Thread : ThreadCosts)
+		{
+			FScopeLock ThreadLock(&Thread->Lock);
+			for (int32 CategoryIndex = 0; CategoryIndex < TcsDefinitionProfilerPrivate::NumCategories; ++CategoryIndex)
+			{
+				for (const TPair<FName, FCost>& Pair : Thread->Costs[CategoryIndex])
+				{
+					FCost& Cost = Costs[CategoryIndex].FindOrAdd(Pair.Key);
+					Cost.Calls += Pair.Value.Calls;
+					Cost.TotalCycles += Pair.Value.TotalCycles;
+					Cost.MaxCycles = FMath::Max(Cost.MaxCycles, Pair.Value.MaxCycles);
+				}
+			}
+		}
+	}
+
+	for (int32 CategoryIndex = 0; CategoryIndex < TcsDefinitionProfilerPrivate::NumCategories; ++CategoryIndex)
+	{
+		const ETcsDefinitionCostCategory EntryCategory = static_cast<ETcsDefinitionCostCategory>(CategoryIndex);
+		if (Category != ETcsDefinitionCostCategory::Num && Category != EntryCategory)
+		{
+			continue;
+		}
+
+		TArray<FTcsDefinitionCostEntry> CategoryEntries;
+		CategoryEntries.Reserve(Costs[CategoryIndex].Num());
+		for (const TPair<FName, FCost>& Pair : Costs[CategoryIndex])
+		{
+			FTcsDefinitionCostEntry& Entry = CategoryEntries.AddDefaulted_GetRef();
+			Entry.Category = EntryCategory;
+			Entry.DefinitionId = Pair.Key;
+			Entry.Calls = Pair.Value.Calls;
+			Entry.TotalCycles = Pair.Value.TotalCycles;
+			Entry.MaxCycles = Pair.Value.MaxCycles;
+		}
+
+		CategoryEntries.Sort([](const FTcsDefinitionCostEntry& A, const FTcsDefinitionCostEntry& B)
+		{
+			return A.TotalCycles > B.TotalCycles;
+		});
+		if (MaxEntries > 0 && CategoryEntries.Num() > MaxEntries)
+		{
+			CategoryEntries.SetNum(MaxEntries);
+		}
+
+		Result.Append(MoveTemp(CategoryEntries));
+	}
+
+	return Result;
+}
+
+double FTcsDefinitionProfiler::GetCaptureSeconds() const
+{
+	FScopeLock Lock(&CostsLock);
+	return AccumulatedCaptureSeconds + (IsEnabled() ? FPlatformTime::Seconds() - CaptureStartTime : 0.0);
+}
+
+void FTcsDefinitionProfiler::DumpTopN(int32 N, ETcsDefinitionCostCategory Category, FOutputDevice& Ar) const
+{
+	const TArray<FTcsDefinitionCostEntry> AllEntries = GetEntries(Category);
+	const double CaptureSeconds = GetCaptureSeconds();
+
+	Ar.Logf(TEXT("TCS definition costs (capture %.2fs, %s):"),
+		CaptureSeconds,
+		IsEnabled() ? TEXT("running") : TEXT("stopped"));
+
+	for (int32 CategoryIndex = 0; CategoryIndex < TcsDefinitionProfilerPrivate::NumCategories; ++CategoryIndex)
+	{
+		const ETcsDefinitionCostCategory EntryCategory = static_cast<ETcsDefinitionCostCategory>(CategoryIndex);
+		if (Category != ETcsDefinitionCostCategory::Num && Category != EntryCategory)
+		{
+			continue;
+		}
+
+		uint64 CategoryCycles = 0;
+		int32 NumDefinitions = 0;
+		for (const FTcsDefinitionCostEntry& Entry : AllEntries)
+		{
+			if (Entry.Category == EntryCategory)
+			{
+				CategoryCycles += Entry.TotalCycles;
+				++NumDefinitions;
+			}
+		}
+
+		Ar.Logf(TEXT("  [%s] %d definitions, total %.3f ms"),
+			GetCategoryName(EntryCategory),
+			NumDefinitions,
+			TcsDefinitionProfilerPrivate::CyclesToMs(CategoryCycles));
+		if (NumDefinitions == 0)
+		{
+			continue;
+		}
+
+		Ar.Logf(TEXT("    %-40s %10s %12s %10s %10s %7s"), TEXT("Definition"), TEXT("Calls"), TEXT("Total(ms)"), TEXT("Avg(us)"), TEXT("Max(us)"), TEXT("%"));
+
+		// 条目已按累计耗时降序排列
+		int32 NumPrinted = 0;
+		for (const FTcsDefinitionCostEntry& Entry : AllEntries)
+		{
+			if (Entry.Category != EntryCategory)
+			{
+				continue;
+			}
+			if (NumPrinted++ >= N)
+			{
+				break;
+			}
+
+			Ar.Logf(TEXT("    %-40s %10lld %12.3f %10.2f %10.2f %6.1f%%"),
+				*Entry.DefinitionId.ToString(),
+				Entry.Calls,
+				Entry.GetTotalMs(),
+				Entry.GetAverageUs(),
+				Entry.GetMaxUs(),
+				CategoryCycles > 0 ? 100.0 * Entry.TotalCycles / CategoryCycles : 0.0);
+		}
+	}
+}
+
+bool FTcsDefinitionProfiler::ExportCsv(const FString& FilePath, FString& OutFilePath) const
+{
+	OutFilePath = FilePath;
+	if (OutFilePath.IsEmpty())
+	{
+		OutFilePath = FPaths::Combine(
+			FPaths::ProfilingDir(),
+			TEXT("TcsDefinitionCost"),
+			FString::Printf(TEXT("TcsDefinitionCost-%s.csv"), *FDateTime::Now().ToString()));
+	}
+
+	const TArray<FTcsDefinitionCostEntry> Entries = GetEntries();
+
+	uint64 CategoryCycles[TcsDefinitionProfilerPrivate::NumCategories] = {};
+	for (const FTcsDefinitionCostEntry& Entry : Entries)
+	{
+		CategoryCycles[static_cast<int32>(Entry.Category)] += Entry.TotalCycles;
+	}
+
+	FString Csv = TEXT("Category,DefinitionId,Calls,TotalMs,AvgUs,MaxUs,PercentOfCategory\n");
+	for (const FTcsDefinitionCostEntry& Entry : Entries)
+	{
+		const uint64 TotalCategoryCycles = CategoryCycles[static_cast<int32>(Entry.Category)];
+		Csv += FString::Printf(TEXT("%s,%s,%lld,%.4f,%.3f,%.3f,%.2f\n"),
+			GetCategoryName(Entry.Category),
+			*Entry.DefinitionId.ToString(),
+			Entry.Calls,
+			Entry.GetTotalMs(),
+			Entry.GetAverageUs(),
+			Entry.GetMaxUs(),
+			TotalCategoryCycles > 0 ? 100.0 * Entry.TotalCycles / TotalCategoryCycles : 0.0);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *OutFilePath))
+	{
+		UE_LOG(LogTcs, Warning, TEXT("[%s] Failed to write definition costs to %s"),
+			*FString(__FUNCTION__),
+			*OutFilePath);
+		return false;
+	}
+
+	return true;
+}
+
+const TCHAR* FTcsDefinitionProfiler::GetCategoryName(ETcsDefinitionCostCategory Category)
+{
+	switch (Category)
+	{
+	case ETcsDefinitionCostCategory::StateTreeTick:
+		return TEXT("StateTreeTick");
+	case ETcsDefinitionCostCategory::ParameterEvaluation:
+		return TEXT("ParameterEvaluation");
+	case ETcsDefinitionCostCategory::ConditionCheck:
+		return TEXT("ConditionCheck");
+	case ETcsDefinitionCostCategory::ModifierExecution:
+		return TEXT("ModifierExecution");
+	default:
+		return TEXT("Unknown");
+	}
+}
+
+ETcsDefinitionCostCategory FTcsDefinitionProfiler::ParseCategory(const FString& Name)
+{
+	for (int32 CategoryIndex = 0; CategoryIndex < TcsDefinitionProfilerPrivate::NumCategories; ++CategoryIndex)
+	{
+		const ETcsDefinitionCostCategory Category = static_cast<ETcsDefinitionCostCategory>(CategoryIndex);
+		if (Name.Equals(GetCategoryName(Category), ESearchCase::IgnoreCase))
+		{
+			return Category;
+		}
+	}
+
+	return ETcsDefinitionCostCategory::Num;
+}
+
+#endif
@@ -2,6 +2,7 @@
 
 #include "TcsDefinitionRegistrySubsystem.h"
 
+#include "TcsDefinitionId.h"
 #include "TcsDeveloperSettings.h"
 #include "TcsLogChannels.h"
 #include "Attribute/TcsAttributeDefinition.h"
@@ -18,9 +19,20 @@
 
 namespace TcsDefinitionRegistryPrivate
 {
+	enum class EAddDefinitionResult : uint8
+	{
+		// 已收录
+		Added,
+		// ID 与已收录的其他资产重复，作为候选记录
+		Shadowed,
+		// 空 ID 或该路径已收录
+		Skipped
+	};
+
 	template <typename AssetType>
-	void AddDefinition(
+	EAddDefinitionResult AddDefinition(
 		TMap<FName, TSoftObjectPtr<AssetType>>& Cache,
+		ETcsDefinitionKind DefinitionKind,
 		FName DefinitionId,
 		const TSoftObjectPtr<AssetType>& AssetPtr,
 		const TCHAR* DefinitionLabel)
@@ -31,24 +43,73 @@ namespace TcsDefinitionRegistryPrivate
 				TEXT("[UTcsDefinitionRegistrySubsystem] Skipping %s with empty DefId: %s"),
 				DefinitionLabel,
 				*AssetPtr.ToSoftObjectPath().ToString());
-			return;
+			return EAddDefinitionResult::Skipped;
 		}
 
 		if (const TSoftObjectPtr<AssetType>* ExistingAsset = Cache.Find(DefinitionId))
 		{
-			if (ExistingAsset->ToSoftObjectPath() != AssetPtr.ToSoftObjectPath())
+			if (ExistingAsset->ToSoftObjectPath() == AssetPtr.ToSoftObjectPath())
 			{
-				UE_LOG(LogTcs, Error,
-					TEXT("[UTcsDefinitionRegistrySubsystem] Duplicate %s DefId '%s': '%s' conflicts with '%s'"),
-					DefinitionLabel,
-					*DefinitionId.ToString(),
-					*ExistingAsset->ToSoftObjectPath().ToString(),
-					*AssetPtr.ToSoftObjectPath().ToString());
+				return EAddDefinitionResult::Skipped;
 			}
-			return;
+
+			UE_LOG(LogTcs, Error,
+				TEXT("[UTcsDefinitionRegistrySubsystem] Duplicate %s DefId '%s': '%s' conflicts with '%s'"),
+				DefinitionLabel,
+				*DefinitionId.ToString(),
+				*ExistingAsset->ToSoftObjectPath().ToString(),
+				*AssetPtr.ToSoftObjectPath().ToString());
+			return EAddDefinitionResult::Shadowed;
 		}
 
 		Cache.Add(DefinitionId, AssetPtr);
+
+		// 注册时即分配稠密 ID，保证同一进程内所有管理器看到一致的 DefIndex
+		FTcsDefinitionIdTable::FindOrAdd(DefinitionKind, DefinitionId);
+		return EAddDefinitionResult::Added;
+	}
+
+	// 仅同步变化的 Key：Changed 中的 ID 按注册表当前内容写入（注册表中已不存在则删除），Removed 中的 ID 删除
+	template <typename AssetType>
+	void MirrorDefinitionChanges(
+		const TMap<FName, TSoftObjectPtr<AssetType>>& Source,
+		TMap<FName, TSoftObjectPtr<AssetType>>& Mirror,
+		const TSet<FName>& Changed,
+		const TSet<FName>& Removed)
+	{
+		for (const FName& DefinitionId : Removed)
+		{
+			Mirror.Remove(DefinitionId);
+		}
+
+		for (const FName& DefinitionId : Changed)
+		{
+			if (const TSoftObjectPtr<AssetType>* AssetPtr = Source.Find(DefinitionId))
+			{
+				Mirror.Add(DefinitionId, *AssetPtr);
+			}
+			else
+			{
+				Mirror.Remove(DefinitionId);
+			}
+		}
+	}
+
+	// 仅当缓存中该 ID 仍指向给定路径时移除（重复 ID 冲突时缓存可能属于另一个资产）
+	template <typename AssetType>
+	bool RemoveDefinitionAtPath(
+		TMap<FName, TSoftObjectPtr<AssetType>>& Cache,
+		FName DefinitionId,
+		const FSoftObjectPath& AssetPath)
+	{
+		const TSoftObjectPtr<AssetType>* ExistingAsset = Cache.Find(DefinitionId);
+		if (!ExistingAsset || ExistingAsset->ToSoftObjectPath() != AssetPath)
+		{
+			return false;
+		}
+
+		Cache.Remove(DefinitionId);
+		return true;
 	}
 }
 
@@ -84,6 +145,17 @@ void UTcsDefinitionRegistrySubsystem::RequestRefresh()
 		return;
 	}
 
+	bFullRefreshRequested = true;
+	ScheduleDeferredRefresh();
+}
+
+void UTcsDefinitionRegistrySubsystem::ScheduleDeferredRefresh()
+{
+	if (!GIsEditor)
+	{
+		return;
+	}
+
 	if (bIsRefreshing)
 	{
 		bRefreshRequestedWhileRefreshing = true;
@@ -117,22 +189,41 @@ void UTcsDefinitionRegistrySubsystem::RefreshDefinitionsNow()
 	ClearQueuedRefresh();
 
 	TGuardValue<bool> RefreshGuard(bIsRefreshing, true);
-	RebuildSnapshot();
-	MirrorSnapshotToDeveloperSettings();
-	bHasCompletedInitialRefresh = true;
-	++RefreshRevision;
 
-	DefinitionsRefreshed.Broadcast(this);
+	FTcsDefinitionChangeSet ChangeSet;
+	if (bFullRefreshRequested || !bHasCompletedInitialRefresh)
+	{
+		// 全量刷新会重新扫描所有目录，累积的增量随之作废
+		bFullRefreshRequested = false;
+		PendingUpsertPaths.Reset();
+		PendingRemovalPaths.Reset();
+		RebuildSnapshot();
+		ChangeSet.bIsFullRefresh = true;
+	}
+	else
+	{
+		ApplyPendingDeltas(ChangeSet);
+	}
+
+	if (!ChangeSet.IsEmpty())
+	{
+		MirrorSnapshotToDeveloperSettings(ChangeSet);
+		bHasCompletedInitialRefresh = true;
+		++RefreshRevision;
+
+		DefinitionsRefreshed.Broadcast(this, ChangeSet);
+
+		UE_LOG(LogTcs, Verbose,
+			TEXT("[UTcsDefinitionRegistrySubsystem] Published refresh revision %d (%s)"),
+			RefreshRevision,
+			ChangeSet.bIsFullRefresh ? TEXT("full") : TEXT("delta"));
+	}
 
 	if (bRefreshRequestedWhileRefreshing)
 	{
 		bRefreshRequestedWhileRefreshing = false;
-		RequestRefresh();
+		ScheduleDeferredRefresh();
 	}
-
-	UE_LOG(LogTcs, Verbose,
-		TEXT("[UTcsDefinitionRegistrySubsystem] Published refresh revision %d"),
-		RefreshRevision);
 }
 
 void UTcsDefinitionRegistrySubsystem::RegisterEditorCallbacks()
@@ -236,6 +327,8 @@ void UTcsDefinitionRegistrySubsystem::RebuildSnapshot()
 	AttributeModifierDefinitions.Empty();
 	StateDefinitions.Empty();
 	StateSlotDefinitions.Empty();
+	TrackedDefinitionsByPath.Empty();
+	ShadowedDefinitionsByPath.Empty();
 
 	const UAssetManagerSettings* AssetManagerSettings = GetDefault<UAssetManagerSettings>();
 	if (!AssetManagerSettings)
@@ -261,7 +354,7 @@ void UTcsDefinitionRegistrySubsystem::RebuildSnapshot()
 		StateSlotDefinitions.Num());
 }
 
-void UTcsDefinitionRegistrySubsystem::MirrorSnapshotToDeveloperSettings() const
+void UTcsDefinitionRegistrySubsystem::MirrorSnapshotToDeveloperSettings(const FTcsDefinitionChangeSet& ChangeSet) const
 {
 	UTcsDeveloperSettings* Settings = GetMutableDefault<UTcsDeveloperSettings>();
 	if (!Settings)
@@ -271,10 +364,36 @@ void UTcsDefinitionRegistrySubsystem::MirrorSnapshotToDeveloperSettings() const
 		return;
 	}
 
-	Settings->SetCachedAttributeDefinitions(AttributeDefinitions);
-	Settings->SetCachedAttributeModifierDefinitions(AttributeModifierDefinitions);
-	Settings->SetCachedStateDefinitions(StateDefinitions);
-	Settings->SetCachedStateSlotDefinitions(StateSlotDefinitions);
+	if (ChangeSet.bIsFullRefresh)
+	{
+		Settings->SetCachedAttributeDefinitions(AttributeDefinitions);
+		Settings->SetCachedAttributeModifierDefinitions(AttributeModifierDefinitions);
+		Settings->SetCachedStateDefinitions(StateDefinitions);
+		Settings->SetCachedStateSlotDefinitions(StateSlotDefinitions);
+		return;
+	}
+
+	// 增量刷新只同步变化的 Key，避免每次资产保存都复制整张映射
+	TcsDefinitionRegistryPrivate::MirrorDefinitionChanges(
+		AttributeDefinitions,
+		Settings->GetMutableCachedAttributeDefinitions(),
+		ChangeSet.GetChanged(ETcsDefinitionKind::Attribute),
+		ChangeSet.GetRemoved(ETcsDefinitionKind::Attribute));
+	TcsDefinitionRegistryPrivate::MirrorDefinitionChanges(
+		AttributeModifierDefinitions,
+		Settings->GetMutableCachedAttributeModifierDefinitions(),
+		ChangeSet.GetChanged(ETcsDefinitionKind::AttributeModifier),
+		ChangeSet.GetRemoved(ETcsDefinitionKind::AttributeModifier));
+	TcsDefinitionRegistryPrivate::MirrorDefinitionChanges(
+		StateDefinitions,
+		Settings->GetMutableCachedStateDefinitions(),
+		ChangeSet.GetChanged(ETcsDefinitionKind::State),
+		ChangeSet.GetRemoved(ETcsDefinitionKind::State));
+	TcsDefinitionRegistryPrivate::MirrorDefinitionChanges(
+		StateSlotDefinitions,
+		Settings->GetMutableCachedStateSlotDefinitions(),
+		ChangeSet.GetChanged(ETcsDefinitionKind::StateSlot),
+		ChangeSet.GetRemoved(ETcsDefinitionKind::StateSlot));
 }
 
 void UTcsDefinitionRegistrySubsystem::ScanPrimaryAssetType(const FPrimaryAssetTypeInfo& TypeInfo, IAssetRegistry& AssetRegistry)
@@ -323,11 +442,20 @@ void UTcsDefinitionRegistrySubsystem::ScanAttributeDefinitions(const TArray<FAss
 			continue;
 		}
 
-		TcsDefinitionRegistryPrivate::AddDefinition(
+		const TcsDefinitionRegistryPrivate::EAddDefinitionResult Result = TcsDefinitionRegistryPrivate::AddDefinition(
 			AttributeDefinitions,
+			ETcsDefinitionKind::Attribute,
 			Asset->AttributeDefId,
 			AssetPtr,
 			TEXT("Attribute"));
+		if (Result == TcsDefinitionRegistryPrivate::EAddDefinitionResult::Added)
+		{
+			TrackDefinition(ETcsDefinitionKind::Attribute, Asset->AttributeDefId, AssetPtr.ToSoftObjectPath());
+		}
+		else if (Result == TcsDefinitionRegistryPrivate::EAddDefinitionResult::Shadowed)
+		{
+			TrackShadowedDefinition(ETcsDefinitionKind::Attribute, Asset->AttributeDefId, AssetPtr.ToSoftObjectPath());
+		}
 	}
 }
 
@@ -342,13 +470,22 @@ void UTcsDefinitionRegistrySubsystem::ScanAttributeModifierDefinitions(const TAr
 			continue;
 		}
 
-		TcsDefinitionRegistryPrivate::AddDefinition(
+		const TcsDefinitionRegistryPrivate::EAddDefinitionResult Result = TcsDefinitionRegistryPrivate::AddDefinition(
 			AttributeModifierDefinitions,
+			ETcsDefinitionKind::AttributeModifier,
 			Asset->AttributeModifierDefId,
 			AssetPtr,
 			TEXT("AttributeModifier"));
+		if (Result == TcsDefinitionRegistryPrivate::EAddDefinitionResult::Added)
+		{
+			TrackDefinition(ETcsDefinitionKind::AttributeModifier, Asset->AttributeModifierDefId, AssetPtr.ToSoftObjectPath());
+		}
+		else if (Result == TcsDefinitionRegistryPrivate::EAddDefinitionResult::Shadowed)
+		{
+			TrackShadowedDefinition(ETcsDefinitionKind::AttributeModifier, Asset->AttributeModifierDefId, AssetPtr.ToSoftObjectPath());
+		}
 	}
-	}
+}
 
 void UTcsDefinitionRegistrySubsystem::ScanStateDefinitions(const TArray<FAssetData>& AssetDataList)
 {
@@ -361,11 +498,20 @@ void UTcsDefinitionRegistrySubsystem::ScanStateDefinitions(const TArray<FAssetDa
 			continue;
 		}
 
-		TcsDefinitionRegistryPrivate::AddDefinition(
+		const TcsDefinitionRegistryPrivate::EAddDefinitionResult Result = TcsDefinitionRegistryPrivate::AddDefinition(
 			StateDefinitions,
+			ETcsDefinitionKind::State,
 			Asset->StateDefId,
 			AssetPtr,
 			TEXT("State"));
+		if (Result == TcsDefinitionRegistryPrivate::EAddDefinitionResult::Added)
+		{
+			TrackDefinition(ETcsDefinitionKind::State, Asset->StateDefId, AssetPtr.ToSoftObjectPath());
+		}
+		else if (Result == TcsDefinitionRegistryPrivate::EAddDefinitionResult::Shadowed)
+		{
+			TrackShadowedDefinition(ETcsDefinitionKind::State, Asset->StateDefId, AssetPtr.ToSoftObjectPath());
+		}
 	}
 }
 
@@ -380,11 +526,20 @@ void UTcsDefinitionRegistrySubsystem::ScanStateSlotDefinitions(const TArray<FAss
 			continue;
 		}
 
-		TcsDefinitionRegistryPrivate::AddDefinition(
+		const TcsDefinitionRegistryPrivate::EAddDefinitionResult Result = TcsDefinitionRegistryPrivate::AddDefinition(
 			StateSlotDefinitions,
+			ETcsDefinitionKind::StateSlot,
 			Asset->StateSlotDefId,
 			AssetPtr,
 			TEXT("StateSlot"));
+		if (Result == TcsDefinitionRegistryPrivate::EAddDefinitionResult::Added)
+		{
+			TrackDefinition(ETcsDefinitionKind::StateSlot, Asset->StateSlotDefId, AssetPtr.ToSoftObjectPath());
+		}
+		else if (Result == TcsDefinitionRegistryPrivate::EAddDefinitionResult::Shadowed)
+		{
+			TrackShadowedDefinition(ETcsDefinitionKind::StateSlot, Asset->StateSlotDefId, AssetPtr.ToSoftObjectPath());
+		}
 	}
 }
 
@@ -420,7 +575,7 @@ void UTcsDefinitionRegistrySubsystem::OnAssetAdded(const FAssetData& AssetData)
 {
 	if (IsTrackedDefinitionClass(AssetData))
 	{
-		RequestRefresh();
+		QueueDefinitionUpsert(AssetData.ToSoftObjectPath());
 	}
 }
 
@@ -428,25 +583,29 @@ void UTcsDefinitionRegistrySubsystem::OnAssetUpdated(const FAssetData& AssetData
 {
 	if (IsTrackedDefinitionClass(AssetData))
 	{
-		RequestRefresh();
+		QueueDefinitionUpsert(AssetData.ToSoftObjectPath());
 	}
 }
 
 void UTcsDefinitionRegistrySubsystem::OnAssetRemoved(const FAssetData& AssetData)
 {
-	RequestRefresh();
+	QueueDefinitionRemoval(AssetData.ToSoftObjectPath());
 }
 
 void UTcsDefinitionRegistrySubsystem::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
 {
-	RequestRefresh();
+	QueueDefinitionRemoval(FSoftObjectPath(OldObjectPath));
+	if (IsTrackedDefinitionClass(AssetData))
+	{
+		QueueDefinitionUpsert(AssetData.ToSoftObjectPath());
+	}
 }
 
 void UTcsDefinitionRegistrySubsystem::OnInMemoryAssetCreated(UObject* AssetObject)
 {
 	if (IsTrackedDefinitionObject(AssetObject))
 	{
-		RequestRefresh();
+		QueueDefinitionUpsert(FSoftObjectPath(AssetObject));
 	}
 }
 
@@ -454,7 +613,7 @@ void UTcsDefinitionRegistrySubsystem::OnInMemoryAssetDeleted(UObject* AssetObjec
 {
 	if (IsTrackedDefinitionObject(AssetObject))
 	{
-		RequestRefresh();
+		QueueDefinitionRemoval(FSoftObjectPath(AssetObject));
 	}
 }
 
@@ -471,5 +630,273 @@ void UTcsDefinitionRegistrySubsystem::ClearQueuedRefresh()
 		FTSTicker::GetCoreTicker().RemoveTicker(DeferredRefreshHandle);
 		DeferredRefreshHandle.Reset();
 	}
+}
+
+void UTcsDefinitionRegistrySubsystem::QueueDefinitionUpsert(const FSoftObjectPath& AssetPath)
+{
+	if (AssetPath.IsNull())
+	{
+		return;
+	}
+
+	PendingRemovalPaths.Remove(AssetPath);
+	PendingUpsertPaths.Add(AssetPath);
+	ScheduleDeferredRefresh();
+}
+
+void UTcsDefinitionRegistrySubsystem::QueueDefinitionRemoval(const FSoftObjectPath& AssetPath)
+{
+	PendingUpsertPaths.Remove(AssetPath);
+
+	// 删除事件对所有资产广播，只处理已注册的定义（含重复 ID 的候选）
+	if (!TrackedDefinitionsByPath.Contains(AssetPath) && !ShadowedDefinitionsByPath.Contains(AssetPath))
+	{
+		return;
+	}
+
+	PendingRemovalPaths.Add(AssetPath);
+	ScheduleDeferredRefresh();
+}
+
+void UTcsDefinitionRegistrySubsystem::ApplyPendingDeltas(FTcsDefinitionChangeSet& OutChangeSet)
+{
+	for (const FSoftObjectPath& AssetPath : PendingRemovalPaths)
+	{
+		RemoveDefinition(AssetPath, OutChangeSet);
+	}
+
+	for (const FSoftObjectPath& AssetPath : PendingUpsertPaths)
+	{
+		UpsertDefinition(AssetPath, OutChangeSet);
+	}
+
+	const int32 NumRemovals = PendingRemovalPaths.Num();
+	const int32 NumUpserts = PendingUpsertPaths.Num();
+	PendingRemovalPaths.Reset();
+	PendingUpsertPaths.Reset();
+
+	// 同一 ID 先移除后重新添加（内容更新、路径变化）视为更新
+	for (int32 KindIndex = 0; KindIndex < static_cast<int32>(ETcsDefinitionKind::Num); ++KindIndex)
+	{
+		OutChangeSet.Removed[KindIndex] = OutChangeSet.Removed[KindIndex].Difference(OutChangeSet.Changed[KindIndex]);
+	}
+
+	UE_LOG(LogTcs, Verbose,
+		TEXT("[UTcsDefinitionRegistrySubsystem] Applied %d upserts and %d removals incrementally"),
+		NumUpserts,
+		NumRemovals);
+}
+
+void UTcsDefinitionRegistrySubsystem::UpsertDefinition(const FSoftObjectPath& AssetPath, FTcsDefinitionChangeSet& OutChangeSet)
+{
+	UObject* AssetObject = AssetPath.TryLoad();
+
+	// 该路径已生效且 DefId 未变：仅内容更新，保留原注册（先移除再添加会让重复 ID 的候选抢先顶替）
+	if (AssetObject)
+	{
+		const FPrimaryAssetId AssetId = AssetObject->GetPrimaryAssetId();
+		const TPair<ETcsDefinitionKind, FName>* TrackedDefinition = TrackedDefinitionsByPath.Find(AssetPath);
+		if (TrackedDefinition &&
+			TrackedDefinition->Value == AssetId.PrimaryAssetName &&
+			IsInScannedDirectories(AssetId.PrimaryAssetType, AssetPath))
+		{
+			OutChangeSet.Changed[static_cast<int32>(TrackedDefinition->Key)].Add(TrackedDefinition->Value);
+			return;
+		}
+	}
+
+	// 先移除该路径上的旧记录：资产的 DefId 可能已被修改
+	RemoveDefinition(AssetPath, OutChangeSet);
+
+	if (!AssetObject)
+	{
+		return;
+	}
+
+	auto Register = [this, &AssetPath, &OutChangeSet](
+		auto& Cache,
+		ETcsDefinitionKind Kind,
+		const FPrimaryAssetType& PrimaryAssetType,
+		FName DefinitionId,
+		const TCHAR* DefinitionLabel)
+	{
+		// 与全量扫描保持一致：只收录 AssetManager 扫描目录下的定义
+		if (!IsInScannedDirectories(PrimaryAssetType, AssetPath))
+		{
+			return;
+		}
+
+		using FAssetPtr = typename TRemoveReference<decltype(Cache)>::Type::ValueType;
+		const TcsDefinitionRegistryPrivate::EAddDefinitionResult Result =
+			TcsDefinitionRegistryPrivate::AddDefinition(Cache, Kind, DefinitionId, FAssetPtr(AssetPath), DefinitionLabel);
+		if (Result == TcsDefinitionRegistryPrivate::EAddDefinitionResult::Added)
+		{
+			TrackDefinition(Kind, DefinitionId, AssetPath);
+			OutChangeSet.Changed[static_cast<int32>(Kind)].Add(DefinitionId);
+		}
+		else if (Result == TcsDefinitionRegistryPrivate::EAddDefinitionResult::Shadowed)
+		{
+			TrackShadowedDefinition(Kind, DefinitionId, AssetPath);
+		}
+	};
+
+	if (const UTcsAttributeDefinition* AttributeDef = Cast<UTcsAttributeDefinition>(AssetObject))
+	{
+		Register(AttributeDefinitions, ETcsDefinitionKind::Attribute,
+			UTcsAttributeDefinition::PrimaryAssetType, AttributeDef->AttributeDefId, TEXT("Attribute"));
+	}
+	else if (const UTcsAttributeModifierDefinition* ModifierDef = Cast<UTcsAttributeModifierDefinition>(AssetObject))
+	{
+		Register(AttributeModifierDefinitions, ETcsDefinitionKind::AttributeModifier,
+			UTcsAttributeModifierDefinition::PrimaryAssetType, ModifierDef->AttributeModifierDefId, TEXT("AttributeModifier"));
+	}
+	else if (const UTcsStateDefinition* StateDef = Cast<UTcsStateDefinition>(AssetObject))
+	{
+		Register(StateDefinitions, ETcsDefinitionKind::State,
+			UTcsStateDefinition::PrimaryAssetType, StateDef->StateDefId, TEXT("State"));
+	}
+	else if (const UTcsStateSlotDefinition* StateSlotDef = Cast<UTcsStateSlotDefinition>(AssetObject))
+	{
+		Register(StateSlotDefinitions, ETcsDefinitionKind::StateSlot,
+			UTcsStateSlotDefinition::PrimaryAssetType, StateSlotDef->StateSlotDefId, TEXT("StateSlot"));
+	}
+}
+
+void UTcsDefinitionRegistrySubsystem::RemoveDefinition(const FSoftObjectPath& AssetPath, FTcsDefinitionChangeSet& OutChangeSet)
+{
+	// 未生效的候选直接丢弃，不影响已收录的定义
+	if (ShadowedDefinitionsByPath.Remove(AssetPath) > 0)
+	{
+		return;
+	}
+
+	TPair<ETcsDefinitionKind, FName> TrackedDefinition;
+	if (!TrackedDefinitionsByPath.RemoveAndCopyValue(AssetPath, TrackedDefinition))
+	{
+		return;
+	}
+
+	const ETcsDefinitionKind Kind = TrackedDefinition.Key;
+	const FName DefinitionId = TrackedDefinition.Value;
+
+	bool bRemoved = false;
+	switch (Kind)
+	{
+	case ETcsDefinitionKind::Attribute:
+		bRemoved = TcsDefinitionRegistryPrivate::RemoveDefinitionAtPath(AttributeDefinitions, DefinitionId, AssetPath);
+		break;
+	case ETcsDefinitionKind::AttributeModifier:
+		bRemoved = TcsDefinitionRegistryPrivate::RemoveDefinitionAtPath(AttributeModifierDefinitions, DefinitionId, AssetPath);
+		break;
+	case ETcsDefinitionKind::State:
+		bRemoved = TcsDefinitionRegistryPrivate::RemoveDefinitionAtPath(StateDefinitions, DefinitionId, AssetPath);
+		break;
+	case ETcsDefinitionKind::StateSlot:
+		bRemoved = TcsDefinitionRegistryPrivate::RemoveDefinitionAtPath(StateSlotDefinitions, DefinitionId, AssetPath);
+		break;
+	default:
+		break;
+	}
+
+	if (bRemoved)
+	{
+		OutChangeSet.Removed[static_cast<int32>(Kind)].Add(DefinitionId);
+		PromoteShadowedDefinition(Kind, DefinitionId, OutChangeSet);
+	}
+}
+
+bool UTcsDefinitionRegistrySubsystem::IsInScannedDirectories(const FPrimaryAssetType& PrimaryAssetType, const FSoftObjectPath& AssetPath) const
+{
+	const UAssetManagerSettings* AssetManagerSettings = GetDefault<UAssetManagerSettings>();
+	if (!AssetManagerSettings)
+	{
+		return false;
+	}
+
+	const FString PackageName = AssetPath.GetLongPackageName();
+	for (const FPrimaryAssetTypeInfo& TypeInfo : AssetManagerSettings->PrimaryAssetTypesToScan)
+	{
+		if (TypeInfo.PrimaryAssetType != PrimaryAssetType)
+		{
+			continue;
+		}
+
+		for (const FDirectoryPath& Directory : TypeInfo.GetDirectories())
+		{
+			const FString DirectoryPrefix = Directory.Path.EndsWith(TEXT("/")) ? Directory.Path : Directory.Path + TEXT("/");
+			if (PackageName.StartsWith(DirectoryPrefix))
+			{
+				return true;
+			}
+		}
 	}
+
+	return false;
+}
+
+void UTcsDefinitionRegistrySubsystem::TrackDefinition(ETcsDefinitionKind Kind, FName DefinitionId, const FSoftObjectPath& AssetPath)
+{
+	TrackedDefinitionsByPath.Add(AssetPath, TPair<ETcsDefinitionKind, FName>(Kind, DefinitionId));
+}
+
+void UTcsDefinitionRegistrySubsystem::TrackShadowedDefinition(ETcsDefinitionKind Kind, FName DefinitionId, const FSoftObjectPath& AssetPath)
+{
+	ShadowedDefinitionsByPath.Add(AssetPath, TPair<ETcsDefinitionKind, FName>(Kind, DefinitionId));
+}
+
+void UTcsDefinitionRegistrySubsystem::PromoteShadowedDefinition(ETcsDefinitionKind Kind, FName DefinitionId, FTcsDefinitionChangeSet& OutChangeSet)
+{
+	// 多个候选时按路径字典序选取，保证结果与事件顺序无关
+	const FSoftObjectPath* CandidatePath = nullptr;
+	for (const TPair<FSoftObjectPath, TPair<ETcsDefinitionKind, FName>>& Pair : ShadowedDefinitionsByPath)
+	{
+		if (Pair.Value.Key == Kind && Pair.Value.Value == DefinitionId &&
+			(!CandidatePath || Pair.Key.ToString() < CandidatePath->ToString()))
+		{
+			CandidatePath = &Pair.Key;
+		}
+	}
+
+	if (!CandidatePath)
+	{
+		return;
+	}
+
+	const FSoftObjectPath AssetPath = *CandidatePath;
+	ShadowedDefinitionsByPath.Remove(AssetPath);
+
+	TcsDefinitionRegistryPrivate::EAddDefinitionResult Result = TcsDefinitionRegistryPrivate::EAddDefinitionResult::Skipped;
+	switch (Kind)
+	{
+	case ETcsDefinitionKind::Attribute:
+		Result = TcsDefinitionRegistryPrivate::AddDefinition(AttributeDefinitions, Kind, DefinitionId,
+			TSoftObjectPtr<UTcsAttributeDefinition>(AssetPath), TEXT("Attribute"));
+		break;
+	case ETcsDefinitionKind::AttributeModifier:
+		Result = TcsDefinitionRegistryPrivate::AddDefinition(AttributeModifierDefinitions, Kind, DefinitionId,
+			TSoftObjectPtr<UTcsAttributeModifierDefinition>(AssetPath), TEXT("AttributeModifier"));
+		break;
+	case ETcsDefinitionKind::State:
+		Result = TcsDefinitionRegistryPrivate::AddDefinition(StateDefinitions, Kind, DefinitionId,
+			TSoftObjectPtr<UTcsStateDefinition>(AssetPath), TEXT("State"));
+		break;
+	case ETcsDefinitionKind::StateSlot:
+		Result = TcsDefinitionRegistryPrivate::AddDefinition(StateSlotDefinitions, Kind, DefinitionId,
+			TSoftObjectPtr<UTcsStateSlotDefinition>(AssetPath), TEXT("StateSlot"));
+		break;
+	default:
+		break;
+	}
+
+	if (Result == TcsDefinitionRegistryPrivate::EAddDefinitionResult::Added)
+	{
+		TrackDefinition(Kind, DefinitionId, AssetPath);
+		OutChangeSet.Changed[static_cast<int32>(Kind)].Add(DefinitionId);
+
+		UE_LOG(LogTcs, Log,
+			TEXT("[UTcsDefinitionRegistrySubsystem] Promoted '%s' for DefId '%s' after the previous asset was removed"),
+			*AssetPath.ToString(),
+			*DefinitionId.ToString());
+	}
+}
 #endif
\ No newline at end of file
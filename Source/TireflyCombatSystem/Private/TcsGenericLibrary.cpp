@@ -4,7 +4,9 @@
 
 #include "TcsDeveloperSettings.h"
 #include "TcsEntityInterface.h"
+#include "TcsSourceHandleRegistry.h"
 #include "Attribute/TcsAttributeComponent.h"
+#include "Attribute/TcsAttributeManagerSubsystem.h"
 #include "State/TcsStateComponent.h"
 #include "Skill/TcsSkillComponent.h"
 
@@ -66,6 +68,31 @@ UTcsStateComponent* UTcsGenericLibrary::GetStateComponent(AActor *Actor)
 	return nullptr;
 }
 
+AActor* UTcsGenericLibrary::GetSourceHandleInstigator(const UObject* WorldContextObject, const FTcsSourceHandle& SourceHandle)
+{
+	const FTcsSourceHandleRegistry* Registry = UTcsAttributeManagerSubsystem::FindSourceHandleRegistry(WorldContextObject);
+	const FTcsSourceHandleData* Data = Registry ? Registry->Resolve(SourceHandle) : nullptr;
+	return Data ? Data->Instigator.Get() : nullptr;
+}
+
+FGameplayTagContainer UTcsGenericLibrary::GetSourceHandleTags(const UObject* WorldContextObject, const FTcsSourceHandle& SourceHandle)
+{
+	const FTcsSourceHandleRegistry* Registry = UTcsAttributeManagerSubsystem::FindSourceHandleRegistry(WorldContextObject);
+	const FTcsSourceHandleData* Data = Registry ? Registry->Resolve(SourceHandle) : nullptr;
+	return Data ? Data->SourceTags : FGameplayTagContainer();
+}
+
+TArray<FPrimaryAssetId> UTcsGenericLibrary::GetSourceHandleCausalityChain(const UObject* WorldContextObject, const FTcsSourceHandle& SourceHandle)
+{
+	TArray<FPrimaryAssetId> CausalityChain;
+	const FTcsSourceHandleRegistry* Registry = UTcsAttributeManagerSubsystem::FindSourceHandleRegistry(WorldContextObject);
+	if (const FTcsSourceHandleData* Data = Registry ? Registry->Resolve(SourceHandle) : nullptr)
+	{
+		Data->GetCausalityChain(CausalityChain);
+	}
+	return CausalityChain;
+}
+
 UTcsSkillComponent *UTcsGenericLibrary::GetSkillComponent(AActor *Actor)
 {
 	if (IsValid(Actor) && Actor->Implements<UTcsEntityInterface>())
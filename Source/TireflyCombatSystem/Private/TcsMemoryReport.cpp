@@ -0,0 +1,198 @@
+// Copyright Tirefly. All Rights Reserved.
+
+
+#include "TcsMemoryReport.h"
+
+#include "Attribute/TcsAttributeComponent.h"
+#include "Attribute/TcsAttributeManagerSubsystem.h"
+#include "State/TcsStateComponent.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+
+
+namespace TcsMemoryReportPrivate
+{
+	constexpr int32 DefaultTopN = 20;
+
+	FString FormatBytes(int64 Bytes)
+	{
+		if (Bytes >= 1024 * 1024)
+		{
+			return FString::Printf(TEXT("%.2f MB"), Bytes / (1024.0 * 1024.0));
+		}
+		if (Bytes >= 1024)
+		{
+			return FString::Printf(TEXT("%.2f KB"), Bytes / 1024.0);
+		}
+		return FString::Printf(TEXT("%lld B"), Bytes);
+	}
+
+	// 按字节数降序输出统计桶
+	void DumpBuckets(const TCHAR* Title, const TMap<FName, FTcsMemoryBucket>& Buckets, int32 MaxEntries, FOutputDevice& Ar)
+	{
+		TArray<TPair<FName, FTcsMemoryBucket>> Sorted = Buckets.Array();
+		Sorted.Sort([](const TPair<FName, FTcsMemoryBucket>& A, const TPair<FName, FTcsMemoryBucket>& B)
+		{
+			return A.Value.Bytes > B.Value.Bytes;
+		});
+
+		Ar.Logf(TEXT("  %s (%d):"), Title, Sorted.Num());
+		const int32 NumToPrint = MaxEntries > 0 ? FMath::Min(MaxEntries, Sorted.Num()) : Sorted.Num();
+		for (int32 Index = 0; Index < NumToPrint; ++Index)
+		{
+			Ar.Logf(TEXT("    %-56s %12s %10lld"),
+				*Sorted[Index].Key.ToString(),
+				*FormatBytes(Sorted[Index].Value.Bytes),
+				Sorted[Index].Value.Count);
+		}
+	}
+
+	template<typename TComponent>
+	void CollectComponents(const UWorld* World, FTcsMemoryReport& Report, int32& OutNumComponents)
+	{
+		for (TObjectIterator<TComponent> It; It; ++It)
+		{
+			const TComponent* Component = *It;
+			if (Component->IsTemplate() || Component->GetWorld() != World || !IsValid(Component))
+			{
+				continue;
+			}
+
+			FTcsMemoryUsage ComponentUsage;
+			Component->CollectMemoryUsage(ComponentUsage);
+
+			FTcsComponentMemoryEntry& Entry = Report.Components.AddDefaulted_GetRef();
+			Entry.OwnerName = Component->GetOwner() ? Component->GetOwner()->GetName() : Component->GetName();
+			Entry.ComponentClass = Component->GetClass()->GetFName();
+			Entry.Bytes = ComponentUsage.TotalBytes;
+
+			// 状态组件统计状态实例数量，属性组件统计修改器数量
+			const TMap<FName, FTcsMemoryBucket>& ItemBuckets = std::is_same_v<TComponent, UTcsStateComponent>
+				? ComponentUsage.StateDefinitions
+				: ComponentUsage.ModifierDefinitions;
+			for (const TPair<FName, FTcsMemoryBucket>& Pair : ItemBuckets)
+			{
+				Entry.NumItems += static_cast<int32>(Pair.Value.Count);
+			}
+
+			Report.Usage.Append(ComponentUsage);
+			++OutNumComponents;
+		}
+	}
+
+	FAutoConsoleCommandWithWorldArgsAndOutputDevice MemReportCommand(
+		TEXT("tcs.memreport"),
+		TEXT("Report memory allocated by TCS attribute/state components in the current world, per component, container and definition. Usage: tcs.memreport [N=20]"),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+		{
+			if (!World)
+			{
+				Ar.Logf(TEXT("tcs.memreport: no world."));
+				return;
+			}
+
+			const int32 TopN = Args.Num() > 0 && Args[0].IsNumeric() ? FMath::Max(1, FCString::Atoi(*Args[0])) : DefaultTopN;
+			FTcsMemoryReport::Collect(World).Dump(Ar, TopN);
+		}));
+}
+
+
+
+void FTcsMemoryUsage::AddContainer(FName ContainerName, SIZE_T Bytes, int64 Count)
+{
+	Containers.FindOrAdd(ContainerName).Add(static_cast<int64>(Bytes), Count);
+	TotalBytes += static_cast<int64>(Bytes);
+}
+
+void FTcsMemoryUsage::AddStateDefinition(FName StateDefId, SIZE_T Bytes)
+{
+	StateDefinitions.FindOrAdd(StateDefId).Add(static_cast<int64>(Bytes));
+}
+
+void FTcsMemoryUsage::AddModifierDefinition(FName ModifierId, SIZE_T Bytes)
+{
+	ModifierDefinitions.FindOrAdd(ModifierId).Add(static_cast<int64>(Bytes));
+}
+
+void FTcsMemoryUsage::Append(const FTcsMemoryUsage& Other)
+{
+	auto AppendBuckets = [](TMap<FName, FTcsMemoryBucket>& Target, const TMap<FName, FTcsMemoryBucket>& Source)
+	{
+		for (const TPair<FName, FTcsMemoryBucket>& Pair : Source)
+		{
+			Target.FindOrAdd(Pair.Key).Add(Pair.Value.Bytes, Pair.Value.Count);
+		}
+	};
+
+	AppendBuckets(Containers, Other.Containers);
+	AppendBuckets(StateDefinitions, Other.StateDefinitions);
+	AppendBuckets(ModifierDefinitions, Other.ModifierDefinitions);
+	TotalBytes += Other.TotalBytes;
+}
+
+
+
+FTcsMemoryReport FTcsMemoryReport::Collect(const UWorld* World)
+{
+	check(IsInGameThread());
+
+	FTcsMemoryReport Report;
+	if (!World)
+	{
+		return Report;
+	}
+
+	TcsMemoryReportPrivate::CollectComponents<UTcsAttributeComponent>(World, Report, Report.NumAttributeComponents);
+	TcsMemoryReportPrivate::CollectComponents<UTcsStateComponent>(World, Report, Report.NumStateComponents);
+
+	Report.Components.Sort([](const FTcsComponentMemoryEntry& A, const FTcsComponentMemoryEntry& B)
+	{
+		return A.Bytes > B.Bytes;
+	});
+
+	const UGameInstance* GameInstance = World->GetGameInstance();
+	if (const UTcsAttributeManagerSubsystem* AttrMgr = GameInstance ? GameInstance->GetSubsystem<UTcsAttributeManagerSubsystem>() : nullptr)
+	{
+		const FTcsSourceHandleRegistry& Registry = AttrMgr->GetSourceHandleRegistry();
+		Report.SourceHandleRegistryBytes = static_cast<int64>(Registry.GetAllocatedSize());
+		Report.NumLiveSourceHandles = Registry.NumLive();
+	}
+
+	return Report;
+}
+
+void FTcsMemoryReport::Dump(FOutputDevice& Ar, int32 TopN) const
+{
+	using namespace TcsMemoryReportPrivate;
+
+	Ar.Logf(TEXT("TCS memory report: total %s (components %s, source handle registry %s)"),
+		*FormatBytes(GetTotalBytes()),
+		*FormatBytes(Usage.TotalBytes),
+		*FormatBytes(SourceHandleRegistryBytes));
+	Ar.Logf(TEXT("  %d attribute components, %d state components, %d live source handles"),
+		NumAttributeComponents,
+		NumStateComponents,
+		NumLiveSourceHandles);
+
+	// 容器数量有限，全部输出
+	DumpBuckets(TEXT("Containers [name, bytes, count]"), Usage.Containers, 0, Ar);
+
+	Ar.Logf(TEXT("  Components (%d, top %d) [owner, class, bytes, states/modifiers]:"), Components.Num(), TopN);
+	const int32 NumComponentsToPrint = FMath::Min(TopN, Components.Num());
+	for (int32 Index = 0; Index < NumComponentsToPrint; ++Index)
+	{
+		const FTcsComponentMemoryEntry& Entry = Components[Index];
+		Ar.Logf(TEXT("    %-40s %-32s %12s %10d"),
+			*Entry.OwnerName,
+			*Entry.ComponentClass.ToString(),
+			*FormatBytes(Entry.Bytes),
+			Entry.NumItems);
+	}
+
+	DumpBuckets(TEXT("State definitions [id, bytes, instances]"), Usage.StateDefinitions, TopN, Ar);
+	DumpBuckets(TEXT("Modifier definitions [id, bytes, instances]"), Usage.ModifierDefinitions, TopN, Ar);
+}
@@ -3,49 +3,308 @@
 
 #include "TcsSourceHandle.h"
 
+#include "TcsDefinitionId.h"
+#include "TcsLogChannels.h"
+#include "TcsSourceHandleNetCache.h"
+#include "TcsSourceHandleRegistry.h"
+#include "Attribute/TcsAttributeManagerSubsystem.h"
+#include "GameFramework/Actor.h"
+#include "State/TcsStateDefinition.h"
+
+
+
+namespace TcsSourceHandlePrivate
+{
+	// 接收端允许的最大因果链长度（防止异常数据导致超大分配）
+	constexpr uint32 MaxNetCausalityDepth = 256;
+
+	/**
+	 * 序列化因果链中的单个资产 Id
+	 * 对端 State 定义列表与本端一致时，状态定义写为 NetIndex + 1；其余资产写 0 后跟完整 FPrimaryAssetId
+	 */
+	bool SerializeCausalityEntry(FArchive& Ar, const FTcsSourceHandleNetContext& Context, FPrimaryAssetId& AssetId)
+	{
+		uint32 NetIndexPlusOne = 0;
+		if (Ar.IsSaving()
+			&& Context.CanUseNetIndex(ETcsDefinitionKind::State)
+			&& AssetId.PrimaryAssetType == UTcsStateDefinition::PrimaryAssetType)
+		{
+			const int32 NetIndex = FTcsDefinitionIdTable::FindNetIndex(ETcsDefinitionKind::State, AssetId.PrimaryAssetName);
+			NetIndexPlusOne = NetIndex != INDEX_NONE ? static_cast<uint32>(NetIndex) + 1 : 0;
+		}
+		Ar.SerializeIntPacked(NetIndexPlusOne);
+
+		if (NetIndexPlusOne == 0)
+		{
+			Ar << AssetId;
+			return !Ar.IsError();
+		}
+
+		if (Ar.IsLoading())
+		{
+			const FName StateDefId = FTcsDefinitionIdTable::GetNetDefinitionId(
+				ETcsDefinitionKind::State,
+				static_cast<int32>(NetIndexPlusOne - 1));
+			if (StateDefId.IsNone())
+			{
+				UE_LOG(LogTcs, Warning, TEXT("[%s] Unknown state definition net index %u, definition lists differ between peers"),
+					*FString(__FUNCTION__), NetIndexPlusOne - 1);
+				return false;
+			}
+			AssetId = FPrimaryAssetId(UTcsStateDefinition::PrimaryAssetType, StateDefId);
+		}
+
+		return true;
+	}
+
+	/**
+	 * 序列化因果链
+	 *
+	 * 格式: bHasChain | bCachedRef | 缓存形式: ChainRef
+	 *                              | 完整形式: ChainRef + 1 (0 表示未缓存), Depth, Entry * Depth
+	 */
+	bool SerializeCausalityChain(
+		FArchive& Ar,
+		const FTcsSourceHandleNetContext& Context,
+		TSharedPtr<const FTcsCausalityNode>& CausalityTail)
+	{
+		uint8 bHasChain = CausalityTail.IsValid() ? 1 : 0;
+		Ar.SerializeBits(&bHasChain, 1);
+		if (!bHasChain)
+		{
+			CausalityTail.Reset();
+			return true;
+		}
+
+		// 对端已确认的链只写出链引用号
+		int32 ChainRef = INDEX_NONE;
+		uint8 bCachedRef = 0;
+		if (Ar.IsSaving() && Context.Cache)
+		{
+			ChainRef = Context.Cache->FindAckedChainRef(CausalityTail.Get());
+			bCachedRef = ChainRef != INDEX_NONE ? 1 : 0;
+			if (!bCachedRef)
+			{
+				ChainRef = Context.Cache->RecordChainSent(CausalityTail, Context.SendPacketId);
+			}
+		}
+		Ar.SerializeBits(&bCachedRef, 1);
+
+		if (bCachedRef)
+		{
+			uint32 CachedChainRef = static_cast<uint32>(ChainRef);
+			Ar.SerializeIntPacked(CachedChainRef);
+
+			if (Ar.IsLoading())
+			{
+				if (Ar.IsError())
+				{
+					return false;
+				}
+
+				// 发送端以包确认判断链已送达，但接收端可能并未处理那次完整发送：
+				// 读取照常继续，句柄暂不带因果链，并请求发送端之后重新完整发送
+				if (!Context.Cache || !Context.Cache->FindReceivedChain(static_cast<int32>(CachedChainRef), CausalityTail))
+				{
+					UE_LOG(LogTcs, Warning, TEXT("[%s] Received unknown causality chain ref %u, requesting full chains"),
+						*FString(__FUNCTION__), CachedChainRef);
+					CausalityTail.Reset();
+					if (Context.Cache)
+					{
+						Context.Cache->RecordUnknownChainRef();
+					}
+				}
+			}
+			return true;
+		}
+
+		// 完整形式
+		uint32 ChainRefPlusOne = ChainRef != INDEX_NONE ? static_cast<uint32>(ChainRef) + 1 : 0;
+		Ar.SerializeIntPacked(ChainRefPlusOne);
+
+		TArray<FPrimaryAssetId> CausalityChain;
+		if (Ar.IsSaving())
+		{
+			FTcsSourceHandleData ChainData;
+			ChainData.CausalityTail = CausalityTail;
+			ChainData.GetCausalityChain(CausalityChain);
+		}
+
+		uint32 Depth = static_cast<uint32>(CausalityChain.Num());
+		Ar.SerializeIntPacked(Depth);
+
+		if (Ar.IsLoading())
+		{
+			if (Ar.IsError() || Depth == 0 || Depth > MaxNetCausalityDepth)
+			{
+				return false;
+			}
+			CausalityChain.SetNum(static_cast<int32>(Depth));
+		}
+
+		for (FPrimaryAssetId& AssetId : CausalityChain)
+		{
+			if (!SerializeCausalityEntry(Ar, Context, AssetId))
+			{
+				return false;
+			}
+		}
+
+		if (Ar.IsLoading())
+		{
+			CausalityTail = Context.Registry ? Context.Registry->InternCausalityChain(CausalityChain) : TSharedPtr<const FTcsCausalityNode>();
+			if (Context.Cache && ChainRefPlusOne > 0 && CausalityTail.IsValid())
+			{
+				Context.Cache->RecordChainReceived(static_cast<int32>(ChainRefPlusOne - 1), CausalityTail);
+			}
+		}
+
+		return true;
+	}
+}
+
 
 
 bool FTcsSourceHandle::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
 {
-	// 序列化 ID
-	Ar << Id;
+	// PackageMap 的 Outer 为 NetConnection，可由此定位所属 GameInstance 的注册表与连接缓存
+	FTcsSourceHandleNetContext Context;
+	UTcsAttributeManagerSubsystem::FindSourceHandleNetContext(Map, Context);
+
+	return NetSerializeWithContext(Ar, Map, Context, bOutSuccess);
+}
+
+bool FTcsSourceHandle::NetSerializeWithContext(
+	FArchive& Ar,
+	UPackageMap* Map,
+	const FTcsSourceHandleNetContext& Context,
+	bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	// 序列化 ID 与代数 (变长整数，无效句柄只占 1 字节)
+	uint32 IdPlusOne = static_cast<uint32>(Id + 1);
+	uint32 PackedGeneration = static_cast<uint32>(Generation);
+	Ar.SerializeIntPacked(IdPlusOne);
+	Ar.SerializeIntPacked(PackedGeneration);
+
+	if (Ar.IsLoading())
+	{
+		Id = static_cast<int32>(IdPlusOne) - 1;
+		Generation = static_cast<int32>(PackedGeneration);
+		OriginId = 0;
+	}
+
+	if (!IsValid())
+	{
+		return !Ar.IsError();
+	}
+
+	// 远端来源回传到其来源连接时只写出句柄与对端的来源端编号，接收端还原为自己的句柄
+	uint8 bReturnToOrigin = 0;
+	uint32 PackedOriginId = 0;
+	if (Ar.IsSaving() && OriginId != 0)
+	{
+		int32 OriginConnectionId = INDEX_NONE;
+		int32 SenderOriginId = 0;
+		if (Context.Registry
+			&& Context.Registry->FindRemoteOrigin(OriginId, OriginConnectionId, SenderOriginId)
+			&& OriginConnectionId == Context.ConnectionId)
+		{
+			bReturnToOrigin = 1;
+			PackedOriginId = static_cast<uint32>(SenderOriginId);
+		}
+		else
+		{
+			// 转发其他连接的来源：以本端的来源端编号完整写出，接收端为其分配独立的来源端
+			PackedOriginId = static_cast<uint32>(OriginId);
+		}
+	}
+
+	Ar.SerializeBits(&bReturnToOrigin, 1);
+	if (bReturnToOrigin)
+	{
+		Ar.SerializeIntPacked(PackedOriginId);
+		if (Ar.IsLoading())
+		{
+			OriginId = static_cast<int32>(PackedOriginId);
+		}
+		return !Ar.IsError();
+	}
+
+	// 本地来源只占 1 位，转发的来源附带发送端的来源端编号
+	uint8 bRelayed = PackedOriginId != 0 ? 1 : 0;
+	Ar.SerializeBits(&bRelayed, 1);
+	if (bRelayed)
+	{
+		Ar.SerializeIntPacked(PackedOriginId);
+	}
+
+	if (Ar.IsLoading())
+	{
+		// 没有注册表时无法分配来源端，句柄仍标记为远端（解析失败）
+		OriginId = Context.Registry
+			? Context.Registry->FindOrAddRemoteOrigin(Context.ConnectionId, static_cast<int32>(PackedOriginId))
+			: INDEX_NONE;
+	}
+
+	// 条件序列化来源元数据 (只在可解析时才序列化)
+	FTcsSourceHandleData Data;
+	uint8 bHasData = 0;
+	if (Ar.IsSaving())
+	{
+		if (const FTcsSourceHandleData* ResolvedData = Context.Registry ? Context.Registry->Resolve(*this) : nullptr)
+		{
+			Data = *ResolvedData;
+			bHasData = 1;
+		}
+	}
+	Ar.SerializeBits(&bHasData, 1);
+
+	if (!bHasData)
+	{
+		return !Ar.IsError();
+	}
 
 	// 序列化 SourceTags
-	SourceTags.NetSerialize(Ar, Map, bOutSuccess);
+	Data.SourceTags.NetSerialize(Ar, Map, bOutSuccess);
 
-	// 条件序列化 Instigator (只在有效时才序列化)
+	// 条件序列化 Instigator (只在有效且存在 PackageMap 时才序列化)
 	uint8 bHasInstigator = 0;
 	if (Ar.IsSaving())
 	{
-		bHasInstigator = Instigator.IsValid() ? 1 : 0;
+		bHasInstigator = Data.Instigator.IsValid() && Map ? 1 : 0;
 	}
 	Ar.SerializeBits(&bHasInstigator, 1);
 
 	if (bHasInstigator)
 	{
-		UObject* InstigatorObject = Instigator.Get();
+		if (!Map)
+		{
+			bOutSuccess = false;
+			return false;
+		}
+
+		UObject* InstigatorObject = Data.Instigator.Get();
 		Map->SerializeObject(Ar, AActor::StaticClass(), InstigatorObject);
 
 		if (Ar.IsLoading())
 		{
-			Instigator = Cast<AActor>(InstigatorObject);
+			Data.Instigator = Cast<AActor>(InstigatorObject);
 		}
 	}
 
 	// 序列化 CausalityChain
-	int32 ChainNum = CausalityChain.Num();
-	Ar << ChainNum;
-
-	if (Ar.IsLoading())
+	if (!TcsSourceHandlePrivate::SerializeCausalityChain(Ar, Context, Data.CausalityTail) || Ar.IsError())
 	{
-		CausalityChain.SetNum(ChainNum);
+		bOutSuccess = false;
+		return false;
 	}
 
-	for (int32 i = 0; i < ChainNum; ++i)
+	if (Ar.IsLoading() && Context.Registry)
 	{
-		Ar << CausalityChain[i];
+		Context.Registry->ImportRemote(*this, MoveTemp(Data));
 	}
 
-	bOutSuccess = true;
 	return true;
 }
@@ -0,0 +1,127 @@
+// Copyright Tirefly. All Rights Reserved.
+
+
+#include "TcsSourceHandleNetCache.h"
+
+#include "TcsSourceHandleRegistry.h"
+
+
+
+void FTcsSourceHandleNetCache::UpdateAckState(int32 InAckedPacketId, int32 InTotalPacketsLost, int32 InOutPacketId, uint64 InFrameNumber)
+{
+	AckedPacketId = InAckedPacketId;
+	TotalPacketsLost = InTotalPacketsLost;
+
+	if (InFrameNumber == AckStateFrameNumber)
+	{
+		return;
+	}
+
+	// 之前各帧写出的数据已随帧末的 Flush 发出，所在包序号不会超过已发出的最后一个包 (OutPacketId - 1)
+	AckStateFrameNumber = InFrameNumber;
+	for (const FTcsCausalityNode* Tail : PendingPacketIdChains)
+	{
+		if (FSentChain* SentChain = SentChains.Find(Tail))
+		{
+			SentChain->SentPacketId = InOutPacketId - 1;
+		}
+	}
+	PendingPacketIdChains.Reset();
+}
+
+int32 FTcsSourceHandleNetCache::FindAckedChainRef(const FTcsCausalityNode* Tail)
+{
+	FSentChain* SentChain = SentChains.Find(Tail);
+	if (!SentChain)
+	{
+		return INDEX_NONE;
+	}
+
+	if (!SentChain->bAcked
+		&& SentChain->SentPacketId != INDEX_NONE
+		&& AckedPacketId >= SentChain->SentPacketId
+		&& TotalPacketsLost == SentChain->PacketsLostAtSend)
+	{
+		SentChain->bAcked = true;
+	}
+
+	return SentChain->bAcked ? SentChain->ChainRef : INDEX_NONE;
+}
+
+int32 FTcsSourceHandleNetCache::RecordChainSent(const TSharedPtr<const FTcsCausalityNode>& Tail, int32 PacketId)
+{
+	if (!Tail.IsValid())
+	{
+		return INDEX_NONE;
+	}
+
+	FSentChain* SentChain = SentChains.Find(Tail.Get());
+	if (!SentChain)
+	{
+		if (SentChains.Num() >= MaxCachedChains)
+		{
+			return INDEX_NONE;
+		}
+
+		SentChain = &SentChains.Add(Tail.Get());
+		SentChain->Tail = Tail;
+		SentChain->ChainRef = SentChains.Num() - 1;
+	}
+	else if (SentChain->PacketsLostAtSend == TotalPacketsLost)
+	{
+		// 自上次记录的发送以来无丢包：那次发送送达即可确认，保留更早的记录，避免持续重发不断推迟确认
+		return SentChain->ChainRef;
+	}
+
+	// 首次发送或期间出现丢包：以本次发送重新计算
+	SentChain->SentPacketId = PacketId;
+	SentChain->PacketsLostAtSend = TotalPacketsLost;
+	if (PacketId == INDEX_NONE)
+	{
+		PendingPacketIdChains.AddUnique(Tail.Get());
+	}
+	return SentChain->ChainRef;
+}
+
+void FTcsSourceHandleNetCache::RecordChainReceived(int32 ChainRef, const TSharedPtr<const FTcsCausalityNode>& Tail)
+{
+	if (ChainRef >= 0 && ChainRef < MaxCachedChains)
+	{
+		ReceivedChains.Add(ChainRef, Tail);
+	}
+}
+
+bool FTcsSourceHandleNetCache::FindReceivedChain(int32 ChainRef, TSharedPtr<const FTcsCausalityNode>& OutTail) const
+{
+	if (const TSharedPtr<const FTcsCausalityNode>* Found = ReceivedChains.Find(ChainRef))
+	{
+		OutTail = *Found;
+		return true;
+	}
+	return false;
+}
+
+void FTcsSourceHandleNetCache::ResetAcks()
+{
+	for (TPair<const FTcsCausalityNode*, FSentChain>& Pair : SentChains)
+	{
+		FSentChain& SentChain = Pair.Value;
+		SentChain.bAcked = false;
+		SentChain.SentPacketId = INDEX_NONE;
+
+		// 累计丢包数不会为负：下一次完整发送必然重新计入确认（见 RecordChainSent）
+		SentChain.PacketsLostAtSend = INDEX_NONE;
+	}
+	PendingPacketIdChains.Reset();
+}
+
+void FTcsSourceHandleNetCache::Reset()
+{
+	SentChains.Empty();
+	ReceivedChains.Empty();
+	PendingPacketIdChains.Empty();
+	AckStateFrameNumber = 0;
+	AckedPacketId = INDEX_NONE;
+	TotalPacketsLost = 0;
+	bHasUnknownChainRef = false;
+}
@@ -0,0 +1,300 @@
+// Copyright Tirefly. All Rights Reserved.
+
+
+#include "TcsSourceHandleRegistry.h"
+
+#include "GameFramework/Actor.h"
+
+
+
+void FTcsSourceHandleData::GetCausalityChain(TArray<FPrimaryAssetId>& OutChain) const
+{
+	OutChain.SetNum(GetCausalityDepth());
+
+	int32 Index = OutChain.Num() - 1;
+	for (const FTcsCausalityNode* Node = CausalityTail.Get(); Node; Node = Node->Parent.Get())
+	{
+		OutChain[Index--] = Node->AssetId;
+	}
+}
+
+FTcsSourceHandle FTcsSourceHandleRegistry::Allocate(FTcsSourceHandleData&& Data)
+{
+	int32 Index;
+	if (FreeIndices.Num() > 0)
+	{
+		Index = FreeIndices.Pop();
+	}
+	else
+	{
+		Index = Entries.AddDefaulted();
+	}
+
+	FEntry& Entry = Entries[Index];
+	Entry.Data = MoveTemp(Data);
+	Entry.RefCount = 1;
+	++Entry.Generation;
+	++NumLiveEntries;
+
+	return FTcsSourceHandle(Index, Entry.Generation);
+}
+
+bool FTcsSourceHandleRegistry::AddRef(const FTcsSourceHandle& Handle)
+{
+	if (Handle.OriginId != 0)
+	{
+		return Resolve(Handle) != nullptr;
+	}
+
+	if (!Entries.IsValidIndex(Handle.Id))
+	{
+		return false;
+	}
+
+	FEntry& Entry = Entries[Handle.Id];
+	if (Entry.Generation != Handle.Generation || Entry.RefCount <= 0)
+	{
+		return false;
+	}
+
+	++Entry.RefCount;
+	return true;
+}
+
+void FTcsSourceHandleRegistry::Release(const FTcsSourceHandle& Handle)
+{
+	if (Handle.OriginId != 0 || !Entries.IsValidIndex(Handle.Id))
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries[Handle.Id];
+	if (Entry.Generation != Handle.Generation || Entry.RefCount <= 0)
+	{
+		return;
+	}
+
+	if (--Entry.RefCount == 0)
+	{
+		Entry.Data = FTcsSourceHandleData();
+		FreeIndices.Add(Handle.Id);
+		--NumLiveEntries;
+	}
+}
+
+const FTcsSourceHandleData* FTcsSourceHandleRegistry::Resolve(const FTcsSourceHandle& Handle) const
+{
+	if (Handle.OriginId != 0)
+	{
+		const TPair<int32, FTcsSourceHandleData>* RemoteEntry = RemoteEntries.Find(TPair<int32, int32>(Handle.OriginId, Handle.Id));
+		return RemoteEntry && RemoteEntry->Key == Handle.Generation ? &RemoteEntry->Value : nullptr;
+	}
+
+	if (Entries.IsValidIndex(Handle.Id))
+	{
+		const FEntry& Entry = Entries[Handle.Id];
+		if (Entry.Generation == Handle.Generation && Entry.RefCount > 0)
+		{
+			return &Entry.Data;
+		}
+	}
+
+	return nullptr;
+}
+
+void FTcsSourceHandleRegistry::ImportRemote(const FTcsSourceHandle& Handle, FTcsSourceHandleData&& Data)
+{
+	if (!Handle.IsValid()
+		|| !ensureMsgf(RemoteOrigins.IsValidIndex(Handle.OriginId - 1), TEXT("ImportRemote expects a remote handle: %s"), *Handle.ToDebugString()))
+	{
+		return;
+	}
+
+	// 连接已关闭的来源端不再接收镜像
+	if (RemoteOrigins[Handle.OriginId - 1].ConnectionId == INDEX_NONE)
+	{
+		return;
+	}
+
+	TPair<int32, FTcsSourceHandleData>& RemoteEntry = RemoteEntries.FindOrAdd(TPair<int32, int32>(Handle.OriginId, Handle.Id));
+	if (RemoteEntry.Key > Handle.Generation)
+	{
+		// 乱序到达的旧代数来源，不覆盖
+		return;
+	}
+
+	RemoteEntry.Key = Handle.Generation;
+	RemoteEntry.Value = MoveTemp(Data);
+}
+
+int32 FTcsSourceHandleRegistry::FindOrAddRemoteOrigin(int32 ConnectionId, int32 SenderOriginId)
+{
+	const TPair<int32, int32> Key(ConnectionId, SenderOriginId);
+	if (const int32* Existing = RemoteOriginIds.Find(Key))
+	{
+		return *Existing;
+	}
+
+	FRemoteOrigin& Origin = RemoteOrigins.AddDefaulted_GetRef();
+	Origin.ConnectionId = ConnectionId;
+	Origin.SenderOriginId = SenderOriginId;
+
+	const int32 OriginId = RemoteOrigins.Num();
+	RemoteOriginIds.Add(Key, OriginId);
+	return OriginId;
+}
+
+bool FTcsSourceHandleRegistry::FindRemoteOrigin(int32 OriginId, int32& OutConnectionId, int32& OutSenderOriginId) const
+{
+	if (!RemoteOrigins.IsValidIndex(OriginId - 1) || RemoteOrigins[OriginId - 1].ConnectionId == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const FRemoteOrigin& Origin = RemoteOrigins[OriginId - 1];
+	OutConnectionId = Origin.ConnectionId;
+	OutSenderOriginId = Origin.SenderOriginId;
+	return true;
+}
+
+void FTcsSourceHandleRegistry::RemoveConnection(int32 ConnectionId)
+{
+	bool bRemovedAny = false;
+	for (auto It = RemoteOriginIds.CreateIterator(); It; ++It)
+	{
+		if (It->Key.Key == ConnectionId)
+		{
+			// 来源端编号不回收：旧句柄的 OriginId 不会指向之后新连接的来源
+			RemoteOrigins[It->Value - 1].ConnectionId = INDEX_NONE;
+			It.RemoveCurrent();
+			bRemovedAny = true;
+		}
+	}
+
+	if (!bRemovedAny)
+	{
+		return;
+	}
+
+	for (auto It = RemoteEntries.CreateIterator(); It; ++It)
+	{
+		if (RemoteOrigins[It->Key.Key - 1].ConnectionId == INDEX_NONE)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+TSharedPtr<const FTcsCausalityNode> FTcsSourceHandleRegistry::ExtendCausalityChain(
+	const TSharedPtr<const FTcsCausalityNode>& Parent,
+	const FPrimaryAssetId& AssetId)
+{
+	const FCausalityNodeKey Key(Parent.Get(), AssetId);
+
+	// 父节点地址被复用时，旧子节点必然已随旧父节点失效，弱引用过期即可安全覆盖
+	TWeakPtr<const FTcsCausalityNode>& InternedNode = InternedCausalityNodes.FindOrAdd(Key);
+	if (TSharedPtr<const FTcsCausalityNode> ExistingNode = InternedNode.Pin())
+	{
+		return ExistingNode;
+	}
+
+	TSharedRef<FTcsCausalityNode> NewNode = MakeShared<FTcsCausalityNode>();
+	NewNode->AssetId = AssetId;
+	NewNode->Parent = Parent;
+	NewNode->Depth = Parent.IsValid() ? Parent->Depth + 1 : 1;
+	InternedNode = NewNode;
+
+	// 驻留表规模翻倍时清理一次失效条目，摊销 O(1)
+	if (InternedCausalityNodes.Num() > FMath::Max(64, InternedCausalityNodesAfterPurge * 2))
+	{
+		for (auto It = InternedCausalityNodes.CreateIterator(); It; ++It)
+		{
+			if (!It->Value.IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+		InternedCausalityNodesAfterPurge = InternedCausalityNodes.Num();
+	}
+
+	return NewNode;
+}
+
+TSharedPtr<const FTcsCausalityNode> FTcsSourceHandleRegistry::InternCausalityChain(const TArray<FPrimaryAssetId>& Chain)
+{
+	TSharedPtr<const FTcsCausalityNode> Tail;
+	for (const FPrimaryAssetId& AssetId : Chain)
+	{
+		Tail = ExtendCausalityChain(Tail, AssetId);
+	}
+	return Tail;
+}
+
+void FTcsSourceHandleRegistry::Reset()
+{
+	Entries.Empty();
+	FreeIndices.Empty();
+	RemoteOrigins.Empty();
+	RemoteOriginIds.Empty();
+	RemoteEntries.Empty();
+	InternedCausalityNodes.Empty();
+	InternedCausalityNodesAfterPurge = 0;
+	NumLiveEntries = 0;
+}
+
+SIZE_T FTcsSourceHandleRegistry::GetAllocatedSize() const
+{
+	SIZE_T Size = Entries.GetAllocatedSize()
+		+ FreeIndices.GetAllocatedSize()
+		+ RemoteOrigins.GetAllocatedSize()
+		+ RemoteOriginIds.GetAllocatedSize()
+		+ RemoteEntries.GetAllocatedSize()
+		+ InternedCausalityNodes.GetAllocatedSize();
+
+	for (const FEntry& Entry : Entries)
+	{
+		Size += Entry.Data.SourceTags.GetGameplayTagArray().GetAllocatedSize();
+	}
+
+	for (const TPair<TPair<int32, int32>, TPair<int32, FTcsSourceHandleData>>& Pair : RemoteEntries)
+	{
+		Size += Pair.Value.Value.SourceTags.GetGameplayTagArray().GetAllocatedSize();
+	}
+
+	for (const TPair<FCausalityNodeKey, TWeakPtr<const FTcsCausalityNode>>& Pair : InternedCausalityNodes)
+	{
+		if (Pair.Value.IsValid())
+		{
+			Size += sizeof(FTcsCausalityNode);
+		}
+	}
+
+	return Size;
+}
+
+FString FTcsSourceHandleRegistry::ToDebugString(const FTcsSourceHandle& Handle) const
+{
+	const FTcsSourceHandleData* Data = Resolve(Handle);
+	if (!Data)
+	{
+		return FString::Printf(TEXT("%s <released>"), *Handle.ToDebugString());
+	}
+
+	TArray<FPrimaryAssetId> CausalityChain;
+	Data->GetCausalityChain(CausalityChain);
+
+	FString ChainStr;
+	for (int32 i = 0; i < CausalityChain.Num(); ++i)
+	{
+		if (i > 0) ChainStr += TEXT("->");
+		ChainStr += CausalityChain[i].ToString();
+	}
+
+	if (Data->Instigator.IsValid())
+	{
+		return FString::Printf(TEXT("%s Instigator=%s Chain=[%s]"),
+			*Handle.ToDebugString(), *Data->Instigator->GetName(), *ChainStr);
+	}
+
+	return FString::Printf(TEXT("%s Chain=[%s]"), *Handle.ToDebugString(), *ChainStr);
+}
@@ -0,0 +1,40 @@
+// Copyright Tirefly. All Rights Reserved.
+
+
+#include "TcsStats.h"
+
+
+
+DEFINE_STAT(STAT_TcsAttributeRecalculateCurrent);
+
+DEFINE_STAT(STAT_TcsAttributeRecalculateBase);
+
+DEFINE_STAT(STAT_TcsAttributeRecalculateBatch);
+
+DEFINE_STAT(STAT_TcsAttributeModifierMerge);
+
+DEFINE_STAT(STAT_TcsAttributeModifierExecute);
+
+DEFINE_STAT(STAT_TcsAttributeRecalculateCommit);
+
+DEFINE_STAT(STAT_TcsAttributeClamp);
+
+DEFINE_STAT(STAT_TcsStateApply);
+
+DEFINE_STAT(STAT_TcsStateSlotActivation);
+
+DEFINE_STAT(STAT_TcsStateMergerExecute);
+
+DEFINE_STAT(STAT_TcsStateTreeTick);
+
+DEFINE_STAT(STAT_TcsModifiersExecuted);
+
+DEFINE_STAT(STAT_TcsStatesApplied);
+
+DEFINE_STAT(STAT_TcsStatesRejected);
+
+DEFINE_STAT(STAT_TcsEventsBroadcast);
+
+#if TCS_STATS_ENABLED
+UE_TRACE_CHANNEL_DEFINE(TcsChannel);
+#endif
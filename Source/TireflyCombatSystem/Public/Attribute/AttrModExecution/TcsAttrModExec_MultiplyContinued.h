@@ -19,4 +19,7 @@ public:
 		const FTcsAttributeModifierInstance& ModInst,
 		UPARAM(ref) TMap<FName, float>& BaseValues,
 		UPARAM(ref) TMap<FName, float>& CurrentValues) override;
+
+	// 纯数值运算，可在工作线程执行
+	virtual bool IsThreadSafe() const override { return true; }
 };
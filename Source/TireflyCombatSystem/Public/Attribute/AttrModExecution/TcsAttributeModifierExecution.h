@@ -32,4 +32,10 @@ public:
 		const FTcsAttributeModifierInstance& ModInst,
 		UPARAM(ref) TMap<FName, float>& BaseValues,
 		UPARAM(ref) TMap<FName, float>& CurrentValues) {}
+
+	/**
+	 * 执行器能否在工作线程上执行（批量重算时并行）
+	 * 只有不访问 UObject、世界或其他共享状态的纯数值执行器才应返回 true；默认留在游戏线程
+	 */
+	virtual bool IsThreadSafe() const { return false; }
 };
@@ -8,6 +8,9 @@
 #include "TcsAttributeInstance.h"
 #include "TcsAttributeChangeEventPayload.h"
 #include "TcsAttributeModifier.h"
+#include "TcsAttributeReplication.h"
+#include "TcsAttributeSnapshot.h"
+#include "TcsNotificationBatchScope.h"
 #include "TcsSourceHandle.h"
 #include "TcsAttributeComponent.generated.h"
 
@@ -16,6 +19,8 @@
 class UTcsAttributeManagerSubsystem;
 class UTcsAttributeDefinition;
 class UTcsAttributeModifierDefinition;
+class UTcsAttributeModifierExecution;
+struct FTcsMemoryUsage;
 
 
 
@@ -24,6 +29,11 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(
 	FTcsAttributeChangeDelegate,
 	const TArray<FTcsAttributeChangeEventPayload>&, Payloads);
 
+// 单个属性值改变的原生事件声明（按属性订阅，不经过 UFunction 派发）
+DECLARE_MULTICAST_DELEGATE_OneParam(
+	FTcsOnAttributeChangedNative,
+	const FTcsAttributeChangeEventPayload& /*Payload*/);
+
 // 属性修改器添加事件委托声明
 // (修改器实例)
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(
@@ -61,15 +71,30 @@ class TIREFLYCOMBATSYSTEM_API UTcsAttributeComponent : public UActorComponent
 	GENERATED_BODY()
 
 	friend class UTcsAttributeManagerSubsystem;
+	friend struct FTcsReplicatedAttribute;
+	friend struct FTcsReplicatedAttributeModifier;
 
 #pragma region ActorComponent
 
 public:
 	UTcsAttributeComponent();
 
+	virtual void PostInitProperties() override;
+
 protected:
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// 仅在启用延迟提交时注册 Tick 函数
+	virtual void RegisterComponentTickFunctions(bool bRegister) override;
+
+	// 仅在延迟提交模式下有待提交修改器时 Tick，提交后立即关闭
+	virtual void TickComponent(
+		float DeltaTime,
+		ELevelTick TickType,
+		FActorComponentTickFunction* ThisTickFunction) override;
+
 	// 缓存的 AttributeManager 指针（迁移期供 Phase C 下沉的业务方法直接访问）
 	UPROPERTY()
 	TObjectPtr<UTcsAttributeManagerSubsystem> AttrMgr;
@@ -123,6 +148,26 @@ public:
 		float NewValue,
 		float BoundaryValue) const;
 
+	/**
+	 * 订阅单个属性的当前值变化（原生回调，只在该属性变化时触发）
+	 *
+	 * @param AttributeName 属性名称
+	 * @param Delegate 回调
+	 * @return 订阅句柄，用于 UnsubscribeAttributeChanged
+	 */
+	FDelegateHandle SubscribeAttributeChanged(FName AttributeName, FTcsOnAttributeChangedNative::FDelegate&& Delegate);
+
+	/**
+	 * 取消单个属性的当前值变化订阅
+	 *
+	 * @param AttributeName 属性名称
+	 * @param Handle 订阅句柄
+	 */
+	void UnsubscribeAttributeChanged(FName AttributeName, FDelegateHandle Handle);
+
+	// 取消某个对象在所有属性上的订阅
+	void UnsubscribeAllAttributeChanged(const void* UserObject);
+
 public:
 	// 战斗实体的所有属性实例
 	UPROPERTY(BlueprintReadOnly, Category = "Attribute")
@@ -132,22 +177,23 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "Attribute")
 	TArray<FTcsAttributeModifierInstance> AttributeModifiers;
 
-	// SourceHandle ID 到 Modifier 实例 ID 的映射 (性能优化 - 稳定索引)
-	// Key: SourceHandle.Id, Value: ModifierInstId 列表
+	// SourceHandle 到 Modifier 实例 ID 的映射 (性能优化 - 稳定索引)
+	// Key: SourceHandle (Id + Generation), Value: ModifierInstId 列表
+	// 每个桶持有一个来源引用 (见 TrackModifierSource / UntrackModifierSource)
 	// 注: 使用稳定的 ModifierInstId 而非数组下标，避免删除操作导致的索引漂移问题
 	// 不使用 UPROPERTY 的原因:
-	//   1. 仅存储值类型 (int32)，不涉及 UObject 指针，无需 GC 追踪
+	//   1. 仅存储值类型 (句柄与 int32)，不涉及 UObject 指针，无需 GC 追踪
 	//   2. 运行时优化数据，可从 AttributeModifiers 重建，无需序列化
 	//   3. 本地缓存，无需网络复制 (每个客户端独立维护)
 	//   4. 内部实现细节，无需暴露给蓝图或编辑器
-	//   5. 生命周期跟随组件，C++ 析构函数自动释放内存
+	//   5. 生命周期跟随组件，EndPlay 时归还来源引用
 	// TODO(Perf): Value 当前为 TArray<int32>，`Remove(InstId)` 为 O(bucket)。
 	//   批量移除同一 SourceHandle 下 K 个 Modifier 时整体退化为 O(K^2)。
 	//   优化方向:
 	//     1) 改为 TSet<int32>，单次删除 O(1)，桶内元素量通常较小，内存开销可接受；
 	//     2) 保持 TArray 但在 RemoveModifiersBySourceHandle 路径直接整桶丢弃，跳过逐个 Remove；
 	//     3) 批量移除 API 引入 "延迟紧凑化"：先标记后重建，避免 O(K^2)。
-	TMap<int32, TArray<int32>> SourceHandleIdToModifierInstIds;
+	TMap<FTcsSourceHandle, TArray<int32>> SourceHandleIdToModifierInstIds;
 
 	// Modifier 实例 ID 到当前数组下标的映射 (性能优化 - 快速定位)
 	// Key: ModifierInstId, Value: AttributeModifiers 数组中的当前索引
@@ -157,6 +203,9 @@ public:
 	//   将 K 次移除的总成本从 O(K) 次 Map 写入降为一次性 O(N) 扫描（当 K 接近 N 时更优）。
 	TMap<int32, int32> ModifierInstIdToIndex;
 
+	// 按属性划分的原生订阅（使用共享指针，回调中新增订阅导致 Map 扩容时不影响正在广播的事件）
+	TMap<FName, TSharedRef<FTcsOnAttributeChangedNative>> AttributeChangedSubscriptions;
+
 	// 属性当前值改变事件
 	UPROPERTY(BlueprintAssignable, Category = "Attribute|Events")
 	FTcsAttributeChangeDelegate OnAttributeValueChanged;
@@ -298,7 +347,7 @@ public:
 
 	// TODO(Perf): 批量移除同一 SourceHandle 下 K 个 Modifier 时，桶维护退化为 O(K^2)。
 	//   优化方向见 RemoveModifiersBySourceHandle 实现注释，以及 SourceHandleIdToModifierInstIds 成员注释。
-	// 应用多个属性修改器
+	// 应用多个属性修改器（刷新已有修改器时，Modifiers 中的实例 Id 被改写为保留下来的实例 Id）
 	UFUNCTION(BlueprintCallable, Category = "Attribute|Modifier")
 	virtual void ApplyModifier(UPARAM(ref) TArray<FTcsAttributeModifierInstance>& Modifiers);
 
@@ -350,6 +399,80 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Attribute|Modifier")
 	virtual void HandleModifierUpdated(UPARAM(ref) TArray<FTcsAttributeModifierInstance>& Modifiers);
 
+protected:
+
+	// 将修改器登记到来源桶（新建桶时增加来源引用）
+	void TrackModifierSource(const FTcsSourceHandle& SourceHandle, int32 ModifierInstId);
+
+	// 将修改器移出来源桶（桶清空时释放来源引用）
+	void UntrackModifierSource(const FTcsSourceHandle& SourceHandle, int32 ModifierInstId);
+
+#pragma endregion
+
+
+#pragma region DeferredModifierCommit
+
+public:
+	/**
+	 * 立即提交本帧暂存的全部修改器
+	 * 延迟提交模式下，需要在提交点之前读取最终属性值时调用
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Attribute|Modifier")
+	void CommitDeferredModifiers();
+
+	// 当前暂存的待提交修改器数量
+	UFUNCTION(BlueprintPure, Category = "Attribute|Modifier")
+	int32 GetNumDeferredModifiers() const { return PendingDeferredModifiers.Num(); }
+
+protected:
+	/**
+	 * 暂存待提交的修改器
+	 * 同一来源、同一修改器 Id 的 CurrentValue 修改器在暂存期间视为刷新（与立即模式下的更新语义一致），
+	 * 刷新保留的实例 Id 回写到 Modifiers 中，调用者可直接用于 RemoveModifier
+	 * 暂存期间为每个修改器持有一个来源引用，提交或丢弃时归还
+	 */
+	void QueueDeferredModifiers(TArray<FTcsAttributeModifierInstance>& Modifiers);
+
+	// 丢弃暂存中满足条件的修改器（移除接口需要同时作用于尚未提交的修改器）
+	void DiscardDeferredModifiers(TFunctionRef<bool(const FTcsAttributeModifierInstance&)> Predicate);
+
+	// 归还暂存修改器持有的来源引用
+	void ReleaseDeferredModifierSource(const FTcsAttributeModifierInstance& Modifier);
+
+public:
+	/**
+	 * 是否启用延迟提交模式
+	 * 启用后 ApplyModifier 只暂存修改器，同帧的全部 CurrentValue 修改器在 DeferredCommitTickGroup 中合并为一次提交，
+	 * 属性变化事件按来源记录整帧的变化量。
+	 * 注意：BaseValue 修改器按原 ApplyModifier 调用逐批提交，合并策略只作用于同一次调用内（与立即模式一致）；
+	 * 提交前查询不到暂存中的修改器。
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attribute|Modifier")
+	bool bDeferModifierCommit = false;
+
+	// 延迟提交所在的 Tick 组
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attribute|Modifier", Meta = (EditCondition = "bDeferModifierCommit"))
+	TEnumAsByte<ETickingGroup> DeferredCommitTickGroup = TG_PostUpdateWork;
+
+protected:
+	// 暂存的修改器
+	struct FPendingDeferredModifier
+	{
+		FTcsAttributeModifierInstance Modifier;
+
+		// 所属的 ApplyModifier 调用序号（BaseValue 修改器按调用分批提交）
+		int32 ApplyCallIndex = 0;
+	};
+
+	// 本帧暂存的待提交修改器（按暂存顺序）
+	TArray<FPendingDeferredModifier> PendingDeferredModifiers;
+
+	// 本帧已暂存的 ApplyModifier 调用次数
+	int32 NumDeferredApplyCalls = 0;
+
+	// 是否正在提交暂存修改器（提交时 ApplyModifier 直接执行）
+	bool bIsCommittingDeferredModifiers = false;
+
 #pragma endregion
 
 
@@ -363,9 +486,37 @@ protected:
 	// 重新计算属性基础值
 	virtual void RecalculateAttributeBaseValues(const TArray<FTcsAttributeModifierInstance>& Modifiers);
 
-	// 重新计算属性当前值
+	// 重新计算属性当前值（管理器开启重算批处理时只登记，由管理器统一并行重算）
 	virtual void RecalculateAttributeCurrentValues(int64 ChangeBatchId = -1);
 
+	// 属性当前值重算任务：准备（游戏线程）→ 计算（纯数值，可在工作线程）→ 提交（游戏线程）
+	struct FCurrentValueRecalculationJob
+	{
+		// 合并、排序后参与计算的修改器，与执行器一一对应
+		TArray<FTcsAttributeModifierInstance> Modifiers;
+		TArray<UTcsAttributeModifierExecution*> Executions;
+
+		// 计算输入与输出
+		TMap<FName, float> BaseValues;
+		TMap<FName, float> CurrentValues;
+		TMap<FName, FTcsAttributeChangeEventPayload> ChangeEventPayloads;
+
+		// 需要记录变化来源的修改批次（包含负数时记录全部修改器）
+		TArray<int64, TInlineAllocator<2>> ChangeBatchIds;
+
+		// 存在未声明线程安全（IsThreadSafe）的执行器时，计算阶段只能在游戏线程执行
+		bool bRequiresGameThread = false;
+	};
+
+	// 准备阶段：合并排序修改器、解析执行器、拷贝基础值（游戏线程）
+	void PrepareCurrentValueRecalculation(FCurrentValueRecalculationJob& Job);
+
+	// 计算阶段：只读写任务内的数据，不访问组件状态、不广播事件
+	static void ExecuteCurrentValueRecalculation(FCurrentValueRecalculationJob& Job);
+
+	// 提交阶段：范围修正、写回当前值、广播事件（游戏线程）
+	void CommitCurrentValueRecalculation(FCurrentValueRecalculationJob& Job);
+
 	// 属性修改器合并
 	virtual void MergeAttributeModifiers(
 		const TArray<FTcsAttributeModifierInstance>& Modifiers,
@@ -385,5 +536,211 @@ protected:
 	// 支持多跳依赖（如 HP <= MaxHP，MaxHP 依赖 Level）
 	virtual void EnforceAttributeRangeConstraints();
 
+protected:
+	// 是否已登记到管理器的待重算列表
+	bool bCurrentValueRecalculationPending = false;
+
+	// 登记期间累积的修改批次
+	TArray<int64, TInlineAllocator<2>> PendingRecalculationBatchIds;
+
+#pragma endregion
+
+
+#pragma region Replication
+
+public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// 服务端：把自上次复制以来发生变化的属性与修改器同步到复制数组
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+protected:
+	// 标记属性数值已变化（仅设置标记，复制在 PreReplication 中同步，快照在帧末发布）
+	void MarkAttributesReplicationDirty()
+	{
+		bAttributesReplicationDirty = true;
+		bAttributeSnapshotDirty = true;
+	}
+
+	// 标记修改器需要同步
+	void MarkModifiersReplicationDirty() { bModifiersReplicationDirty = true; }
+
+	// 同步属性复制数组：只标脏量化后发生变化的条目
+	void SyncReplicatedAttributes();
+
+	// 同步修改器复制数组：只标脏新增或更新过的条目
+	void SyncReplicatedModifiers();
+
+	// 客户端：收到新增或变化的属性条目
+	void HandleReplicatedAttributeUpdated(const FTcsReplicatedAttribute& Item);
+
+	// 客户端：收到移除的属性条目
+	void HandleReplicatedAttributeRemoved(const FTcsReplicatedAttribute& Item);
+
+	// 客户端：收到新增或变化的修改器条目
+	void HandleReplicatedModifierUpdated(const FTcsReplicatedAttributeModifier& Item);
+
+	// 客户端：收到移除的修改器条目
+	void HandleReplicatedModifierRemoved(const FTcsReplicatedAttributeModifier& Item);
+
+public:
+	/**
+	 * 请求对端重新完整发送因果链（接收端遇到未知的因果链引用时由属性管理器调用）
+	 * 客户端经由 Server RPC 发往服务端，服务端经由 Client RPC 发往拥有者客户端
+	 */
+	void SendFullCausalityChainRequest();
+
+protected:
+	// 客户端上报本端各类别网络定义列表的哈希：两端一致的类别才以 NetIndex 同步定义 ID
+	UFUNCTION(Server, Reliable)
+	void ServerReportNetworkDefinitionListHashes(const TArray<uint32>& ListHashes);
+
+	// 服务端回复自己的网络定义列表哈希
+	UFUNCTION(Client, Reliable)
+	void ClientReportNetworkDefinitionListHashes(const TArray<uint32>& ListHashes);
+
+	// 客户端缺失因果链，请求服务端重新完整发送
+	UFUNCTION(Server, Reliable)
+	void ServerRequestFullCausalityChains();
+
+	// 服务端缺失因果链，请求客户端重新完整发送
+	UFUNCTION(Client, Reliable)
+	void ClientRequestFullCausalityChains();
+
+	// 记录对端上报的网络定义列表哈希（两个方向共用）
+	void HandlePeerNetworkDefinitionListHashes(const TArray<uint32>& ListHashes);
+
+	// 对端请求重新完整发送因果链（两个方向共用）
+	void HandleFullCausalityChainRequest();
+
+protected:
+	// 属性复制数组（按属性增量同步数值）
+	UPROPERTY(Replicated)
+	FTcsReplicatedAttributeArray ReplicatedAttributes;
+
+	// 修改器复制数组（只同步新增、更新与移除）
+	UPROPERTY(Replicated)
+	FTcsReplicatedAttributeModifierArray ReplicatedModifiers;
+
+	// 属性自上次同步以来是否可能发生变化
+	bool bAttributesReplicationDirty = false;
+
+	// 修改器自上次同步以来是否可能发生变化
+	bool bModifiersReplicationDirty = false;
+
+#pragma endregion
+
+
+#pragma region NotificationBatch
+
+public:
+	// 开启事件批处理（可嵌套；推荐使用 FTcsAttributeNotificationBatchScope）
+	void BeginNotificationBatch();
+
+	// 结束事件批处理，最外层结束时合并去重并统一广播
+	void EndNotificationBatch();
+
+	// 当前是否处于事件批处理中
+	bool IsBatchingNotifications() const { return NotificationBatchDepth > 0; }
+
+protected:
+	// 批处理中暂存的修改器事件类型
+	enum class EPendingModifierNotify : uint8
+	{
+		Added,
+		Removed,
+		Updated,
+	};
+
+	// 批处理中暂存的修改器事件
+	struct FPendingModifierNotification
+	{
+		EPendingModifierNotify Type = EPendingModifierNotify::Updated;
+		FTcsAttributeModifierInstance Modifier;
+
+		// 批处理内新增后又被移除，不再广播
+		bool bDiscarded = false;
+	};
+
+	// 批处理中暂存的边界事件
+	struct FPendingBoundaryNotification
+	{
+		FName AttributeName = NAME_None;
+		bool bIsMaxBoundary = false;
+		float OldValue = 0.f;
+		float NewValue = 0.f;
+		float BoundaryValue = 0.f;
+	};
+
+	// 合并暂存的属性变化（同一属性保留最早的旧值与最新的新值，来源变化量累加）
+	static void QueueAttributeChangePayloads(
+		const TArray<FTcsAttributeChangeEventPayload>& Payloads,
+		TArray<FTcsAttributeChangeEventPayload>& PendingPayloads,
+		TMap<FName, int32>& PendingIndices);
+
+	// 暂存修改器事件（同一实例内 Added+Updated 合并为 Added，Added+Removed 相互抵消）
+	void QueueModifierNotification(EPendingModifierNotify Type, const FTcsAttributeModifierInstance& ModifierInstance) const;
+
+	// 广播暂存的全部事件
+	void FlushPendingNotifications();
+
+protected:
+	// 批处理嵌套深度
+	int32 NotificationBatchDepth = 0;
+
+	// 以下暂存数据在 const 广播函数中写入
+	mutable TArray<FTcsAttributeChangeEventPayload> PendingValueChangePayloads;
+	mutable TMap<FName, int32> PendingValueChangeIndices;
+	mutable TArray<FTcsAttributeChangeEventPayload> PendingBaseValueChangePayloads;
+	mutable TMap<FName, int32> PendingBaseValueChangeIndices;
+	mutable TArray<FPendingModifierNotification> PendingModifierNotifications;
+	mutable TMap<int32, int32> PendingModifierIndices;
+	mutable TArray<FPendingBoundaryNotification> PendingBoundaryNotifications;
+
+#pragma endregion
+
+
+#pragma region AttributeSnapshot
+
+public:
+	/**
+	 * 获取最近一次发布的属性快照（任意线程）
+	 * 需启用 bPublishAttributeSnapshot；快照由属性管理器在每帧所有 Actor Tick 结束后发布（仅当属性有变化，
+	 * 每帧至多一次）。返回的快照不可变，持有期间不受后续发布影响；首次发布之前为空。
+	 */
+	FTcsAttributeSnapshotPtr GetAttributeSnapshot() const { return AttributeSnapshots.GetPublished(); }
+
+public:
+	// 是否发布供工作线程读取的属性快照
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attribute|Snapshot")
+	bool bPublishAttributeSnapshot = false;
+
+protected:
+	// 发布属性快照（游戏线程，仅由属性管理器在帧末调用）
+	void PublishAttributeSnapshot();
+
+	// 属性快照发布器
+	FTcsAttributeSnapshotBuffer AttributeSnapshots;
+
+	// 属性自上次发布快照以来是否可能发生变化
+	bool bAttributeSnapshotDirty = true;
+
+#pragma endregion
+
+
+#pragma region MemoryReport
+
+public:
+	/**
+	 * 统计组件的内存占用（游戏线程，见 FTcsMemoryReport）
+	 * 按容器写入 Usage，修改器实例的开销同时按修改器定义 Id 归集
+	 */
+	virtual void CollectMemoryUsage(FTcsMemoryUsage& Usage) const;
+
 #pragma endregion
 };
+
+
+
+// 属性组件事件批处理作用域
+using FTcsAttributeNotificationBatchScope = TTcsNotificationBatchScope<UTcsAttributeComponent>;
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
 #include "GameplayTagContainer.h"
+#include "TcsDefinitionId.h"
 #include "StructUtils/InstancedStruct.h"
 #include "TcsAttributeInstance.h"
 #include "TcsAttributeDefinition.generated.h"
@@ -41,6 +42,23 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Identity")
 	FName AttributeDefId;
 
+	/**
+	 * 获取属性定义的稠密 ID（首次访问时分配）
+	 * 进程内有效，用于运行时容器索引；Blueprint、存档与网络同步请使用 AttributeDefId
+	 */
+	int32 GetAttributeDefIndex() const
+	{
+		if (CachedDefIndex == INDEX_NONE)
+		{
+			CachedDefIndex = FTcsDefinitionIdTable::FindOrAdd(ETcsDefinitionKind::Attribute, AttributeDefId);
+		}
+		return CachedDefIndex;
+	}
+
+protected:
+	// 稠密 ID 缓存（运行时分配，不序列化；AttributeDefId 变更时失效）
+	mutable int32 CachedDefIndex = INDEX_NONE;
+
 #pragma endregion
 
 
@@ -103,6 +121,19 @@ public:
 #pragma endregion
 
 
+#pragma region Replication
+
+public:
+	/**
+	 * 网络同步时的数值量化精度
+	 * 精度越低占用带宽越少，且量化误差以内的数值变化不会触发同步
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication")
+	ETcsAttributeNetQuantization NetQuantization = ETcsAttributeNetQuantization::ANQ_None;
+
+#pragma endregion
+
+
 #pragma region Display
 
 public:
@@ -23,6 +23,18 @@ enum class ETcsAttributeRangeType : uint8
 
 
 
+// 属性值网络同步的量化精度
+UENUM(BlueprintType)
+enum class ETcsAttributeNetQuantization : uint8
+{
+	ANQ_None = 0			UMETA(DisplayName = "完整精度", ToolTip = "按 32 位浮点数同步"),
+	ANQ_Integer = 1			UMETA(DisplayName = "整数", ToolTip = "四舍五入到整数后按变长整数同步"),
+	ANQ_OneDecimal = 2		UMETA(DisplayName = "一位小数", ToolTip = "量化到 0.1 后按变长整数同步"),
+	ANQ_TwoDecimals = 3		UMETA(DisplayName = "两位小数", ToolTip = "量化到 0.01 后按变长整数同步"),
+};
+
+
+
 // 属性范围
 USTRUCT(BlueprintType)
 struct TIREFLYCOMBATSYSTEM_API FTcsAttributeRange
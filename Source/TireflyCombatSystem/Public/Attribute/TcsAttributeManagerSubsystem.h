@@ -6,7 +6,10 @@
 #include "GameplayTagContainer.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "TcsAttributeModifier.h"
+#include "TcsCombatCommandQueue.h"
 #include "TcsSourceHandle.h"
+#include "TcsSourceHandleNetCache.h"
+#include "TcsSourceHandleRegistry.h"
 #include "TcsAttributeManagerSubsystem.generated.h"
 
 
@@ -14,6 +17,8 @@ class UTcsAttributeComponent;
 class UTcsAttributeDefinition;
 class UTcsAttributeModifierDefinition;
 class UTcsDefinitionRegistrySubsystem;
+struct FTcsDefinitionChangeSet;
+class UNetConnection;
 
 
 // 属性管理器子系统，所有战斗实体执行属性相关逻辑的入口
@@ -63,9 +68,12 @@ protected:
 
 	void RebuildAttributeTagMappings();
 
+	// 发布属性与属性修改器定义的网络索引（属性复制按索引压缩定义 ID）
+	void PublishNetworkDefinitionIds() const;
+
 #if WITH_EDITOR
 	UTcsDefinitionRegistrySubsystem* GetDefinitionRegistry() const;
-	void HandleDefinitionRegistryRefreshed(const UTcsDefinitionRegistrySubsystem* Registry);
+	void HandleDefinitionRegistryRefreshed(const UTcsDefinitionRegistrySubsystem* Registry, const FTcsDefinitionChangeSet& ChangeSet);
 	FDelegateHandle DefinitionRegistryRefreshedHandle;
 #endif
 
@@ -86,6 +94,22 @@ public:
 	 */
 	const UTcsAttributeModifierDefinition* GetModifierDefinition(FName ModifierId) const;
 
+	/**
+	 * 注册运行时创建的临时属性定义（自动化测试、基准测试与无头模拟使用）
+	 * 直接写入定义缓存，不经过 DefinitionRegistry / AssetManager，定义重新加载后失效；
+	 * 定义缓存不持有 GC 引用，调用方负责保持定义对象存活
+	 *
+	 * @param Definition 属性定义（按 AttributeDefId 注册，同名覆盖）
+	 */
+	void RegisterTransientAttributeDefinition(const UTcsAttributeDefinition* Definition);
+
+	/**
+	 * 注册运行时创建的临时属性修改器定义（约束同 RegisterTransientAttributeDefinition）
+	 *
+	 * @param Definition 属性修改器定义（按 AttributeModifierDefId 注册，同名覆盖）
+	 */
+	void RegisterTransientModifierDefinition(const UTcsAttributeModifierDefinition* Definition);
+
 #pragma endregion
 	
 
@@ -148,23 +172,330 @@ protected:
 
 public:
 	/**
-	 * 创建 SourceHandle (唯一的创建入口)
+	 * 创建 SourceHandle (C++ 创建入口)
+	 * 返回的句柄带有一个引用，由调用者持有，不再使用时需调用 ReleaseSourceHandle
 	 *
 	 * @param CausalityChain 因果链 (从根源到直接父级的 PrimaryAssetId 有序链)
 	 * @param Instigator 施加者Actor
 	 * @param SourceTags Source类型标签 (可选)
 	 * @return 创建的SourceHandle
 	 */
-	UFUNCTION(BlueprintCallable, Category = "TireflyCombatSystem|SourceHandle")
 	FTcsSourceHandle CreateSourceHandle(
 		const TArray<FPrimaryAssetId>& CausalityChain,
 		AActor* Instigator,
 		const FGameplayTagContainer& SourceTags = FGameplayTagContainer());
 
+	/**
+	 * 创建 SourceHandle (蓝图创建入口)
+	 * 返回的句柄不归调用者所有：创建时的引用在下一次 World Tick 开始（并执行完排队的战斗指令）后归还，
+	 * 此前挂上的修改器各自持有来源引用，最后一个修改器移除时来源被回收。
+	 * 需要跨帧保存句柄时调用 RetainSourceHandle，并在不再使用时调用 ReleaseSourceHandle 归还。
+	 *
+	 * @param CausalityChain 因果链 (从根源到直接父级的 PrimaryAssetId 有序链)
+	 * @param Instigator 施加者Actor
+	 * @param SourceTags Source类型标签 (可选)
+	 * @return 创建的SourceHandle
+	 */
+	UFUNCTION(BlueprintCallable, Category = "TireflyCombatSystem|SourceHandle", meta = (DisplayName = "Create Source Handle"))
+	FTcsSourceHandle CreateUnownedSourceHandle(
+		const TArray<FPrimaryAssetId>& CausalityChain,
+		AActor* Instigator,
+		const FGameplayTagContainer& SourceTags = FGameplayTagContainer());
+
+	/**
+	 * 创建派生 SourceHandle：在父来源的因果链末尾追加一个定义（O(1)，与同前缀的链共享节点）
+	 * 父句柄无效时创建根源句柄（空因果链）
+	 *
+	 * @param ParentSourceHandle 父级来源句柄
+	 * @param DerivedAssetId 追加到因果链的定义资产 Id
+	 * @param Instigator 施加者Actor
+	 * @param SourceTags Source类型标签 (可选)
+	 * @return 创建的SourceHandle（带一个由调用者持有的引用）
+	 */
+	FTcsSourceHandle CreateDerivedSourceHandle(
+		const FTcsSourceHandle& ParentSourceHandle,
+		const FPrimaryAssetId& DerivedAssetId,
+		AActor* Instigator,
+		const FGameplayTagContainer& SourceTags = FGameplayTagContainer());
+
+	/**
+	 * 增加 SourceHandle 的引用（远端来源不计数）
+	 *
+	 * @param SourceHandle 来源句柄
+	 * @return 来源是否仍然存在
+	 */
+	UFUNCTION(BlueprintCallable, Category = "TireflyCombatSystem|SourceHandle")
+	bool RetainSourceHandle(const FTcsSourceHandle& SourceHandle);
+
+	/**
+	 * 释放 SourceHandle 的引用，引用归零时来源元数据被回收（远端来源不计数）
+	 * 蓝图中只应与 RetainSourceHandle 成对调用
+	 *
+	 * @param SourceHandle 来源句柄
+	 */
+	UFUNCTION(BlueprintCallable, Category = "TireflyCombatSystem|SourceHandle")
+	void ReleaseSourceHandle(const FTcsSourceHandle& SourceHandle);
+
+	/**
+	 * 解析 SourceHandle 的来源元数据
+	 *
+	 * @param SourceHandle 来源句柄
+	 * @return 元数据指针；来源已释放时返回 nullptr
+	 */
+	const FTcsSourceHandleData* ResolveSourceHandle(const FTcsSourceHandle& SourceHandle) const;
+
+	// 获取来源的施加者 (来源已释放时返回 nullptr)
+	UFUNCTION(BlueprintPure, Category = "TireflyCombatSystem|SourceHandle")
+	AActor* GetSourceInstigator(const FTcsSourceHandle& SourceHandle) const;
+
+	// 获取来源的类型标签 (来源已释放时返回空容器)
+	UFUNCTION(BlueprintPure, Category = "TireflyCombatSystem|SourceHandle")
+	FGameplayTagContainer GetSourceTags(const FTcsSourceHandle& SourceHandle) const;
+
+	// 获取来源的完整因果链 (来源已释放时返回空数组；需展开节点链，仅用于调试与蓝图)
+	UFUNCTION(BlueprintPure, Category = "TireflyCombatSystem|SourceHandle")
+	TArray<FPrimaryAssetId> GetSourceCausalityChain(const FTcsSourceHandle& SourceHandle) const;
+
+	// 生成包含来源元数据的调试字符串
+	UFUNCTION(BlueprintPure, Category = "TireflyCombatSystem|SourceHandle")
+	FString GetSourceHandleDebugString(const FTcsSourceHandle& SourceHandle) const;
+
+	FTcsSourceHandleRegistry& GetSourceHandleRegistry() { return SourceHandleRegistry; }
+
+	const FTcsSourceHandleRegistry& GetSourceHandleRegistry() const { return SourceHandleRegistry; }
+
+	/**
+	 * 通过任意位于 World 内的对象定位所属 GameInstance 的来源注册表（供网络序列化等无上下文场景使用）
+	 *
+	 * @param WorldContextObject 世界上下文对象（例如 UPackageMap，其 Outer 为 NetConnection）
+	 * @return 注册表指针；无法定位时返回 nullptr
+	 */
+	static FTcsSourceHandleRegistry* FindSourceHandleRegistry(const UObject* WorldContextObject);
+
+	/**
+	 * 通过 PackageMap 构建 SourceHandle 网络序列化上下文（注册表 + 所属连接的标识与因果链缓存）
+	 *
+	 * @param Map 网络包映射（Outer 为 NetConnection）
+	 * @param OutContext 输出上下文；无法定位连接时只填充注册表
+	 * @return 是否定位到注册表
+	 */
+	static bool FindSourceHandleNetContext(UPackageMap* Map, FTcsSourceHandleNetContext& OutContext);
+
+	/**
+	 * 写出定义 ID 时能否对该类别使用 NetIndex（对端握手上报的列表哈希与本端一致时才可使用）
+	 *
+	 * @param Map 网络包映射（Outer 为 NetConnection）
+	 * @param Kind 定义类别
+	 * @return 是否可使用 NetIndex；连接未完成握手、回放连接或无法定位连接时返回 false
+	 */
+	static bool CanUseDefinitionNetIndex(UPackageMap* Map, ETcsDefinitionKind Kind);
+
+	/**
+	 * 记录对端上报的网络定义列表哈希（握手，见 UTcsAttributeComponent::ServerReportNetworkDefinitionListHashes）
+	 *
+	 * @param Connection 对端所在的连接
+	 * @param ListHashes 对端各类别的列表哈希（按 ETcsDefinitionKind 排列）
+	 */
+	void SetPeerNetworkDefinitionListHashes(UNetConnection* Connection, const TArray<uint32>& ListHashes);
+
+	/**
+	 * 对端缺失因果链时，撤销该连接上所有链的确认状态，之后的链重新完整发送
+	 *
+	 * @param Connection 对端所在的连接
+	 */
+	void RequestFullCausalityChains(UNetConnection* Connection);
+
 protected:
-	// 全局 SourceHandle ID 管理器
-	UPROPERTY()
-	int32 GlobalSourceHandleIdMgr = -1;
+	// 来源句柄注册表 (来源元数据只在此存储一份)
+	FTcsSourceHandleRegistry SourceHandleRegistry;
+
+	// 网络连接状态（来源句柄与定义 ID 的网络序列化共用）
+	struct FNetConnectionState
+	{
+		// 连接标识（注册表据此区分远端来源经由哪条连接到达）
+		int32 ConnectionId = 0;
+
+		// 因果链缓存（回放连接不使用）
+		FTcsSourceHandleNetCache Cache;
+
+		// 对端上报的网络定义列表哈希（按 ETcsDefinitionKind 排列，未握手时为空）
+		TArray<uint32> PeerDefinitionListHashes;
+
+		// 对端列表与本端一致的类别（位掩码，见 FTcsSourceHandleNetContext::NetIndexKinds）
+		uint8 GetNetIndexKinds() const;
+	};
+
+	// 每条网络连接的状态
+	TMap<TObjectKey<UNetConnection>, FNetConnectionState> NetConnectionStates;
+
+	// 下一个分配的连接标识
+	int32 NextNetConnectionId = 1;
+
+	// 查找或创建连接状态
+	FNetConnectionState& FindOrAddNetConnectionState(UNetConnection* Connection);
+
+	// 清理已关闭连接的状态与经由其收到的远端来源
+	void RemoveClosedNetConnectionStates();
+
+	// 接收端遇到未知因果链引用时，通过连接玩家的属性组件请求对端重新完整发送
+	void SendFullCausalityChainRequests();
+
+	// 蓝图创建的来源：创建时的引用在下一次 World Tick 开始时归还
+	TArray<FTcsSourceHandle> PendingUnownedSourceHandles;
+
+	// 归还蓝图创建的来源的创建引用
+	void ReleasePendingUnownedSourceHandles();
 
 #pragma endregion
+
+
+#pragma region CombatCommandQueue
+
+public:
+	/**
+	 * 提交应用属性修改器指令（任意线程）
+	 * 指令在下一次 World Tick 开始时于游戏线程执行，等价于目标属性组件上的 CreateAttributeModifier + ApplyModifier
+	 *
+	 * @param Target 目标
+	 * @param ModifierIds 修改器 Id 列表
+	 * @param SourceHandle 来源句柄（须已在游戏线程创建）
+	 * @param Instigator 施加者（为空时取来源的施加者）
+	 * @param Operands 操作数（为空时使用定义中的操作数）
+	 */
+	void EnqueueApplyModifiers(
+		AActor* Target,
+		TArray<FName> ModifierIds,
+		const FTcsSourceHandle& SourceHandle,
+		AActor* Instigator = nullptr,
+		TMap<FName, float> Operands = TMap<FName, float>());
+
+	// 提交按来源移除属性修改器指令（任意线程）
+	void EnqueueRemoveModifiersBySource(AActor* Target, const FTcsSourceHandle& SourceHandle);
+
+	// 提交应用状态指令（任意线程）
+	void EnqueueApplyState(
+		AActor* Target,
+		FName StateDefId,
+		AActor* Instigator,
+		int32 StateLevel = 1,
+		const FTcsSourceHandle& ParentSourceHandle = FTcsSourceHandle());
+
+	// 提交按定义 Id 移除状态指令（任意线程）
+	void EnqueueRemoveStatesByDefId(AActor* Target, FName StateDefId);
+
+	// 提交任意指令（任意线程）
+	void EnqueueCombatCommand(FTcsCombatCommand&& Command) { CombatCommandQueue.Enqueue(MoveTemp(Command)); }
+
+	/**
+	 * 立即执行已提交的指令（游戏线程）
+	 * 默认在 World Tick 开始时自动执行，需要更早生效时可手动调用
+	 *
+	 * @return 执行的指令数量
+	 */
+	int32 DrainCombatCommands();
+
+protected:
+	// World Tick 开始时执行本 GameInstance 的指令
+	void HandleWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	// 在游戏线程执行单条指令
+	void ExecuteCombatCommand(FTcsCombatCommand& Command);
+
+protected:
+	// 多生产者单消费者指令队列
+	FTcsCombatCommandQueue CombatCommandQueue;
+
+	FDelegateHandle WorldTickStartHandle;
+
+#pragma endregion
+
+
+#pragma region AttributeSnapshot
+
+public:
+	// 登记需要每帧发布属性快照的组件（游戏线程）
+	void RegisterAttributeSnapshotPublisher(UTcsAttributeComponent* AttributeComponent);
+
+	// 注销属性快照发布组件（游戏线程）
+	void UnregisterAttributeSnapshotPublisher(UTcsAttributeComponent* AttributeComponent);
+
+protected:
+	// 所有 Actor Tick 结束后发布本帧发生变化的属性快照
+	void HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+protected:
+	// 登记的属性快照发布组件
+	TArray<TWeakObjectPtr<UTcsAttributeComponent>> AttributeSnapshotPublishers;
+
+	FDelegateHandle WorldPostActorTickHandle;
+
+#pragma endregion
+
+
+#pragma region AttributeRecalculation
+
+public:
+	/**
+	 * 开启属性重算批处理（游戏线程，可嵌套）
+	 * 批处理期间属性组件的当前值重算只登记不执行；最外层结束时，所有登记组件的修改器计算通过 ParallelFor 并行执行，
+	 * 范围修正与事件广播随后按登记顺序在游戏线程串行执行。
+	 * 注意：批处理期间读取到的属性当前值尚未包含本批次的修改。
+	 */
+	void BeginAttributeRecalculationBatch();
+
+	// 结束属性重算批处理，最外层结束时执行重算
+	void EndAttributeRecalculationBatch();
+
+	// 是否正在收集属性重算请求
+	bool IsBatchingAttributeRecalculation() const { return AttributeRecalculationBatchDepth > 0; }
+
+	// 登记需要重算当前值的属性组件（同一组件多次登记只重算一次，修改批次累积）
+	void RequestAttributeRecalculation(UTcsAttributeComponent* AttributeComponent, int64 ChangeBatchId);
+
+	/**
+	 * 立即重算已登记的属性组件（游戏线程）
+	 *
+	 * @return 重算的组件数量
+	 */
+	int32 FlushAttributeRecalculations();
+
+protected:
+	// 批处理嵌套深度
+	int32 AttributeRecalculationBatchDepth = 0;
+
+	// 等待重算的属性组件（按登记顺序）
+	TArray<TWeakObjectPtr<UTcsAttributeComponent>> PendingRecalculationComponents;
+
+#pragma endregion
+};
+
+
+
+/**
+ * 属性重算批处理作用域（RAII）
+ * 例如对大量目标同时施加或移除光环时使用，使各组件的修改器计算并行执行
+ * 战斗指令派发、延迟修改器提交以及状态的施加/移除入口已在内部开启，外层再开启时合并为同一批次
+ */
+class FTcsAttributeRecalculationScope : public FNoncopyable
+{
+public:
+	explicit FTcsAttributeRecalculationScope(UTcsAttributeManagerSubsystem* InAttributeManager)
+		: AttributeManager(InAttributeManager)
+	{
+		if (AttributeManager)
+		{
+			AttributeManager->BeginAttributeRecalculationBatch();
+		}
+	}
+
+	~FTcsAttributeRecalculationScope()
+	{
+		if (AttributeManager)
+		{
+			AttributeManager->EndAttributeRecalculationBatch();
+		}
+	}
+
+private:
+	UTcsAttributeManagerSubsystem* AttributeManager = nullptr;
 };
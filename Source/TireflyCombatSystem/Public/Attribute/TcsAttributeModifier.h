@@ -45,6 +45,10 @@ public:
 	UPROPERTY(BlueprintReadOnly)
 	FName ModifierId = NAME_None;
 
+	// 修改器定义稠密 ID (与 ModifierId 一一对应，用于运行时合并分组；仅进程内有效，不参与序列化与网络同步)
+	UPROPERTY(Transient, NotReplicated)
+	int32 ModifierDefIndex = INDEX_NONE;
+
 	// 修改器来源句柄 (统一的来源追踪)
 	UPROPERTY(BlueprintReadOnly)
 	FTcsSourceHandle SourceHandle;
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
 #include "GameplayTagContainer.h"
+#include "TcsDefinitionId.h"
 #include "TcsAttributeModifier.h"
 #include "TcsAttributeModifierDefinition.generated.h"
 
@@ -39,6 +40,23 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Identity")
 	FName AttributeModifierDefId;
 
+	/**
+	 * 获取属性修改器定义的稠密 ID（首次访问时分配）
+	 * 进程内有效，用于运行时容器索引；Blueprint、存档与网络同步请使用 AttributeModifierDefId
+	 */
+	int32 GetAttributeModifierDefIndex() const
+	{
+		if (CachedDefIndex == INDEX_NONE)
+		{
+			CachedDefIndex = FTcsDefinitionIdTable::FindOrAdd(ETcsDefinitionKind::AttributeModifier, AttributeModifierDefId);
+		}
+		return CachedDefIndex;
+	}
+
+protected:
+	// 稠密 ID 缓存（运行时分配，不序列化；AttributeModifierDefId 变更时失效）
+	mutable int32 CachedDefIndex = INDEX_NONE;
+
 #pragma endregion
 
 
@@ -0,0 +1,186 @@
+// Copyright Tirefly. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "TcsAttributeInstance.h"
+#include "TcsAttributeModifier.h"
+#include "TcsAttributeReplication.generated.h"
+
+
+class UTcsAttributeComponent;
+struct FTcsReplicatedAttributeArray;
+struct FTcsReplicatedAttributeModifierArray;
+
+
+
+/**
+ * 属性复制条目
+ *
+ * 服务端在 PreReplication 时从 UTcsAttributeComponent::Attributes 同步，量化后未变化的属性不会被标脏；
+ * 客户端收到后写回 Attributes 并广播属性变化事件。
+ */
+USTRUCT()
+struct TIREFLYCOMBATSYSTEM_API FTcsReplicatedAttribute : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+public:
+	// 属性名
+	UPROPERTY()
+	FName AttributeName = NAME_None;
+
+	// 量化后的基础值
+	UPROPERTY()
+	float BaseValue = 0.f;
+
+	// 量化后的当前值
+	UPROPERTY()
+	float CurrentValue = 0.f;
+
+	// 量化精度（取自属性定义）
+	UPROPERTY()
+	ETcsAttributeNetQuantization Quantization = ETcsAttributeNetQuantization::ANQ_None;
+
+public:
+	/**
+	 * 从属性实例同步数值（按属性定义的精度量化）
+	 *
+	 * @param Attribute 属性实例
+	 * @return 量化后的数值或精度是否发生变化
+	 */
+	bool SyncFrom(const FTcsAttributeInstance& Attribute);
+
+	// 网络序列化（属性名按定义网络索引写出，数值按精度量化）
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	void PreReplicatedRemove(const FTcsReplicatedAttributeArray& InArraySerializer);
+	void PostReplicatedAdd(const FTcsReplicatedAttributeArray& InArraySerializer);
+	void PostReplicatedChange(const FTcsReplicatedAttributeArray& InArraySerializer);
+};
+
+
+
+template<>
+struct TStructOpsTypeTraits<FTcsReplicatedAttribute> : public TStructOpsTypeTraitsBase2<FTcsReplicatedAttribute>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+
+
+// 属性复制数组
+USTRUCT()
+struct TIREFLYCOMBATSYSTEM_API FTcsReplicatedAttributeArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	TArray<FTcsReplicatedAttribute> Items;
+
+	// 所属组件（PostInitProperties 时设置，不参与复制）
+	UTcsAttributeComponent* OwnerComponent = nullptr;
+
+public:
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FTcsReplicatedAttribute, FTcsReplicatedAttributeArray>(
+			Items, DeltaParms, *this);
+	}
+};
+
+
+
+template<>
+struct TStructOpsTypeTraits<FTcsReplicatedAttributeArray> : public TStructOpsTypeTraitsBase2<FTcsReplicatedAttributeArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+
+
+/**
+ * 属性修改器复制条目
+ *
+ * 只同步 CurrentValue 模式下持久存在的修改器（BaseValue 模式修改器执行后即丢弃，其结果随属性基础值同步）。
+ * 客户端收到的修改器仅用于展示与查询，属性数值以服务端同步的结果为准。
+ */
+USTRUCT()
+struct TIREFLYCOMBATSYSTEM_API FTcsReplicatedAttributeModifier : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+public:
+	// 修改器实例（时间戳与批次号仅服务端用于变化检测，不参与序列化）
+	UPROPERTY()
+	FTcsAttributeModifierInstance Modifier;
+
+public:
+	/**
+	 * 从修改器实例同步
+	 *
+	 * @param Source 修改器实例
+	 * @return 修改器是否被更新过（按更新时间戳与变更批次判断）
+	 */
+	bool SyncFrom(const FTcsAttributeModifierInstance& Source);
+
+	// 网络序列化（修改器 Id 按定义网络索引写出，来源句柄使用其自身的压缩序列化）
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	void PreReplicatedRemove(const FTcsReplicatedAttributeModifierArray& InArraySerializer);
+	void PostReplicatedAdd(const FTcsReplicatedAttributeModifierArray& InArraySerializer);
+	void PostReplicatedChange(const FTcsReplicatedAttributeModifierArray& InArraySerializer);
+};
+
+
+
+template<>
+struct TStructOpsTypeTraits<FTcsReplicatedAttributeModifier> : public TStructOpsTypeTraitsBase2<FTcsReplicatedAttributeModifier>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+
+
+// 属性修改器复制数组
+USTRUCT()
+struct TIREFLYCOMBATSYSTEM_API FTcsReplicatedAttributeModifierArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	TArray<FTcsReplicatedAttributeModifier> Items;
+
+	// 所属组件（PostInitProperties 时设置，不参与复制）
+	UTcsAttributeComponent* OwnerComponent = nullptr;
+
+public:
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FTcsReplicatedAttributeModifier, FTcsReplicatedAttributeModifierArray>(
+			Items, DeltaParms, *this);
+	}
+};
+
+
+
+template<>
+struct TStructOpsTypeTraits<FTcsReplicatedAttributeModifierArray> : public TStructOpsTypeTraitsBase2<FTcsReplicatedAttributeModifierArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
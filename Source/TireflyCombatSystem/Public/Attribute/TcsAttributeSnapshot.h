@@ -0,0 +1,107 @@
+// Copyright Tirefly. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+#include "Templates/SharedPointer.h"
+
+
+struct FTcsAttributeInstance;
+
+
+
+/**
+ * 属性数值快照（发布后不可变）
+ *
+ * 属性名按 FName 比较索引排序，查找为二分查找；数值与属性名按下标一一对应。
+ * 每次发布都创建新的快照对象，持有快照共享指针的读取方看到的内容永远不会被改写。
+ */
+struct TIREFLYCOMBATSYSTEM_API FTcsAttributeSnapshot
+{
+public:
+	// 查找属性当前值
+	bool FindCurrentValue(FName AttributeName, float& OutValue) const;
+
+	// 查找属性基础值
+	bool FindBaseValue(FName AttributeName, float& OutValue) const;
+
+	// 属性数量
+	int32 Num() const { return AttributeNames.Num(); }
+
+	// 发布时的帧号（GFrameCounter）
+	uint64 GetFrameNumber() const { return FrameNumber; }
+
+	// 发布代数（同一发布者每次发布递增，从 1 开始）
+	uint64 GetGeneration() const { return Generation; }
+
+	const TArray<FName>& GetAttributeNames() const { return AttributeNames; }
+	const TArray<float>& GetCurrentValues() const { return CurrentValues; }
+	const TArray<float>& GetBaseValues() const { return BaseValues; }
+
+	// 已分配的内存（字节，不含结构体本身）
+	SIZE_T GetAllocatedSize() const
+	{
+		return AttributeNames.GetAllocatedSize() + CurrentValues.GetAllocatedSize() + BaseValues.GetAllocatedSize();
+	}
+
+private:
+	friend class FTcsAttributeSnapshotBuffer;
+
+	int32 FindIndex(FName AttributeName) const;
+
+	TArray<FName> AttributeNames;
+	TArray<float> CurrentValues;
+	TArray<float> BaseValues;
+	uint64 FrameNumber = 0;
+	uint64 Generation = 0;
+};
+
+using FTcsAttributeSnapshotPtr = TSharedPtr<const FTcsAttributeSnapshot, ESPMode::ThreadSafe>;
+
+
+
+/**
+ * 属性快照发布器
+ *
+ * 游戏线程每次发布创建一份新的不可变快照，并在锁内替换已发布的共享指针；任意线程通过 GetPublished
+ * 取得共享指针副本后即可在锁外读取，旧快照在最后一个读取方释放后才销毁，发布不会改写读取中的内存。
+ * 同一帧至多发布一次，快照代数单调递增，读取方可用代数判断快照是否更新。
+ */
+class TIREFLYCOMBATSYSTEM_API FTcsAttributeSnapshotBuffer
+{
+public:
+	// 最近一次发布的快照（任意线程）；从未发布时为空
+	FTcsAttributeSnapshotPtr GetPublished() const
+	{
+		FReadScopeLock ReadLock(PublishedLock);
+		return Published;
+	}
+
+	/**
+	 * 从属性实例创建新快照并发布（游戏线程）
+	 * 属性集合不变时复用上一份快照已排序的属性名列表
+	 *
+	 * @param Attributes 属性实例
+	 * @param FrameNumber 发布帧号
+	 * @return 是否发布；同一帧已发布过时返回 false
+	 */
+	bool Publish(const TMap<FName, FTcsAttributeInstance>& Attributes, uint64 FrameNumber);
+
+	// 撤销已发布的快照（游戏线程）；读取方已持有的快照保持有效
+	void Reset();
+
+	// 已发布快照分配的内存（字节，不含结构体本身）
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	// 已发布的快照，仅在 PublishedLock 内读写指针本身
+	FTcsAttributeSnapshotPtr Published;
+
+	mutable FRWLock PublishedLock;
+
+	// 最近一次发布的帧号与代数（游戏线程）
+	uint64 LastPublishedFrame = 0;
+	uint64 LastGeneration = 0;
+	bool bHasPublished = false;
+};
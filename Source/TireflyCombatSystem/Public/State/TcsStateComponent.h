@@ -10,6 +10,7 @@
 #include "TcsStateInstance.h"
 #include "TcsStateContainer.h"
 #include "TcsStateSlot.h"
+#include "TcsNotificationBatchScope.h"
 #include "TcsStateComponent.generated.h"
 
 
@@ -17,9 +18,14 @@
 class UTcsStateInstance;
 class UTcsStateManagerSubsystem;
 class UTcsAttributeManagerSubsystem;
+class UTcsAttributeComponent;
 class UTcsStateDefinition;
 class UTcsStateSlotDefinition;
 struct FStateTreeStateHandle;
+struct FTcsStateTreeSlotMapping;
+struct FTcsMemoryUsage;
+class APawn;
+class AController;
 
 
 
@@ -148,11 +154,21 @@ protected:
 
 public:
 	friend class UTcsStateInstance;
+	friend class UTcsAttributeManagerSubsystem;
 
 public:
 	void AddToStateTreeTickScheduler(UTcsStateInstance* StateInstance) { StateTreeTickScheduler.Add(StateInstance); }
 	void RemoveFromStateTreeTickScheduler(UTcsStateInstance* StateInstance) { StateTreeTickScheduler.Remove(StateInstance); }
 
+	// 重新解析所有状态实例的对象引用（拥有者或发起者的控制器、组件变化时调用）
+	UFUNCTION(BlueprintCallable, Category = "State")
+	void RefreshStateObjectReferences();
+
+protected:
+	// 拥有者 Pawn 的控制器变化时刷新状态实例的对象引用与 StateTree 上下文缓存
+	UFUNCTION()
+	void HandleOwnerControllerChanged(APawn* Pawn, AController* OldController, AController* NewController);
+
 #pragma endregion
 
 
@@ -464,13 +480,8 @@ protected:
 #pragma region StateSlot_References
 
 protected:
-	// 映射集合：StateSlot 到 StateTreeState
-	UPROPERTY()
-	TMap<FGameplayTag, FStateTreeStateHandle> Mapping_StateSlotToStateHandle;
-	
-	// 映射集合：StateTreeState 到 StateSlot
-	UPROPERTY()
-	TMap<FStateTreeStateHandle, FGameplayTag> Mapping_StateHandleToStateSlot;
+	// StateSlot 与 StateTreeState 的映射（由状态管理器按 StateTree 资产共享）
+	TSharedPtr<const FTcsStateTreeSlotMapping> StateSlotMapping;
 
 	// StateTree状态槽映射 (运行时状态数据)
 	UPROPERTY()
@@ -584,7 +595,7 @@ protected:
 	void RemoveUnmergedStates(
 		FTcsStateSlot* StateSlot,
 		const TArray<UTcsStateInstance*>& MergedStates,
-		const TMap<FName, UTcsStateInstance*>& MergePrimaryByDefId);
+		const TMap<int32, UTcsStateInstance*>& MergePrimaryByDefIndex);
 
 	// 按槽位激活模式处理状态。
 	virtual void ProcessStateSlotByActivationMode(FTcsStateSlot* StateSlot, FGameplayTag SlotTag);
@@ -655,6 +666,43 @@ protected:
 
 #pragma endregion
 
+
+#pragma region StateTree_Event
+
+public:
+	/**
+	 * 向监听该事件的所有运行中状态发送 StateTree 事件
+	 * 只投递给 StateTree 需要该事件（或其父标签）的状态实例，不遍历全部状态
+	 *
+	 * @param EventTag 事件标签
+	 * @param EventPayload 事件负载
+	 * @return 接收事件的状态实例数量
+	 */
+	UFUNCTION(BlueprintCallable, Category = "State|StateTree")
+	int32 SendStateTreeEventToStates(FGameplayTag EventTag, const FInstancedStruct& EventPayload);
+
+	// 登记状态实例的 StateTree 事件监听（StateTree 启动时调用）
+	void RegisterStateTreeEventListener(UTcsStateInstance* StateInstance);
+
+	// 注销状态实例的 StateTree 事件监听（StateTree 停止时调用）
+	void UnregisterStateTreeEventListener(UTcsStateInstance* StateInstance);
+
+protected:
+	// 收集状态实例需要的事件标签
+	bool GetStateTreeEventListenTags(
+		const UTcsStateInstance* StateInstance,
+		FGameplayTagContainer& OutEventTags,
+		bool& bOutListensToAllEvents);
+
+protected:
+	// 事件标签 -> 监听该标签的状态实例
+	TMap<FGameplayTag, TArray<TWeakObjectPtr<UTcsStateInstance>>> StateTreeEventListeners;
+
+	// 监听所有事件的状态实例
+	TArray<TWeakObjectPtr<UTcsStateInstance>> StateTreeAllEventListeners;
+
+#pragma endregion
+
 	
 #pragma region StateDuration
 
@@ -684,4 +732,117 @@ protected:
 	FTcsStateDurationTracker DurationTracker;
 
 #pragma endregion
+
+
+#pragma region NotificationBatch
+
+public:
+	/**
+	 * 开启事件批处理（可嵌套；推荐使用 FTcsStateNotificationBatchScope）
+	 * 同时开启拥有者属性组件的批处理，使状态变化引起的修改器与属性事件一并合并
+	 */
+	void BeginNotificationBatch();
+
+	// 结束事件批处理，最外层结束时先广播属性事件，再按首次出现顺序广播合并后的状态事件
+	void EndNotificationBatch();
+
+	// 当前是否处于事件批处理中
+	bool IsBatchingNotifications() const { return NotificationBatchDepth > 0; }
+
+protected:
+	// 批处理中暂存的状态事件类型
+	enum class EPendingStateNotify : uint8
+	{
+		StageChanged,
+		Deactivated,
+		Removed,
+		StackChanged,
+		LevelChanged,
+		DurationRefreshed,
+		SlotGateStateChanged,
+		ParameterChanged,
+		Merged,
+		ApplySuccess,
+		ApplyFailed,
+	};
+
+	// 批处理中暂存的状态事件（各类型只使用与其委托参数对应的字段）
+	struct FPendingStateNotification
+	{
+		EPendingStateNotify Type = EPendingStateNotify::StageChanged;
+		TWeakObjectPtr<UTcsStateInstance> StateInstance;
+		TWeakObjectPtr<UTcsStateInstance> OtherStateInstance;
+		TWeakObjectPtr<AActor> TargetActor;
+		FName Name = NAME_None;
+		FGameplayTag Tag;
+		ETcsStateStage PreviousStage = ETcsStateStage::SS_Inactive;
+		ETcsStateStage NewStage = ETcsStateStage::SS_Inactive;
+		int32 OldValue = 0;
+		int32 NewValue = 0;
+		float Duration = 0.f;
+		bool bInitialFlag = false;
+		bool bFlag = false;
+		ETcsStateParameterKeyType KeyType = ETcsStateParameterKeyType::Name;
+		ETcsStateParameterType ParameterType = ETcsStateParameterType::SPT_Numeric;
+		ETcsStateApplyFailReason FailureReason = ETcsStateApplyFailReason::None;
+		FString Message;
+	};
+
+	// 事件去重键：(类型, 实例, 名称, 标签)
+	using FPendingStateNotifyKey = TTuple<EPendingStateNotify, const UObject*, FName, FGameplayTag>;
+
+	/**
+	 * 查找或新增暂存事件
+	 *
+	 * @param Type 事件类型
+	 * @param StateInstance 去重所用的状态实例（可为空）
+	 * @param Name 去重所用的名称
+	 * @param Tag 去重所用的标签
+	 * @param bOutIsNew 是否为新增事件
+	 * @return 暂存事件
+	 */
+	FPendingStateNotification& FindOrAddPendingNotification(
+		EPendingStateNotify Type,
+		UTcsStateInstance* StateInstance,
+		FName Name,
+		FGameplayTag Tag,
+		bool& bOutIsNew);
+
+	// 新增不参与去重的暂存事件
+	FPendingStateNotification& AddPendingNotification(EPendingStateNotify Type);
+
+	// 广播暂存的全部状态事件
+	void FlushPendingNotifications();
+
+protected:
+	// 批处理嵌套深度
+	int32 NotificationBatchDepth = 0;
+
+	// 批处理期间同时开启批处理的属性组件
+	TWeakObjectPtr<UTcsAttributeComponent> BatchedAttributeComponent;
+
+	// 暂存事件（按首次出现顺序）
+	TArray<FPendingStateNotification> PendingNotifications;
+
+	// 去重键到暂存事件下标的映射
+	TMap<FPendingStateNotifyKey, int32> PendingNotificationIndices;
+
+#pragma endregion
+
+
+#pragma region MemoryReport
+
+public:
+	/**
+	 * 统计组件及其持有的状态实例的内存占用（游戏线程，见 FTcsMemoryReport）
+	 * 按容器写入 Usage，状态实例的开销同时按状态定义 Id 归集
+	 */
+	virtual void CollectMemoryUsage(FTcsMemoryUsage& Usage) const;
+
+#pragma endregion
 };
+
+
+
+// 状态组件事件批处理作用域
+using FTcsStateNotificationBatchScope = TTcsNotificationBatchScope<UTcsStateComponent>;
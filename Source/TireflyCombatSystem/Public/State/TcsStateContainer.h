@@ -42,9 +42,9 @@ public:
 	UPROPERTY()
 	TMap<int32, TObjectPtr<UTcsStateInstance>> InstancesById;
 
-	// 通过定义Id索引
+	// 通过定义稠密 ID 索引：数组下标即 StateDefIndex，按需增长，空桶保留
 	UPROPERTY()
-	TMap<FName, FTcsStateInstanceArray> InstancesByName;
+	TArray<FTcsStateInstanceArray> InstancesByDefIndex;
 
 	// 通过SlotTag索引
 	UPROPERTY()
@@ -61,6 +61,8 @@ public:
 
 	bool GetInstancesByName(FName StateDefId, TArray<UTcsStateInstance*>& OutInstances) const;
 
+	bool GetInstancesByDefIndex(int32 StateDefIndex, TArray<UTcsStateInstance*>& OutInstances) const;
+
 	bool GetInstancesBySlot(FGameplayTag SlotTag, TArray<UTcsStateInstance*>& OutInstances) const;
 };
 
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
 #include "GameplayTagContainer.h"
+#include "TcsDefinitionId.h"
 #include "StateTreeReference.h"
 #include "TcsStateInstance.h"
 #include "StateCondition/TcsStateCondition.h"
@@ -45,10 +46,28 @@ public:
 	 * 状态的语义标识（新增字段）
 	 * 用于父子 Tag 匹配、分类筛选、跨系统对齐
 	 * 推荐命名约定：TCS.State.<StateDefId>
+	 * 写入 AssetRegistry 标签，未加载时也可按 Tag 解析状态定义
 	 */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Identity", Meta = (Categories = "TCS.State"))
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, AssetRegistrySearchable, Category = "Identity", Meta = (Categories = "TCS.State"))
 	FGameplayTag StateTag;
 
+	/**
+	 * 获取状态定义的稠密 ID（首次访问时分配）
+	 * 进程内有效，用于运行时容器索引；Blueprint、存档与网络同步请使用 StateDefId
+	 */
+	int32 GetStateDefIndex() const
+	{
+		if (CachedDefIndex == INDEX_NONE)
+		{
+			CachedDefIndex = FTcsDefinitionIdTable::FindOrAdd(ETcsDefinitionKind::State, StateDefId);
+		}
+		return CachedDefIndex;
+	}
+
+protected:
+	// 稠密 ID 缓存（运行时分配，不序列化；StateDefId 变更时失效）
+	mutable int32 CachedDefIndex = INDEX_NONE;
+
 #pragma endregion
 
 
@@ -146,6 +165,35 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "State Tree")
 	ETcsStateTreeTickPolicy TickPolicy = ETcsStateTreeTickPolicy::WhileActive;
 
+	/**
+	 * 无逻辑状态：不创建、不执行 StateTree（例如只有属性修改器和持续时间的纯数值 Buff）
+	 * 阶段、槽位、叠层与事件流程照常执行；未配置 StateTree 或 StateTree 不含任何节点时自动视为无逻辑状态
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "State Tree")
+	bool bSkipStateTree = false;
+
+	/**
+	 * StateTree 额外监听的事件标签
+	 * 事件转换与事件进入条件所需的标签会从 StateTree 资产自动收集；
+	 * 在任务中自行读取事件的 StateTree 需要在此声明，否则收不到 SendStateTreeEventToStates 广播的事件
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "State Tree", Meta = (EditCondition = "!bSkipStateTree"))
+	FGameplayTagContainer StateTreeEventTags;
+
+	/**
+	 * 状态是否需要运行 StateTree
+	 *
+	 * @return 为 false 时跳过 StateTree 的实例数据分配、启动、Tick 与停止
+	 */
+	bool RequiresStateTree() const;
+
+protected:
+	// 根据 StateTree 资产内容判断是否需要运行
+	bool ComputeRequiresStateTree() const;
+
+	// 运行时缓存（-1 未计算，0 不需要，1 需要；编辑器下 StateTree 可能被重新编译，不缓存）
+	mutable int8 CachedRequiresStateTree = -1;
+
 #pragma endregion
 
 
@@ -176,6 +224,26 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Parameter")
 	TMap<FGameplayTag, FTcsStateParameter> TagParameters;
 
+	/**
+	 * 获取编译后的参数 Schema（PostLoad 与编辑后编译）
+	 * 未编译的定义（运行时 NewObject 创建且未调用 CompileParameterSchema）按当前配置临时构建，不缓存
+	 *
+	 * @return 参数 Schema，实例持有共享引用以保证重新编译期间旧值块布局仍然有效
+	 */
+	TSharedRef<const FTcsStateParameterSchema> GetParameterSchema() const;
+
+	/**
+	 * 重新编译参数 Schema（运行时创建的定义在配置完成后调用）
+	 */
+	void CompileParameterSchema();
+
+protected:
+	// 按当前参数集与持续时间、叠层配置构建参数 Schema
+	TSharedRef<const FTcsStateParameterSchema> BuildParameterSchema() const;
+
+	// 编译后的参数 Schema（运行时缓存，不序列化）
+	TSharedPtr<const FTcsStateParameterSchema> ParameterSchema;
+
 #pragma endregion
 
 
@@ -183,6 +251,9 @@ public:
 	// 覆写 GetPrimaryAssetId
 	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
 
+	// 加载完成后预编译参数 Schema，避免首次创建实例时编译
+	virtual void PostLoad() override;
+
 #if WITH_EDITOR
 	// 编辑器验证：属性值变更时的验证
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
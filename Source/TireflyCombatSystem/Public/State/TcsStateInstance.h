@@ -7,17 +7,20 @@
 #include "StateTreeReference.h"
 #include "StateTreeInstanceData.h"
 #include "StateTreeExecutionTypes.h"
+#include "TcsDefinitionId.h"
 #include "TcsSourceHandle.h"
 #include "TcsStateInstance.generated.h"
 
 
 class UTcsAttributeComponent;
+class UTcsAttributeManagerSubsystem;
 class UTcsSkillComponent;
 class UTcsStateComponent;
 class UTcsStateMerger;
 class UTcsStateCondition;
 class UTcsStateParamExtractor;
 class UTcsStateDefinition;
+struct FTcsMemoryUsage;
 
 
 
@@ -163,6 +166,100 @@ public:
 
 
 
+// 状态参数 Schema：由状态定义编译，为每个参数分配在扁平值块中的偏移
+// 参数索引分配顺序：Parameters（按名称排序）→ TagParameters（按标签名排序）→ 内置参数（TotalDuration / StackCount，已声明则复用）
+struct TIREFLYCOMBATSYSTEM_API FTcsStateParameterSchema
+{
+public:
+	// Schema 条目
+	struct FEntry
+	{
+		// 参数类型
+		ETcsStateParameterType ParameterType = ETcsStateParameterType::SPT_Numeric;
+
+		// 参数键类型
+		ETcsStateParameterKeyType KeyType = ETcsStateParameterKeyType::Name;
+
+		// 参数名（KeyType 为 Name 时有效）
+		FName ParameterName;
+
+		// 参数标签（KeyType 为 Tag 时有效）
+		FGameplayTag ParameterTag;
+
+		// 参数值在值块中的字节偏移
+		int32 Offset = 0;
+	};
+
+	// 参数类型数量（用于按类型分桶的索引表）
+	static constexpr int32 NumParameterTypes = 3;
+
+	// 值块内存对齐
+	static constexpr int32 ValueBlockAlignment = 16;
+
+	using FValueBlock = TArray<uint8, TAlignedHeapAllocator<ValueBlockAlignment>>;
+
+public:
+	// 按名称查找参数索引，未找到返回 INDEX_NONE
+	int32 FindIndexByName(FName ParameterName, ETcsStateParameterType ParameterType) const
+	{
+		const int32* Found = NameToIndex[static_cast<int32>(ParameterType)].Find(ParameterName);
+		return Found ? *Found : INDEX_NONE;
+	}
+
+	// 按标签查找参数索引，未找到返回 INDEX_NONE
+	int32 FindIndexByTag(const FGameplayTag& ParameterTag, ETcsStateParameterType ParameterType) const
+	{
+		const int32* Found = TagToIndex[static_cast<int32>(ParameterType)].Find(ParameterTag);
+		return Found ? *Found : INDEX_NONE;
+	}
+
+	// 检查索引是否有效且类型匹配
+	bool IsValidIndex(int32 ParamIndex, ETcsStateParameterType ParameterType) const
+	{
+		return Entries.IsValidIndex(ParamIndex) && Entries[ParamIndex].ParameterType == ParameterType;
+	}
+
+	// 参数数量
+	int32 Num() const { return Entries.Num(); }
+
+public:
+	// 参数条目（数组下标即参数索引）
+	TArray<FEntry> Entries;
+
+	// 参数名 -> 参数索引（按参数类型分桶）
+	TMap<FName, int32> NameToIndex[NumParameterTypes];
+
+	// 参数标签 -> 参数索引（按参数类型分桶）
+	TMap<FGameplayTag, int32> TagToIndex[NumParameterTypes];
+
+	// 默认值块，实例初始化时整体拷贝
+	FValueBlock DefaultValueBlock;
+
+	// 默认已赋值标记（内置参数按定义配置预置，其余参数由评估写入）
+	TBitArray<> DefaultAssignedFlags;
+
+	// 内置参数索引：总持续时间
+	int32 TotalDurationIndex = INDEX_NONE;
+
+	// 内置参数索引：叠层数
+	int32 StackCountIndex = INDEX_NONE;
+};
+
+
+
+// 状态动态参数：不在 Schema 中、运行时通过 Set*Param 新增的参数
+struct FTcsStateDynamicParameters
+{
+	TMap<FName, float> NumericParameters;
+	TMap<FGameplayTag, float> NumericParametersTag;
+	TMap<FName, bool> BoolParameters;
+	TMap<FGameplayTag, bool> BoolParametersTag;
+	TMap<FName, FVector> VectorParameters;
+	TMap<FGameplayTag, FVector> VectorParametersTag;
+};
+
+
+
 // 状态实例
 UCLASS(BlueprintType, Blueprintable)
 class TIREFLYCOMBATSYSTEM_API UTcsStateInstance : public UObject
@@ -176,6 +273,8 @@ public:
 
 	virtual UWorld* GetWorld() const override;
 
+	virtual void BeginDestroy() override;
+
 #pragma endregion
 
 
@@ -198,7 +297,14 @@ public:
     FName GetStateDefId() const { return StateDefId; }
 
     // 设置状态的定义Id（由管理器填充）
-    void SetStateDefId(FName InStateDefId) { StateDefId = InStateDefId; }
+    void SetStateDefId(FName InStateDefId)
+    {
+        StateDefId = InStateDefId;
+        StateDefIndex = FTcsDefinitionIdTable::FindOrAdd(ETcsDefinitionKind::State, InStateDefId);
+    }
+
+	// 获取状态定义的稠密 ID（进程内有效，用于运行时容器索引）
+	int32 GetStateDefIndex() const { return StateDefIndex; }
 
 	// 获取状态定义 DataAsset 硬引用
 	const UTcsStateDefinition* GetStateDef() const { return StateDef; }
@@ -209,8 +315,16 @@ public:
 	// 获取状态实例的来源句柄
 	const FTcsSourceHandle& GetSourceHandle() const { return SourceHandle; }
 
-	// 设置状态实例的来源句柄（由管理器在 CreateStateInstance 中填充）
-	void SetSourceHandle(const FTcsSourceHandle& InSourceHandle) { SourceHandle = InSourceHandle; }
+	/**
+	 * 设置状态实例的来源句柄（由 CreateStateInstance 填充）
+	 *
+	 * @param InSourceHandle 来源句柄
+	 * @param InSourceHandleOwner 句柄引用的持有方；非空时本实例接管该引用，并在 ReleaseSourceHandle 或销毁时释放
+	 */
+	void SetSourceHandle(const FTcsSourceHandle& InSourceHandle, UTcsAttributeManagerSubsystem* InSourceHandleOwner = nullptr);
+
+	// 释放本实例持有的来源句柄引用（句柄本身保留，用于事后比较与调试）
+	void ReleaseSourceHandle();
 
 protected:
 	// 状态定义 DataAsset 硬引用
@@ -221,6 +335,9 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = "Meta")
 	FName StateDefId;
 
+	// 状态定义稠密 ID（与 StateDefId 一一对应，仅进程内有效，不序列化）
+	int32 StateDefIndex = INDEX_NONE;
+
 	// 状态实例Id
 	UPROPERTY(BlueprintReadOnly, Category = "Meta")
 	int32 StateInstanceId = -1;
@@ -232,6 +349,9 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = "Meta")
 	FTcsSourceHandle SourceHandle;
 
+	// 持有来源句柄引用的属性管理器（引用释放后置空）
+	TWeakObjectPtr<UTcsAttributeManagerSubsystem> SourceHandleOwner;
+
 #pragma endregion
 
 
@@ -324,7 +444,14 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "State|Runtime")
 	UTcsSkillComponent* GetInstigatorSkillComponent() const { return InstigatorSkillCmp.Get(); }
 
+	// 重新解析拥有者与发起者的控制器和组件（控制器或组件变化时调用），同时使 StateTree 上下文缓存失效
+	UFUNCTION(BlueprintCallable, Category = "State|Runtime")
+	void RefreshObjectReferences();
+
 protected:
+	// 从 Owner / Instigator 解析控制器与组件并使 StateTree 上下文缓存失效（Initialize 与 RefreshObjectReferences 共用）
+	void ResolveObjectReferences();
+
 	// 状态实例拥有者
 	UPROPERTY(BlueprintReadOnly, Category = "State|Runtime")
 	TWeakObjectPtr<AActor> Owner;
@@ -370,11 +497,67 @@ protected:
 
 #pragma region Parameters
 
+public:
+	// 获取参数 Schema（来自状态定义，未初始化时为空）
+	const FTcsStateParameterSchema* GetParamSchema() const { return ParamSchema.Get(); }
+
+	// 按名称查找 Schema 参数索引，供原生代码缓存后走索引快速路径；未找到返回 INDEX_NONE
+	int32 FindParamIndex(FName ParameterName, ETcsStateParameterType ParameterType) const
+	{
+		return ParamSchema.IsValid() ? ParamSchema->FindIndexByName(ParameterName, ParameterType) : INDEX_NONE;
+	}
+
+	// 按标签查找 Schema 参数索引，供原生代码缓存后走索引快速路径；未找到返回 INDEX_NONE
+	int32 FindParamIndexByTag(FGameplayTag ParameterTag, ETcsStateParameterType ParameterType) const
+	{
+		return ParamSchema.IsValid() ? ParamSchema->FindIndexByTag(ParameterTag, ParameterType) : INDEX_NONE;
+	}
+
+	// 检查 Schema 参数是否已写入值
+	bool IsParamAssigned(int32 ParamIndex) const
+	{
+		return ParamAssignedFlags.IsValidIndex(ParamIndex) && ParamAssignedFlags[ParamIndex];
+	}
+
 protected:
 	void InitParameterValues();
 
 	void InitParameterTagValues();
 
+	// 获取 Schema 参数在值块中的地址（调用方保证索引与类型有效）
+	template <typename ValueType>
+	ValueType& AccessParamValue(int32 ParamIndex)
+	{
+		return *reinterpret_cast<ValueType*>(ParamValueBlock.GetData() + ParamSchema->Entries[ParamIndex].Offset);
+	}
+
+	template <typename ValueType>
+	const ValueType& AccessParamValue(int32 ParamIndex) const
+	{
+		return *reinterpret_cast<const ValueType*>(ParamValueBlock.GetData() + ParamSchema->Entries[ParamIndex].Offset);
+	}
+
+	// 获取动态参数容器，不存在时创建
+	FTcsStateDynamicParameters& GetOrCreateDynamicParameters();
+
+	// 查找数值参数值（Schema 优先，其次动态参数）；未写入返回 nullptr
+	const float* FindNumericParamValue(int32 ParamIndex, FName ParameterName) const;
+
+	// 写入 Schema 参数后的变更通知
+	void NotifyParamChangedByIndex(int32 ParamIndex);
+
+	// 参数 Schema（与状态定义共享；定义重新编译后，旧 Schema 随引用它的实例一起释放）
+	TSharedPtr<const FTcsStateParameterSchema> ParamSchema;
+
+	// 参数值块（初始化时从 Schema 默认值块整体拷贝）
+	FTcsStateParameterSchema::FValueBlock ParamValueBlock;
+
+	// Schema 参数已赋值标记
+	TBitArray<> ParamAssignedFlags;
+
+	// Schema 之外的动态参数（仅在运行时写入未声明参数时分配）
+	TUniquePtr<FTcsStateDynamicParameters> DynamicParameters;
+
 #pragma endregion
 
 
@@ -401,14 +584,23 @@ public:
 	UFUNCTION(BlueprintPure, Category = "State|Parameters")
 	TArray<FGameplayTag> GetAllNumericParamTags() const;
 
-protected:
-	// 数值类型参数
-	UPROPERTY(BlueprintReadOnly, Category = "State|Parameters")
-	TMap<FName, float> NumericParameters;
+	// 获取所有已赋值的数值类型参数（按值块构建的副本）
+	UFUNCTION(BlueprintPure, Category = "State|Parameters")
+	TMap<FName, float> GetNumericParameters() const;
 
-	// 数值类型参数（Tag）
-	UPROPERTY(BlueprintReadOnly, Category = "State|Parameters")
-	TMap<FGameplayTag, float> NumericParametersTag;
+	// 获取所有已赋值的数值类型参数（Tag，按值块构建的副本）
+	UFUNCTION(BlueprintPure, Category = "State|Parameters")
+	TMap<FGameplayTag, float> GetNumericParametersTag() const;
+
+	// 按 Schema 索引读取数值参数（快速路径，调用方保证索引有效且类型为 Numeric）
+	float GetNumericParamByIndex(int32 ParamIndex) const
+	{
+		checkSlow(ParamSchema.IsValid() && ParamSchema->IsValidIndex(ParamIndex, ETcsStateParameterType::SPT_Numeric));
+		return AccessParamValue<float>(ParamIndex);
+	}
+
+	// 按 Schema 索引写入数值参数
+	void SetNumericParamByIndex(int32 ParamIndex, float Value);
 
 #pragma endregion
 
@@ -436,14 +628,23 @@ public:
 	UFUNCTION(BlueprintPure, Category = "State|Parameters")
 	TArray<FGameplayTag> GetAllBoolParamTags() const;
 
-protected:
-	// 布尔类型参数
-	UPROPERTY(BlueprintReadOnly, Category = "State|Parameters")  
-	TMap<FName, bool> BoolParameters;
+	// 获取所有已赋值的布尔类型参数（按值块构建的副本）
+	UFUNCTION(BlueprintPure, Category = "State|Parameters")
+	TMap<FName, bool> GetBoolParameters() const;
 
-	// 布尔类型参数（Tag）
-	UPROPERTY(BlueprintReadOnly, Category = "State|Parameters")
-	TMap<FGameplayTag, bool> BoolParametersTag;
+	// 获取所有已赋值的布尔类型参数（Tag，按值块构建的副本）
+	UFUNCTION(BlueprintPure, Category = "State|Parameters")
+	TMap<FGameplayTag, bool> GetBoolParametersTag() const;
+
+	// 按 Schema 索引读取布尔参数（快速路径，调用方保证索引有效且类型为 Bool）
+	bool GetBoolParamByIndex(int32 ParamIndex) const
+	{
+		checkSlow(ParamSchema.IsValid() && ParamSchema->IsValidIndex(ParamIndex, ETcsStateParameterType::SPT_Bool));
+		return AccessParamValue<bool>(ParamIndex);
+	}
+
+	// 按 Schema 索引写入布尔参数
+	void SetBoolParamByIndex(int32 ParamIndex, bool Value);
 
 #pragma endregion
 
@@ -471,14 +672,23 @@ public:
 	UFUNCTION(BlueprintPure, Category = "State|Parameters")
 	TArray<FGameplayTag> GetAllVectorParamTags() const;
 
-protected:
-	// 向量类型参数
-	UPROPERTY(BlueprintReadOnly, Category = "State|Parameters")
-	TMap<FName, FVector> VectorParameters;
+	// 获取所有已赋值的向量类型参数（按值块构建的副本）
+	UFUNCTION(BlueprintPure, Category = "State|Parameters")
+	TMap<FName, FVector> GetVectorParameters() const;
 
-	// 向量类型参数（Tag）
-	UPROPERTY(BlueprintReadOnly, Category = "State|Parameters")
-	TMap<FGameplayTag, FVector> VectorParametersTag;
+	// 获取所有已赋值的向量类型参数（Tag，按值块构建的副本）
+	UFUNCTION(BlueprintPure, Category = "State|Parameters")
+	TMap<FGameplayTag, FVector> GetVectorParametersTag() const;
+
+	// 按 Schema 索引读取向量参数（快速路径，调用方保证索引有效且类型为 Vector）
+	const FVector& GetVectorParamByIndex(int32 ParamIndex) const
+	{
+		checkSlow(ParamSchema.IsValid() && ParamSchema->IsValidIndex(ParamIndex, ETcsStateParameterType::SPT_Vector));
+		return AccessParamValue<FVector>(ParamIndex);
+	}
+
+	// 按 Schema 索引写入向量参数
+	void SetVectorParamByIndex(int32 ParamIndex, const FVector& Value);
 
 #pragma endregion
 
@@ -584,6 +794,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "State|StateTree")
 	void SendStateTreeEvent(FGameplayTag EventTag, const FInstancedStruct& EventPayload);
 
+	// 使 StateTree 上下文数据缓存失效，下次创建执行上下文时重新解析
+	void InvalidateStateTreeContextCache() { StateTreeContextCache.Reset(); }
+
 protected:
 	// 设置StateTree上下文
 	virtual bool SetContextRequirements(FStateTreeExecutionContext& Context);
@@ -610,5 +823,49 @@ private:
 	UPROPERTY()
 	FStateTreeInstanceData StateTreeInstanceData;
 
+	/**
+	 * StateTree 上下文数据缓存
+	 * StartStateTree 时解析一次，Tick、发送事件、停止时直接复用；
+	 * 引用的对象失效、控制器变化（包括从无到有）、StateTree 变化或调用 RefreshObjectReferences 时重新解析
+	 */
+	struct FStateTreeContextCache
+	{
+		// 缓存对应的 StateTree，为空表示缓存无效
+		const UStateTree* StateTree = nullptr;
+
+		// Schema 上下文数据
+		TArray<TPair<FName, FStateTreeDataView>> ContextData;
+
+		// 外部数据（链接的子树有各自的外部数据需求，按 StateTree 区分）
+		TArray<TPair<const UStateTree*, TArray<FStateTreeDataView>>> ExternalData;
+
+		// 缓存中引用的对象，任一失效时整个缓存失效
+		TArray<TWeakObjectPtr<const UObject>> ReferencedObjects;
+
+		// 解析缓存时拥有者与发起者的控制器，与当前控制器不一致时缓存失效
+		TWeakObjectPtr<const AController> OwnerController;
+		TWeakObjectPtr<const AController> InstigatorController;
+
+		void Reset();
+
+		void AddReferencedObject(const FStateTreeDataView& DataView);
+
+		bool IsValidFor(const UStateTree* InStateTree, const UTcsStateInstance& StateInstance) const;
+	};
+
+	FStateTreeContextCache StateTreeContextCache;
+
+#pragma endregion
+
+
+#pragma region MemoryReport
+
+public:
+	/**
+	 * 统计状态实例的内存占用（游戏线程，见 FTcsMemoryReport）
+	 * 按容器写入 Usage，并把实例总开销归集到其状态定义 Id
+	 */
+	virtual void CollectMemoryUsage(FTcsMemoryUsage& Usage) const;
+
 #pragma endregion
 };
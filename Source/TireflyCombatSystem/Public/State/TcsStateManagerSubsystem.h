@@ -7,6 +7,7 @@
 #include "TcsStateSlot.h"
 #include "State/TcsStateInstance.h"
 #include "TcsSourceHandle.h"
+#include "StateTree/TcsStateTreeAssetInfo.h"
 #include "TcsStateManagerSubsystem.generated.h"
 
 
@@ -16,6 +17,36 @@ class UTcsStateComponent;
 class UTcsStateDefinition;
 class UTcsStateSlotDefinition;
 class UTcsDefinitionRegistrySubsystem;
+class UStateTree;
+struct FTcsDefinitionChangeSet;
+struct FStreamableHandle;
+
+
+
+// 状态定义异步流式加载完成回调（参数为本次请求中已可用的状态定义 ID）
+DECLARE_DELEGATE_OneParam(FTcsOnStateDefinitionsStreamed, const TArray<FName>& /*LoadedStateDefIds*/);
+
+
+
+// 状态定义同步回退加载记录（卡顿报告条目）
+USTRUCT(BlueprintType)
+struct TIREFLYCOMBATSYSTEM_API FTcsStateSyncLoadHitchRecord
+{
+	GENERATED_BODY()
+
+public:
+	// 同步加载的状态定义 ID
+	UPROPERTY(BlueprintReadOnly, Category = "State Manager")
+	FName StateDefId;
+
+	// 同步加载耗时（毫秒）
+	UPROPERTY(BlueprintReadOnly, Category = "State Manager")
+	float LoadTimeMs = 0.f;
+
+	// 发生同步加载的帧号
+	UPROPERTY(BlueprintReadOnly, Category = "State Manager")
+	int64 FrameNumber = 0;
+};
 
 
 
@@ -39,6 +70,18 @@ protected:
 	// 缓存的状态定义（从 DeveloperSettings 加载）
 	TMap<FName, const UTcsStateDefinition*> StateDefinitions;
 
+	// 缓存的状态定义（按 StateDefIndex 稠密索引，未加载的位置为 nullptr）
+	TArray<const UTcsStateDefinition*> StateDefinitionsByIndex;
+
+	// 将状态定义写入名称缓存与稠密索引缓存
+	void CacheStateDefinition(FName StateDefId, const UTcsStateDefinition* Asset);
+
+	// 从名称缓存、稠密索引缓存与 Tag 映射中移除状态定义
+	void UncacheStateDefinition(FName StateDefId);
+
+	// 清空状态定义缓存
+	void ResetStateDefinitionCache(int32 ExpectedNum = 0);
+
 	// StateTag -> StateDefId 映射（运行时构建，用于 Tag 入口 API）
 	TMap<FGameplayTag, FName> StateTagToDefId;
 
@@ -81,9 +124,15 @@ protected:
 	 */
 	void PreloadCommonStates();
 
+	/**
+	 * 发布全部 State 定义 ID，生成跨进程一致的网络索引（内部方法）
+	 * 包含尚未加载的定义，供 SourceHandle 因果链等网络数据压缩使用
+	 */
+	void PublishNetworkStateDefinitionIds();
+
 #if WITH_EDITOR
 	UTcsDefinitionRegistrySubsystem* GetDefinitionRegistry() const;
-	void HandleDefinitionRegistryRefreshed(const UTcsDefinitionRegistrySubsystem* Registry);
+	void HandleDefinitionRegistryRefreshed(const UTcsDefinitionRegistrySubsystem* Registry, const FTcsDefinitionChangeSet& ChangeSet);
 	const TMap<FName, TSoftObjectPtr<UTcsStateDefinition>>* GetStateDefinitionSourceCache() const;
 	const TMap<FName, TSoftObjectPtr<UTcsStateSlotDefinition>>* GetStateSlotDefinitionSourceCache() const;
 	FDelegateHandle DefinitionRegistryRefreshedHandle;
@@ -99,9 +148,19 @@ public:
 	 */
 	const UTcsStateDefinition* GetStateDefinition(FName DefId);
 
+	/**
+	 * 通过稠密 ID 获取状态定义资产（运行时热路径使用，避免 FName 哈希）
+	 * 未命中缓存时回退到 GetStateDefinition（含按需加载）
+	 *
+	 * @param StateDefIndex 状态定义稠密 ID（UTcsStateInstance::GetStateDefIndex）
+	 * @return 状态定义资产指针，如果未找到则返回 nullptr
+	 */
+	const UTcsStateDefinition* GetStateDefinitionByIndex(int32 StateDefIndex);
+
 	/**
 	 * 通过 StateTag 获取状态定义资产
-	 * 支持按需加载（当 StateLoadingStrategy 为 OnDemand 或 Hybrid 时）
+	 * 未加载的定义通过 AssetRegistry 标签索引解析后按需加载（当 StateLoadingStrategy 为 OnDemand 或 Hybrid 时）；
+	 * 索引未命中直接返回 nullptr，不会逐个加载全部定义去匹配标签
 	 *
 	 * @param StateTag 状态标签
 	 * @return 状态定义资产指针，如果未找到则返回 nullptr
@@ -136,6 +195,127 @@ public:
 	/** 获取所有已缓存的 StateSlot 定义名称。 */
 	TArray<FName> GetAllStateSlotDefNames() const;
 
+	/**
+	 * 注册运行时创建的临时状态定义（自动化测试、基准测试与无头模拟使用）
+	 * 直接写入定义缓存，不经过 DefinitionRegistry / AssetManager，定义重新加载后失效；
+	 * 定义缓存不持有 GC 引用，调用方负责保持定义对象存活；定义配置完成后需先调用 CompileParameterSchema
+	 *
+	 * @param Definition 状态定义（按 StateDefId 注册，同名覆盖）
+	 */
+	void RegisterTransientStateDefinition(const UTcsStateDefinition* Definition);
+
+	/**
+	 * 注册运行时创建的临时状态槽定义（约束同 RegisterTransientStateDefinition）
+	 * 只影响之后初始化槽映射的状态组件
+	 *
+	 * @param Definition 状态槽定义（按 StateSlotDefId 注册，同名覆盖）
+	 */
+	void RegisterTransientStateSlotDefinition(const UTcsStateSlotDefinition* Definition);
+
+#pragma endregion
+
+
+#pragma region StateStreaming
+
+public:
+	/**
+	 * 异步流式加载状态定义（通过 StreamableManager，不阻塞游戏线程）
+	 * 已加载的定义直接跳过；全部已加载时回调会被立即调用
+	 *
+	 * @param StateDefIds 状态定义 ID 列表
+	 * @param OnStreamed 加载完成回调（可选，返回 false 时不会被调用）
+	 * @return 是否至少有一个定义已加载或已发起加载
+	 */
+	bool RequestAsyncLoadStateDefinitions(
+		const TArray<FName>& StateDefIds,
+		FTcsOnStateDefinitionsStreamed OnStreamed = FTcsOnStateDefinitionsStreamed());
+
+	/**
+	 * 预取状态定义（按 ID），适用于 OnDemand / Hybrid 策略下提前消除首次应用的同步加载
+	 *
+	 * @param StateDefIds 状态定义 ID 列表
+	 */
+	UFUNCTION(BlueprintCallable, Category = "State Manager")
+	void PrefetchStateDefinitions(const TArray<FName>& StateDefIds);
+
+	/**
+	 * 预取状态定义（按 StateTag），未加载定义的 Tag 通过 AssetRegistry 标签解析，不触发加载
+	 *
+	 * @param StateTags 状态标签集合
+	 */
+	UFUNCTION(BlueprintCallable, Category = "State Manager")
+	void PrefetchStateDefinitionsByTag(const FGameplayTagContainer& StateTags);
+
+	/**
+	 * 先异步加载状态定义再向目标应用状态
+	 * 定义已加载时立即应用；否则在加载完成的后续帧应用，结果通过目标 StateComponent 的 ApplySuccess / ApplyFailed 事件通知。
+	 * 请求被拒绝（参数无效或定义无法解析）时只返回 false，不会再触发 ApplyFailed 事件
+	 *
+	 * @param Target 目标
+	 * @param StateDefId 状态定义 ID
+	 * @param Instigator 状态的发起者
+	 * @param StateLevel 状态等级（默认为 1）
+	 * @param ParentSourceHandle 父级来源句柄 (用于因果链传递, 默认为空)
+	 * @return 请求是否被接受（接受后的失败只通过 ApplyFailed 事件通知）
+	 */
+	UFUNCTION(BlueprintCallable, Category = "State Manager")
+	bool RequestApplyStateToTargetAsync(
+		AActor* Target,
+		FName StateDefId,
+		AActor* Instigator,
+		int32 StateLevel = 1,
+		const FTcsSourceHandle& ParentSourceHandle = FTcsSourceHandle());
+
+	/** 检查状态定义是否已加载到缓存 */
+	bool IsStateDefinitionLoaded(FName StateDefId) const { return StateDefinitions.Contains(StateDefId); }
+
+	/**
+	 * 获取同步回退加载的卡顿报告
+	 * OnDemand / Hybrid 策略下每次因未预取而在游戏线程同步读盘都会记录一条，只保留最近 MaxSyncLoadHitchRecords 条
+	 *
+	 * @return 按发生顺序排列的记录
+	 */
+	UFUNCTION(BlueprintCallable, Category = "State Manager")
+	TArray<FTcsStateSyncLoadHitchRecord> GetSyncLoadHitchReport() const;
+
+	/** 清空同步回退加载的卡顿报告 */
+	UFUNCTION(BlueprintCallable, Category = "State Manager")
+	void ResetSyncLoadHitchReport();
+
+protected:
+	// 解析状态定义的资产路径（DefinitionRegistry / DeveloperSettings 缓存优先，其次 AssetManager）
+	FSoftObjectPath ResolveStateDefinitionPath(FName StateDefId) const;
+
+	// 解析 StateTag 对应的状态定义 ID（已加载映射优先，其次 AssetRegistry 标签索引）
+	bool ResolveStateDefIdByTag(const FGameplayTag& StateTag, FName& OutStateDefId);
+
+	// 将已加载的状态定义写入缓存与 Tag 映射
+	void RegisterLoadedStateDefinition(FName StateDefId, const UTcsStateDefinition* Asset);
+
+	// 异步加载完成回调
+	void HandleStateDefinitionsStreamed(TArray<FName> RequestedStateDefIds, FTcsOnStateDefinitionsStreamed OnStreamed);
+
+	// 记录同步回退加载
+	void RecordSyncLoadHitch(FName StateDefId, double LoadTimeSeconds);
+
+	// 异步加载句柄（持有句柄以保证流式加载的定义不被 GC）
+	TMap<FName, TSharedPtr<FStreamableHandle>> StateDefinitionStreamingHandles;
+
+	// 未加载定义的 StateTag -> StateDefId 索引（从 AssetRegistry 标签构建，首次按 Tag 解析未命中时构建）
+	TMap<FGameplayTag, FName> UnloadedStateTagIndex;
+
+	// 未加载定义的 Tag 索引是否已构建
+	bool bUnloadedStateTagIndexBuilt = false;
+
+	// 同步回退加载记录（环形缓冲，写满后覆盖最旧的记录）
+	TArray<FTcsStateSyncLoadHitchRecord> SyncLoadHitchRecords;
+
+	// 环形缓冲的下一个写入位置
+	int32 NextSyncLoadHitchRecordIndex = 0;
+
+	// 同步回退加载记录上限
+	static constexpr int32 MaxSyncLoadHitchRecords = 64;
+
 #pragma endregion
 	
 
@@ -175,4 +355,45 @@ public:
 		const FTcsSourceHandle& ParentSourceHandle = FTcsSourceHandle());
 
 #pragma endregion
+
+
+#pragma region StateTreeAssetCache
+
+public:
+	/**
+	 * 获取 StateTree 资产的事件监听信息
+	 * 每个资产只构建一次，供所有状态组件按事件标签路由 StateTree 事件
+	 *
+	 * @param StateTree StateTree 资产
+	 * @return 共享的事件监听信息
+	 */
+	TSharedRef<const FTcsStateTreeEventListenInfo> GetStateTreeEventListenInfo(const UStateTree& StateTree);
+
+	/**
+	 * 获取 StateTree 资产的状态槽映射
+	 * 每个资产只构建一次，状态槽定义变更或 StateTree 重新编译后重建；已取得的映射保持不变
+	 *
+	 * @param StateTree StateTree 资产
+	 * @return 共享的状态槽映射
+	 */
+	TSharedRef<const FTcsStateTreeSlotMapping> GetStateTreeSlotMapping(const UStateTree& StateTree);
+
+protected:
+	// 按当前状态槽定义构建状态槽映射
+	TSharedRef<const FTcsStateTreeSlotMapping> BuildStateTreeSlotMapping(const UStateTree& StateTree) const;
+
+#if WITH_EDITOR
+	// StateTree 重新编译后丢弃该资产的缓存
+	void HandleStateTreePostCompile(const UStateTree& StateTree);
+
+	FDelegateHandle StateTreePostCompileHandle;
+#endif
+
+	// StateTree 资产 -> 事件监听信息
+	TMap<TObjectKey<UStateTree>, TSharedRef<const FTcsStateTreeEventListenInfo>> StateTreeEventListenInfos;
+
+	// StateTree 资产 -> 状态槽映射
+	TMap<TObjectKey<UStateTree>, TSharedRef<const FTcsStateTreeSlotMapping>> StateTreeSlotMappings;
+
+#pragma endregion
 };
@@ -0,0 +1,48 @@
+// Copyright Tirefly. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "StateTreeTypes.h"
+
+
+class UStateTree;
+
+
+
+/**
+ * StateTree 资产的事件监听信息（每个资产构建一次，所有状态实例共享）
+ *
+ * 从编译后的 StateTree 收集事件转换与事件进入条件要求的事件标签，包括链接的子树资产。
+ */
+struct TIREFLYCOMBATSYSTEM_API FTcsStateTreeEventListenInfo
+{
+	// 需要的事件标签（事件标签与其中任一标签或其子标签匹配时才需要投递）
+	FGameplayTagContainer EventTags;
+
+	// 存在不限定标签的事件需求，需要接收所有事件
+	bool bListensToAllEvents = false;
+
+	// 从编译后的 StateTree 构建
+	static FTcsStateTreeEventListenInfo Build(const UStateTree& StateTree);
+};
+
+
+
+/**
+ * StateTree 资产的状态槽映射（每个资产按当前状态槽定义构建一次，所有状态组件共享）
+ *
+ * 状态槽定义中的 StateTreeStateName 按名称匹配编译后 StateTree 的状态（同名时取第一个）。
+ */
+struct TIREFLYCOMBATSYSTEM_API FTcsStateTreeSlotMapping
+{
+	// 状态槽 -> StateTree 状态
+	TMap<FGameplayTag, FStateTreeStateHandle> SlotToStateHandle;
+
+	// StateTree 状态 -> 状态槽
+	TMap<FStateTreeStateHandle, FGameplayTag> StateHandleToSlot;
+
+	// StateTree 状态名 -> 映射到该状态的状态槽（状态切换时只刷新进入/退出状态对应的槽）
+	TMap<FName, TArray<FGameplayTag, TInlineAllocator<1>>> StateNameToSlots;
+};
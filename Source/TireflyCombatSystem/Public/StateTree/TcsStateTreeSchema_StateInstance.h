@@ -51,10 +51,12 @@ public:
 	virtual bool IsClassAllowed(const UClass* InClass) const override;
 	virtual bool IsExternalItemAllowed(const UStruct& InStruct) const override;
 
+	// OutContextData: 可选，记录写入的上下文数据，供调用方缓存后直接复用
 	static bool SetContextRequirements(
 		UTcsStateInstance& StateInstance,
 		FStateTreeExecutionContext& Context,
-		bool bLogErrors = true);
+		bool bLogErrors = true,
+		TArray<TPair<FName, FStateTreeDataView>>* OutContextData = nullptr);
 	static bool CollectExternalData(
 		const FStateTreeExecutionContext& Context,
 		const UStateTree* StateTree,
@@ -69,7 +71,8 @@ protected:
 	public:
 		FTcsContextDataSetter(
 			TNotNull<const UTcsStateInstance*> InStateInstance,
-			FStateTreeExecutionContext& Context);
+			FStateTreeExecutionContext& Context,
+			TArray<TPair<FName, FStateTreeDataView>>* InRecordedContextData = nullptr);
 		
 		TNotNull<const UTcsStateInstance*> GetStateInstance() const
 		{
@@ -84,6 +87,7 @@ protected:
 	private:
 		TNotNull<const UTcsStateInstance*> StateInstance;
 		FStateTreeExecutionContext& ExecutionContext;
+		TArray<TPair<FName, FStateTreeDataView>>* RecordedContextData = nullptr;
 	};
 
 	virtual void SetContextData(FTcsContextDataSetter& ContextDataSetter, bool bLogErrors) const;
@@ -0,0 +1,96 @@
+// Copyright Tirefly. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "TcsSourceHandle.h"
+
+#include <atomic>
+
+
+class AActor;
+
+
+
+// 战斗指令类型
+enum class ETcsCombatCommandType : uint8
+{
+	// 应用属性修改器（ModifierIds + 可选 Operands）
+	ApplyModifiers,
+	// 按来源移除属性修改器
+	RemoveModifiersBySource,
+	// 应用状态
+	ApplyState,
+	// 按定义 Id 移除状态
+	RemoveStatesByDefId,
+};
+
+
+
+/**
+ * 战斗指令（可在任意线程构造）
+ *
+ * 只保存值类型与弱引用，执行时在游戏线程上解析目标；目标已销毁的指令直接丢弃。
+ * SourceHandle 须在游戏线程创建后再交给工作线程使用。
+ */
+struct TIREFLYCOMBATSYSTEM_API FTcsCombatCommand
+{
+	ETcsCombatCommandType Type = ETcsCombatCommandType::ApplyModifiers;
+
+	// 目标
+	TWeakObjectPtr<AActor> Target;
+
+	// 施加者（为空时修改器指令取来源的施加者）
+	TWeakObjectPtr<AActor> Instigator;
+
+	// 来源句柄（修改器来源 / 状态的父级来源）
+	FTcsSourceHandle SourceHandle;
+
+	// 修改器 Id 列表（ApplyModifiers）
+	TArray<FName> ModifierIds;
+
+	// 修改器操作数（ApplyModifiers，为空时使用定义中的操作数）
+	TMap<FName, float> Operands;
+
+	// 状态定义 Id（ApplyState / RemoveStatesByDefId）
+	FName StateDefId = NAME_None;
+
+	// 状态等级（ApplyState）
+	int32 StateLevel = 1;
+};
+
+
+
+/**
+ * 多生产者单消费者的战斗指令队列
+ *
+ * - Enqueue 可在任意线程调用，无锁
+ * - Drain 只能在游戏线程调用，按入队顺序执行；同一来源（同一生产线程）的指令保持提交顺序
+ * - 每次 Drain 只执行开始时已入队的指令，执行过程中新入队的指令留到下一次
+ */
+class TIREFLYCOMBATSYSTEM_API FTcsCombatCommandQueue
+{
+public:
+	// 入队（任意线程）
+	void Enqueue(FTcsCombatCommand&& Command);
+
+	/**
+	 * 执行当前已入队的全部指令（游戏线程）
+	 *
+	 * @param Executor 指令执行函数
+	 * @return 执行的指令数量
+	 */
+	int32 Drain(TFunctionRef<void(FTcsCombatCommand&)> Executor);
+
+	// 丢弃全部未执行的指令（游戏线程）
+	void Reset();
+
+	// 当前待执行的指令数量（近似值，可在任意线程读取）
+	int32 NumPending() const { return PendingCount.load(std::memory_order_relaxed); }
+
+private:
+	TQueue<FTcsCombatCommand, EQueueMode::Mpsc> Commands;
+
+	std::atomic<int32> PendingCount{0};
+};
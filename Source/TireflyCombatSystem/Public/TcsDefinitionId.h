@@ -0,0 +1,124 @@
+// Copyright Tirefly. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+
+// 定义类别（每个类别拥有独立的稠密 ID 空间）
+enum class ETcsDefinitionKind : uint8
+{
+	Attribute = 0,
+	AttributeModifier,
+	State,
+	StateSlot,
+	Num
+};
+
+
+
+/**
+ * 定义稠密 ID 表
+ *
+ * 为每个定义 ID（FName）分配进程内唯一、从 0 开始连续递增的整数 ID（DefIndex），
+ * 运行时容器可直接以 DefIndex 作为数组下标或整数键，避免在热路径上反复哈希 FName。
+ *
+ * 注意:
+ * - DefIndex 在首次加载/注册定义时分配，分配后不回收（定义重命名或删除只会留下空位）
+ * - DefIndex 仅在当前进程内有效，不同进程之间分配顺序可能不同：不可用于存档或网络同步，跨进程请使用 FName
+ *   或网络索引（NetIndex：按定义 ID 排序后的下标，两端加载相同内容时一致）
+ * - NetIndex 只能在确认两端列表一致（列表哈希相同）的连接上使用，否则必须写出 FName
+ * - 仅在游戏线程访问（查询位于修改器合并等热路径上，不加锁）；分配新 ID 与发布网络索引时会检查线程
+ */
+class TIREFLYCOMBATSYSTEM_API FTcsDefinitionIdTable
+{
+public:
+	/**
+	 * 查找定义 ID 对应的 DefIndex，不存在时分配新的 DefIndex
+	 *
+	 * @param Kind 定义类别
+	 * @param DefinitionId 定义 ID
+	 * @return DefIndex；DefinitionId 为空时返回 INDEX_NONE
+	 */
+	static int32 FindOrAdd(ETcsDefinitionKind Kind, FName DefinitionId);
+
+	/**
+	 * 查找定义 ID 对应的 DefIndex
+	 *
+	 * @param Kind 定义类别
+	 * @param DefinitionId 定义 ID
+	 * @return DefIndex；未分配时返回 INDEX_NONE
+	 */
+	static int32 Find(ETcsDefinitionKind Kind, FName DefinitionId);
+
+	/**
+	 * 获取 DefIndex 对应的定义 ID（用于 Blueprint 与调试输出）
+	 *
+	 * @param Kind 定义类别
+	 * @param DefIndex 稠密 ID
+	 * @return 定义 ID；DefIndex 无效时返回 NAME_None
+	 */
+	static FName GetDefinitionId(ETcsDefinitionKind Kind, int32 DefIndex);
+
+	/**
+	 * 获取已分配的 DefIndex 数量（即该类别稠密数组所需的长度）
+	 *
+	 * @param Kind 定义类别
+	 * @return DefIndex 数量
+	 */
+	static int32 Num(ETcsDefinitionKind Kind);
+
+	/**
+	 * 发布某类别的完整定义 ID 列表，用于生成跨进程一致的网络索引（NetIndex）
+	 * 列表按 FName 字符串排序后编号，服务端与客户端加载相同内容时得到相同的 NetIndex
+	 *
+	 * @param Kind 定义类别
+	 * @param DefinitionIds 该类别的全部定义 ID（顺序无关）
+	 */
+	static void SetNetworkDefinitionIds(ETcsDefinitionKind Kind, TArray<FName> DefinitionIds);
+
+	/**
+	 * 查找定义 ID 对应的网络索引
+	 *
+	 * @param Kind 定义类别
+	 * @param DefinitionId 定义 ID
+	 * @return NetIndex；未发布时返回 INDEX_NONE
+	 */
+	static int32 FindNetIndex(ETcsDefinitionKind Kind, FName DefinitionId);
+
+	/**
+	 * 获取网络索引对应的定义 ID
+	 *
+	 * @param Kind 定义类别
+	 * @param NetIndex 网络索引
+	 * @return 定义 ID；NetIndex 无效时返回 NAME_None
+	 */
+	static FName GetNetDefinitionId(ETcsDefinitionKind Kind, int32 NetIndex);
+
+	/** 获取已发布的网络定义 ID 列表（按 NetIndex 排列） */
+	static TArray<FName> GetNetworkDefinitionIds(ETcsDefinitionKind Kind);
+
+	/**
+	 * 获取已发布的网络定义 ID 列表的哈希（与进程无关，两端哈希相同时 NetIndex 一致）
+	 *
+	 * @param Kind 定义类别
+	 * @return 列表哈希
+	 */
+	static uint32 GetNetworkDefinitionListHash(ETcsDefinitionKind Kind);
+
+	/** 获取全部类别的网络定义列表哈希（按 ETcsDefinitionKind 排列，用于连接握手） */
+	static TArray<uint32> GetNetworkDefinitionListHashes();
+
+	/**
+	 * 网络序列化定义 ID：允许使用 NetIndex 且已发布的定义写为 NetIndex + 1，否则写 0 后跟完整 FName
+	 * 读取端按数据中的形式解析，不依赖 bUseNetIndex
+	 *
+	 * @param Ar 序列化归档
+	 * @param Kind 定义类别
+	 * @param DefinitionId 定义 ID
+	 * @param bUseNetIndex 写出时是否允许使用 NetIndex（仅当对端列表哈希与本端一致时为 true）
+	 * @return 是否成功（读取到未知 NetIndex 时失败）
+	 */
+	static bool NetSerializeDefinitionId(FArchive& Ar, ETcsDefinitionKind Kind, FName& DefinitionId, bool bUseNetIndex);
+};
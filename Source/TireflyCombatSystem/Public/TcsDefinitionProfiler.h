@@ -0,0 +1,186 @@
+// Copyright Tirefly. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TcsStats.h"
+#include "HAL/CriticalSection.h"
+#include <atomic>
+
+
+
+// 定义开销的统计类别
+enum class ETcsDefinitionCostCategory : uint8
+{
+	// 状态实例的 StateTree Tick（按状态定义 Id 归集）
+	StateTreeTick,
+
+	// 状态参数求值（按状态定义 Id 归集）
+	ParameterEvaluation,
+
+	// 状态激活条件检查（按状态定义 Id 归集）
+	ConditionCheck,
+
+	// 属性修改器执行（按修改器定义 Id 归集）
+	ModifierExecution,
+
+	Num
+};
+
+
+
+#if TCS_STATS_ENABLED
+
+// 单个定义在某一类别下的累计开销
+struct FTcsDefinitionCostEntry
+{
+	ETcsDefinitionCostCategory Category = ETcsDefinitionCostCategory::Num;
+	FName DefinitionId;
+
+	// 调用次数
+	int64 Calls = 0;
+
+	// 累计耗时 / 单次最大耗时（CPU 周期）
+	uint64 TotalCycles = 0;
+	uint64 MaxCycles = 0;
+
+	double GetTotalMs() const;
+	double GetAverageUs() const;
+	double GetMaxUs() const;
+};
+
+
+
+/**
+ * 定义开销分析器
+ *
+ * 可选开启的全局分析器，把 StateTree Tick、参数求值、条件检查与修改器执行的耗时归集到对应的定义 Id，
+ * 用于在帧尖峰时定位具体是哪几个状态/修改器定义开销过高。
+ * 未开启时每个采样点只有一次原子读；开启后采样写入当前线程自己的累计表（只有本线程与读取方使用的锁，
+ * 工作线程之间不竞争），Dump / 导出时再合并各线程的数据。测得的绝对耗时会略有偏高，适合做相对排序。
+ *
+ * 控制台命令：
+ * - tcs.Profiler.Start / tcs.Profiler.Stop：开始 / 停止采样（开始时不会清空已有数据）
+ * - tcs.Profiler.Reset：清空已采样数据
+ * - tcs.Profiler.Dump [N] [Category]：按累计耗时输出各类别前 N 项（默认 10），Category 为类别名时只输出该类别
+ * - tcs.Profiler.ExportCsv [Path]：导出全部数据为 CSV，默认写到 Saved/Profiling/TcsDefinitionCost
+ *
+ * Shipping 下整个分析器编译为空。
+ */
+class TIREFLYCOMBATSYSTEM_API FTcsDefinitionProfiler
+{
+public:
+	static FTcsDefinitionProfiler& Get();
+
+	static bool IsEnabled() { return bEnabled.load(std::memory_order_relaxed); }
+
+	// 开启 / 关闭采样
+	void SetEnabled(bool bInEnabled);
+
+	// 清空已采样数据
+	void Reset();
+
+	// 记录一次采样（任意线程）
+	void Record(ETcsDefinitionCostCategory Category, FName DefinitionId, uint64 Cycles);
+
+	/**
+	 * 获取采样数据（按累计耗时降序）
+	 *
+	 * @param Category 只返回该类别；为 Num 时返回全部类别
+	 * @param MaxEntries 每个类别最多返回的条目数，小于等于 0 表示不限制
+	 */
+	TArray<FTcsDefinitionCostEntry> GetEntries(
+		ETcsDefinitionCostCategory Category = ETcsDefinitionCostCategory::Num,
+		int32 MaxEntries = 0) const;
+
+	// 采样时长（秒），包含当前正在进行的采样
+	double GetCaptureSeconds() const;
+
+	// 按类别输出前 N 项
+	void DumpTopN(int32 N, ETcsDefinitionCostCategory Category, FOutputDevice& Ar) const;
+
+	/**
+	 * 导出全部采样数据为 CSV
+	 * 列：Category,DefinitionId,Calls,TotalMs,AvgUs,MaxUs,PercentOfCategory
+	 *
+	 * @param FilePath 目标路径，为空时写到 Saved/Profiling/TcsDefinitionCost/TcsDefinitionCost-<时间戳>.csv
+	 * @param OutFilePath 实际写出的路径
+	 * @return 是否写出成功
+	 */
+	bool ExportCsv(const FString& FilePath, FString& OutFilePath) const;
+
+	static const TCHAR* GetCategoryName(ETcsDefinitionCostCategory Category);
+
+	// 按名称解析类别（不区分大小写），失败返回 Num
+	static ETcsDefinitionCostCategory ParseCategory(const FString& Name);
+
+private:
+	struct FCost
+	{
+		int64 Calls = 0;
+		uint64 TotalCycles = 0;
+		uint64 MaxCycles = 0;
+	};
+
+	// 单个线程的累计表；锁只在本线程采样与合并 / 清空时使用，采样时基本无竞争
+	struct FThreadCosts
+	{
+		FCriticalSection Lock;
+		TMap<FName, FCost> Costs[static_cast<int32>(ETcsDefinitionCostCategory::Num)];
+	};
+
+	// 当前线程的累计表，首次采样时创建并登记（由分析器持有，线程退出后数据保留到 Reset）
+	FThreadCosts& GetThreadCosts();
+
+	static std::atomic<bool> bEnabled;
+
+	// 保护线程累计表列表与采样时长
+	mutable FCriticalSection CostsLock;
+	TArray<TUniquePtr<FThreadCosts>> ThreadCosts;
+
+	// 累计采样时长与当前采样的开始时间
+	double AccumulatedCaptureSeconds = 0.0;
+	double CaptureStartTime = 0.0;
+};
+
+
+
+// 定义开销采样作用域：分析器未开启时不计时
+class FTcsDefinitionCostScope : public FNoncopyable
+{
+public:
+	FTcsDefinitionCostScope(ETcsDefinitionCostCategory InCategory, FName InDefinitionId)
+	{
+		if (FTcsDefinitionProfiler::IsEnabled())
+		{
+			Category = InCategory;
+			DefinitionId = InDefinitionId;
+			StartCycles = FPlatformTime::Cycles64();
+		}
+	}
+
+	~FTcsDefinitionCostScope()
+	{
+		if (StartCycles != 0)
+		{
+			FTcsDefinitionProfiler::Get().Record(Category, DefinitionId, FPlatformTime::Cycles64() - StartCycles);
+		}
+	}
+
+private:
+	ETcsDefinitionCostCategory Category = ETcsDefinitionCostCategory::Num;
+	FName DefinitionId;
+	uint64 StartCycles = 0;
+};
+
+
+
+// 把作用域内的耗时归集到指定定义 Id
+#define TCS_DEFINITION_COST_SCOPE(Category, DefinitionId) \
+	FTcsDefinitionCostScope PREPROCESSOR_JOIN(TcsDefinitionCostScope_, __LINE__)(ETcsDefinitionCostCategory::Category, DefinitionId)
+
+#else
+
+#define TCS_DEFINITION_COST_SCOPE(Category, DefinitionId)
+
+#endif
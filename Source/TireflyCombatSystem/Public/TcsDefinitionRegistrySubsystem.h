@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Containers/Ticker.h"
 #include "Subsystems/EngineSubsystem.h"
+#include "TcsDefinitionId.h"
 #include "TcsDefinitionRegistrySubsystem.generated.h"
 
 class UTcsAttributeDefinition;
@@ -16,7 +17,50 @@ struct FAssetData;
 struct FPrimaryAssetTypeInfo;
 struct FPropertyChangedEvent;
 
-DECLARE_MULTICAST_DELEGATE_OneParam(FTcsDefinitionRegistryRefreshed, const UTcsDefinitionRegistrySubsystem*);
+/**
+ * 定义变更集：一次刷新中发生变化的定义 ID（按定义类别分组）
+ *
+ * - bIsFullRefresh 为 true 时（首次扫描、AssetManager 扫描配置变化）变更集不逐条列出定义，管理器应全量重载
+ * - 否则管理器只需对 Removed 中的定义移除缓存，对 Changed 中的定义（新增或内容更新）重新加载
+ */
+struct TIREFLYCOMBATSYSTEM_API FTcsDefinitionChangeSet
+{
+public:
+	// 是否为全量刷新
+	bool bIsFullRefresh = false;
+
+	// 新增或内容更新的定义 ID
+	TSet<FName> Changed[static_cast<int32>(ETcsDefinitionKind::Num)];
+
+	// 被移除的定义 ID（同一 ID 若在本次刷新中被重新添加，则只出现在 Changed 中）
+	TSet<FName> Removed[static_cast<int32>(ETcsDefinitionKind::Num)];
+
+public:
+	const TSet<FName>& GetChanged(ETcsDefinitionKind Kind) const { return Changed[static_cast<int32>(Kind)]; }
+
+	const TSet<FName>& GetRemoved(ETcsDefinitionKind Kind) const { return Removed[static_cast<int32>(Kind)]; }
+
+	// 指定类别是否有变化（全量刷新视为所有类别都有变化）
+	bool HasChanges(ETcsDefinitionKind Kind) const
+	{
+		return bIsFullRefresh || GetChanged(Kind).Num() > 0 || GetRemoved(Kind).Num() > 0;
+	}
+
+	// 是否无任何变化
+	bool IsEmpty() const
+	{
+		for (int32 KindIndex = 0; KindIndex < static_cast<int32>(ETcsDefinitionKind::Num); ++KindIndex)
+		{
+			if (Changed[KindIndex].Num() > 0 || Removed[KindIndex].Num() > 0)
+			{
+				return false;
+			}
+		}
+		return !bIsFullRefresh;
+	}
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FTcsDefinitionRegistryRefreshed, const UTcsDefinitionRegistrySubsystem*, const FTcsDefinitionChangeSet&);
 
 UCLASS()
 class TIREFLYCOMBATSYSTEM_API UTcsDefinitionRegistrySubsystem : public UEngineSubsystem
@@ -63,7 +107,10 @@ public:
 	}
 
 #if WITH_EDITOR
+	// 请求全量刷新（下一帧重新扫描所有定义目录）
 	void RequestRefresh();
+
+	// 立即处理待刷新内容：有全量刷新请求时重新扫描，否则只应用累积的单资产增量
 	void RefreshDefinitionsNow();
 #endif
 
@@ -71,9 +118,10 @@ private:
 #if WITH_EDITOR
 	void RegisterEditorCallbacks();
 	void UnregisterEditorCallbacks();
+	void ScheduleDeferredRefresh();
 	bool HandleDeferredRefresh(float DeltaTime);
 	void RebuildSnapshot();
-	void MirrorSnapshotToDeveloperSettings() const;
+	void MirrorSnapshotToDeveloperSettings(const FTcsDefinitionChangeSet& ChangeSet) const;
 	void ScanPrimaryAssetType(const FPrimaryAssetTypeInfo& TypeInfo, class IAssetRegistry& AssetRegistry);
 	void ScanAttributeDefinitions(const TArray<FAssetData>& AssetDataList);
 	void ScanAttributeModifierDefinitions(const TArray<FAssetData>& AssetDataList);
@@ -90,6 +138,30 @@ private:
 	void OnAssetManagerSettingsChanged(UObject* SettingsObject, FPropertyChangedEvent& PropertyChangedEvent);
 	void ClearQueuedRefresh();
 
+	// 增量更新
+	void QueueDefinitionUpsert(const FSoftObjectPath& AssetPath);
+	void QueueDefinitionRemoval(const FSoftObjectPath& AssetPath);
+	void ApplyPendingDeltas(FTcsDefinitionChangeSet& OutChangeSet);
+	void UpsertDefinition(const FSoftObjectPath& AssetPath, FTcsDefinitionChangeSet& OutChangeSet);
+	void RemoveDefinition(const FSoftObjectPath& AssetPath, FTcsDefinitionChangeSet& OutChangeSet);
+	bool IsInScannedDirectories(const FPrimaryAssetType& PrimaryAssetType, const FSoftObjectPath& AssetPath) const;
+	void TrackDefinition(ETcsDefinitionKind Kind, FName DefinitionId, const FSoftObjectPath& AssetPath);
+	void TrackShadowedDefinition(ETcsDefinitionKind Kind, FName DefinitionId, const FSoftObjectPath& AssetPath);
+	void PromoteShadowedDefinition(ETcsDefinitionKind Kind, FName DefinitionId, FTcsDefinitionChangeSet& OutChangeSet);
+
+	// 已注册定义的资产路径 -> (类别, 定义 ID)，用于删除/重命名等只知道路径的增量事件
+	TMap<FSoftObjectPath, TPair<ETcsDefinitionKind, FName>> TrackedDefinitionsByPath;
+
+	// 因定义 ID 重复而未收录的资产路径 -> (类别, 定义 ID)；生效的资产被移除时从中提升一个顶替
+	TMap<FSoftObjectPath, TPair<ETcsDefinitionKind, FName>> ShadowedDefinitionsByPath;
+
+	// 待应用的增量：新增/更新的资产路径、删除的资产路径
+	TSet<FSoftObjectPath> PendingUpsertPaths;
+	TSet<FSoftObjectPath> PendingRemovalPaths;
+
+	// 是否有待处理的全量刷新请求
+	bool bFullRefreshRequested = false;
+
 	bool bHasRegisteredEditorCallbacks = false;
 	bool bHasCompletedInitialRefresh = false;
 	bool bIsRefreshQueued = false;
@@ -176,6 +176,29 @@ public:
 		return CachedAttributeModifierDefinitions;
 	}
 
+	/**
+	 * 获取可修改的缓存映射（由 Subsystem 增量同步变化的定义时调用）
+	 */
+	TMap<FName, TSoftObjectPtr<UTcsAttributeDefinition>>& GetMutableCachedAttributeDefinitions()
+	{
+		return CachedAttributeDefinitions;
+	}
+
+	TMap<FName, TSoftObjectPtr<UTcsStateDefinition>>& GetMutableCachedStateDefinitions()
+	{
+		return CachedStateDefinitions;
+	}
+
+	TMap<FName, TSoftObjectPtr<UTcsStateSlotDefinition>>& GetMutableCachedStateSlotDefinitions()
+	{
+		return CachedStateSlotDefinitions;
+	}
+
+	TMap<FName, TSoftObjectPtr<UTcsAttributeModifierDefinition>>& GetMutableCachedAttributeModifierDefinitions()
+	{
+		return CachedAttributeModifierDefinitions;
+	}
+
 	/**
 	 * 设置缓存的属性定义资产映射（由 Subsystem 调用）
 	 */
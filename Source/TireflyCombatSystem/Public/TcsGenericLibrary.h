@@ -3,7 +3,9 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "TcsSourceHandle.h"
 #include "TcsGenericLibrary.generated.h"
 
 
@@ -45,7 +47,25 @@ public:
 
 #pragma endregion
 
-	
+
+#pragma region SourceHandleHelper
+
+public:
+	// 获取来源的施加者（通过所属 GameInstance 的来源注册表解析；来源已释放时返回 nullptr）
+	UFUNCTION(BlueprintPure, Category = "TireflyCombatSystem|SourceHandle", meta = (WorldContext = "WorldContextObject"))
+	static AActor* GetSourceHandleInstigator(const UObject* WorldContextObject, const FTcsSourceHandle& SourceHandle);
+
+	// 获取来源的类型标签（来源已释放时返回空容器）
+	UFUNCTION(BlueprintPure, Category = "TireflyCombatSystem|SourceHandle", meta = (WorldContext = "WorldContextObject"))
+	static FGameplayTagContainer GetSourceHandleTags(const UObject* WorldContextObject, const FTcsSourceHandle& SourceHandle);
+
+	// 获取来源的完整因果链（来源已释放时返回空数组）
+	UFUNCTION(BlueprintPure, Category = "TireflyCombatSystem|SourceHandle", meta = (WorldContext = "WorldContextObject"))
+	static TArray<FPrimaryAssetId> GetSourceHandleCausalityChain(const UObject* WorldContextObject, const FTcsSourceHandle& SourceHandle);
+
+#pragma endregion
+
+
 #pragma region SkillHelper
 
 public:
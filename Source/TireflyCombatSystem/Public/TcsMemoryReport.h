@@ -0,0 +1,129 @@
+// Copyright Tirefly. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+
+class UWorld;
+class UActorComponent;
+
+
+
+// 内存统计桶：条目数量与字节数
+struct FTcsMemoryBucket
+{
+	int64 Count = 0;
+	int64 Bytes = 0;
+
+	void Add(int64 InBytes, int64 InCount = 1)
+	{
+		Bytes += InBytes;
+		Count += InCount;
+	}
+};
+
+
+
+/**
+ * 内存统计累加器
+ *
+ * 组件与状态实例把各自容器的已分配字节数（对象本体 + 容器堆内存）按容器名写入 Containers，
+ * 同时把状态实例、修改器实例的开销按定义 Id 归集到 StateDefinitions / ModifierDefinitions。
+ * 定义维度只是同一批字节的另一种划分，不计入 TotalBytes。
+ */
+struct TIREFLYCOMBATSYSTEM_API FTcsMemoryUsage
+{
+	// 按容器名（如 "StateComponent.InstanceIndex.InstancesById"）累计
+	TMap<FName, FTcsMemoryBucket> Containers;
+
+	// 按状态定义 Id 累计状态实例开销
+	TMap<FName, FTcsMemoryBucket> StateDefinitions;
+
+	// 按修改器定义 Id 累计修改器实例开销
+	TMap<FName, FTcsMemoryBucket> ModifierDefinitions;
+
+	// 全部容器字节数之和
+	int64 TotalBytes = 0;
+
+	/**
+	 * 记录一个容器的开销
+	 *
+	 * @param ContainerName 容器名
+	 * @param Bytes 已分配字节数
+	 * @param Count 容器内的条目数量
+	 */
+	void AddContainer(FName ContainerName, SIZE_T Bytes, int64 Count = 1);
+
+	void AddStateDefinition(FName StateDefId, SIZE_T Bytes);
+
+	void AddModifierDefinition(FName ModifierId, SIZE_T Bytes);
+
+	// 合并另一个累加器
+	void Append(const FTcsMemoryUsage& Other);
+};
+
+
+
+// 单个组件的内存统计
+struct FTcsComponentMemoryEntry
+{
+	// 所属 Actor 名
+	FString OwnerName;
+
+	// 组件类名
+	FName ComponentClass;
+
+	// 组件及其持有的状态实例、修改器的总字节数
+	int64 Bytes = 0;
+
+	// 状态组件为状态实例数量，属性组件为修改器数量
+	int32 NumItems = 0;
+};
+
+
+
+/**
+ * 战斗系统内存报告
+ *
+ * 汇总一个世界内所有属性组件、状态组件（含其状态实例）的已分配内存，
+ * 按组件、容器与定义三个维度统计，并附带来源句柄注册表的开销。
+ * 统计值为容器已分配容量（而非已使用元素），可直接用于服务器内存规划与泄漏排查。
+ *
+ * 控制台命令：tcs.memreport [N]（各排行表输出前 N 项，默认 20）
+ */
+struct TIREFLYCOMBATSYSTEM_API FTcsMemoryReport
+{
+	// 逐组件统计（按字节数降序）
+	TArray<FTcsComponentMemoryEntry> Components;
+
+	// 全部组件的容器与定义汇总
+	FTcsMemoryUsage Usage;
+
+	// 来源句柄注册表（按 GameInstance 共享）
+	int64 SourceHandleRegistryBytes = 0;
+	int32 NumLiveSourceHandles = 0;
+
+	int32 NumAttributeComponents = 0;
+	int32 NumStateComponents = 0;
+
+	// 组件与来源句柄注册表的总字节数
+	int64 GetTotalBytes() const { return Usage.TotalBytes + SourceHandleRegistryBytes; }
+
+	/**
+	 * 收集世界内的战斗系统内存统计（游戏线程）
+	 *
+	 * @param World 目标世界
+	 * @return 内存报告
+	 */
+	static FTcsMemoryReport Collect(const UWorld* World);
+
+	/**
+	 * 输出报告
+	 *
+	 * @param Ar 输出设备
+	 * @param TopN 组件与定义排行表的输出条目数
+	 */
+	void Dump(FOutputDevice& Ar, int32 TopN = 20) const;
+};
@@ -0,0 +1,38 @@
+// Copyright Tirefly. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+
+/**
+ * 事件批处理作用域（RAII）
+ *
+ * 构造时开启组件的事件批处理，析构时结束；作用域可嵌套，最外层作用域结束时组件合并去重后统一广播。
+ * ComponentType 需提供 BeginNotificationBatch() / EndNotificationBatch()。
+ */
+template<typename ComponentType>
+class TTcsNotificationBatchScope : public FNoncopyable
+{
+public:
+	explicit TTcsNotificationBatchScope(ComponentType* InComponent)
+		: Component(InComponent)
+	{
+		if (Component)
+		{
+			Component->BeginNotificationBatch();
+		}
+	}
+
+	~TTcsNotificationBatchScope()
+	{
+		if (Component)
+		{
+			Component->EndNotificationBatch();
+		}
+	}
+
+private:
+	ComponentType* Component = nullptr;
+};
@@ -3,24 +3,30 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "GameplayTagContainer.h"
 #include "TcsSourceHandle.generated.h"
 
 
+struct FTcsSourceHandleNetContext;
+
 
 /**
  * SourceHandle 用于标识和追踪效果的来源
  *
  * 核心概念:
- * - Id: 全局唯一标识符（单调递增）
- * - Instigator: 实际造成效果的实体 (运行时 Actor)
- * - SourceTags: 来源标签（可选，用于分类/过滤）
- * - CausalityChain: 因果链，从根源到直接父级的完整链（包含父级自身，不包含当前实例）
+ * - 句柄本身只有 Id + Generation + OriginId，拷贝、哈希、比较均为常数开销
+ * - 来源元数据（施加者、来源标签、因果链）只在 FTcsSourceHandleRegistry 中存储一份，按需解析
+ * - Id: 来源在注册表中的槽位（-1 表示无效），槽位释放后会被复用
+ * - Generation: 槽位代数，每次复用时递增，使旧句柄不会解析到新来源
+ * - OriginId: 来源端标识，0 表示本地来源；通过网络收到的远端来源按 (连接, 对端来源端) 分配独立的 OriginId，
+ *   不同来源端的 Id 各自编号，互不冲突
  *
- * 示例:
+ * 因果链示例（FTcsSourceHandleData::GetCausalityChain 展开结果）:
  * - 根源 State (玩家释放技能): CausalityChain 为空
  * - 派生 State (技能 → Buff): CausalityChain = [技能StateDef.PrimaryAssetId]
  * - 多层派生 (技能 → Buff → 持续伤害): CausalityChain = [技能Id, BuffId]
+ *
+ * @see FTcsSourceHandleRegistry
+ * @see UTcsAttributeManagerSubsystem::CreateSourceHandle
  */
 USTRUCT(BlueprintType)
 struct TIREFLYCOMBATSYSTEM_API FTcsSourceHandle
@@ -28,44 +34,38 @@ struct TIREFLYCOMBATSYSTEM_API FTcsSourceHandle
 	GENERATED_BODY()
 
 public:
-	// 全局唯一来源 ID (单调递增, -1 表示无效)
+	// 来源在注册表中的槽位 (-1 表示无效)
 	UPROPERTY(BlueprintReadOnly, Category = "Source Handle")
 	int32 Id = -1;
 
-	// Source 类型标签 (可选, 用于分类和过滤)
-	UPROPERTY(BlueprintReadOnly, Category = "Source Handle")
-	FGameplayTagContainer SourceTags;
-
-	// 施加者 (实际造成效果的实体, 使用弱指针避免 GC 问题)
+	// 槽位代数 (与 Id 共同构成句柄的唯一标识)
 	UPROPERTY(BlueprintReadOnly, Category = "Source Handle")
-	TWeakObjectPtr<AActor> Instigator;
+	int32 Generation = 0;
 
-	// 因果链: 从根源到直接父级的完整链（包含父级自身，不包含当前实例）
+	// 来源端标识 (0 表示本地来源；非 0 时 Id 属于该来源端的注册表，本地只有只读镜像，不参与引用计数)
 	UPROPERTY(BlueprintReadOnly, Category = "Source Handle")
-	TArray<FPrimaryAssetId> CausalityChain;
+	int32 OriginId = 0;
 
 public:
 	// 默认构造函数
 	FTcsSourceHandle() = default;
 
 	/**
-	 * 完整构造函数
-	 * @param InId 全局唯一ID
-	 * @param InCausalityChain 因果链
-	 * @param InInstigator 施加者Actor
-	 * @param InSourceTags Source类型标签
+	 * 完整构造函数（仅供 FTcsSourceHandleRegistry 使用）
+	 * @param InId 槽位
+	 * @param InGeneration 槽位代数
+	 * @param InOriginId 来源端标识（0 表示本地来源）
 	 */
-	FTcsSourceHandle(int32 InId, const TArray<FPrimaryAssetId>& InCausalityChain,
-		AActor* InInstigator, const FGameplayTagContainer& InSourceTags = FGameplayTagContainer())
+	FTcsSourceHandle(int32 InId, int32 InGeneration, int32 InOriginId = 0)
 		: Id(InId)
-		, SourceTags(InSourceTags)
-		, Instigator(InInstigator)
-		, CausalityChain(InCausalityChain)
+		, Generation(InGeneration)
+		, OriginId(InOriginId)
 	{
 	}
 
 	/**
 	 * 检查 SourceHandle 是否有效
+	 * 注意: 有效只表示句柄曾被分配，来源元数据是否仍存在需通过注册表解析
 	 * @return true 当且仅当 ID >= 0
 	 */
 	bool IsValid() const
@@ -73,33 +73,37 @@ public:
 		return Id >= 0;
 	}
 
+	// 是否为本地注册表分配的来源（只有本地来源参与引用计数）
+	bool IsLocal() const
+	{
+		return IsValid() && OriginId == 0;
+	}
+
+	// 是否为通过网络收到的远端来源
+	bool IsRemote() const
+	{
+		return IsValid() && OriginId != 0;
+	}
+
 	/**
-	 * 生成调试字符串
-	 * @return 格式: "[SH:ID] Instigator=ActorName Chain=[...]" 或 "[SH:ID]"
+	 * 生成调试字符串（不解析元数据，完整信息见 FTcsSourceHandleRegistry::ToDebugString）
+	 * @return 格式: "[SH:Id.Generation]"，远端来源为 "[SH:R<OriginId>:Id.Generation]"
 	 */
 	FString ToDebugString() const
 	{
-		FString ChainStr;
-		for (int32 i = 0; i < CausalityChain.Num(); ++i)
+		if (OriginId != 0)
 		{
-			if (i > 0) ChainStr += TEXT("->");
-			ChainStr += CausalityChain[i].ToString();
-		}
-
-		if (Instigator.IsValid())
-		{
-			return FString::Printf(TEXT("[SH:%d] Instigator=%s Chain=[%s]"),
-				Id, *Instigator->GetName(), *ChainStr);
-		}
-		else
-		{
-			return FString::Printf(TEXT("[SH:%d] Chain=[%s]"), Id, *ChainStr);
+			return FString::Printf(TEXT("[SH:R%d:%d.%d]"), OriginId, Id, Generation);
 		}
+		return FString::Printf(TEXT("[SH:%d.%d]"), Id, Generation);
 	}
 
 	/**
 	 * 网络序列化
-	 * 实现自定义网络同步, 支持条件复制 (Instigator 有效时才复制)
+	 * 句柄与其来源元数据一同写出，接收端将元数据导入本地注册表的远端镜像，并为句柄分配该连接上的 OriginId
+	 * 远端句柄回传给其来源端所在的连接时只写出句柄与对端的来源端编号，接收端将其还原为自己的句柄；
+	 * 转发给其他连接（如服务器把客户端的来源转发给第三方客户端）时按镜像完整写出元数据
+	 * 因果链按定义网络索引压缩写出，对端已确认的链只写出连接内的链引用号
 	 * @param Ar 序列化归档
 	 * @param Map 网络包映射
 	 * @param bOutSuccess 输出是否成功
@@ -108,23 +112,33 @@ public:
 	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
 
 	/**
-	 * 相等性比较 (基于 ID)
+	 * 使用显式上下文的网络序列化（NetSerialize 的实现，可脱离 NetConnection 调用）
+	 * @param Ar 序列化归档
+	 * @param Map 网络包映射（可为空，此时不序列化 Instigator）
+	 * @param Context 序列化上下文
+	 * @param bOutSuccess 输出是否成功
+	 * @return 是否成功序列化
+	 */
+	bool NetSerializeWithContext(FArchive& Ar, UPackageMap* Map, const FTcsSourceHandleNetContext& Context, bool& bOutSuccess);
+
+	/**
+	 * 相等性比较 (基于 ID、代数与来源端)
 	 * @param Other 另一个SourceHandle
 	 * @return 是否相等
 	 */
 	bool operator==(const FTcsSourceHandle& Other) const
 	{
-		return Id == Other.Id;
+		return Id == Other.Id && Generation == Other.Generation && OriginId == Other.OriginId;
 	}
 
 	/**
-	 * 不等性比较 (基于 ID)
+	 * 不等性比较 (基于 ID、代数与来源端)
 	 * @param Other 另一个SourceHandle
 	 * @return 是否不等
 	 */
 	bool operator!=(const FTcsSourceHandle& Other) const
 	{
-		return Id != Other.Id;
+		return !(*this == Other);
 	}
 
 	/**
@@ -134,7 +148,8 @@ public:
 	 */
 	friend uint32 GetTypeHash(const FTcsSourceHandle& Handle)
 	{
-		return GetTypeHash(Handle.Id);
+		const uint32 Hash = GetTypeHash((static_cast<uint64>(static_cast<uint32>(Handle.Generation)) << 32) | static_cast<uint32>(Handle.Id));
+		return Handle.OriginId != 0 ? HashCombineFast(Hash, static_cast<uint32>(Handle.OriginId)) : Hash;
 	}
 };
 
@@ -0,0 +1,184 @@
+// Copyright Tirefly. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TcsDefinitionId.h"
+
+
+struct FTcsCausalityNode;
+class FTcsSourceHandleRegistry;
+class FTcsSourceHandleNetCache;
+
+
+
+// FTcsSourceHandle 网络序列化上下文（由 NetConnection 构建，测试中可直接构造以脱离真实网络）
+struct TIREFLYCOMBATSYSTEM_API FTcsSourceHandleNetContext
+{
+	// 来源注册表（发送端解析元数据，接收端导入元数据）
+	FTcsSourceHandleRegistry* Registry = nullptr;
+
+	// 当前连接的标识（注册表据此区分远端来源经由哪条连接到达；0 表示未关联连接）
+	int32 ConnectionId = 0;
+
+	// 当前连接的因果链缓存（为空时每次都完整发送因果链）
+	FTcsSourceHandleNetCache* Cache = nullptr;
+
+	// 本次写出所在的包序号（仅发送端使用）；INDEX_NONE 表示未知，由缓存在写出所在帧结束后补记
+	int32 SendPacketId = INDEX_NONE;
+
+	// 对端网络定义列表与本端一致的类别（按 ETcsDefinitionKind 的位掩码，仅发送端使用）；其余类别写出 FName
+	uint8 NetIndexKinds = 0;
+
+	// 写出时是否可对该类别使用 NetIndex
+	bool CanUseNetIndex(ETcsDefinitionKind Kind) const
+	{
+		return (NetIndexKinds & (1 << static_cast<uint8>(Kind))) != 0;
+	}
+};
+
+
+
+/**
+ * 每条网络连接的因果链缓存
+ *
+ * 发送端首次发送一条因果链时为其分配连接内的 ChainRef 并随链完整写出；
+ * 确认对端已收到该包后，后续同一条链只写出 ChainRef。
+ * 接收端按 ChainRef 记录收到的链，用于解析只携带 ChainRef 的句柄。
+ *
+ * 确认规则（保守）:
+ * - 对端已确认的最大包序号 >= 链最近一次完整发送所在的包序号
+ * - 且自那次发送以来连接未统计到任何丢包
+ * 两个条件同时满足时，那次发送必然已送达；否则继续完整发送，直到满足为止。
+ *
+ * 包被确认并不保证接收端处理了其中的 Bunch（例如 Actor 通道尚未打开、接收端缓存被重置），
+ * 因此接收端遇到未知的 ChainRef 时不中断读取：该句柄暂不带因果链，并记录一次未知引用；
+ * 所属子系统据此请求发送端 ResetAcks，之后所有链都回到完整发送，直到重新确认。
+ *
+ * 序列化时无法得知数据最终落在哪个包里（排队中的 Bunch、拆分的 Partial Bunch 可能在之后的包中发出），
+ * 因此真实连接上的发送包序号在写出所在帧结束后补记：下一帧首次更新确认状态时，以连接已发出的
+ * 最后一个包（OutPacketId - 1）作为上界（上一帧的数据已在帧末全部发出）。补记前该链不会被视为已确认。
+ * 自记录的发送以来无丢包时，之后的重发不刷新记录，避免持续重发不断推迟确认。
+ *
+ * 注意:
+ * - 仅在游戏线程访问
+ * - 发送端强引用已发送的链尾节点，保证节点地址在缓存生命周期内不被复用
+ * - ChainRef 不回收，达到 MaxCachedChains 后新链不再缓存（仍可完整发送）
+ */
+class TIREFLYCOMBATSYSTEM_API FTcsSourceHandleNetCache
+{
+public:
+	// 单个连接最多缓存的因果链数量
+	static constexpr int32 MaxCachedChains = 4096;
+
+	/**
+	 * 更新连接的确认状态（每次序列化前调用）
+	 * 进入新的一帧时，为之前各帧中包序号未知的发送补记包序号上界
+	 *
+	 * @param InAckedPacketId 对端已确认的最大包序号
+	 * @param InTotalPacketsLost 连接累计丢包数
+	 * @param InOutPacketId 连接下一个待发送的包序号（不小于此前已发出的所有包）
+	 * @param InFrameNumber 当前帧号
+	 */
+	void UpdateAckState(int32 InAckedPacketId, int32 InTotalPacketsLost, int32 InOutPacketId = INDEX_NONE, uint64 InFrameNumber = 0);
+
+	/**
+	 * 查找已被对端确认的因果链
+	 *
+	 * @param Tail 因果链尾节点
+	 * @return 已确认时返回 ChainRef，否则返回 INDEX_NONE
+	 */
+	int32 FindAckedChainRef(const FTcsCausalityNode* Tail);
+
+	/**
+	 * 记录一次因果链的完整发送
+	 *
+	 * @param Tail 因果链尾节点
+	 * @param PacketId 所在的包序号；INDEX_NONE 表示未知，在下一帧更新确认状态时补记
+	 * @return 分配给该链的 ChainRef；缓存已满时返回 INDEX_NONE
+	 */
+	int32 RecordChainSent(const TSharedPtr<const FTcsCausalityNode>& Tail, int32 PacketId);
+
+	/**
+	 * 记录收到的完整因果链
+	 *
+	 * @param ChainRef 发送端分配的 ChainRef
+	 * @param Tail 驻留后的因果链尾节点
+	 */
+	void RecordChainReceived(int32 ChainRef, const TSharedPtr<const FTcsCausalityNode>& Tail);
+
+	/**
+	 * 按 ChainRef 查找收到的因果链
+	 *
+	 * @param ChainRef 发送端分配的 ChainRef
+	 * @param OutTail 因果链尾节点
+	 * @return 是否找到
+	 */
+	bool FindReceivedChain(int32 ChainRef, TSharedPtr<const FTcsCausalityNode>& OutTail) const;
+
+	// 记录接收端遇到的未知 ChainRef（等待请求发送端重新完整发送）
+	void RecordUnknownChainRef() { bHasUnknownChainRef = true; }
+
+	/**
+	 * 取出并清除未知 ChainRef 记录
+	 * @return 自上次取出以来是否遇到过未知 ChainRef
+	 */
+	bool ConsumeUnknownChainRef()
+	{
+		const bool bHadUnknownChainRef = bHasUnknownChainRef;
+		bHasUnknownChainRef = false;
+		return bHadUnknownChainRef;
+	}
+
+	// 发送端：撤销所有链的确认状态（对端缺失链时调用），ChainRef 保持不变，链在重新确认前完整发送
+	void ResetAcks();
+
+	// 清空缓存（连接重建时调用）
+	void Reset();
+
+	// 发送端已缓存的链数量
+	int32 NumSentChains() const { return SentChains.Num(); }
+
+	// 接收端已缓存的链数量
+	int32 NumReceivedChains() const { return ReceivedChains.Num(); }
+
+private:
+	struct FSentChain
+	{
+		// 链尾节点（强引用）
+		TSharedPtr<const FTcsCausalityNode> Tail;
+
+		// 连接内的链引用号
+		int32 ChainRef = INDEX_NONE;
+
+		// 计入确认的那次完整发送所在的包序号（INDEX_NONE 表示尚待补记）
+		int32 SentPacketId = INDEX_NONE;
+
+		// 计入确认的那次完整发送时连接的累计丢包数
+		int32 PacketsLostAtSend = 0;
+
+		// 对端是否已确认
+		bool bAcked = false;
+	};
+
+	// 发送端: 链尾节点 -> 发送记录
+	TMap<const FTcsCausalityNode*, FSentChain> SentChains;
+
+	// 接收端: ChainRef -> 链尾节点
+	TMap<int32, TSharedPtr<const FTcsCausalityNode>> ReceivedChains;
+
+	// 本帧发送、包序号尚待补记的链
+	TArray<const FTcsCausalityNode*> PendingPacketIdChains;
+
+	// 最近一次更新确认状态时的帧号
+	uint64 AckStateFrameNumber = 0;
+
+	// 对端已确认的最大包序号
+	int32 AckedPacketId = INDEX_NONE;
+
+	// 连接累计丢包数
+	int32 TotalPacketsLost = 0;
+
+	// 接收端是否遇到过未知 ChainRef
+	bool bHasUnknownChainRef = false;
+};
@@ -0,0 +1,220 @@
+// Copyright Tirefly. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "TcsSourceHandle.h"
+
+
+class AActor;
+
+
+
+/**
+ * 因果链节点（不可变，引用计数）
+ *
+ * 因果链以 "尾节点 -> 父节点 -> ... -> 根节点" 的单向链表表示：
+ * 延长一条链只需新建一个指向原尾节点的节点（O(1)），前缀相同的链共享同一批节点。
+ * 节点由 FTcsSourceHandleRegistry 驻留（intern），相同的 (父节点, 资产 Id) 只会存在一个节点。
+ */
+struct TIREFLYCOMBATSYSTEM_API FTcsCausalityNode
+{
+	// 本节点对应的定义资产 Id
+	FPrimaryAssetId AssetId;
+
+	// 父节点（根节点为空）
+	TSharedPtr<const FTcsCausalityNode> Parent;
+
+	// 从根节点到本节点的链长度（根节点为 1）
+	int32 Depth = 1;
+};
+
+
+
+// 来源元数据（每个来源只在注册表中存储一份）
+struct TIREFLYCOMBATSYSTEM_API FTcsSourceHandleData
+{
+	// Source 类型标签 (可选, 用于分类和过滤)
+	FGameplayTagContainer SourceTags;
+
+	// 施加者 (实际造成效果的实体, 使用弱指针避免 GC 问题)
+	TWeakObjectPtr<AActor> Instigator;
+
+	// 因果链尾节点: 从根源到直接父级的完整链（包含父级自身，不包含当前实例），空表示根源
+	TSharedPtr<const FTcsCausalityNode> CausalityTail;
+
+	// 因果链长度
+	int32 GetCausalityDepth() const { return CausalityTail.IsValid() ? CausalityTail->Depth : 0; }
+
+	/**
+	 * 展开完整因果链（用于调试、蓝图与网络序列化，热路径请直接使用 CausalityTail）
+	 *
+	 * @param OutChain 从根源到直接父级的有序链
+	 */
+	void GetCausalityChain(TArray<FPrimaryAssetId>& OutChain) const;
+};
+
+
+
+/**
+ * 来源句柄注册表
+ *
+ * 以槽位数组存储来源元数据，对外只发放轻量的 FTcsSourceHandle（槽位 + 代数 + 来源端）。
+ * 每个本地来源带引用计数：创建者持有一个引用，属性组件为每个挂有修改器的来源持有一个引用；
+ * 引用归零时槽位回收、代数递增，旧句柄随即解析失败而不会指向新来源。
+ *
+ * 注意:
+ * - 仅在游戏线程访问
+ * - 由 UTcsAttributeManagerSubsystem 持有，生命周期跟随 GameInstance
+ * - 通过网络收到的来源以 (OriginId, 槽位) 为键存放在独立的镜像表中，与本地槽位互不冲突；镜像不参与引用计数
+ * - OriginId 按 (连接, 对端来源端编号) 分配：不同客户端的同号槽位、服务器转发的第三方来源各自独立
+ * - 连接关闭时经由该连接收到的镜像随之清理，其 OriginId 不再复用，旧句柄解析失败
+ */
+class TIREFLYCOMBATSYSTEM_API FTcsSourceHandleRegistry
+{
+public:
+	/**
+	 * 分配来源句柄（初始引用计数为 1，归调用者所有）
+	 *
+	 * @param Data 来源元数据
+	 * @return 新句柄
+	 */
+	FTcsSourceHandle Allocate(FTcsSourceHandleData&& Data);
+
+	/**
+	 * 增加来源引用（远端句柄不计数）
+	 *
+	 * @param Handle 来源句柄
+	 * @return 来源是否仍可解析
+	 */
+	bool AddRef(const FTcsSourceHandle& Handle);
+
+	/**
+	 * 释放来源引用，归零时回收槽位（远端句柄不计数）
+	 *
+	 * @param Handle 来源句柄
+	 */
+	void Release(const FTcsSourceHandle& Handle);
+
+	/**
+	 * 解析来源元数据
+	 *
+	 * @param Handle 来源句柄
+	 * @return 元数据指针；句柄无效或来源已释放时返回 nullptr（指针在下一次 Allocate/Release 前有效）
+	 */
+	const FTcsSourceHandleData* Resolve(const FTcsSourceHandle& Handle) const;
+
+	/**
+	 * 导入远端来源的元数据
+	 * 同一远端槽位收到更新代数的来源时覆盖旧记录
+	 *
+	 * @param Handle 远端句柄（OriginId 须由 FindOrAddRemoteOrigin 分配）
+	 * @param Data 来源元数据
+	 */
+	void ImportRemote(const FTcsSourceHandle& Handle, FTcsSourceHandleData&& Data);
+
+	/**
+	 * 查找或分配远端来源端
+	 *
+	 * @param ConnectionId 收到来源的连接标识（见 FTcsSourceHandleNetContext::ConnectionId）
+	 * @param SenderOriginId 对端为该来源使用的 OriginId（0 表示对端的本地来源）
+	 * @return 本地 OriginId（>= 1）
+	 */
+	int32 FindOrAddRemoteOrigin(int32 ConnectionId, int32 SenderOriginId);
+
+	/**
+	 * 查询远端来源端所在的连接
+	 *
+	 * @param OriginId 本地 OriginId
+	 * @param OutConnectionId 收到来源的连接标识
+	 * @param OutSenderOriginId 对端为该来源使用的 OriginId
+	 * @return OriginId 未分配或其连接已关闭时返回 false
+	 */
+	bool FindRemoteOrigin(int32 OriginId, int32& OutConnectionId, int32& OutSenderOriginId) const;
+
+	/**
+	 * 清理经由指定连接收到的所有远端来源（连接关闭时调用）
+	 *
+	 * @param ConnectionId 连接标识
+	 */
+	void RemoveConnection(int32 ConnectionId);
+
+	/**
+	 * 在因果链末尾追加一个节点（O(1)，结果被驻留以便共享）
+	 *
+	 * @param Parent 原因果链尾节点（空表示从根源开始）
+	 * @param AssetId 追加的定义资产 Id
+	 * @return 新的尾节点
+	 */
+	TSharedPtr<const FTcsCausalityNode> ExtendCausalityChain(
+		const TSharedPtr<const FTcsCausalityNode>& Parent,
+		const FPrimaryAssetId& AssetId);
+
+	/**
+	 * 将完整因果链驻留为节点链
+	 *
+	 * @param Chain 从根源到直接父级的有序链
+	 * @return 尾节点；空链返回空指针
+	 */
+	TSharedPtr<const FTcsCausalityNode> InternCausalityChain(const TArray<FPrimaryAssetId>& Chain);
+
+	// 清空所有来源（已发放的句柄全部失效）
+	void Reset();
+
+	// 当前存活的本地来源数量
+	int32 NumLive() const { return NumLiveEntries; }
+
+	/**
+	 * 注册表已分配的内存（字节）
+	 * 来源标签只统计显式标签数组（不含父标签缓存），因果链节点按驻留表中存活的节点估算（不含共享指针控制块）
+	 */
+	SIZE_T GetAllocatedSize() const;
+
+	/**
+	 * 生成调试字符串
+	 * @return 格式: "[SH:Id.Generation] Instigator=ActorName Chain=[...]" 或 "[SH:Id.Generation] <released>"
+	 */
+	FString ToDebugString(const FTcsSourceHandle& Handle) const;
+
+private:
+	struct FEntry
+	{
+		FTcsSourceHandleData Data;
+		int32 Generation = 0;
+		int32 RefCount = 0;
+	};
+
+	// 本地来源槽位
+	TArray<FEntry> Entries;
+
+	// 空闲槽位
+	TArray<int32> FreeIndices;
+
+	struct FRemoteOrigin
+	{
+		// 收到来源的连接标识（INDEX_NONE 表示连接已关闭）
+		int32 ConnectionId = INDEX_NONE;
+
+		// 对端为该来源使用的 OriginId
+		int32 SenderOriginId = 0;
+	};
+
+	// 远端来源端 (下标 + 1 为 OriginId)
+	TArray<FRemoteOrigin> RemoteOrigins;
+
+	// (连接标识, 对端 OriginId) -> 本地 OriginId
+	TMap<TPair<int32, int32>, int32> RemoteOriginIds;
+
+	// 远端来源镜像 ((OriginId, 槽位) -> 代数 + 元数据)
+	TMap<TPair<int32, int32>, TPair<int32, FTcsSourceHandleData>> RemoteEntries;
+
+	// 因果链节点驻留表 ((父节点, 资产 Id) -> 节点)，节点由持有它的来源引用计数，表中只保存弱引用
+	using FCausalityNodeKey = TPair<const FTcsCausalityNode*, FPrimaryAssetId>;
+	TMap<FCausalityNodeKey, TWeakPtr<const FTcsCausalityNode>> InternedCausalityNodes;
+
+	// 驻留表上次清理失效条目后的大小（用于摊销清理）
+	int32 InternedCausalityNodesAfterPurge = 0;
+
+	int32 NumLiveEntries = 0;
+};
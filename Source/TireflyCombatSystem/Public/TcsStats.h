@@ -0,0 +1,113 @@
+// Copyright Tirefly. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+
+
+// 战斗系统性能统计开关：Shipping 下全部统计与追踪代码编译为空
+#ifndef TCS_STATS_ENABLED
+	#define TCS_STATS_ENABLED !UE_BUILD_SHIPPING
+#endif
+
+
+
+#pragma region StatGroup
+
+/**
+ * 战斗系统统计组
+ * 运行时使用 "stat Tcs" 查看；Insights 中周期统计随 cpu 通道输出，计数器随 stats 通道输出。
+ * 计数器（DWORD_COUNTER）每帧清零，显示的是单帧数值。
+ */
+DECLARE_STATS_GROUP(TEXT("TireflyCombatSystem"), STATGROUP_Tcs, STATCAT_Advanced);
+
+// 属性：重算当前值（单组件同步重算）
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Attribute Recalculate Current"), STAT_TcsAttributeRecalculateCurrent, STATGROUP_Tcs, TIREFLYCOMBATSYSTEM_API);
+
+// 属性：重算基础值
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Attribute Recalculate Base"), STAT_TcsAttributeRecalculateBase, STATGROUP_Tcs, TIREFLYCOMBATSYSTEM_API);
+
+// 属性：管理器批量重算（准备、并行计算与提交）
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Attribute Recalculate Batch"), STAT_TcsAttributeRecalculateBatch, STATGROUP_Tcs, TIREFLYCOMBATSYSTEM_API);
+
+// 属性：修改器合并
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Attribute Modifier Merge"), STAT_TcsAttributeModifierMerge, STATGROUP_Tcs, TIREFLYCOMBATSYSTEM_API);
+
+// 属性：修改器执行（可能位于工作线程）
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Attribute Modifier Execute"), STAT_TcsAttributeModifierExecute, STATGROUP_Tcs, TIREFLYCOMBATSYSTEM_API);
+
+// 属性：提交重算结果（范围修正、写回与广播）
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Attribute Recalculate Commit"), STAT_TcsAttributeRecalculateCommit, STATGROUP_Tcs, TIREFLYCOMBATSYSTEM_API);
+
+// 属性：范围修正
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Attribute Clamp"), STAT_TcsAttributeClamp, STATGROUP_Tcs, TIREFLYCOMBATSYSTEM_API);
+
+// 状态：应用状态实例
+DECLARE_CYCLE_STAT_EXTERN(TEXT("State Apply"), STAT_TcsStateApply, STATGROUP_Tcs, TIREFLYCOMBATSYSTEM_API);
+
+// 状态：槽位激活刷新
+DECLARE_CYCLE_STAT_EXTERN(TEXT("State Slot Activation"), STAT_TcsStateSlotActivation, STATGROUP_Tcs, TIREFLYCOMBATSYSTEM_API);
+
+// 状态：状态合并器执行
+DECLARE_CYCLE_STAT_EXTERN(TEXT("State Merger Execute"), STAT_TcsStateMergerExecute, STATGROUP_Tcs, TIREFLYCOMBATSYSTEM_API);
+
+// 状态：StateTree Tick
+DECLARE_CYCLE_STAT_EXTERN(TEXT("State StateTree Tick"), STAT_TcsStateTreeTick, STATGROUP_Tcs, TIREFLYCOMBATSYSTEM_API);
+
+// 计数器：本帧执行的属性修改器数量
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Modifiers Executed"), STAT_TcsModifiersExecuted, STATGROUP_Tcs, TIREFLYCOMBATSYSTEM_API);
+
+// 计数器：本帧成功应用的状态数量
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("States Applied"), STAT_TcsStatesApplied, STATGROUP_Tcs, TIREFLYCOMBATSYSTEM_API);
+
+// 计数器：本帧应用失败的状态数量
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("States Rejected"), STAT_TcsStatesRejected, STATGROUP_Tcs, TIREFLYCOMBATSYSTEM_API);
+
+// 计数器：本帧实际广播的事件数量（只统计有监听者的广播）
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Events Broadcast"), STAT_TcsEventsBroadcast, STATGROUP_Tcs, TIREFLYCOMBATSYSTEM_API);
+
+#pragma endregion
+
+
+
+#pragma region TraceChannel
+
+/**
+ * 战斗系统 Insights 追踪通道
+ * 使用 "-trace=cpu,tcs" 启动（或运行时 "Trace.Enable tcs"）时，TCS 热点作用域会额外输出独立命名的 CPU 事件，
+ * 可以在未开启 stats 的构建（如 Test）中单独筛选战斗系统耗时。
+ */
+#if TCS_STATS_ENABLED
+UE_TRACE_CHANNEL_EXTERN(TcsChannel, TIREFLYCOMBATSYSTEM_API);
+#endif
+
+#pragma endregion
+
+
+
+#pragma region Macros
+
+#if TCS_STATS_ENABLED
+
+	// 周期统计作用域：同时写入 TCS 统计组与 tcs 追踪通道
+	#define TCS_SCOPE_CYCLE_COUNTER(Stat) \
+		SCOPE_CYCLE_COUNTER(Stat); \
+		TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("Tcs::" #Stat, TcsChannel)
+
+	// 计数器累加
+	#define TCS_INC_DWORD_STAT(Stat) INC_DWORD_STAT(Stat)
+	#define TCS_INC_DWORD_STAT_BY(Stat, Amount) INC_DWORD_STAT_BY(Stat, Amount)
+
+#else
+
+	#define TCS_SCOPE_CYCLE_COUNTER(Stat)
+	#define TCS_INC_DWORD_STAT(Stat)
+	#define TCS_INC_DWORD_STAT_BY(Stat, Amount)
+
+#endif
+
+#pragma endregion
@@ -28,6 +28,7 @@ public class TireflyCombatSystem : ModuleRules
 				"Core",
 				"CoreUObject",
 				"Engine",
+				"NetCore",
 				"GameplayTags",
 				"AIModule",
 				"StateTreeModule",
@@ -0,0 +1,45 @@
+// Copyright Tirefly. All Rights Reserved.
+
+
+#include "TcsBenchmarkEntity.h"
+
+
+
+void UTcsBenchmarkAttributeComponent::BenchmarkSetDeferModifierCommit(bool bEnabled)
+{
+	if (bDeferModifierCommit == bEnabled)
+	{
+		return;
+	}
+
+	// 先提交暂存中的修改器，避免切换后遗留
+	CommitDeferredModifiers();
+	bDeferModifierCommit = bEnabled;
+	if (IsRegistered())
+	{
+		RegisterComponentTickFunctions(false);
+		RegisterComponentTickFunctions(true);
+	}
+}
+
+
+
+UTcsBenchmarkStateComponent::UTcsBenchmarkStateComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	// 实体没有组件级 StateTree，避免 BeginPlay 时启动空的 StateTree
+	bStartLogicAutomatically = false;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+
+
+ATcsBenchmarkEntity::ATcsBenchmarkEntity(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = false;
+	SetCanBeDamaged(false);
+
+	AttributeComponent = CreateDefaultSubobject<UTcsBenchmarkAttributeComponent>(TEXT("AttributeComponent"));
+	StateComponent = CreateDefaultSubobject<UTcsBenchmarkStateComponent>(TEXT("StateComponent"));
+}
@@ -0,0 +1,78 @@
+// Copyright Tirefly. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "TcsEntityInterface.h"
+#include "Attribute/TcsAttributeComponent.h"
+#include "State/TcsStateComponent.h"
+#include "TcsBenchmarkEntity.generated.h"
+
+
+
+// 基准测试用属性组件：公开受保护的重算入口与延迟提交开关
+UCLASS(NotBlueprintable, HideDropdown)
+class UTcsBenchmarkAttributeComponent : public UTcsAttributeComponent
+{
+	GENERATED_BODY()
+
+public:
+	// 重算全部属性当前值（管理器开启重算批处理时只登记）
+	void BenchmarkRecalculateCurrentValues() { RecalculateAttributeCurrentValues(); }
+
+	// 切换延迟提交模式（Tick 函数只在启用时注册，已注册的组件需要重新注册）
+	void BenchmarkSetDeferModifierCommit(bool bEnabled);
+};
+
+
+
+// 基准测试用状态组件：不自动启动组件级 StateTree，公开槽位激活、持续时间与移除入口
+UCLASS(NotBlueprintable, HideDropdown)
+class UTcsBenchmarkStateComponent : public UTcsStateComponent
+{
+	GENERATED_BODY()
+
+public:
+	UTcsBenchmarkStateComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	// 刷新指定槽位的激活结果
+	void BenchmarkUpdateStateSlotActivation(FGameplayTag SlotTag) { UpdateStateSlotActivation(SlotTag); }
+
+	// 推进激活状态的持续时间
+	void BenchmarkUpdateStateDurations(float DeltaTime) { UpdateActiveStateDurations(DeltaTime); }
+
+	// 移除全部状态
+	int32 BenchmarkRemoveAllStates() { return RemoveAllStates(); }
+
+	// 按状态定义 Id 移除状态
+	int32 BenchmarkRemoveStatesByDefId(FName StateDefId, bool bRemoveAll = true) { return RemoveStatesByDefId(StateDefId, bRemoveAll); }
+};
+
+
+
+// 基准测试与无头模拟用的轻量战斗实体（Actor 不 Tick，组件默认不 Tick；无渲染与碰撞组件）
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class ATcsBenchmarkEntity : public AActor, public ITcsEntityInterface
+{
+	GENERATED_BODY()
+
+public:
+	ATcsBenchmarkEntity(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	virtual UTcsStateComponent* GetStateComponent_Implementation() const override { return StateComponent; }
+	virtual UTcsSkillComponent* GetSkillComponent_Implementation() const override { return nullptr; }
+	virtual UTcsAttributeComponent* GetAttributeComponent_Implementation() const override { return AttributeComponent; }
+	virtual FGameplayTag GetCombatEntityType_Implementation() const override { return FGameplayTag(); }
+	virtual int32 GetCombatEntityLevel_Implementation() const override { return 1; }
+
+	UTcsBenchmarkAttributeComponent* GetBenchmarkAttributeComponent() const { return AttributeComponent; }
+	UTcsBenchmarkStateComponent* GetBenchmarkStateComponent() const { return StateComponent; }
+
+protected:
+	UPROPERTY()
+	TObjectPtr<UTcsBenchmarkAttributeComponent> AttributeComponent;
+
+	UPROPERTY()
+	TObjectPtr<UTcsBenchmarkStateComponent> StateComponent;
+};
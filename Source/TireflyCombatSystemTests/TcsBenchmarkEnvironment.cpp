@@ -0,0 +1,670 @@
+// Copyright Tirefly. All Rights Reserved.
+
+
+#include "TcsBenchmarkEnvironment.h"
+
+#include "CoreGlobals.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "NativeGameplayTags.h"
+#include "TcsBenchmarkEntity.h"
+#include "TcsLogChannels.h"
+#include "Attribute/TcsAttributeDefinition.h"
+#include "Attribute/TcsAttributeManagerSubsystem.h"
+#include "Attribute/TcsAttributeModifierDefinition.h"
+#include "Attribute/AttrModExecution/TcsAttrModExec_Addition.h"
+#include "Attribute/AttrModMerger/TcsAttrModMerger_NoMerge.h"
+#include "State/TcsStateDefinition.h"
+#include "State/TcsStateManagerSubsystem.h"
+#include "State/TcsStateSlotDefinition.h"
+#include "State/StateMerger/TcsStateMerger_NoMerge.h"
+#include "State/StateMerger/TcsStateMerger_StackByInstigator.h"
+#include "State/StateMerger/TcsStateMerger_StackDirectly.h"
+#include "State/StateMerger/TcsStateMerger_UseNewest.h"
+#include "State/StateMerger/TcsStateMerger_UseOldest.h"
+#include "StateTree.h"
+#include "StateTree/TcsStateTreeSchema_StateInstance.h"
+
+#if WITH_EDITOR
+#include "StateTreeCompiler.h"
+#include "StateTreeCompilerLog.h"
+#include "StateTreeEditorData.h"
+#include "StateTreeState.h"
+#include "Tasks/StateTreeDelayTask.h"
+#endif
+
+
+
+namespace TcsBenchmarkEnvironmentPrivate
+{
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_TcsBenchmark_StateSlot, "Tcs.Test.StateSlot.Buff");
+
+	const FName StateSlotDefId(TEXT("TcsBenchmark_StateSlot"));
+	const FString NoMergeName(TEXT("NoMerge"));
+
+	// 初始属性值
+	constexpr float InitAttributeValue = 100.f;
+
+	// 伤害修改器每次扣减的数值
+	constexpr float DamageMagnitude = -1.f;
+
+	// StateTree 驱动状态的延时任务时长（秒），完成后回到根状态重新开始
+	constexpr float StateTreeDelayDuration = 0.5f;
+
+#if WITH_EDITOR
+	// 编译一个循环执行延时任务的 StateTree：根状态运行延时任务，完成后转换回根状态
+	UStateTree* CompileLoopingDelayStateTree(FString& OutError)
+	{
+		UStateTree* StateTree = NewObject<UStateTree>(GetTransientPackage(), TEXT("TcsBenchmark_StateTree"), RF_Transient);
+		UStateTreeEditorData* EditorData = NewObject<UStateTreeEditorData>(StateTree, NAME_None, RF_Transient);
+		StateTree->EditorData = EditorData;
+		EditorData->Schema = NewObject<UTcsStateTreeSchema_StateInstance>(EditorData, NAME_None, RF_Transient);
+
+		UStateTreeState& Root = EditorData->AddSubTree(TEXT("Root"));
+		TStateTreeEditorNode<FStateTreeDelayTask>& DelayTask = Root.AddTask<FStateTreeDelayTask>();
+		DelayTask.GetInstanceData().Duration = StateTreeDelayDuration;
+		Root.AddTransition(EStateTreeTransitionTrigger::OnStateCompleted, EStateTreeTransitionType::GotoState, &Root);
+
+		FStateTreeCompilerLog Log;
+		FStateTreeCompiler Compiler(Log);
+		if (!Compiler.Compile(*StateTree))
+		{
+			OutError = TEXT("Failed to compile benchmark StateTree");
+			return nullptr;
+		}
+		return StateTree;
+	}
+#endif
+
+	double Median(const TArray<double>& SortedSamples)
+	{
+		const int32 Num = SortedSamples.Num();
+		if (Num == 0)
+		{
+			return 0.0;
+		}
+
+		return Num % 2 == 1
+			? SortedSamples[Num / 2]
+			: (SortedSamples[Num / 2 - 1] + SortedSamples[Num / 2]) * 0.5;
+	}
+}
+
+
+
+FTcsBenchmarkEnvironment::FTcsBenchmarkEnvironment()
+{
+}
+
+FTcsBenchmarkEnvironment::~FTcsBenchmarkEnvironment()
+{
+	Shutdown();
+}
+
+bool FTcsBenchmarkEnvironment::Initialize(FString& OutError)
+{
+	check(IsInGameThread());
+
+	if (World)
+	{
+		return true;
+	}
+
+	if (!GEngine)
+	{
+		OutError = TEXT("GEngine is not available");
+		return false;
+	}
+
+	if (!GetStateSlotTag().IsValid())
+	{
+		OutError = TEXT("Benchmark state slot tag is not registered");
+		return false;
+	}
+
+	// 独立的 GameInstance 与 Game 世界：初始化管理器子系统，不创建视口与本地玩家
+	GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->InitializeStandalone();
+	World = GameInstance->GetWorld();
+	if (!World)
+	{
+		OutError = TEXT("Failed to create standalone world");
+		Shutdown();
+		return false;
+	}
+
+	World->InitializeActorsForPlay(FURL());
+	if (AWorldSettings* WorldSettings = World->GetWorldSettings())
+	{
+		// 标记世界已开始游戏，之后生成的实体直接执行 BeginPlay
+		WorldSettings->NotifyBeginPlay();
+	}
+
+	if (!GetAttributeManager() || !GetStateManager())
+	{
+		OutError = TEXT("TCS manager subsystems are not available");
+		Shutdown();
+		return false;
+	}
+
+	RegisterDefinitions();
+	return true;
+}
+
+void FTcsBenchmarkEnvironment::Shutdown()
+{
+	DestroyEntities();
+
+	if (GameInstance)
+	{
+		GameInstance->Shutdown();
+	}
+
+	if (World)
+	{
+		if (GEngine)
+		{
+			GEngine->DestroyWorldContext(World);
+		}
+		World->DestroyWorld(false);
+	}
+
+	GameInstance = nullptr;
+	World = nullptr;
+	Definitions.Reset();
+	StateDefinitions.Reset();
+	StateTreeStateDefId = NAME_None;
+}
+
+int32 FTcsBenchmarkEnvironment::SpawnEntities(int32 NumEntities, const FTcsBenchmarkSpawnOptions& Options)
+{
+	using namespace TcsBenchmarkEnvironmentPrivate;
+
+	if (!World)
+	{
+		return 0;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.ObjectFlags |= RF_Transient;
+
+	Entities.Reserve(Entities.Num() + NumEntities);
+	int32 NumSpawned = 0;
+	for (; NumSpawned < NumEntities; ++NumSpawned)
+	{
+		ATcsBenchmarkEntity* Entity = World->SpawnActor<ATcsBenchmarkEntity>(SpawnParams);
+		if (!Entity)
+		{
+			break;
+		}
+
+		UTcsBenchmarkAttributeComponent* AttributeComponent = Entity->GetBenchmarkAttributeComponent();
+		for (int32 Index = 0; Index < NumAttributes; ++Index)
+		{
+			AttributeComponent->AddAttribute(GetAttributeName(Index), InitAttributeValue);
+		}
+
+		if (Options.bTickComponents)
+		{
+			// 属性组件只在有暂存修改器时自行开启 Tick
+			AttributeComponent->BenchmarkSetDeferModifierCommit(Options.bDeferModifierCommit);
+			Entity->GetBenchmarkStateComponent()->SetComponentTickEnabled(true);
+		}
+
+		Entities.Add(Entity);
+	}
+
+	return NumSpawned;
+}
+
+void FTcsBenchmarkEnvironment::TickWorld(float DeltaTime)
+{
+	check(IsInGameThread());
+
+	if (!World)
+	{
+		return;
+	}
+
+	// 引擎主循环之外没有人推进帧号：属性快照、来源句柄网络缓存等按 GFrameCounter 判断是否为新的一帧
+	++GFrameCounter;
+	World->Tick(LEVELTICK_All, DeltaTime);
+}
+
+void FTcsBenchmarkEnvironment::DestroyEntities()
+{
+	for (ATcsBenchmarkEntity* Entity : Entities)
+	{
+		if (IsValid(Entity))
+		{
+			Entity->Destroy();
+		}
+	}
+	Entities.Reset();
+}
+
+UTcsAttributeManagerSubsystem* FTcsBenchmarkEnvironment::GetAttributeManager() const
+{
+	return GameInstance ? GameInstance->GetSubsystem<UTcsAttributeManagerSubsystem>() : nullptr;
+}
+
+UTcsStateManagerSubsystem* FTcsBenchmarkEnvironment::GetStateManager() const
+{
+	return GameInstance ? GameInstance->GetSubsystem<UTcsStateManagerSubsystem>() : nullptr;
+}
+
+FName FTcsBenchmarkEnvironment::GetAttributeName(int32 Index)
+{
+	return FName(TEXT("TcsBenchmark_Attribute"), Index + 1);
+}
+
+FName FTcsBenchmarkEnvironment::GetModifierId(int32 Index)
+{
+	return FName(TEXT("TcsBenchmark_Modifier"), Index + 1);
+}
+
+FName FTcsBenchmarkEnvironment::GetDamageModifierId()
+{
+	return FName(TEXT("TcsBenchmark_Damage"));
+}
+
+FGameplayTag FTcsBenchmarkEnvironment::GetStateSlotTag()
+{
+	return TcsBenchmarkEnvironmentPrivate::TAG_TcsBenchmark_StateSlot;
+}
+
+FName FTcsBenchmarkEnvironment::GetNoMergeStateDefId() const
+{
+	for (const FTcsBenchmarkStateDefinition& StateDefinition : StateDefinitions)
+	{
+		if (StateDefinition.MergerName == TcsBenchmarkEnvironmentPrivate::NoMergeName)
+		{
+			return StateDefinition.StateDefId;
+		}
+	}
+	return NAME_None;
+}
+
+void FTcsBenchmarkEnvironment::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(GameInstance);
+	Collector.AddReferencedObject(World);
+	Collector.AddReferencedObjects(Entities);
+	Collector.AddReferencedObjects(Definitions);
+}
+
+void FTcsBenchmarkEnvironment::RegisterDefinitions()
+{
+	using namespace TcsBenchmarkEnvironmentPrivate;
+
+	UTcsAttributeManagerSubsystem* AttrMgr = GetAttributeManager();
+	UTcsStateManagerSubsystem* StateMgr = GetStateManager();
+
+	for (int32 Index = 0; Index < NumAttributes; ++Index)
+	{
+		UTcsAttributeDefinition* AttributeDef = NewObject<UTcsAttributeDefinition>(GetTransientPackage());
+		AttributeDef->AttributeDefId = GetAttributeName(Index);
+		Definitions.Add(AttributeDef);
+		AttrMgr->RegisterTransientAttributeDefinition(AttributeDef);
+
+		UTcsAttributeModifierDefinition* ModifierDef = NewObject<UTcsAttributeModifierDefinition>(GetTransientPackage());
+		ModifierDef->AttributeModifierDefId = GetModifierId(Index);
+		ModifierDef->ModifierName = ModifierDef->AttributeModifierDefId;
+		ModifierDef->AttributeName = AttributeDef->AttributeDefId;
+		ModifierDef->ModifierMode = ETcsAttributeModifierMode::AMM_CurrentValue;
+		ModifierDef->Operands.Add(TEXT("Magnitude"), 1.f);
+		ModifierDef->ModifierType = UTcsAttrModExec_Addition::StaticClass();
+		ModifierDef->MergerType = UTcsAttrModMerger_NoMerge::StaticClass();
+		Definitions.Add(ModifierDef);
+		AttrMgr->RegisterTransientModifierDefinition(ModifierDef);
+	}
+
+	UTcsAttributeModifierDefinition* DamageDef = NewObject<UTcsAttributeModifierDefinition>(GetTransientPackage());
+	DamageDef->AttributeModifierDefId = GetDamageModifierId();
+	DamageDef->ModifierName = DamageDef->AttributeModifierDefId;
+	DamageDef->AttributeName = GetAttributeName(0);
+	DamageDef->ModifierMode = ETcsAttributeModifierMode::AMM_BaseValue;
+	DamageDef->Operands.Add(TEXT("Magnitude"), DamageMagnitude);
+	DamageDef->ModifierType = UTcsAttrModExec_Addition::StaticClass();
+	DamageDef->MergerType = UTcsAttrModMerger_NoMerge::StaticClass();
+	Definitions.Add(DamageDef);
+	AttrMgr->RegisterTransientModifierDefinition(DamageDef);
+
+	// 所有状态位于同一个全部激活的槽位，槽内实例数即为激活实例数
+	UTcsStateSlotDefinition* SlotDef = NewObject<UTcsStateSlotDefinition>(GetTransientPackage());
+	SlotDef->StateSlotDefId = StateSlotDefId;
+	SlotDef->SlotTag = GetStateSlotTag();
+	SlotDef->ActivationMode = ETcsStateSlotActivationMode::SSAM_AllActive;
+	Definitions.Add(SlotDef);
+	StateMgr->RegisterTransientStateSlotDefinition(SlotDef);
+
+	AddStateDefinition(NoMergeName, UTcsStateMerger_NoMerge::StaticClass());
+	AddStateDefinition(TEXT("StackDirectly"), UTcsStateMerger_StackDirectly::StaticClass());
+	AddStateDefinition(TEXT("StackByInstigator"), UTcsStateMerger_StackByInstigator::StaticClass());
+	AddStateDefinition(TEXT("UseNewest"), UTcsStateMerger_UseNewest::StaticClass());
+	AddStateDefinition(TEXT("UseOldest"), UTcsStateMerger_UseOldest::StaticClass());
+
+	// 不加入 StateDefinitions：按合并器划分的基准不包含 StateTree 开销
+	AddStateTreeStateDefinition();
+}
+
+void FTcsBenchmarkEnvironment::AddStateDefinition(const FString& MergerName, TSubclassOf<UTcsStateMerger> MergerType)
+{
+	UTcsStateDefinition* StateDef = NewStateDefinition(MergerName, MergerType);
+	StateDef->CompileParameterSchema();
+	GetStateManager()->RegisterTransientStateDefinition(StateDef);
+
+	StateDefinitions.Add({ MergerName, StateDef->StateDefId });
+}
+
+void FTcsBenchmarkEnvironment::AddStateTreeStateDefinition()
+{
+	using namespace TcsBenchmarkEnvironmentPrivate;
+
+#if WITH_EDITOR
+	FString Error;
+	UStateTree* StateTree = CompileLoopingDelayStateTree(Error);
+	if (!StateTree)
+	{
+		UE_LOG(LogTcs, Warning, TEXT("[%s] %s, StateTree-driven benchmark state is unavailable."),
+			*FString(__FUNCTION__),
+			*Error);
+		return;
+	}
+	Definitions.Add(StateTree);
+
+	UTcsStateDefinition* StateDef = NewStateDefinition(TEXT("StateTree"), UTcsStateMerger_UseNewest::StaticClass());
+	StateDef->StateTreeRef.SetStateTree(StateTree);
+	StateDef->bSkipStateTree = false;
+	StateDef->CompileParameterSchema();
+	GetStateManager()->RegisterTransientStateDefinition(StateDef);
+
+	StateTreeStateDefId = StateDef->StateDefId;
+#endif
+}
+
+UTcsStateDefinition* FTcsBenchmarkEnvironment::NewStateDefinition(const FString& Name, TSubclassOf<UTcsStateMerger> MergerType)
+{
+	UTcsStateDefinition* StateDef = NewObject<UTcsStateDefinition>(GetTransientPackage());
+	StateDef->StateDefId = FName(*FString::Printf(TEXT("TcsBenchmark_State_%s"), *Name));
+	StateDef->StateSlotType = GetStateSlotTag();
+	StateDef->DurationType = SDT_Duration;
+	StateDef->Duration = StateDuration;
+	StateDef->MaxStackCount = 8;
+	StateDef->MergerType = MergerType;
+	StateDef->bSkipStateTree = true;
+	Definitions.Add(StateDef);
+	return StateDef;
+}
+
+
+
+FTcsBenchmarkSettings FTcsBenchmarkSettings::FromCommandLine()
+{
+	FTcsBenchmarkSettings Settings;
+	const TCHAR* CommandLine = FCommandLine::Get();
+
+	FString EntityCountsString;
+	if (FParse::Value(CommandLine, TEXT("TcsBenchEntities="), EntityCountsString, false))
+	{
+		TArray<FString> Tokens;
+		EntityCountsString.ParseIntoArray(Tokens, TEXT(","));
+		for (const FString& Token : Tokens)
+		{
+			const int32 Count = FCString::Atoi(*Token);
+			if (Count > 0)
+			{
+				Settings.EntityCounts.Add(Count);
+			}
+		}
+	}
+	if (Settings.EntityCounts.IsEmpty())
+	{
+		Settings.EntityCounts = { 100, 1000, 5000 };
+	}
+
+	FParse::Value(CommandLine, TEXT("TcsBenchIterations="), Settings.NumIterations);
+	FParse::Value(CommandLine, TEXT("TcsBenchWarmup="), Settings.NumWarmupIterations);
+	FParse::Value(CommandLine, TEXT("TcsBenchTolerance="), Settings.Tolerance);
+	Settings.NumIterations = FMath::Max(Settings.NumIterations, 1);
+	Settings.NumWarmupIterations = FMath::Max(Settings.NumWarmupIterations, 0);
+	Settings.Tolerance = FMath::Max(Settings.Tolerance, 1.0);
+
+	if (!FParse::Value(CommandLine, TEXT("TcsBenchBaselines="), Settings.BaselinePath))
+	{
+		if (const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("TireflyCombatSystem")))
+		{
+			Settings.BaselinePath = FPaths::Combine(Plugin->GetBaseDir(), TEXT("Config"), TEXT("TcsBenchmarkBaselines.csv"));
+		}
+	}
+
+	Settings.bRequireBaselines = FParse::Param(CommandLine, TEXT("TcsBenchRequireBaselines"));
+
+	if (!FParse::Value(CommandLine, TEXT("TcsBenchOutput="), Settings.OutputDir))
+	{
+		Settings.OutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Automation"), TEXT("TcsBenchmarks"));
+	}
+
+	return Settings;
+}
+
+
+
+FTcsBenchmarkResult RunTcsBenchmark(
+	const FString& Name,
+	int32 NumEntities,
+	const FTcsBenchmarkSettings& Settings,
+	TFunctionRef<void()> Setup,
+	TFunctionRef<void()> Measure,
+	TFunctionRef<void()> Teardown)
+{
+	using namespace TcsBenchmarkEnvironmentPrivate;
+
+	for (int32 Iteration = 0; Iteration < Settings.NumWarmupIterations; ++Iteration)
+	{
+		Setup();
+		Measure();
+		Teardown();
+	}
+
+	TArray<double> SamplesUs;
+	SamplesUs.Reserve(Settings.NumIterations);
+	for (int32 Iteration = 0; Iteration < Settings.NumIterations; ++Iteration)
+	{
+		Setup();
+
+		const double StartTime = FPlatformTime::Seconds();
+		Measure();
+		SamplesUs.Add((FPlatformTime::Seconds() - StartTime) * 1000000.0);
+
+		Teardown();
+	}
+	SamplesUs.Sort();
+
+	FTcsBenchmarkResult Result;
+	Result.Name = Name;
+	Result.NumEntities = NumEntities;
+	Result.NumIterations = SamplesUs.Num();
+	Result.MedianUs = Median(SamplesUs);
+	Result.P99Us = ComputeTcsBenchmarkPercentile(SamplesUs, 0.99);
+	return Result;
+}
+
+
+
+double ComputeTcsBenchmarkPercentile(const TArray<double>& SortedSamples, double Fraction)
+{
+	if (SortedSamples.IsEmpty())
+	{
+		return 0.0;
+	}
+
+	// 最近秩法
+	const int32 Rank = FMath::CeilToInt32(Fraction * SortedSamples.Num());
+	return SortedSamples[FMath::Clamp(Rank - 1, 0, SortedSamples.Num() - 1)];
+}
+
+
+
+FTcsBenchmarkReport::FTcsBenchmarkReport(FString InSuiteName, const FTcsBenchmarkSettings& InSettings)
+	: SuiteName(MoveTemp(InSuiteName))
+	, Settings(InSettings)
+{
+}
+
+bool FTcsBenchmarkReport::Finish(FAutomationTestBase& Test) const
+{
+	TMap<FString, FBaseline> Baselines;
+	LoadBaselines(Baselines);
+
+	// 基线文件为空时回归检查不生效，在结果中明确说明，避免误以为基准已通过回归判定
+	if (Baselines.IsEmpty() && !Settings.bRequireBaselines)
+	{
+		Test.AddInfo(FString::Printf(TEXT("No baselines in %s, regression check is inactive for %s"),
+			*Settings.BaselinePath, *SuiteName));
+	}
+
+	bool bPassed = true;
+	FString Csv = TEXT("Benchmark,Entities,Iterations,MedianUs,P99Us,BaselineMedianUs,BaselineP99Us,Status\n");
+	for (const FTcsBenchmarkResult& Result : Results)
+	{
+		const FBaseline* Baseline = Baselines.Find(MakeBaselineKey(Result.Name, Result.NumEntities));
+		const TCHAR* Status = TEXT("NoBaseline");
+		if (!Baseline && Settings.bRequireBaselines)
+		{
+			bPassed = false;
+			Status = TEXT("MissingBaseline");
+			Test.AddError(FString::Printf(TEXT("%s x%d has no baseline in %s (-TcsBenchRequireBaselines)"),
+				*Result.Name, Result.NumEntities, *Settings.BaselinePath));
+		}
+		else if (Baseline)
+		{
+			const bool bMedianRegressed = Baseline->MedianUs > 0.0 && Result.MedianUs > Baseline->MedianUs * Settings.Tolerance;
+			const bool bP99Regressed = Baseline->P99Us > 0.0 && Result.P99Us > Baseline->P99Us * Settings.Tolerance;
+			Status = bMedianRegressed || bP99Regressed ? TEXT("Regressed") : TEXT("Passed");
+			if (bMedianRegressed || bP99Regressed)
+			{
+				bPassed = false;
+				Test.AddError(FString::Printf(
+					TEXT("%s x%d regressed: median %.2fus (baseline %.2fus), p99 %.2fus (baseline %.2fus), tolerance x%.2f"),
+					*Result.Name, Result.NumEntities,
+					Result.MedianUs, Baseline->MedianUs,
+					Result.P99Us, Baseline->P99Us,
+					Settings.Tolerance));
+			}
+		}
+
+		Test.AddInfo(FString::Printf(TEXT("%s x%d: median %.2fus, p99 %.2fus (%d iterations, %s)"),
+			*Result.Name, Result.NumEntities, Result.MedianUs, Result.P99Us, Result.NumIterations, Status));
+
+		Csv += FString::Printf(TEXT("%s,%d,%d,%.3f,%.3f,%s,%s,%s\n"),
+			*Result.Name, Result.NumEntities, Result.NumIterations, Result.MedianUs, Result.P99Us,
+			Baseline ? *FString::Printf(TEXT("%.3f"), Baseline->MedianUs) : TEXT(""),
+			Baseline ? *FString::Printf(TEXT("%.3f"), Baseline->P99Us) : TEXT(""),
+			Status);
+	}
+
+	const FString OutputPath = FPaths::Combine(Settings.OutputDir, SuiteName + TEXT(".csv"));
+	if (FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		Test.AddInfo(FString::Printf(TEXT("Benchmark results written to %s"), *FPaths::ConvertRelativePathToFull(OutputPath)));
+	}
+	else
+	{
+		Test.AddWarning(FString::Printf(TEXT("Failed to write benchmark results to %s"), *OutputPath));
+	}
+
+	return bPassed;
+}
+
+void FTcsBenchmarkReport::LoadBaselines(TMap<FString, FBaseline>& OutBaselines) const
+{
+	TArray<FString> Lines;
+	if (Settings.BaselinePath.IsEmpty() || !FFileHelper::LoadFileToStringArray(Lines, *Settings.BaselinePath))
+	{
+		return;
+	}
+
+	// 按表头定位列；允许多份结果文件直接拼接（重复的表头行会被重新解析）
+	int32 NameColumn = INDEX_NONE;
+	int32 EntitiesColumn = INDEX_NONE;
+	int32 MedianColumn = INDEX_NONE;
+	int32 P99Column = INDEX_NONE;
+	for (const FString& Line : Lines)
+	{
+		if (Line.IsEmpty() || Line.StartsWith(TEXT("#")))
+		{
+			continue;
+		}
+
+		TArray<FString> Columns;
+		Line.ParseIntoArray(Columns, TEXT(","), false);
+		if (Columns.IsValidIndex(0) && Columns[0] == TEXT("Benchmark"))
+		{
+			NameColumn = 0;
+			EntitiesColumn = Columns.IndexOfByKey(TEXT("Entities"));
+			MedianColumn = Columns.IndexOfByKey(TEXT("MedianUs"));
+			P99Column = Columns.IndexOfByKey(TEXT("P99Us"));
+			continue;
+		}
+
+		if (NameColumn == INDEX_NONE || !Columns.IsValidIndex(EntitiesColumn)
+			|| !Columns.IsValidIndex(MedianColumn) || !Columns.IsValidIndex(P99Column))
+		{
+			continue;
+		}
+
+		FBaseline& Baseline = OutBaselines.Add(MakeBaselineKey(Columns[NameColumn], FCString::Atoi(*Columns[EntitiesColumn])));
+		Baseline.MedianUs = FCString::Atod(*Columns[MedianColumn]);
+		Baseline.P99Us = FCString::Atod(*Columns[P99Column]);
+	}
+}
+
+FString FTcsBenchmarkReport::MakeBaselineKey(const FString& Name, int32 NumEntities)
+{
+	return FString::Printf(TEXT("%s|%d"), *Name, NumEntities);
+}
+
+
+
+FTcsScopedBenchmarkLogSuppression::FTcsScopedBenchmarkLogSuppression()
+{
+	FLogCategoryBase* Categories[] =
+	{
+		&LogTcs,
+		&LogTcsAttribute,
+		&LogTcsAttrModExec,
+		&LogTcsAttrModMerger,
+		&LogTcsState,
+		&LogTcsStateMerger,
+		&LogTcsStateCondition,
+		&LogTcsSkill,
+		&LogTcsStateTree,
+	};
+
+	for (FLogCategoryBase* Category : Categories)
+	{
+		const ELogVerbosity::Type Verbosity = Category->GetVerbosity();
+		if (Verbosity > ELogVerbosity::Warning)
+		{
+			SavedVerbosities.Emplace(Category, Verbosity);
+			Category->SetVerbosity(ELogVerbosity::Warning);
+		}
+	}
+}
+
+FTcsScopedBenchmarkLogSuppression::~FTcsScopedBenchmarkLogSuppression()
+{
+	for (const TPair<FLogCategoryBase*, ELogVerbosity::Type>& Saved : SavedVerbosities)
+	{
+		Saved.Key->SetVerbosity(Saved.Value);
+	}
+}
@@ -0,0 +1,252 @@
+// Copyright Tirefly. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "UObject/GCObject.h"
+
+
+class ATcsBenchmarkEntity;
+class UGameInstance;
+class UWorld;
+class UTcsAttributeManagerSubsystem;
+class UTcsStateManagerSubsystem;
+class UTcsStateDefinition;
+class UTcsStateMerger;
+class FAutomationTestBase;
+
+
+
+// 合成状态定义（每种状态合并器一个，全部位于基准状态槽）
+struct FTcsBenchmarkStateDefinition
+{
+	// 合并器名称（用于结果命名）
+	FString MergerName;
+
+	// 状态定义 Id
+	FName StateDefId;
+};
+
+
+
+// 实体生成选项
+struct FTcsBenchmarkSpawnOptions
+{
+	// 组件随世界 Tick（状态组件推进持续时间与 StateTree）；为 false 时由基准直接驱动组件入口
+	bool bTickComponents = false;
+
+	// 属性组件启用延迟提交，修改器在属性组件 Tick 中合并提交
+	bool bDeferModifierCommit = false;
+};
+
+
+
+/**
+ * 无头基准测试环境
+ *
+ * 创建独立的 GameInstance 与 Game 世界（不需要视口与 GPU），向属性/状态管理器注册合成定义，
+ * 并按需生成 ATcsBenchmarkEntity。基准直接驱动组件入口；无头模拟通过 TickWorld 按固定步长推进整个世界。
+ */
+class FTcsBenchmarkEnvironment : public FGCObject
+{
+public:
+	// 合成属性数量（每个属性对应一个加法修改器定义）
+	static constexpr int32 NumAttributes = 8;
+
+	// 合成状态的持续时间（秒），足够长以保证基准期间不会过期
+	static constexpr float StateDuration = 3600.f;
+
+	FTcsBenchmarkEnvironment();
+	virtual ~FTcsBenchmarkEnvironment() override;
+
+	/**
+	 * 创建世界并注册合成定义（游戏线程）
+	 *
+	 * @param OutError 失败原因
+	 * @return 是否成功
+	 */
+	bool Initialize(FString& OutError);
+
+	// 销毁实体与世界（析构时自动调用）
+	void Shutdown();
+
+	/**
+	 * 生成实体并为其添加全部合成属性
+	 *
+	 * @param NumEntities 生成数量
+	 * @param Options 生成选项
+	 * @return 实际生成的数量
+	 */
+	int32 SpawnEntities(int32 NumEntities, const FTcsBenchmarkSpawnOptions& Options = FTcsBenchmarkSpawnOptions());
+
+	/**
+	 * 以 LEVELTICK_All 推进世界一帧（游戏线程）
+	 * 同时推进 GFrameCounter，使按帧去重的逻辑与引擎主循环下的行为一致
+	 */
+	void TickWorld(float DeltaTime);
+
+	// 销毁全部实体
+	void DestroyEntities();
+
+	UWorld* GetWorld() const { return World; }
+	UTcsAttributeManagerSubsystem* GetAttributeManager() const;
+	UTcsStateManagerSubsystem* GetStateManager() const;
+	const TArray<TObjectPtr<ATcsBenchmarkEntity>>& GetEntities() const { return Entities; }
+
+	// 合成属性名 / 修改器 Id（Index ∈ [0, NumAttributes)）
+	static FName GetAttributeName(int32 Index);
+	static FName GetModifierId(int32 Index);
+
+	// 伤害修改器 Id（直接扣减第一个合成属性的 Base 值，不常驻）
+	static FName GetDamageModifierId();
+
+	// 合成状态所在槽位
+	static FGameplayTag GetStateSlotTag();
+
+	// 合成状态定义（每种状态合并器一个）
+	const TArray<FTcsBenchmarkStateDefinition>& GetStateDefinitions() const { return StateDefinitions; }
+
+	// 不合并的合成状态（用于在槽位中堆积多个实例）
+	FName GetNoMergeStateDefId() const;
+
+	// 由 StateTree 驱动的合成状态（循环执行延时任务）；StateTree 需要编辑器编译，非编辑器构建下为 NAME_None
+	FName GetStateTreeStateDefId() const { return StateTreeStateDefId; }
+
+	//~ FGCObject
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override { return TEXT("FTcsBenchmarkEnvironment"); }
+
+protected:
+	void RegisterDefinitions();
+
+	void AddStateDefinition(const FString& MergerName, TSubclassOf<UTcsStateMerger> MergerType);
+
+	void AddStateTreeStateDefinition();
+
+	// 创建跳过 StateTree 的合成状态定义（未编译、未注册）
+	UTcsStateDefinition* NewStateDefinition(const FString& Name, TSubclassOf<UTcsStateMerger> MergerType);
+
+	TObjectPtr<UGameInstance> GameInstance;
+	TObjectPtr<UWorld> World;
+	TArray<TObjectPtr<ATcsBenchmarkEntity>> Entities;
+
+	// 合成定义（管理器的定义缓存不持有 GC 引用，由环境保持存活）
+	TArray<TObjectPtr<UObject>> Definitions;
+	TArray<FTcsBenchmarkStateDefinition> StateDefinitions;
+	FName StateTreeStateDefId;
+};
+
+
+
+// 单项基准结果（耗时为整批实体执行一次的耗时）
+struct FTcsBenchmarkResult
+{
+	FString Name;
+	int32 NumEntities = 0;
+	int32 NumIterations = 0;
+	double MedianUs = 0.0;
+	double P99Us = 0.0;
+};
+
+
+
+// 基准运行参数（可通过命令行覆盖）
+struct FTcsBenchmarkSettings
+{
+	// 实体规模：-TcsBenchEntities=100,1000,5000
+	TArray<int32> EntityCounts;
+
+	// 每个规模的计时次数：-TcsBenchIterations=32
+	int32 NumIterations = 32;
+
+	// 不计时的预热次数：-TcsBenchWarmup=3
+	int32 NumWarmupIterations = 3;
+
+	// 超过基线的容忍倍数，中位数与 p99 均按此判定回归：-TcsBenchTolerance=1.5
+	double Tolerance = 1.5;
+
+	// 基线文件：-TcsBenchBaselines=<Path>，默认为插件 Config/TcsBenchmarkBaselines.csv
+	FString BaselinePath;
+
+	// 缺少基线条目的结果按失败处理（CI 使用）：-TcsBenchRequireBaselines
+	bool bRequireBaselines = false;
+
+	// 结果输出目录：-TcsBenchOutput=<Dir>，默认为 Saved/Automation/TcsBenchmarks
+	FString OutputDir;
+
+	static FTcsBenchmarkSettings FromCommandLine();
+};
+
+
+
+/**
+ * 运行一项基准
+ * 每次迭代依次执行 Setup（不计时）、Measure（计时）、Teardown（不计时），
+ * 先执行预热迭代，再对计时迭代求中位数与 p99。
+ */
+FTcsBenchmarkResult RunTcsBenchmark(
+	const FString& Name,
+	int32 NumEntities,
+	const FTcsBenchmarkSettings& Settings,
+	TFunctionRef<void()> Setup,
+	TFunctionRef<void()> Measure,
+	TFunctionRef<void()> Teardown);
+
+
+
+// 对已排序样本求百分位（最近秩法，Fraction ∈ [0, 1]）
+double ComputeTcsBenchmarkPercentile(const TArray<double>& SortedSamples, double Fraction);
+
+
+
+/**
+ * 基准结果报告
+ *
+ * 结果写出为 CSV（列：Benchmark,Entities,Iterations,MedianUs,P99Us,BaselineMedianUs,BaselineP99Us,Status），
+ * 基线文件使用同样的格式（只读取 Benchmark、Entities、MedianUs、P99Us 列），
+ * 因此可以直接用一次正常运行的结果文件作为新的基线。
+ */
+class FTcsBenchmarkReport
+{
+public:
+	FTcsBenchmarkReport(FString InSuiteName, const FTcsBenchmarkSettings& InSettings);
+
+	void Add(const FTcsBenchmarkResult& Result) { Results.Add(Result); }
+
+	/**
+	 * 与基线比较并写出 CSV；超出容忍倍数的结果作为错误报告给测试
+	 *
+	 * @param Test 当前自动化测试
+	 * @return 没有回归返回 true
+	 */
+	bool Finish(FAutomationTestBase& Test) const;
+
+private:
+	struct FBaseline
+	{
+		double MedianUs = 0.0;
+		double P99Us = 0.0;
+	};
+
+	void LoadBaselines(TMap<FString, FBaseline>& OutBaselines) const;
+
+	static FString MakeBaselineKey(const FString& Name, int32 NumEntities);
+
+	FString SuiteName;
+	FTcsBenchmarkSettings Settings;
+	TArray<FTcsBenchmarkResult> Results;
+};
+
+
+
+// 在作用域内降低 TCS 日志频道的输出级别（逐条 Log 级日志会淹没计时结果）
+class FTcsScopedBenchmarkLogSuppression : public FNoncopyable
+{
+public:
+	FTcsScopedBenchmarkLogSuppression();
+	~FTcsScopedBenchmarkLogSuppression();
+
+private:
+	TArray<TPair<FLogCategoryBase*, ELogVerbosity::Type>> SavedVerbosities;
+};
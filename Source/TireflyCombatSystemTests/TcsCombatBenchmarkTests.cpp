@@ -0,0 +1,347 @@
+// Copyright Tirefly. All Rights Reserved.
+
+
+#include "Misc/AutomationTest.h"
+#include "TcsBenchmarkEntity.h"
+#include "TcsBenchmarkEnvironment.h"
+#include "TcsSourceHandle.h"
+#include "Attribute/TcsAttributeManagerSubsystem.h"
+
+
+
+/**
+ * TCS 性能基准（PerfFilter，需要显式运行）
+ *
+ * 无头运行示例：
+ *   UnrealEditor-Cmd <Project>.uproject -ExecCmds="Automation RunTests TireflyCombatSystem.Benchmark;Quit"
+ *     -nullrhi -unattended -nosplash -TcsBenchEntities=100,1000,5000
+ *
+ * 每项基准在各实体规模下重复计时（整批实体执行一次为一个样本），结果写出到
+ * Saved/Automation/TcsBenchmarks/<Suite>.csv，并与插件 Config/TcsBenchmarkBaselines.csv 中的基线比较。
+ * 其他参数见 FTcsBenchmarkSettings。
+ *
+ * 注意：基线与构建机相关，目前提交的基线文件只有表头，回归检查对所有基准都不生效（结果状态为 NoBaseline）。
+ * 在构建机上采集并提交基线之前，CI 只运行基准并归档结果，不要加 -TcsBenchRequireBaselines（否则全部判为失败）；
+ * 基线提交后再加上该参数，缺少基线条目的结果判为失败，保证新增基准与基线一起提交。
+ */
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace TcsCombatBenchmarkTests
+{
+	// 每个实体上常驻的修改器数量（重算基准）
+	constexpr int32 NumResidentModifiers = 16;
+
+	// 每个实体槽位中堆积的状态实例数量（槽位激活与持续时间基准）
+	constexpr int32 NumResidentStates = 8;
+
+	// 持续时间基准的帧间隔
+	constexpr float FrameDeltaTime = 1.f / 60.f;
+
+	TArray<FName> MakeAllModifierIds()
+	{
+		TArray<FName> ModifierIds;
+		for (int32 Index = 0; Index < FTcsBenchmarkEnvironment::NumAttributes; ++Index)
+		{
+			ModifierIds.Add(FTcsBenchmarkEnvironment::GetModifierId(Index));
+		}
+		return ModifierIds;
+	}
+
+	// 每个实体一个来源句柄（由基准持有引用）
+	struct FEntitySources
+	{
+		TArray<FTcsSourceHandle> Handles;
+
+		void Create(FTcsBenchmarkEnvironment& Env)
+		{
+			UTcsAttributeManagerSubsystem* AttrMgr = Env.GetAttributeManager();
+			Handles.Reset(Env.GetEntities().Num());
+			for (ATcsBenchmarkEntity* Entity : Env.GetEntities())
+			{
+				Handles.Add(AttrMgr->CreateSourceHandle(TArray<FPrimaryAssetId>(), Entity));
+			}
+		}
+
+		void Release(FTcsBenchmarkEnvironment& Env)
+		{
+			UTcsAttributeManagerSubsystem* AttrMgr = Env.GetAttributeManager();
+			for (const FTcsSourceHandle& Handle : Handles)
+			{
+				AttrMgr->ReleaseSourceHandle(Handle);
+			}
+			Handles.Reset();
+		}
+	};
+
+	void ApplyModifiers(FTcsBenchmarkEnvironment& Env, const FEntitySources& Sources, const TArray<FName>& ModifierIds)
+	{
+		const TArray<TObjectPtr<ATcsBenchmarkEntity>>& Entities = Env.GetEntities();
+		TArray<FTcsAttributeModifierInstance> AppliedModifiers;
+		for (int32 Index = 0; Index < Entities.Num(); ++Index)
+		{
+			Entities[Index]->GetBenchmarkAttributeComponent()->ApplyModifierWithSourceHandle(
+				Sources.Handles[Index], ModifierIds, AppliedModifiers);
+		}
+	}
+
+	void RemoveModifiers(FTcsBenchmarkEnvironment& Env, const FEntitySources& Sources)
+	{
+		const TArray<TObjectPtr<ATcsBenchmarkEntity>>& Entities = Env.GetEntities();
+		for (int32 Index = 0; Index < Entities.Num(); ++Index)
+		{
+			Entities[Index]->GetBenchmarkAttributeComponent()->RemoveModifiersBySourceHandle(Sources.Handles[Index]);
+		}
+	}
+
+	void ApplyState(FTcsBenchmarkEnvironment& Env, FName StateDefId)
+	{
+		for (ATcsBenchmarkEntity* Entity : Env.GetEntities())
+		{
+			Entity->GetBenchmarkStateComponent()->TryApplyState(StateDefId, Entity);
+		}
+	}
+
+	void RemoveAllStates(FTcsBenchmarkEnvironment& Env)
+	{
+		for (ATcsBenchmarkEntity* Entity : Env.GetEntities())
+		{
+			Entity->GetBenchmarkStateComponent()->BenchmarkRemoveAllStates();
+		}
+	}
+
+	/**
+	 * 在每个实体规模下运行基准，并输出报告
+	 *
+	 * @param RunScale 在已生成的实体上运行一个或多个基准，并把结果加入报告
+	 */
+	bool RunSuite(
+		FAutomationTestBase& Test,
+		const FString& SuiteName,
+		TFunctionRef<void(FTcsBenchmarkEnvironment&, const FTcsBenchmarkSettings&, FTcsBenchmarkReport&)> RunScale)
+	{
+		const FTcsBenchmarkSettings Settings = FTcsBenchmarkSettings::FromCommandLine();
+		FTcsScopedBenchmarkLogSuppression LogSuppression;
+
+		FTcsBenchmarkEnvironment Env;
+		FString Error;
+		if (!Env.Initialize(Error))
+		{
+			Test.AddError(FString::Printf(TEXT("Failed to initialize benchmark environment: %s"), *Error));
+			return false;
+		}
+
+		FTcsBenchmarkReport Report(SuiteName, Settings);
+		for (const int32 NumEntities : Settings.EntityCounts)
+		{
+			Env.DestroyEntities();
+			if (Env.SpawnEntities(NumEntities) != NumEntities)
+			{
+				Test.AddError(FString::Printf(TEXT("Failed to spawn %d benchmark entities"), NumEntities));
+				return false;
+			}
+
+			RunScale(Env, Settings, Report);
+		}
+
+		return Report.Finish(Test);
+	}
+}
+
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTcsBenchmarkApplyModifierTest,
+	"TireflyCombatSystem.Benchmark.Attribute.ApplyModifier",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FTcsBenchmarkApplyModifierTest::RunTest(const FString& Parameters)
+{
+	using namespace TcsCombatBenchmarkTests;
+
+	return RunSuite(*this, TEXT("Attribute.ApplyModifier"),
+		[](FTcsBenchmarkEnvironment& Env, const FTcsBenchmarkSettings& Settings, FTcsBenchmarkReport& Report)
+		{
+			const TArray<FName> ModifierIds = MakeAllModifierIds();
+			FEntitySources Sources;
+
+			// 每个实体在一个来源下应用全部合成修改器（每个属性一个）
+			Report.Add(RunTcsBenchmark(TEXT("Attribute.ApplyModifier"), Env.GetEntities().Num(), Settings,
+				[&] { Sources.Create(Env); },
+				[&] { ApplyModifiers(Env, Sources, ModifierIds); },
+				[&] { RemoveModifiers(Env, Sources); Sources.Release(Env); }));
+		});
+}
+
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTcsBenchmarkRemoveModifiersBySourceTest,
+	"TireflyCombatSystem.Benchmark.Attribute.RemoveModifiersBySourceHandle",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FTcsBenchmarkRemoveModifiersBySourceTest::RunTest(const FString& Parameters)
+{
+	using namespace TcsCombatBenchmarkTests;
+
+	return RunSuite(*this, TEXT("Attribute.RemoveModifiersBySourceHandle"),
+		[](FTcsBenchmarkEnvironment& Env, const FTcsBenchmarkSettings& Settings, FTcsBenchmarkReport& Report)
+		{
+			// 同一来源下挂两轮全部修改器，覆盖来源桶内多条目的移除
+			TArray<FName> ModifierIds = MakeAllModifierIds();
+			ModifierIds.Append(MakeAllModifierIds());
+			FEntitySources Sources;
+
+			Report.Add(RunTcsBenchmark(TEXT("Attribute.RemoveModifiersBySourceHandle"), Env.GetEntities().Num(), Settings,
+				[&] { Sources.Create(Env); ApplyModifiers(Env, Sources, ModifierIds); },
+				[&] { RemoveModifiers(Env, Sources); },
+				[&] { Sources.Release(Env); }));
+		});
+}
+
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTcsBenchmarkRecalculateTest,
+	"TireflyCombatSystem.Benchmark.Attribute.Recalculate",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FTcsBenchmarkRecalculateTest::RunTest(const FString& Parameters)
+{
+	using namespace TcsCombatBenchmarkTests;
+
+	return RunSuite(*this, TEXT("Attribute.Recalculate"),
+		[](FTcsBenchmarkEnvironment& Env, const FTcsBenchmarkSettings& Settings, FTcsBenchmarkReport& Report)
+		{
+			TArray<FName> ModifierIds;
+			while (ModifierIds.Num() < NumResidentModifiers)
+			{
+				ModifierIds.Append(MakeAllModifierIds());
+			}
+			ModifierIds.SetNum(NumResidentModifiers);
+
+			FEntitySources Sources;
+			Sources.Create(Env);
+			ApplyModifiers(Env, Sources, ModifierIds);
+
+			// 逐组件串行重算
+			Report.Add(RunTcsBenchmark(TEXT("Attribute.Recalculate.Serial"), Env.GetEntities().Num(), Settings,
+				[] {},
+				[&]
+				{
+					for (ATcsBenchmarkEntity* Entity : Env.GetEntities())
+					{
+						Entity->GetBenchmarkAttributeComponent()->BenchmarkRecalculateCurrentValues();
+					}
+				},
+				[] {}));
+
+			// 管理器批处理：登记后在作用域结束时并行重算
+			Report.Add(RunTcsBenchmark(TEXT("Attribute.Recalculate.Batched"), Env.GetEntities().Num(), Settings,
+				[] {},
+				[&]
+				{
+					FTcsAttributeRecalculationScope RecalculationScope(Env.GetAttributeManager());
+					for (ATcsBenchmarkEntity* Entity : Env.GetEntities())
+					{
+						Entity->GetBenchmarkAttributeComponent()->BenchmarkRecalculateCurrentValues();
+					}
+				},
+				[] {}));
+
+			RemoveModifiers(Env, Sources);
+			Sources.Release(Env);
+		});
+}
+
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTcsBenchmarkTryApplyStateTest,
+	"TireflyCombatSystem.Benchmark.State.TryApplyState",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FTcsBenchmarkTryApplyStateTest::RunTest(const FString& Parameters)
+{
+	using namespace TcsCombatBenchmarkTests;
+
+	return RunSuite(*this, TEXT("State.TryApplyState"),
+		[](FTcsBenchmarkEnvironment& Env, const FTcsBenchmarkSettings& Settings, FTcsBenchmarkReport& Report)
+		{
+			// 槽内已有同定义的实例，计时的第二次应用会经过合并器
+			for (const FTcsBenchmarkStateDefinition& StateDefinition : Env.GetStateDefinitions())
+			{
+				Report.Add(RunTcsBenchmark(
+					FString::Printf(TEXT("State.TryApplyState.%s"), *StateDefinition.MergerName),
+					Env.GetEntities().Num(),
+					Settings,
+					[&] { ApplyState(Env, StateDefinition.StateDefId); },
+					[&] { ApplyState(Env, StateDefinition.StateDefId); },
+					[&] { RemoveAllStates(Env); }));
+			}
+		});
+}
+
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTcsBenchmarkUpdateStateSlotActivationTest,
+	"TireflyCombatSystem.Benchmark.State.UpdateStateSlotActivation",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FTcsBenchmarkUpdateStateSlotActivationTest::RunTest(const FString& Parameters)
+{
+	using namespace TcsCombatBenchmarkTests;
+
+	return RunSuite(*this, TEXT("State.UpdateStateSlotActivation"),
+		[](FTcsBenchmarkEnvironment& Env, const FTcsBenchmarkSettings& Settings, FTcsBenchmarkReport& Report)
+		{
+			for (int32 Index = 0; Index < NumResidentStates; ++Index)
+			{
+				ApplyState(Env, Env.GetNoMergeStateDefId());
+			}
+
+			const FGameplayTag SlotTag = FTcsBenchmarkEnvironment::GetStateSlotTag();
+			Report.Add(RunTcsBenchmark(TEXT("State.UpdateStateSlotActivation"), Env.GetEntities().Num(), Settings,
+				[] {},
+				[&]
+				{
+					for (ATcsBenchmarkEntity* Entity : Env.GetEntities())
+					{
+						Entity->GetBenchmarkStateComponent()->BenchmarkUpdateStateSlotActivation(SlotTag);
+					}
+				},
+				[] {}));
+
+			RemoveAllStates(Env);
+		});
+}
+
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTcsBenchmarkStateDurationTickTest,
+	"TireflyCombatSystem.Benchmark.State.DurationTick",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FTcsBenchmarkStateDurationTickTest::RunTest(const FString& Parameters)
+{
+	using namespace TcsCombatBenchmarkTests;
+
+	return RunSuite(*this, TEXT("State.DurationTick"),
+		[](FTcsBenchmarkEnvironment& Env, const FTcsBenchmarkSettings& Settings, FTcsBenchmarkReport& Report)
+		{
+			for (int32 Index = 0; Index < NumResidentStates; ++Index)
+			{
+				ApplyState(Env, Env.GetNoMergeStateDefId());
+			}
+
+			Report.Add(RunTcsBenchmark(TEXT("State.DurationTick"), Env.GetEntities().Num(), Settings,
+				[] {},
+				[&]
+				{
+					for (ATcsBenchmarkEntity* Entity : Env.GetEntities())
+					{
+						Entity->GetBenchmarkStateComponent()->BenchmarkUpdateStateDurations(FrameDeltaTime);
+					}
+				},
+				[] {}));
+
+			RemoveAllStates(Env);
+		});
+}
+
+#endif
@@ -0,0 +1,422 @@
+// Copyright Tirefly. All Rights Reserved.
+
+
+#include "TcsCombatSimulationCommandlet.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "TcsBenchmarkEntity.h"
+#include "TcsBenchmarkEnvironment.h"
+#include "TcsSourceHandle.h"
+#include "Attribute/TcsAttributeManagerSubsystem.h"
+
+
+
+DEFINE_LOG_CATEGORY_STATIC(LogTcsCombatSimulation, Log, All);
+
+
+
+namespace TcsCombatSimulationPrivate
+{
+	// 模拟参数（见 UTcsCombatSimulationCommandlet 注释）
+	struct FSimulationSettings
+	{
+		int32 NumEntities = 1000;
+		int32 NumFrames = 1800;
+		int32 NumWarmupFrames = 60;
+		float DeltaTime = 1.f / 30.f;
+		int32 Seed = 1;
+
+		float StateApplyChance = 0.05f;
+		float StateRemoveChance = 0.02f;
+		float BuffApplyChance = 0.05f;
+		float BuffRemoveChance = 0.02f;
+		float DamageChance = 0.25f;
+
+		bool bRecalculationBatch = true;
+		bool bDeferModifierCommit = true;
+
+		FString OutputPath;
+
+		// 小于等于 0 表示不检查
+		double MaxFrameP99Ms = 0.0;
+
+		static FSimulationSettings Parse(const FString& Params)
+		{
+			FSimulationSettings Settings;
+			const TCHAR* CommandLine = *Params;
+
+			FParse::Value(CommandLine, TEXT("Entities="), Settings.NumEntities);
+			FParse::Value(CommandLine, TEXT("Frames="), Settings.NumFrames);
+			FParse::Value(CommandLine, TEXT("WarmupFrames="), Settings.NumWarmupFrames);
+			FParse::Value(CommandLine, TEXT("DeltaTime="), Settings.DeltaTime);
+			FParse::Value(CommandLine, TEXT("Seed="), Settings.Seed);
+			FParse::Value(CommandLine, TEXT("StateApplyChance="), Settings.StateApplyChance);
+			FParse::Value(CommandLine, TEXT("StateRemoveChance="), Settings.StateRemoveChance);
+			FParse::Value(CommandLine, TEXT("BuffApplyChance="), Settings.BuffApplyChance);
+			FParse::Value(CommandLine, TEXT("BuffRemoveChance="), Settings.BuffRemoveChance);
+			FParse::Value(CommandLine, TEXT("DamageChance="), Settings.DamageChance);
+			FParse::Value(CommandLine, TEXT("MaxFrameP99Ms="), Settings.MaxFrameP99Ms);
+			Settings.bRecalculationBatch = !FParse::Param(CommandLine, TEXT("NoRecalcBatch"));
+			Settings.bDeferModifierCommit = !FParse::Param(CommandLine, TEXT("NoDeferredCommit"));
+
+			Settings.NumEntities = FMath::Max(Settings.NumEntities, 1);
+			Settings.NumFrames = FMath::Max(Settings.NumFrames, 1);
+			Settings.NumWarmupFrames = FMath::Max(Settings.NumWarmupFrames, 0);
+			Settings.DeltaTime = FMath::Max(Settings.DeltaTime, UE_KINDA_SMALL_NUMBER);
+
+			if (!FParse::Value(CommandLine, TEXT("Output="), Settings.OutputPath))
+			{
+				Settings.OutputPath = FPaths::Combine(
+					FPaths::ProjectSavedDir(), TEXT("Automation"), TEXT("TcsSimulation"), TEXT("TcsCombatSimulation.csv"));
+			}
+
+			return Settings;
+		}
+	};
+
+
+
+	// 计时帧内驱动的流量计数
+	struct FSimulationCounters
+	{
+		int64 StatesApplied = 0;
+		int64 StatesRejected = 0;
+		int64 StatesRemoved = 0;
+		int64 ModifiersApplied = 0;
+		int64 ModifiersRemoved = 0;
+
+		// 经指令队列提交的伤害（在下一次 World Tick 开始时执行）
+		int64 DamageSubmitted = 0;
+
+		// 处理的修改器总数：增益挂载 + 增益移除 + 伤害
+		int64 GetModifiersProcessed() const { return ModifiersApplied + ModifiersRemoved + DamageSubmitted; }
+	};
+
+
+
+	struct FSimulationResult
+	{
+		FSimulationCounters Counters;
+
+		// 流量中是否包含 StateTree 驱动的状态
+		bool bStateTreeState = false;
+
+		// 计时帧的实际耗时总和 / 模拟时长（秒）
+		double WallSeconds = 0.0;
+		double SimulatedSeconds = 0.0;
+
+		double FrameP50Ms = 0.0;
+		double FrameP90Ms = 0.0;
+		double FrameP99Ms = 0.0;
+		double FrameMaxMs = 0.0;
+
+		double GetStatesAppliedPerSecond() const { return WallSeconds > 0.0 ? Counters.StatesApplied / WallSeconds : 0.0; }
+		double GetModifiersProcessedPerSecond() const { return WallSeconds > 0.0 ? Counters.GetModifiersProcessed() / WallSeconds : 0.0; }
+	};
+
+
+
+	/**
+	 * 脚本化战斗流量
+	 *
+	 * 每个实体持有一个来源句柄：以该句柄为自己挂载增益修改器（按来源整体移除），并通过战斗指令队列对随机目标造成伤害；
+	 * 状态从全部合成状态定义（含 StateTree 驱动的状态）中随机选取，发起者为随机实体，以覆盖各状态合并器与按发起者叠层的路径。
+	 */
+	class FCombatSimulation
+	{
+	public:
+		FCombatSimulation(FTcsBenchmarkEnvironment& InEnv, const FSimulationSettings& InSettings)
+			: Env(InEnv)
+			, Settings(InSettings)
+			, Random(InSettings.Seed)
+		{
+			BuffModifierIds.Add(NAME_None);
+			DamageModifierIds.Add(FTcsBenchmarkEnvironment::GetDamageModifierId());
+
+			for (const FTcsBenchmarkStateDefinition& StateDefinition : Env.GetStateDefinitions())
+			{
+				StateDefIds.Add(StateDefinition.StateDefId);
+			}
+			if (!Env.GetStateTreeStateDefId().IsNone())
+			{
+				StateDefIds.Add(Env.GetStateTreeStateDefId());
+			}
+		}
+
+		FSimulationResult Run()
+		{
+			CreateSources();
+
+			FSimulationCounters WarmupCounters;
+			for (int32 Frame = 0; Frame < Settings.NumWarmupFrames; ++Frame)
+			{
+				StepFrame(WarmupCounters);
+			}
+
+			FSimulationResult Result;
+			TArray<double> FrameTimesMs;
+			FrameTimesMs.Reserve(Settings.NumFrames);
+			for (int32 Frame = 0; Frame < Settings.NumFrames; ++Frame)
+			{
+				const double StartTime = FPlatformTime::Seconds();
+				StepFrame(Result.Counters);
+				const double FrameSeconds = FPlatformTime::Seconds() - StartTime;
+
+				Result.WallSeconds += FrameSeconds;
+				FrameTimesMs.Add(FrameSeconds * 1000.0);
+			}
+			FrameTimesMs.Sort();
+
+			Result.SimulatedSeconds = static_cast<double>(Settings.NumFrames) * Settings.DeltaTime;
+			Result.FrameP50Ms = ComputeTcsBenchmarkPercentile(FrameTimesMs, 0.50);
+			Result.FrameP90Ms = ComputeTcsBenchmarkPercentile(FrameTimesMs, 0.90);
+			Result.FrameP99Ms = ComputeTcsBenchmarkPercentile(FrameTimesMs, 0.99);
+			Result.FrameMaxMs = FrameTimesMs.Last();
+
+			ReleaseSources();
+			return Result;
+		}
+
+	private:
+		void CreateSources()
+		{
+			UTcsAttributeManagerSubsystem* AttrMgr = Env.GetAttributeManager();
+			const TArray<TObjectPtr<ATcsBenchmarkEntity>>& Entities = Env.GetEntities();
+			SourceHandles.Reset(Entities.Num());
+			for (ATcsBenchmarkEntity* Entity : Entities)
+			{
+				SourceHandles.Add(AttrMgr->CreateSourceHandle(TArray<FPrimaryAssetId>(), Entity));
+			}
+			NumActiveBuffs.Init(0, Entities.Num());
+		}
+
+		void ReleaseSources()
+		{
+			UTcsAttributeManagerSubsystem* AttrMgr = Env.GetAttributeManager();
+			const TArray<TObjectPtr<ATcsBenchmarkEntity>>& Entities = Env.GetEntities();
+			for (int32 Index = 0; Index < Entities.Num(); ++Index)
+			{
+				Entities[Index]->GetBenchmarkAttributeComponent()->RemoveModifiersBySourceHandle(SourceHandles[Index]);
+				AttrMgr->ReleaseSourceHandle(SourceHandles[Index]);
+			}
+			SourceHandles.Reset();
+			NumActiveBuffs.Reset();
+		}
+
+		// 推进一帧：逐实体生成流量，再推进世界（指令队列、组件 Tick、延迟提交）
+		void StepFrame(FSimulationCounters& Counters)
+		{
+			GenerateTraffic(Counters);
+			Env.TickWorld(Settings.DeltaTime);
+		}
+
+		void GenerateTraffic(FSimulationCounters& Counters)
+		{
+			const TArray<TObjectPtr<ATcsBenchmarkEntity>>& Entities = Env.GetEntities();
+			UTcsAttributeManagerSubsystem* AttrMgr = Env.GetAttributeManager();
+
+			// 流量生成期间的属性重算合并为一次批量重算（与游戏中按帧批处理光环/伤害的用法一致）
+			FTcsAttributeRecalculationScope RecalculationScope(Settings.bRecalculationBatch ? AttrMgr : nullptr);
+
+			for (int32 Index = 0; Index < Entities.Num(); ++Index)
+			{
+				ATcsBenchmarkEntity* Entity = Entities[Index];
+				UTcsBenchmarkStateComponent* StateComponent = Entity->GetBenchmarkStateComponent();
+				UTcsBenchmarkAttributeComponent* AttributeComponent = Entity->GetBenchmarkAttributeComponent();
+
+				if (Random.FRand() < Settings.StateApplyChance)
+				{
+					const FName StateDefId = StateDefIds[Random.RandHelper(StateDefIds.Num())];
+					ATcsBenchmarkEntity* Instigator = Entities[Random.RandHelper(Entities.Num())];
+					if (StateComponent->TryApplyState(StateDefId, Instigator))
+					{
+						++Counters.StatesApplied;
+					}
+					else
+					{
+						++Counters.StatesRejected;
+					}
+				}
+
+				if (Random.FRand() < Settings.StateRemoveChance)
+				{
+					const FName StateDefId = StateDefIds[Random.RandHelper(StateDefIds.Num())];
+					Counters.StatesRemoved += StateComponent->BenchmarkRemoveStatesByDefId(StateDefId);
+				}
+
+				if (Random.FRand() < Settings.BuffApplyChance)
+				{
+					BuffModifierIds[0] = FTcsBenchmarkEnvironment::GetModifierId(Random.RandHelper(FTcsBenchmarkEnvironment::NumAttributes));
+					if (AttributeComponent->ApplyModifierWithSourceHandle(SourceHandles[Index], BuffModifierIds, AppliedModifiers))
+					{
+						Counters.ModifiersApplied += AppliedModifiers.Num();
+						NumActiveBuffs[Index] += AppliedModifiers.Num();
+					}
+				}
+
+				if (NumActiveBuffs[Index] > 0 && Random.FRand() < Settings.BuffRemoveChance)
+				{
+					if (AttributeComponent->RemoveModifiersBySourceHandle(SourceHandles[Index]))
+					{
+						Counters.ModifiersRemoved += NumActiveBuffs[Index];
+					}
+					NumActiveBuffs[Index] = 0;
+				}
+
+				if (Random.FRand() < Settings.DamageChance)
+				{
+					ATcsBenchmarkEntity* Target = Entities[Random.RandHelper(Entities.Num())];
+					AttrMgr->EnqueueApplyModifiers(Target, DamageModifierIds, SourceHandles[Index], Entity);
+					++Counters.DamageSubmitted;
+				}
+			}
+		}
+
+		FTcsBenchmarkEnvironment& Env;
+		const FSimulationSettings& Settings;
+		FRandomStream Random;
+
+		// 每个实体一个来源句柄，以及以该来源挂在自身上的增益修改器数量
+		TArray<FTcsSourceHandle> SourceHandles;
+		TArray<int32> NumActiveBuffs;
+
+		// 流量中随机选取的状态定义 Id
+		TArray<FName> StateDefIds;
+
+		// 复用的修改器 Id 与输出数组（避免逐次分配）
+		TArray<FName> BuffModifierIds;
+		TArray<FName> DamageModifierIds;
+		TArray<FTcsAttributeModifierInstance> AppliedModifiers;
+	};
+
+
+
+	bool WriteCsv(const FSimulationSettings& Settings, const FSimulationResult& Result)
+	{
+		FString Csv = TEXT("Entities,Frames,DeltaTime,Seed,RecalcBatch,DeferredCommit,StateTreeState,WallSeconds,SimulatedSeconds,")
+			TEXT("StatesApplied,StatesRejected,StatesRemoved,ModifiersApplied,ModifiersRemoved,DamageSubmitted,")
+			TEXT("StatesAppliedPerSecond,ModifiersProcessedPerSecond,FrameP50Ms,FrameP90Ms,FrameP99Ms,FrameMaxMs\n");
+		Csv += FString::Printf(TEXT("%d,%d,%.6f,%d,%d,%d,%d,%.3f,%.3f,%lld,%lld,%lld,%lld,%lld,%lld,%.1f,%.1f,%.3f,%.3f,%.3f,%.3f\n"),
+			Settings.NumEntities, Settings.NumFrames, Settings.DeltaTime, Settings.Seed, Settings.bRecalculationBatch ? 1 : 0,
+			Settings.bDeferModifierCommit ? 1 : 0, Result.bStateTreeState ? 1 : 0,
+			Result.WallSeconds, Result.SimulatedSeconds,
+			Result.Counters.StatesApplied, Result.Counters.StatesRejected, Result.Counters.StatesRemoved,
+			Result.Counters.ModifiersApplied, Result.Counters.ModifiersRemoved, Result.Counters.DamageSubmitted,
+			Result.GetStatesAppliedPerSecond(), Result.GetModifiersProcessedPerSecond(),
+			Result.FrameP50Ms, Result.FrameP90Ms, Result.FrameP99Ms, Result.FrameMaxMs);
+
+		return FFileHelper::SaveStringToFile(Csv, *Settings.OutputPath);
+	}
+}
+
+
+
+UTcsCombatSimulationCommandlet::UTcsCombatSimulationCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UTcsCombatSimulationCommandlet::Main(const FString& Params)
+{
+	using namespace TcsCombatSimulationPrivate;
+
+	const FSimulationSettings Settings = FSimulationSettings::Parse(Params);
+	UE_LOG(LogTcsCombatSimulation, Display, TEXT("[%s] Simulating %d entities for %d frames (+%d warmup) at dt=%.4fs, seed %d, recalculation batch %s, deferred commit %s"),
+		*FString(__FUNCTION__),
+		Settings.NumEntities,
+		Settings.NumFrames,
+		Settings.NumWarmupFrames,
+		Settings.DeltaTime,
+		Settings.Seed,
+		Settings.bRecalculationBatch ? TEXT("on") : TEXT("off"),
+		Settings.bDeferModifierCommit ? TEXT("on") : TEXT("off"));
+
+	FSimulationResult Result;
+	{
+		// 逐条 Log 级日志会淹没计时结果
+		FTcsScopedBenchmarkLogSuppression LogSuppression;
+
+		FTcsBenchmarkEnvironment Env;
+		FString Error;
+		if (!Env.Initialize(Error))
+		{
+			UE_LOG(LogTcsCombatSimulation, Error, TEXT("[%s] Failed to initialize simulation environment: %s"),
+				*FString(__FUNCTION__),
+				*Error);
+			return 1;
+		}
+
+		if (Env.GetStateTreeStateDefId().IsNone())
+		{
+			UE_LOG(LogTcsCombatSimulation, Warning, TEXT("[%s] StateTree-driven state is unavailable (requires an editor build); simulating without StateTree ticks"),
+				*FString(__FUNCTION__));
+		}
+
+		FTcsBenchmarkSpawnOptions SpawnOptions;
+		SpawnOptions.bTickComponents = true;
+		SpawnOptions.bDeferModifierCommit = Settings.bDeferModifierCommit;
+		if (Env.SpawnEntities(Settings.NumEntities, SpawnOptions) != Settings.NumEntities)
+		{
+			UE_LOG(LogTcsCombatSimulation, Error, TEXT("[%s] Failed to spawn %d simulation entities"),
+				*FString(__FUNCTION__),
+				Settings.NumEntities);
+			return 1;
+		}
+
+		FCombatSimulation Simulation(Env, Settings);
+		Result = Simulation.Run();
+		Result.bStateTreeState = !Env.GetStateTreeStateDefId().IsNone();
+	}
+
+	UE_LOG(LogTcsCombatSimulation, Display, TEXT("[%s] Wall time %.3fs for %.1fs simulated (%.1fx real time)"),
+		*FString(__FUNCTION__),
+		Result.WallSeconds,
+		Result.SimulatedSeconds,
+		Result.WallSeconds > 0.0 ? Result.SimulatedSeconds / Result.WallSeconds : 0.0);
+	UE_LOG(LogTcsCombatSimulation, Display, TEXT("[%s] States: %lld applied, %lld rejected, %lld removed (%.1f applied/s)"),
+		*FString(__FUNCTION__),
+		Result.Counters.StatesApplied,
+		Result.Counters.StatesRejected,
+		Result.Counters.StatesRemoved,
+		Result.GetStatesAppliedPerSecond());
+	UE_LOG(LogTcsCombatSimulation, Display, TEXT("[%s] Modifiers: %lld applied, %lld removed, %lld damage submitted (%.1f processed/s)"),
+		*FString(__FUNCTION__),
+		Result.Counters.ModifiersApplied,
+		Result.Counters.ModifiersRemoved,
+		Result.Counters.DamageSubmitted,
+		Result.GetModifiersProcessedPerSecond());
+	UE_LOG(LogTcsCombatSimulation, Display, TEXT("[%s] Frame time: p50 %.3fms, p90 %.3fms, p99 %.3fms, max %.3fms"),
+		*FString(__FUNCTION__),
+		Result.FrameP50Ms,
+		Result.FrameP90Ms,
+		Result.FrameP99Ms,
+		Result.FrameMaxMs);
+
+	if (WriteCsv(Settings, Result))
+	{
+		UE_LOG(LogTcsCombatSimulation, Display, TEXT("[%s] Simulation results written to %s"),
+			*FString(__FUNCTION__),
+			*FPaths::ConvertRelativePathToFull(Settings.OutputPath));
+	}
+	else
+	{
+		UE_LOG(LogTcsCombatSimulation, Warning, TEXT("[%s] Failed to write simulation results to %s"),
+			*FString(__FUNCTION__),
+			*Settings.OutputPath);
+	}
+
+	if (Settings.MaxFrameP99Ms > 0.0 && Result.FrameP99Ms > Settings.MaxFrameP99Ms)
+	{
+		UE_LOG(LogTcsCombatSimulation, Error, TEXT("[%s] Frame time p99 %.3fms exceeds limit %.3fms"),
+			*FString(__FUNCTION__),
+			Result.FrameP99Ms,
+			Settings.MaxFrameP99Ms);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,50 @@
+// Copyright Tirefly. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TcsCombatSimulationCommandlet.generated.h"
+
+
+
+/**
+ * 无头战斗模拟（吞吐量负载测试）
+ *
+ * 在 FTcsBenchmarkEnvironment 创建的独立世界中生成 N 个轻量战斗实体，每帧先生成脚本化的状态应用/移除、
+ * 增益修改器挂载/移除与伤害流量，再以 World->Tick(LEVELTICK_All) 按固定时间步长推进世界。一帧的耗时因此包含
+ * 战斗指令队列的执行（伤害经由指令队列提交）、状态组件 Tick（持续时间与 StateTree，其中一种状态由 StateTree 驱动）
+ * 与属性组件的延迟修改器提交。统计状态应用与修改器处理的吞吐量（每秒）及帧耗时百分位。
+ * 流量由固定种子的随机流生成，同一组参数的两次运行流量完全一致，可直接在 CI Linux 机器上对比。
+ * StateTree 驱动的状态需要编辑器构建（UnrealEditor-Cmd）在运行时编译合成 StateTree。
+ *
+ * 运行示例：
+ *   UnrealEditor-Cmd <Project>.uproject -run=TcsCombatSimulation -nullrhi -unattended -nosplash
+ *     -Entities=1000 -Frames=1800 -DeltaTime=0.0333 -Seed=1
+ *
+ * 参数（均可省略）：
+ * - -Entities=1000：实体数量
+ * - -Frames=1800 / -WarmupFrames=60：计时帧数 / 不计时的预热帧数
+ * - -DeltaTime=0.0333：固定时间步长（秒）；帧与帧之间不等待，按最快速度推进
+ * - -Seed=1：流量随机种子
+ * - -StateApplyChance=0.05 / -StateRemoveChance=0.02：每个实体每帧应用 / 移除状态的概率
+ * - -BuffApplyChance=0.05 / -BuffRemoveChance=0.02：每个实体每帧挂载 / 移除增益修改器的概率
+ * - -DamageChance=0.25：每个实体每帧对随机目标造成一次伤害的概率
+ * - -NoRecalcBatch：不使用属性重算批处理（每次修改器变化同步重算）
+ * - -NoDeferredCommit：属性组件不启用延迟提交（修改器在流量生成时立即生效）
+ * - -Output=<Path>：结果 CSV 路径，默认 Saved/Automation/TcsSimulation/TcsCombatSimulation.csv
+ * - -MaxFrameP99Ms=<Ms>：帧耗时 p99 超过该值时返回非 0（默认不检查）
+ *
+ * 返回值：0 成功；1 环境初始化失败、生成实体失败或超出帧耗时上限。
+ */
+UCLASS()
+class UTcsCombatSimulationCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTcsCombatSimulationCommandlet();
+
+	//~ UCommandlet
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,458 @@
+// Copyright Tirefly. All Rights Reserved.
+
+
+#include "Misc/AutomationTest.h"
+#include "UObject/CoreNet.h"
+#include "TcsDefinitionId.h"
+#include "TcsSourceHandle.h"
+#include "TcsSourceHandleNetCache.h"
+#include "TcsSourceHandleRegistry.h"
+#include "State/TcsStateDefinition.h"
+
+
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace TcsSourceHandleNetSerializeTests
+{
+	// 模拟一条连接的两端（发送端与接收端各自持有注册表与连接缓存）
+	struct FConnectionPair
+	{
+		FTcsSourceHandleRegistry SenderRegistry;
+		FTcsSourceHandleRegistry ReceiverRegistry;
+		FTcsSourceHandleNetCache SenderCache;
+		FTcsSourceHandleNetCache ReceiverCache;
+
+		// 握手确认两端列表一致的定义类别
+		uint8 NetIndexKinds = 0;
+
+		FTcsSourceHandleNetContext MakeSendContext(int32 PacketId, bool bUseCache)
+		{
+			FTcsSourceHandleNetContext Context;
+			Context.Registry = &SenderRegistry;
+			Context.Cache = bUseCache ? &SenderCache : nullptr;
+			Context.SendPacketId = PacketId;
+			Context.NetIndexKinds = NetIndexKinds;
+			return Context;
+		}
+
+		FTcsSourceHandleNetContext MakeReceiveContext(bool bUseCache)
+		{
+			FTcsSourceHandleNetContext Context;
+			Context.Registry = &ReceiverRegistry;
+			Context.Cache = bUseCache ? &ReceiverCache : nullptr;
+			return Context;
+		}
+	};
+
+	FPrimaryAssetId MakeStateAssetId(const TCHAR* StateDefId)
+	{
+		return FPrimaryAssetId(UTcsStateDefinition::PrimaryAssetType, FName(StateDefId));
+	}
+
+	TArray<FPrimaryAssetId> MakeTestChain()
+	{
+		return { MakeStateAssetId(TEXT("TcsTest_Skill")), MakeStateAssetId(TEXT("TcsTest_Buff")), MakeStateAssetId(TEXT("TcsTest_DoT")) };
+	}
+
+	FTcsSourceHandle AllocateWithChain(FTcsSourceHandleRegistry& Registry, const TArray<FPrimaryAssetId>& Chain)
+	{
+		FTcsSourceHandleData Data;
+		Data.CausalityTail = Registry.InternCausalityChain(Chain);
+		return Registry.Allocate(MoveTemp(Data));
+	}
+
+	// 写出句柄并返回位数；Writer 保留写出的数据供接收端读取
+	int64 Write(FNetBitWriter& Writer, FTcsSourceHandle Handle, const FTcsSourceHandleNetContext& Context)
+	{
+		bool bSuccess = false;
+		Handle.NetSerializeWithContext(Writer, nullptr, Context, bSuccess);
+		return bSuccess && !Writer.IsError() ? Writer.GetNumBits() : INDEX_NONE;
+	}
+
+	bool Read(FNetBitWriter& Writer, const FTcsSourceHandleNetContext& Context, FTcsSourceHandle& OutHandle)
+	{
+		FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+		bool bSuccess = false;
+		OutHandle.NetSerializeWithContext(Reader, nullptr, Context, bSuccess);
+		return bSuccess && !Reader.IsError();
+	}
+
+	TArray<FPrimaryAssetId> ResolveChain(const FTcsSourceHandleRegistry& Registry, const FTcsSourceHandle& Handle)
+	{
+		TArray<FPrimaryAssetId> Chain;
+		if (const FTcsSourceHandleData* Data = Registry.Resolve(Handle))
+		{
+			Data->GetCausalityChain(Chain);
+		}
+		return Chain;
+	}
+
+	// 临时替换 State 的网络定义列表，析构时恢复
+	struct FScopedNetworkStateDefinitionIds
+	{
+		TArray<FName> SavedIds;
+
+		explicit FScopedNetworkStateDefinitionIds(const TArray<FName>& Ids)
+			: SavedIds(FTcsDefinitionIdTable::GetNetworkDefinitionIds(ETcsDefinitionKind::State))
+		{
+			FTcsDefinitionIdTable::SetNetworkDefinitionIds(ETcsDefinitionKind::State, Ids);
+		}
+
+		~FScopedNetworkStateDefinitionIds()
+		{
+			FTcsDefinitionIdTable::SetNetworkDefinitionIds(ETcsDefinitionKind::State, SavedIds);
+		}
+	};
+}
+
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTcsSourceHandleNetSerializeFullChainTest,
+	"TireflyCombatSystem.SourceHandle.NetSerialize.FullChainRoundTrip",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTcsSourceHandleNetSerializeFullChainTest::RunTest(const FString& Parameters)
+{
+	using namespace TcsSourceHandleNetSerializeTests;
+
+	FConnectionPair Connection;
+	const TArray<FPrimaryAssetId> Chain = MakeTestChain();
+	const FTcsSourceHandle Handle = AllocateWithChain(Connection.SenderRegistry, Chain);
+
+	FNetBitWriter Writer(1024);
+	TestTrue(TEXT("Write succeeds"), Write(Writer, Handle, Connection.MakeSendContext(1, false)) > 0);
+
+	FTcsSourceHandle Received;
+	TestTrue(TEXT("Read succeeds"), Read(Writer, Connection.MakeReceiveContext(false), Received));
+	TestEqual(TEXT("Handle slot round trips"), Received.Id, Handle.Id);
+	TestEqual(TEXT("Handle generation round trips"), Received.Generation, Handle.Generation);
+	TestTrue(TEXT("Received handle is remote"), Received.IsRemote());
+	TestEqual(TEXT("Chain round trips"), ResolveChain(Connection.ReceiverRegistry, Received), Chain);
+
+	// 接收端本地分配的同槽位来源与远端镜像互不覆盖
+	const FTcsSourceHandle ReceiverLocal = AllocateWithChain(Connection.ReceiverRegistry, { MakeStateAssetId(TEXT("TcsTest_Local")) });
+	TestEqual(TEXT("Local slot collides with remote slot"), ReceiverLocal.Id, Received.Id);
+	TestEqual(TEXT("Remote chain survives local allocation"), ResolveChain(Connection.ReceiverRegistry, Received), Chain);
+	TestEqual(TEXT("Local chain resolves separately"), ResolveChain(Connection.ReceiverRegistry, ReceiverLocal).Num(), 1);
+
+	// 远端句柄不参与引用计数
+	Connection.ReceiverRegistry.Release(Received);
+	TestEqual(TEXT("Releasing remote handle is a no-op"), ResolveChain(Connection.ReceiverRegistry, Received), Chain);
+
+	// 远端句柄回传给来源端时还原为本地句柄
+	FNetBitWriter EchoWriter(1024);
+	TestTrue(TEXT("Echo write succeeds"), Write(EchoWriter, Received, Connection.MakeReceiveContext(false)) > 0);
+	FTcsSourceHandle Echoed;
+	TestTrue(TEXT("Echo read succeeds"), Read(EchoWriter, Connection.MakeSendContext(1, false), Echoed));
+	TestEqual(TEXT("Echoed handle is the original local handle"), Echoed, Handle);
+
+	// 无效句柄只写出 Id/代数
+	FNetBitWriter InvalidWriter(1024);
+	TestTrue(TEXT("Invalid handle is compact"), Write(InvalidWriter, FTcsSourceHandle(), Connection.MakeSendContext(1, false)) <= 16);
+
+	FTcsSourceHandle ReceivedInvalid(3, 7);
+	TestTrue(TEXT("Invalid handle read succeeds"), Read(InvalidWriter, Connection.MakeReceiveContext(false), ReceivedInvalid));
+	TestFalse(TEXT("Invalid handle stays invalid"), ReceivedInvalid.IsValid());
+
+	return true;
+}
+
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTcsSourceHandleNetSerializeRelayTest,
+	"TireflyCombatSystem.SourceHandle.NetSerialize.RelayAcrossConnections",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTcsSourceHandleNetSerializeRelayTest::RunTest(const FString& Parameters)
+{
+	using namespace TcsSourceHandleNetSerializeTests;
+
+	// 服务器与两个客户端，服务器上连接 1 通往 A、连接 2 通往 B；客户端上通往服务器的连接均为 1
+	FTcsSourceHandleRegistry ClientA;
+	FTcsSourceHandleRegistry ClientB;
+	FTcsSourceHandleRegistry Server;
+
+	auto MakeContext = [](FTcsSourceHandleRegistry& Registry, int32 ConnectionId)
+	{
+		FTcsSourceHandleNetContext Context;
+		Context.Registry = &Registry;
+		Context.ConnectionId = ConnectionId;
+		return Context;
+	};
+
+	const TArray<FPrimaryAssetId> ChainA = { MakeStateAssetId(TEXT("TcsTest_ClientA")) };
+	const TArray<FPrimaryAssetId> ChainB = { MakeStateAssetId(TEXT("TcsTest_ClientB")) };
+	const FTcsSourceHandle HandleA = AllocateWithChain(ClientA, ChainA);
+	const FTcsSourceHandle HandleB = AllocateWithChain(ClientB, ChainB);
+	TestEqual(TEXT("Both clients use the same slot"), HandleA.Id, HandleB.Id);
+
+	// 两个客户端的同号槽位在服务器上互不覆盖
+	FNetBitWriter WriterA(1024);
+	FNetBitWriter WriterB(1024);
+	TestTrue(TEXT("Client A write succeeds"), Write(WriterA, HandleA, MakeContext(ClientA, 1)) > 0);
+	TestTrue(TEXT("Client B write succeeds"), Write(WriterB, HandleB, MakeContext(ClientB, 1)) > 0);
+
+	FTcsSourceHandle ServerA;
+	FTcsSourceHandle ServerB;
+	TestTrue(TEXT("Server reads A"), Read(WriterA, MakeContext(Server, 1), ServerA));
+	TestTrue(TEXT("Server reads B"), Read(WriterB, MakeContext(Server, 2), ServerB));
+	TestNotEqual(TEXT("Mirrors from different connections are distinct"), ServerA, ServerB);
+	TestEqual(TEXT("Server resolves A"), ResolveChain(Server, ServerA), ChainA);
+	TestEqual(TEXT("Server resolves B"), ResolveChain(Server, ServerB), ChainB);
+
+	// 服务器把 A 的来源转发给 B：完整写出元数据，B 解析到 A 的因果链
+	FNetBitWriter RelayWriter(1024);
+	TestTrue(TEXT("Relay write succeeds"), Write(RelayWriter, ServerA, MakeContext(Server, 2)) > 0);
+	FTcsSourceHandle RelayedOnB;
+	TestTrue(TEXT("Relay read succeeds"), Read(RelayWriter, MakeContext(ClientB, 1), RelayedOnB));
+	TestTrue(TEXT("Relayed handle is remote on B"), RelayedOnB.IsRemote());
+	TestNotEqual(TEXT("Relayed handle does not alias B's own handle"), RelayedOnB, HandleB);
+	TestEqual(TEXT("B resolves A's chain"), ResolveChain(ClientB, RelayedOnB), ChainA);
+	TestEqual(TEXT("B's own chain is untouched"), ResolveChain(ClientB, HandleB), ChainB);
+
+	// B 把转发来的句柄回传给服务器：还原为服务器上 A 的镜像
+	FNetBitWriter BackToServerWriter(1024);
+	TestTrue(TEXT("Return write succeeds"), Write(BackToServerWriter, RelayedOnB, MakeContext(ClientB, 1)) > 0);
+	FTcsSourceHandle BackOnServer;
+	TestTrue(TEXT("Return read succeeds"), Read(BackToServerWriter, MakeContext(Server, 2), BackOnServer));
+	TestEqual(TEXT("Returned handle is the server's mirror of A"), BackOnServer, ServerA);
+
+	// 服务器再把它回传给 A：还原为 A 的本地句柄
+	FNetBitWriter BackToAWriter(1024);
+	TestTrue(TEXT("Return to A write succeeds"), Write(BackToAWriter, BackOnServer, MakeContext(Server, 1)) > 0);
+	FTcsSourceHandle BackOnA;
+	TestTrue(TEXT("Return to A read succeeds"), Read(BackToAWriter, MakeContext(ClientA, 1), BackOnA));
+	TestEqual(TEXT("Returned handle is A's local handle"), BackOnA, HandleA);
+
+	// 连接关闭后经由其收到的镜像被清理，重连后的新来源不会与旧句柄混淆
+	Server.RemoveConnection(1);
+	TestEqual(TEXT("Mirror from closed connection is released"), ResolveChain(Server, ServerA).Num(), 0);
+	TestEqual(TEXT("Mirror from open connection survives"), ResolveChain(Server, ServerB), ChainB);
+
+	FNetBitWriter ReconnectWriter(1024);
+	TestTrue(TEXT("Reconnect write succeeds"), Write(ReconnectWriter, HandleA, MakeContext(ClientA, 1)) > 0);
+	FTcsSourceHandle ServerAReconnected;
+	TestTrue(TEXT("Reconnect read succeeds"), Read(ReconnectWriter, MakeContext(Server, 3), ServerAReconnected));
+	TestNotEqual(TEXT("Reconnected mirror gets a new origin"), ServerAReconnected.OriginId, ServerA.OriginId);
+	TestEqual(TEXT("Stale handle stays released"), ResolveChain(Server, ServerA).Num(), 0);
+
+	return true;
+}
+
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTcsSourceHandleNetSerializeCachedChainTest,
+	"TireflyCombatSystem.SourceHandle.NetSerialize.CachedChainAfterAck",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTcsSourceHandleNetSerializeCachedChainTest::RunTest(const FString& Parameters)
+{
+	using namespace TcsSourceHandleNetSerializeTests;
+
+	FConnectionPair Connection;
+	const TArray<FPrimaryAssetId> Chain = MakeTestChain();
+	const FTcsSourceHandle Handle = AllocateWithChain(Connection.SenderRegistry, Chain);
+
+	// 包 1：完整发送
+	Connection.SenderCache.UpdateAckState(0, 0);
+	FNetBitWriter FirstWriter(1024);
+	const int64 FullBits = Write(FirstWriter, Handle, Connection.MakeSendContext(1, true));
+	FTcsSourceHandle Received;
+	TestTrue(TEXT("First read succeeds"), Read(FirstWriter, Connection.MakeReceiveContext(true), Received));
+
+	// 包 2：包 1 尚未确认，仍完整发送
+	FNetBitWriter SecondWriter(1024);
+	TestEqual(TEXT("Unacked chain is sent in full"), Write(SecondWriter, Handle, Connection.MakeSendContext(2, true)), FullBits);
+	TestTrue(TEXT("Second read succeeds"), Read(SecondWriter, Connection.MakeReceiveContext(true), Received));
+
+	// 包 3：包 2 已确认且无丢包，只写出链引用号
+	Connection.SenderCache.UpdateAckState(2, 0);
+	FNetBitWriter ThirdWriter(1024);
+	const int64 CachedBits = Write(ThirdWriter, Handle, Connection.MakeSendContext(3, true));
+	TestTrue(TEXT("Acked chain is sent as a reference"), CachedBits > 0 && CachedBits < FullBits);
+
+	Connection.ReceiverRegistry.Reset();
+	TestTrue(TEXT("Cached read succeeds"), Read(ThirdWriter, Connection.MakeReceiveContext(true), Received));
+	TestEqual(TEXT("Cached chain resolves"), ResolveChain(Connection.ReceiverRegistry, Received), Chain);
+
+	// 同前缀的派生链是不同的链，需要单独完整发送
+	TArray<FPrimaryAssetId> DerivedChain = Chain;
+	DerivedChain.Add(MakeStateAssetId(TEXT("TcsTest_Explosion")));
+	const FTcsSourceHandle DerivedHandle = AllocateWithChain(Connection.SenderRegistry, DerivedChain);
+	FNetBitWriter DerivedWriter(1024);
+	TestTrue(TEXT("New chain is sent in full"), Write(DerivedWriter, DerivedHandle, Connection.MakeSendContext(4, true)) > CachedBits);
+	TestTrue(TEXT("Derived read succeeds"), Read(DerivedWriter, Connection.MakeReceiveContext(true), Received));
+	TestEqual(TEXT("Derived chain resolves"), ResolveChain(Connection.ReceiverRegistry, Received), DerivedChain);
+
+	return true;
+}
+
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTcsSourceHandleNetSerializeLossTest,
+	"TireflyCombatSystem.SourceHandle.NetSerialize.LossForcesFullResend",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTcsSourceHandleNetSerializeLossTest::RunTest(const FString& Parameters)
+{
+	using namespace TcsSourceHandleNetSerializeTests;
+
+	FConnectionPair Connection;
+	const TArray<FPrimaryAssetId> Chain = MakeTestChain();
+	const FTcsSourceHandle Handle = AllocateWithChain(Connection.SenderRegistry, Chain);
+
+	// 包 1 丢失：接收端从未读取
+	Connection.SenderCache.UpdateAckState(0, 0);
+	FNetBitWriter LostWriter(1024);
+	const int64 FullBits = Write(LostWriter, Handle, Connection.MakeSendContext(1, true));
+
+	// 包 1 已越过确认号但期间出现丢包，不能视为已送达
+	Connection.SenderCache.UpdateAckState(1, 1);
+	FNetBitWriter ResendWriter(1024);
+	TestEqual(TEXT("Lost chain is resent in full"), Write(ResendWriter, Handle, Connection.MakeSendContext(2, true)), FullBits);
+
+	FTcsSourceHandle Received;
+	TestTrue(TEXT("Resend read succeeds"), Read(ResendWriter, Connection.MakeReceiveContext(true), Received));
+	TestEqual(TEXT("Resent chain resolves"), ResolveChain(Connection.ReceiverRegistry, Received), Chain);
+
+	// 重发的包 2 确认后才切换为引用
+	Connection.SenderCache.UpdateAckState(2, 1);
+	FNetBitWriter CachedWriter(1024);
+	TestTrue(TEXT("Chain is cached after resend is acked"), Write(CachedWriter, Handle, Connection.MakeSendContext(3, true)) < FullBits);
+	TestTrue(TEXT("Cached read succeeds"), Read(CachedWriter, Connection.MakeReceiveContext(true), Received));
+
+	// 包已确认但接收端没有那条链（例如未处理完整发送所在的 Bunch）：读取不中断，句柄暂不带因果链并请求重新完整发送
+	Connection.ReceiverCache.Reset();
+	AddExpectedError(TEXT("unknown causality chain ref"), EAutomationExpectedErrorFlags::Contains, 1);
+	TestTrue(TEXT("Unknown chain ref keeps the stream readable"), Read(CachedWriter, Connection.MakeReceiveContext(true), Received));
+	TestNotNull(TEXT("Handle still resolves"), Connection.ReceiverRegistry.Resolve(Received));
+	TestEqual(TEXT("Unknown chain is not guessed"), ResolveChain(Connection.ReceiverRegistry, Received).Num(), 0);
+	TestTrue(TEXT("Receiver asks for full chains"), Connection.ReceiverCache.ConsumeUnknownChainRef());
+	TestFalse(TEXT("Request is consumed once"), Connection.ReceiverCache.ConsumeUnknownChainRef());
+
+	// 发送端收到请求后撤销确认：链重新完整发送，接收端恢复
+	Connection.SenderCache.ResetAcks();
+	FNetBitWriter RecoveryWriter(1024);
+	TestEqual(TEXT("Chain is resent in full after the request"), Write(RecoveryWriter, Handle, Connection.MakeSendContext(4, true)), FullBits);
+	TestTrue(TEXT("Recovery read succeeds"), Read(RecoveryWriter, Connection.MakeReceiveContext(true), Received));
+	TestEqual(TEXT("Recovered chain resolves"), ResolveChain(Connection.ReceiverRegistry, Received), Chain);
+
+	// 重发确认后再次切换为引用
+	Connection.SenderCache.UpdateAckState(4, 1);
+	FNetBitWriter RecachedWriter(1024);
+	TestTrue(TEXT("Chain is cached again once the resend is acked"), Write(RecachedWriter, Handle, Connection.MakeSendContext(5, true)) < FullBits);
+
+	return true;
+}
+
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTcsSourceHandleNetSerializeDeferredPacketIdTest,
+	"TireflyCombatSystem.SourceHandle.NetSerialize.DeferredPacketId",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTcsSourceHandleNetSerializeDeferredPacketIdTest::RunTest(const FString& Parameters)
+{
+	using namespace TcsSourceHandleNetSerializeTests;
+
+	FConnectionPair Connection;
+	const TArray<FPrimaryAssetId> Chain = MakeTestChain();
+	const FTcsSourceHandle Handle = AllocateWithChain(Connection.SenderRegistry, Chain);
+
+	// 帧 1：包序号未知（与真实连接一致），写出时连接的下一个包序号为 5
+	Connection.SenderCache.UpdateAckState(4, 0, 5, 1);
+	FNetBitWriter FirstWriter(1024);
+	const int64 FullBits = Write(FirstWriter, Handle, Connection.MakeSendContext(INDEX_NONE, true));
+
+	// 同一帧内发送包序号尚未补记，仍完整发送
+	FNetBitWriter SameFrameWriter(1024);
+	TestEqual(TEXT("Chain is sent in full before its packet id is known"),
+		Write(SameFrameWriter, Handle, Connection.MakeSendContext(INDEX_NONE, true)), FullBits);
+
+	// 帧 2：帧 1 的数据已在包 5、6 中发出，补记上界 6；对端只确认到 5，数据可能仍在途中
+	Connection.SenderCache.UpdateAckState(5, 0, 7, 2);
+	FNetBitWriter UnackedWriter(1024);
+	TestEqual(TEXT("Chain stays full until the bound is acked"),
+		Write(UnackedWriter, Handle, Connection.MakeSendContext(INDEX_NONE, true)), FullBits);
+
+	// 帧 3：期间无丢包，最早一次发送的上界 6 被确认后切换为引用（之后的重发不会推迟确认）
+	Connection.SenderCache.UpdateAckState(6, 0, 9, 3);
+	FNetBitWriter CachedWriter(1024);
+	TestTrue(TEXT("Chain is cached once the bound is acked"),
+		Write(CachedWriter, Handle, Connection.MakeSendContext(INDEX_NONE, true)) < FullBits);
+
+	return true;
+}
+
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTcsSourceHandleNetSerializeNetIndexTest,
+	"TireflyCombatSystem.SourceHandle.NetSerialize.DefinitionNetIndex",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTcsSourceHandleNetSerializeNetIndexTest::RunTest(const FString& Parameters)
+{
+	using namespace TcsSourceHandleNetSerializeTests;
+
+	const TArray<FPrimaryAssetId> Chain = MakeTestChain();
+
+	int64 NameBits = 0;
+	{
+		FScopedNetworkStateDefinitionIds NetworkIds{ TArray<FName>() };
+		FConnectionPair Connection;
+		FNetBitWriter Writer(4096);
+		NameBits = Write(Writer, AllocateWithChain(Connection.SenderRegistry, Chain), Connection.MakeSendContext(1, false));
+	}
+
+	// 发布顺序不影响 NetIndex 与列表哈希（按名称排序）
+	uint32 PermutedHash = 0;
+	{
+		FScopedNetworkStateDefinitionIds NetworkIds({ FName(TEXT("TcsTest_Skill")), FName(TEXT("TcsTest_Buff")), FName(TEXT("TcsTest_DoT")) });
+		PermutedHash = FTcsDefinitionIdTable::GetNetworkDefinitionListHash(ETcsDefinitionKind::State);
+	}
+	uint32 DifferentHash = 0;
+	{
+		FScopedNetworkStateDefinitionIds NetworkIds({ FName(TEXT("TcsTest_Skill")), FName(TEXT("TcsTest_Buff")) });
+		DifferentHash = FTcsDefinitionIdTable::GetNetworkDefinitionListHash(ETcsDefinitionKind::State);
+	}
+
+	FScopedNetworkStateDefinitionIds NetworkIds({ FName(TEXT("TcsTest_DoT")), FName(TEXT("TcsTest_Skill")), FName(TEXT("TcsTest_Buff")) });
+	TestEqual(TEXT("Net index is sorted by name"), FTcsDefinitionIdTable::FindNetIndex(ETcsDefinitionKind::State, FName(TEXT("TcsTest_Buff"))), 0);
+	TestEqual(TEXT("List hash ignores publish order"), FTcsDefinitionIdTable::GetNetworkDefinitionListHash(ETcsDefinitionKind::State), PermutedHash);
+	TestNotEqual(TEXT("List hash detects different lists"), FTcsDefinitionIdTable::GetNetworkDefinitionListHash(ETcsDefinitionKind::State), DifferentHash);
+
+	// 握手前（或对端列表不同）写出名称，接收端无需一致的列表
+	FConnectionPair Connection;
+	const FTcsSourceHandle Handle = AllocateWithChain(Connection.SenderRegistry, Chain);
+	FNetBitWriter UnverifiedWriter(4096);
+	TestEqual(TEXT("Unverified peer gets names"), Write(UnverifiedWriter, Handle, Connection.MakeSendContext(1, false)), NameBits);
+	{
+		FScopedNetworkStateDefinitionIds ReceiverNetworkIds{ TArray<FName>() };
+		FTcsSourceHandle Received;
+		TestTrue(TEXT("Names read without a matching list"), Read(UnverifiedWriter, Connection.MakeReceiveContext(false), Received));
+		TestEqual(TEXT("Chain round trips through names"), ResolveChain(Connection.ReceiverRegistry, Received), Chain);
+	}
+
+	// 握手确认列表一致后写出 NetIndex
+	Connection.NetIndexKinds = 1 << static_cast<uint8>(ETcsDefinitionKind::State);
+	FNetBitWriter Writer(4096);
+	const int64 IndexBits = Write(Writer, Handle, Connection.MakeSendContext(1, false));
+	TestTrue(TEXT("Net indices are smaller than names"), IndexBits > 0 && IndexBits < NameBits);
+
+	FTcsSourceHandle Received;
+	TestTrue(TEXT("Read succeeds"), Read(Writer, Connection.MakeReceiveContext(false), Received));
+	TestEqual(TEXT("Chain round trips through net indices"), ResolveChain(Connection.ReceiverRegistry, Received), Chain);
+
+	// 未发布的资产回退为完整 FPrimaryAssetId
+	TArray<FPrimaryAssetId> MixedChain = Chain;
+	MixedChain.Add(MakeStateAssetId(TEXT("TcsTest_Unpublished")));
+	FNetBitWriter MixedWriter(4096);
+	Write(MixedWriter, AllocateWithChain(Connection.SenderRegistry, MixedChain), Connection.MakeSendContext(1, false));
+	TestTrue(TEXT("Mixed read succeeds"), Read(MixedWriter, Connection.MakeReceiveContext(false), Received));
+	TestEqual(TEXT("Mixed chain round trips"), ResolveChain(Connection.ReceiverRegistry, Received), MixedChain);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,36 @@
+// Copyright Tirefly. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class TireflyCombatSystemTests : ModuleRules
+{
+	public TireflyCombatSystemTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"GameplayTags",
+				"Projects",
+				"StateTreeModule",
+				"GameplayStateTreeModule",
+				"TireflyCombatSystem"
+			}
+			);
+
+		// 无头模拟在编辑器下编译合成 StateTree
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.AddRange(
+				new string[]
+				{
+					"StateTreeEditorModule"
+				}
+			);
+		}
+	}
+}
@@ -8,7 +8,7 @@
 
 
 
-#define LOCTEXT_NAMESPACE "FTireflyCombatSystemModule"
+#define LOCTEXT_NAMESPACE "FTireflyCombatSystemTestsModule"
 
 
 
@@ -25,4 +25,4 @@ void FTireflyCombatSystemTestsModule::ShutdownModule()
 
 #undef LOCTEXT_NAMESPACE
 	
-IMPLEMENT_MODULE(FTireflyCombatSystemTestsModule, TireflyCombatSystem)
\ No newline at end of file
+IMPLEMENT_MODULE(FTireflyCombatSystemTestsModule, TireflyCombatSystemTests)
\ No newline at end of file